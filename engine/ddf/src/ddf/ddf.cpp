@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#include <dlib/align.h>
+#include <dlib/endian.h>
 #include <dlib/memory.h>
 #include <dlib/profile.h>
 #include <dlib/hash.h>
@@ -32,6 +34,36 @@ namespace dmDDF
     Descriptor* g_FirstDescriptor = 0;
     dmHashTable64<const Descriptor*> g_Descriptors;
 
+    static const uint32_t MAX_LAYOUT_HASH_DEPTH = 16;
+
+    static void HashLayout(HashState64* state, const Descriptor* desc, uint32_t depth)
+    {
+        dmHashUpdateBuffer64(state, &desc->m_Size, sizeof(desc->m_Size));
+        // Self referencing (repeated) types would otherwise recurse forever
+        if (depth == MAX_LAYOUT_HASH_DEPTH)
+            return;
+
+        for (int i = 0; i < desc->m_FieldCount; ++i)
+        {
+            const FieldDescriptor* f = &desc->m_Fields[i];
+            uint32_t field_layout[] = { f->m_Number, f->m_Type, f->m_Label, f->m_Offset };
+            dmHashUpdateBuffer64(state, field_layout, sizeof(field_layout));
+            if (f->m_MessageDescriptor)
+            {
+                HashLayout(state, f->m_MessageDescriptor, depth + 1);
+            }
+        }
+    }
+
+    // Hash of the memory layout of a message type, used to reject flat messages built from another version of the type
+    static uint64_t GetLayoutHash(const Descriptor* desc)
+    {
+        HashState64 state;
+        dmHashInit64(&state, false);
+        HashLayout(&state, desc, 0);
+        return dmHashFinal64(&state);
+    }
+
     void RegisterAllTypes()
     {
         const Descriptor* d = g_FirstDescriptor;
@@ -61,6 +93,8 @@ namespace dmDDF
     InternalRegisterDescriptor::InternalRegisterDescriptor(Descriptor* descriptor)
     {
         descriptor->m_NextDescriptor = g_FirstDescriptor;
+        // The descriptor tables are constant initialized, so nested types can be hashed even if they aren't registered yet
+        descriptor->m_LayoutHash = GetLayoutHash(descriptor);
         g_FirstDescriptor = descriptor;
     }
 
@@ -79,77 +113,60 @@ namespace dmDDF
         return GetDescriptorFromHash(dmHashString64(name));
     }
 
-    static Result CalculateRepeated(LoadContext* load_context, InputBuffer* ib, const Descriptor* desc)
+    // Messages are decoded into a scratch arena which starts out on the stack and grows on the heap
+    // as required. The result is then copied into a buffer of the exact size.
+    static const uint32_t LOAD_STACK_BUFFER_SIZE = 1024;
+
+    // The first byte of the magic, 'D', is a tag with the invalid wire type 4 (WIRETYPE_END_GROUP),
+    // so a flat message can never be mistaken for a protobuf encoded message.
+    static const uint32_t FLAT_MAGIC = 'D' | ('D' << 8) | ('F' << 16) | ('F' << 24);
+    static const uint16_t FLAT_VERSION = 2;
+
+    struct FlatHeader
     {
-        assert(desc);
+        uint32_t m_Magic;
+        uint16_t m_Version;
+        /// DM_ENDIAN_LITTLE or DM_ENDIAN_BIG
+        uint8_t  m_ByteOrder;
+        uint8_t  m_PointerSize;
+        uint64_t m_LayoutHash;
+        uint32_t m_Size;
+        uint8_t  m_Reserved[12];
+    };
+
+    static inline uint64_t GetRegisteredLayoutHash(const Descriptor* desc)
+    {
+        return desc->m_LayoutHash != 0 ? desc->m_LayoutHash : GetLayoutHash(desc);
+    }
 
-        // Calculate number of entries in arrays, ie memory requirements for the entire message
-        uint32_t start = ib->Tell();
-        while (!ib->Eof())
-        {
-            uint32_t tag;
-            if (ib->ReadVarInt32(&tag))
-            {
-                uint32_t key = tag >> 3;
-                uint32_t type = tag & 0x7;
-
-                if (key == 0)
-                    return RESULT_WIRE_FORMAT_ERROR;
-
-                const FieldDescriptor* field = FindField(desc, key, 0);
-
-                if (field == 0)
-                {
-                    Result e = SkipField(ib, type);
-                    if (e != RESULT_OK)
-                        return e;
-                }
-                else
-                {
-                    if (field->m_Label == LABEL_REPEATED)
-                    {
-                        load_context->IncreaseArrayCount(start, field->m_Number);
-                    }
-
-                    if (field->m_Type != TYPE_MESSAGE)
-                    {
-                        Result e = SkipField(ib, type);
-                        if (e != RESULT_OK)
-                            return e;
-                    }
-                    else
-                    {
-                        assert(field->m_MessageDescriptor);
-                        uint32_t length;
-                        if (!ib->ReadVarInt32(&length))
-                            return RESULT_WIRE_FORMAT_ERROR;
-
-                        #if 1
-                        InputBuffer sub_ib;
-                        if (!ib->SubBuffer(length, &sub_ib))
-                        {
-                            return RESULT_WIRE_FORMAT_ERROR;
-                        }
-
-                        Result e = CalculateRepeated(load_context, &sub_ib, field->m_MessageDescriptor);
-                        #else
-                        InputBuffer sub_ib = ib;
-                        sub_ib->m_End = sub_ib->m_Current + length;
-                        Result e = CalculateRepeated(load_context, &sub_ib, field->m_MessageDescriptor);
-                        #endif
-                        if (e != RESULT_OK)
-                            return e;
-                    }
-                }
-            }
-            else
-            {
-                return RESULT_WIRE_FORMAT_ERROR;
-            }
-        }
+    static bool IsFlatMessage(const void* buffer, uint32_t buffer_size)
+    {
+        uint32_t magic;
+        if (buffer_size < sizeof(FlatHeader))
+            return false;
+        memcpy(&magic, buffer, sizeof(magic));
+        return magic == FLAT_MAGIC;
+    }
+
+    static Result CheckFlatHeader(const void* buffer, uint32_t buffer_size, const Descriptor* desc, FlatHeader* header)
+    {
+        memcpy(header, buffer, sizeof(FlatHeader));
+        if (header->m_Version != FLAT_VERSION || header->m_ByteOrder != DM_ENDIAN || header->m_PointerSize != sizeof(void*))
+            return RESULT_VERSION_MISMATCH;
+        if (header->m_LayoutHash != GetRegisteredLayoutHash(desc))
+            return RESULT_VERSION_MISMATCH;
+        if (header->m_Size > buffer_size - sizeof(FlatHeader))
+            return RESULT_WIRE_FORMAT_ERROR;
         return RESULT_OK;
     }
 
+    static Result DecodeMessage(LoadContext* load_context, const void* buffer, uint32_t buffer_size, const Descriptor* desc)
+    {
+        Message message = load_context->AllocMessage(desc);
+        InputBuffer input_buffer((const char*) buffer, buffer_size);
+        return DoLoadMessage(load_context, &input_buffer, desc, &message);
+    }
+
     Result LoadMessage(const void* buffer, uint32_t buffer_size, const Descriptor* desc, void** out_message)
     {
         return LoadMessage(buffer, buffer_size, desc, out_message, 0, 0);
@@ -164,45 +181,109 @@ namespace dmDDF
 
         if (size)
             *size = 0;
+        *out_message = 0;
 
         if (desc->m_MajorVersion != DDF_MAJOR_VERSION)
             return RESULT_VERSION_MISMATCH;
 
-        LoadContext load_context(0, 0, true, options);
-        Message dry_message = load_context.AllocMessage(desc);
-
-        InputBuffer input_buffer((const char*) buffer, buffer_size);
-
-        Result e = CalculateRepeated(&load_context, &input_buffer, desc);
-        if (e != RESULT_OK)
-        {
-            return e;
-        }
-
-        input_buffer.Seek(0);
-        e = DoLoadMessage(&load_context, &input_buffer, desc, &dry_message);
-
-        int message_buffer_size = load_context.GetMemoryUsage();
         char* message_buffer = 0;
-        dmMemory::AlignedMalloc((void**)&message_buffer, 16, message_buffer_size);
-        assert(message_buffer);
-        load_context.SetMemoryBuffer(message_buffer, message_buffer_size, false);
-        Message message = load_context.AllocMessage(desc);
-
-        input_buffer.Seek(0);
-        e = DoLoadMessage(&load_context, &input_buffer, desc, &message);
-        if ( e == RESULT_OK )
+        uint32_t message_buffer_size = 0;
+        Result e;
+        if (IsFlatMessage(buffer, buffer_size))
         {
-            if (size)
-                *size = message_buffer_size;
-            *out_message = (void*) message_buffer;
+            FlatHeader header;
+            e = CheckFlatHeader(buffer, buffer_size, desc, &header);
+            if (e != RESULT_OK)
+                return e;
+
+            message_buffer_size = header.m_Size;
+            dmMemory::AlignedMalloc((void**)&message_buffer, 16, message_buffer_size);
+            assert(message_buffer);
+            memcpy(message_buffer, (const char*) buffer + sizeof(FlatHeader), message_buffer_size);
         }
         else
+        {
+            DM_ALIGNED(16) char stack_buffer[LOAD_STACK_BUFFER_SIZE];
+            LoadContext load_context(stack_buffer, sizeof(stack_buffer));
+            e = DecodeMessage(&load_context, buffer, buffer_size, desc);
+            if (e != RESULT_OK)
+                return e;
+
+            message_buffer_size = load_context.GetMemoryUsage();
+            dmMemory::AlignedMalloc((void**)&message_buffer, 16, message_buffer_size);
+            assert(message_buffer);
+            memcpy(message_buffer, load_context.GetPointer(0), message_buffer_size);
+        }
+
+        e = DoRelocatePointers(desc, message_buffer, 0, message_buffer_size, options);
+        if (e != RESULT_OK)
         {
             dmMemory::AlignedFree((void*) message_buffer);
-            *out_message = 0;
+            return e;
         }
-        return e;
+
+        if (size)
+            *size = message_buffer_size;
+        *out_message = (void*) message_buffer;
+        return RESULT_OK;
+    }
+
+    Result SaveFlatMessage(const void* buffer, uint32_t buffer_size, const Descriptor* desc, dmArray<uint8_t>& flat)
+    {
+        assert(buffer);
+        assert(desc);
+
+        if (desc->m_MajorVersion != DDF_MAJOR_VERSION)
+            return RESULT_VERSION_MISMATCH;
+
+        DM_ALIGNED(16) char stack_buffer[LOAD_STACK_BUFFER_SIZE];
+        LoadContext load_context(stack_buffer, sizeof(stack_buffer));
+        Result e = DecodeMessage(&load_context, buffer, buffer_size, desc);
+        if (e != RESULT_OK)
+            return e;
+
+        // The message data following the header must be 16 byte aligned
+        DM_STATIC_ASSERT(sizeof(FlatHeader) == 32, Invalid_Struct_Size);
+
+        FlatHeader header;
+        memset(&header, 0, sizeof(header));
+        header.m_Magic = FLAT_MAGIC;
+        header.m_Version = FLAT_VERSION;
+        header.m_ByteOrder = DM_ENDIAN;
+        header.m_PointerSize = (uint8_t) sizeof(void*);
+        header.m_LayoutHash = GetRegisteredLayoutHash(desc);
+        header.m_Size = load_context.GetMemoryUsage();
+
+        flat.SetSize(0);
+        flat.SetCapacity(sizeof(header) + header.m_Size);
+        flat.PushArray((const uint8_t*) &header, sizeof(header));
+        flat.PushArray((const uint8_t*) load_context.GetPointer(0), header.m_Size);
+        return RESULT_OK;
+    }
+
+    Result LoadFlatMessageInPlace(void* buffer, uint32_t buffer_size, const Descriptor* desc, void** out_message)
+    {
+        assert(buffer);
+        assert(desc);
+        assert(out_message);
+        assert(((uintptr_t) buffer & 15) == 0);
+
+        *out_message = 0;
+        if (!IsFlatMessage(buffer, buffer_size))
+            return RESULT_WIRE_FORMAT_ERROR;
+
+        FlatHeader header;
+        Result e = CheckFlatHeader(buffer, buffer_size, desc, &header);
+        if (e != RESULT_OK)
+            return e;
+
+        char* message = (char*) buffer + sizeof(FlatHeader);
+        e = DoRelocatePointers(desc, message, 0, header.m_Size, 0);
+        if (e != RESULT_OK)
+            return e;
+
+        *out_message = (void*) message;
+        return RESULT_OK;
     }
 
     Result LoadMessageFromFile(const char* file_name, const Descriptor* desc, void** message)
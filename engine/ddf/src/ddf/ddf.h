@@ -61,6 +61,8 @@ namespace dmDDF
         FieldDescriptor* m_Fields;
         uint8_t          m_FieldCount;  // TODO: Where to check < 255...?
         void*            m_NextDescriptor;
+        /// Hash of the memory layout, used to validate flat messages. Set when the type is registered.
+        uint64_t         m_LayoutHash;
     };
 
     struct RepeatedField
@@ -177,6 +179,32 @@ namespace dmDDF
      */
     Result LoadMessage(const void* buffer, uint32_t buffer_size, const Descriptor* desc, void** message, uint32_t options, uint32_t* size);
 
+    /**
+     * Convert a protobuf encoded DDF message to the flat format. The flat format is the in-memory
+     * layout of the message, with pointers stored as offsets, so loading it only requires a copy
+     * and a pointer fix-up. LoadMessage accepts both formats.
+     * The layout depends on the pointer size and endianness of the platform, and on the exact
+     * version of the message type. Loading fails with RESULT_VERSION_MISMATCH on mismatch.
+     * @param buffer Protobuf encoded input buffer
+     * @param buffer_size Input buffer size in bytes
+     * @param desc DDF descriptor
+     * @param flat Array to store the flat message in
+     * @return RESULT_OK on success
+     */
+    Result SaveFlatMessage(const void* buffer, uint32_t buffer_size, const Descriptor* desc, dmArray<uint8_t>& flat);
+
+    /**
+     * Use a message in the flat format in place, without copying it. The pointers in the buffer are
+     * fixed up, so the buffer must be writable, 16 byte aligned and outlive the message.
+     * The message must not be freed with FreeMessage. The buffer content is undefined on failure.
+     * @param buffer Flat message buffer, see SaveFlatMessage
+     * @param buffer_size Buffer size in bytes
+     * @param desc DDF descriptor
+     * @param message Pointer to message, located within buffer
+     * @return RESULT_OK on success
+     */
+    Result LoadFlatMessageInPlace(void* buffer, uint32_t buffer_size, const Descriptor* desc, void** message);
+
     /**
      * Save function call-back
      * @param context Save context
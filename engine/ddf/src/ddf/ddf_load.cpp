@@ -99,7 +99,7 @@ namespace dmDDF
             else if (f->m_DefaultValue)
             {
                 // Assume scalar type
-                message->SetScalar(f, f->m_DefaultValue, ScalarTypeSize(f->m_Type));
+                message->SetScalar(load_context, f, f->m_DefaultValue, ScalarTypeSize(f->m_Type));
             }
         }
     }
@@ -113,20 +113,71 @@ namespace dmDDF
         }
     }
 
+    // Count the entries of the repeated fields in this message only. Sub messages are skipped
+    // without being parsed, they are counted when they are loaded.
+    static Result CountRepeated(InputBuffer input_buffer, const Descriptor* desc, uint32_t* counts)
+    {
+        while (!input_buffer.Eof())
+        {
+            uint32_t tag;
+            if (!input_buffer.ReadVarInt32(&tag))
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t key = tag >> 3;
+            if (key == 0)
+            {
+                return RESULT_WIRE_FORMAT_ERROR;
+            }
+
+            uint32_t field_index;
+            const FieldDescriptor* field = FindField(desc, key, &field_index);
+            if (field && field->m_Label == LABEL_REPEATED)
+            {
+                counts[field_index]++;
+            }
+
+            Result e = SkipField(&input_buffer, tag & 0x7);
+            if (e != RESULT_OK)
+            {
+                return e;
+            }
+        }
+        return RESULT_OK;
+    }
+
     Result DoLoadMessage(LoadContext* load_context, InputBuffer* input_buffer,
                          const Descriptor* desc, Message* message)
     {
         uint8_t read_fields[DDF_MAX_FIELDS];
         memset(read_fields, 0, sizeof(read_fields));
 
+        bool has_repeated = false;
         for (int i = 0; i < desc->m_FieldCount; ++i)
         {
-            const FieldDescriptor* f = &desc->m_Fields[i];
-            if (f->m_Label == LABEL_REPEATED)
+            has_repeated |= desc->m_Fields[i].m_Label == LABEL_REPEATED;
+        }
+
+        if (has_repeated)
+        {
+            // Repeated fields are stored in contiguous arrays, so they must be sized up front
+            uint32_t repeated_counts[DDF_MAX_FIELDS];
+            assert(desc->m_FieldCount <= DDF_MAX_FIELDS);
+            memset(repeated_counts, 0, sizeof(repeated_counts[0]) * desc->m_FieldCount);
+            Result e = CountRepeated(*input_buffer, desc, repeated_counts);
+            if (e != RESULT_OK)
             {
-                // TODO: Verify buffer_pos!!!! Correct to use Tell()?
-                uint32_t buffer_pos = input_buffer->Tell();
-                message->AllocateRepeatedBuffer(load_context, f, load_context->GetArrayCount(buffer_pos, f->m_Number));
+                return e;
+            }
+
+            for (int i = 0; i < desc->m_FieldCount; ++i)
+            {
+                const FieldDescriptor* f = &desc->m_Fields[i];
+                if (f->m_Label == LABEL_REPEATED)
+                {
+                    message->AllocateRepeatedBuffer(load_context, f, repeated_counts[i]);
+                }
             }
         }
 
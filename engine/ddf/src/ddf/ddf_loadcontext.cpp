@@ -11,41 +11,67 @@
 // specific language governing permissions and limitations under the License.
 
 #include <string.h>
+#include <assert.h>
 #include <dlib/align.h>
+#include <dlib/memory.h>
+#include <dlib/math.h>
 #include "ddf_loadcontext.h"
 #include "ddf_util.h"
 
 namespace dmDDF
 {
-    LoadContext::LoadContext(char* buffer, int buffer_size, bool dry_run, uint32_t options)
+    LoadContext::LoadContext(char* buffer, uint32_t buffer_size)
     {
+        assert(((uintptr_t) buffer & 15) == 0);
         m_Start = buffer;
-        m_Current = buffer;
-        m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
-        m_Options = options;
-        if (!dry_run)
+        m_Current = 0;
+        m_Capacity = buffer_size;
+        m_OwnsBuffer = false;
+        memset(buffer, 0, buffer_size);
+    }
+
+    LoadContext::~LoadContext()
+    {
+        if (m_OwnsBuffer)
         {
-            memset(buffer, 0, buffer_size);
+            dmMemory::AlignedFree(m_Start);
         }
-        m_ArrayCount.SetCapacity(2048, 2048);
     }
 
-    Message LoadContext::AllocMessage(const Descriptor* desc)
+    uint32_t LoadContext::Alloc(uint32_t size, uint32_t align)
     {
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
-        char* b = m_Current;
-        m_Current += desc->m_Size;
-        assert(m_DryRun || m_Current <= m_End);
+        uint32_t offset = (uint32_t) DM_ALIGN(m_Current, align);
+        uint32_t end = offset + size;
+        if (end > m_Capacity)
+        {
+            uint32_t capacity = (uint32_t) DM_ALIGN(dmMath::Max(end, m_Capacity * 2), 16);
+            char* buffer = 0;
+            dmMemory::Result r = dmMemory::AlignedMalloc((void**) &buffer, 16, capacity);
+            assert(r == dmMemory::RESULT_OK);
+            (void) r;
+            memcpy(buffer, m_Start, m_Current);
+            memset(buffer + m_Current, 0, capacity - m_Current);
+            if (m_OwnsBuffer)
+            {
+                dmMemory::AlignedFree(m_Start);
+            }
+            m_Start = buffer;
+            m_Capacity = capacity;
+            m_OwnsBuffer = true;
+        }
+        m_Current = end;
+        return offset;
+    }
 
-        return Message(desc, b, desc->m_Size, m_DryRun);
+    Message LoadContext::AllocMessage(const Descriptor* desc)
+    {
+        return Message(desc, Alloc(desc->m_Size, 16));
     }
 
-    void* LoadContext::AllocRepeated(const FieldDescriptor* field_desc, int count)
+    uint32_t LoadContext::AllocRepeated(const FieldDescriptor* field_desc, int count)
     {
         Type type = (Type) field_desc->m_Type;
 
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
         int element_size = 0;
         if ( field_desc->m_Type == TYPE_MESSAGE )
         {
@@ -60,78 +86,22 @@ namespace dmDDF
             element_size = ScalarTypeSize(type);
         }
 
-        char* b = m_Current;
-        m_Current += count * element_size;
-        assert(m_DryRun || m_Current <= m_End);
-        return (void*) b;
-    }
-
-    char* LoadContext::AllocString(int length)
-    {
-        char* b = m_Current;
-        m_Current += length;
-        assert(m_DryRun || m_Current <= m_End);
-
-        return b;
-    }
-
-    char* LoadContext::AllocBytes(int length)
-    {
-        m_Current = (char*) DM_ALIGN(m_Current, 16);
-        char* b = m_Current;
-        m_Current += length;
-        assert(m_DryRun || m_Current <= m_End);
-        return b;
-    }
-
-    uint32_t LoadContext::GetOffset(void* memory)
-    {
-        return ((uintptr_t) memory) - ((uintptr_t) m_Start);
+        return Alloc(count * element_size, 16);
     }
 
-    void* LoadContext::GetPointer(uint32_t offset)
+    uint32_t LoadContext::AllocString(int length)
     {
-        return m_Start+offset;
+        return Alloc(length, 1);
     }
 
-    void LoadContext::SetMemoryBuffer(char* buffer, int buffer_size, bool dry_run)
+    uint32_t LoadContext::AllocBytes(int length)
     {
-        m_Start = buffer;
-        m_Current = buffer;
-        m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
-        if (!dry_run)
-        {
-            memset(buffer, 0, buffer_size);
-        }
-    }
-
-    int LoadContext::GetMemoryUsage()
-    {
-        return (int) (m_Current - m_Start);
-    }
-
-    void LoadContext::IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number)
-    {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        if(m_ArrayCount.Full())
-            m_ArrayCount.SetCapacity(2048, m_ArrayCount.Capacity() + 1024);
-        uint32_t* value_p = m_ArrayCount.Get(hash);
-        if(value_p) {
-            (*value_p)++;
-        }
-        else {
-            m_ArrayCount.Put(hash, 1);
-        }
+        return Alloc(length, 16);
     }
 
-    uint32_t LoadContext::GetArrayCount(uint32_t buffer_pos, uint32_t field_number)
+    uint32_t LoadContext::GetMemoryUsage()
     {
-        uint32_t key[] = {field_number, buffer_pos};
-        uint32_t hash = dmHashBufferNoReverse32((void*)key, sizeof(key));
-        uint32_t *value_p = m_ArrayCount.Get(hash);
-        return value_p == 0 ? 0 : *value_p;
+        return m_Current;
     }
 }
 
@@ -14,7 +14,6 @@
 #define DDF_LOADCONTEXT_H
 
 #include <stdint.h>
-#include <dlib/hashtable.h>
 #include "ddf.h"
 #include "ddf_message.h"
 
@@ -22,36 +21,36 @@ namespace dmDDF
 {
     class Message;
 
+    /**
+     * Growable arena the message is decoded into. All references within the
+     * arena, including the pointer fields of the message, are stored as offsets
+     * from the start of the arena while loading, as the arena may move when it grows.
+     */
     class LoadContext
     {
     public:
-        LoadContext(char* buffer, int buffer_size, bool dry_run, uint32_t options);
-        Message     AllocMessage(const Descriptor* desc);
-        void*       AllocRepeated(const FieldDescriptor* field_desc, int count);
-        char*       AllocString(int length);
-        char*       AllocBytes(int length);
-        uint32_t    GetOffset(void* memory);
-        void*       GetPointer(uint32_t offset);
-
-        void        SetMemoryBuffer(char* buffer, int buffer_size, bool dry_run);
-        int         GetMemoryUsage();
+        LoadContext(char* buffer, uint32_t buffer_size);
+        ~LoadContext();
 
-        void        IncreaseArrayCount(uint32_t buffer_pos, uint32_t field_number);
-        uint32_t    GetArrayCount(uint32_t buffer_pos, uint32_t field_number);
+        Message     AllocMessage(const Descriptor* desc);
+        uint32_t    AllocRepeated(const FieldDescriptor* field_desc, int count);
+        uint32_t    AllocString(int length);
+        uint32_t    AllocBytes(int length);
 
-        inline uint32_t GetOptions()
+        inline char* GetPointer(uint32_t offset)
         {
-            return m_Options;
+            return m_Start + offset;
         }
 
+        uint32_t    GetMemoryUsage();
+
     private:
-        dmHashTable32<uint32_t> m_ArrayCount;
+        uint32_t    Alloc(uint32_t size, uint32_t align);
 
-        char* m_Start;
-        char* m_End;
-        char* m_Current;
-        bool  m_DryRun;
-        uint32_t m_Options;
+        char*    m_Start;
+        uint32_t m_Current;
+        uint32_t m_Capacity;
+        bool     m_OwnsBuffer;
     };
 }
 
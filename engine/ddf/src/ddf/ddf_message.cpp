@@ -18,12 +18,16 @@
 namespace dmDDF
 {
 
-    Message::Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size, bool dry_run)
+    Message::Message(const Descriptor* message_descriptor, uint32_t offset)
     {
         m_MessageDescriptor = message_descriptor;
-        m_Start = buffer;
-        m_End = buffer + buffer_size;
-        m_DryRun = dry_run;
+        m_Offset = offset;
+    }
+
+    char* Message::GetField(LoadContext* load_context, const FieldDescriptor* field)
+    {
+        assert(field->m_Offset < m_MessageDescriptor->m_Size);
+        return load_context->GetPointer(m_Offset + field->m_Offset);
     }
 
     #define READSCALARFIELD_CASE(DDF_TYPE, CPP_TYPE, READ_METHOD) \
@@ -36,11 +40,11 @@ namespace dmDDF
             }                                                               \
             if (field->m_Label == LABEL_REPEATED)                       \
             {                                                               \
-                AddScalar(field, (void*) &value, sizeof(CPP_TYPE));         \
+                AddScalar(load_context, field, (void*) &value, sizeof(CPP_TYPE)); \
             }                                                               \
             else                                                            \
             {                                                               \
-                SetScalar(field, (void*) &value, sizeof(CPP_TYPE));         \
+                SetScalar(load_context, field, (void*) &value, sizeof(CPP_TYPE)); \
             }                                                               \
             return RESULT_OK;                                               \
         }                                                                   \
@@ -157,17 +161,17 @@ namespace dmDDF
             return RESULT_WIRE_FORMAT_ERROR;
         }
 
-        char* msg_buf = 0;
+        uint32_t msg_offset = 0;
         if (field->m_Label == LABEL_REPEATED)
         {
-            msg_buf = (char*) AddMessage(field);
+            msg_offset = AddMessage(load_context, field);
         }
         else
         {
-            msg_buf = &m_Start[field->m_Offset];
-            assert(msg_buf + field->m_MessageDescriptor->m_Size <= m_End);
+            msg_offset = m_Offset + field->m_Offset;
+            assert(field->m_Offset + field->m_MessageDescriptor->m_Size <= m_MessageDescriptor->m_Size);
         }
-        Message message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size, m_DryRun);
+        Message message(field->m_MessageDescriptor, msg_offset);
         InputBuffer sub_buffer;
         if (!input_buffer->SubBuffer(length, &sub_buffer))
         {
@@ -193,8 +197,7 @@ namespace dmDDF
         }
         assert(found);
 #endif
-        char* msg_buf = &m_Start[field->m_Offset];
-        return Message(field->m_MessageDescriptor, (char*) msg_buf, field->m_MessageDescriptor->m_Size, m_DryRun);
+        return Message(field->m_MessageDescriptor, m_Offset + field->m_Offset);
     }
 
     Result Message::ReadField(LoadContext* load_context,
@@ -221,88 +224,53 @@ namespace dmDDF
         }
     }
 
-    void Message::SetScalar(const FieldDescriptor* field, const void* buffer, int buffer_size)
+    void Message::SetScalar(LoadContext* load_context, const FieldDescriptor* field, const void* buffer, int buffer_size)
     {
         assert((Label) field->m_Label != LABEL_REPEATED);
         assert(field->m_MessageDescriptor == 0);
 
-        assert(m_Start + field->m_Offset + buffer_size <= m_End);
-        if (!m_DryRun)
-        {
-            memcpy(m_Start + field->m_Offset, buffer, buffer_size);
-        }
+        assert(field->m_Offset + buffer_size <= m_MessageDescriptor->m_Size);
+        memcpy(GetField(load_context, field), buffer, buffer_size);
     }
 
-    void* Message::AddScalar(const FieldDescriptor* field, const void* buffer, int buffer_size)
+    void Message::AddScalar(LoadContext* load_context, const FieldDescriptor* field, const void* buffer, int buffer_size)
     {
         assert((Label) field->m_Label == LABEL_REPEATED);
         assert(field->m_MessageDescriptor == 0);
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * buffer_size;
-
-            memcpy((void*) dest, buffer, buffer_size);
-            repeated_field->m_ArrayCount++;
+        RepeatedField* repeated_field = (RepeatedField*) GetField(load_context, field);
+        uint32_t dest = (uint32_t) repeated_field->m_Array + repeated_field->m_ArrayCount * buffer_size;
 
-            return (void*) dest;
-        }
-        return 0;
+        memcpy(load_context->GetPointer(dest), buffer, buffer_size);
+        repeated_field->m_ArrayCount++;
     }
 
-    void* Message::AddMessage(const FieldDescriptor* field)
+    uint32_t Message::AddMessage(LoadContext* load_context, const FieldDescriptor* field)
     {
         assert((Label) field->m_Label == LABEL_REPEATED);
         assert(field->m_MessageDescriptor);
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t dest = repeated_field->m_Array + repeated_field->m_ArrayCount * field->m_MessageDescriptor->m_Size;
-
-            memset((void*) dest, 0, field->m_MessageDescriptor->m_Size);
-            repeated_field->m_ArrayCount++;
-
-            return (void*) dest;
-        }
-        return 0;
-    }
-
-    void Message::SetRepeatedBuffer(const FieldDescriptor* field, void* buffer)
-    {
-        assert((Label) field->m_Label == LABEL_REPEATED);
+        // The arena is zero initialized
+        RepeatedField* repeated_field = (RepeatedField*) GetField(load_context, field);
+        uint32_t dest = (uint32_t) repeated_field->m_Array + repeated_field->m_ArrayCount * field->m_MessageDescriptor->m_Size;
+        repeated_field->m_ArrayCount++;
 
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            repeated_field->m_Array = (uintptr_t) buffer;
-            repeated_field->m_ArrayCount = 0;
-        }
+        return dest;
     }
 
     void Message::SetString(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len)
     {
         assert((Type) field->m_Type == TYPE_STRING);
 
-        // Always alloc
-        char* str_buf = load_context->AllocString(buffer_len + 1);
+        // Always alloc. Allocating may move the arena, so only fetch pointers after this point
+        uint32_t str_offset = load_context->AllocString(buffer_len + 1);
 
-        if (!m_DryRun)
-        {
-            const char** string_field = (const char**) &m_Start[field->m_Offset];
-            memcpy(str_buf, buffer, buffer_len);
-            str_buf[buffer_len] = '\0';
+        char* str_buf = load_context->GetPointer(str_offset);
+        memcpy(str_buf, buffer, buffer_len);
+        str_buf[buffer_len] = '\0';
 
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
-            {
-                *string_field = (char*)(uintptr_t) load_context->GetOffset(str_buf);
-            }
-            else
-            {
-                *string_field = str_buf;
-            }
-        }
+        uintptr_t* string_field = (uintptr_t*) GetField(load_context, field);
+        *string_field = str_offset;
     }
 
     void Message::AddString(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len)
@@ -310,70 +278,152 @@ namespace dmDDF
         assert((Label) field->m_Label == LABEL_REPEATED);
         assert(field->m_MessageDescriptor == 0);
 
-        // Always alloc
-        char* str_buf = load_context->AllocString(buffer_len + 1);
-
-        if (!m_DryRun)
-        {
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            uintptr_t array = (uintptr_t)repeated_field->m_Array;
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS )
-            {
-                if (repeated_field->m_ArrayCount == 0) {
-                    repeated_field->m_Array = (uintptr_t) load_context->GetOffset((void*)repeated_field->m_Array);
-                }
-                array = (uintptr_t)load_context->GetPointer(repeated_field->m_Array);
-            }
+        // Always alloc. Allocating may move the arena, so only fetch pointers after this point
+        uint32_t str_offset = load_context->AllocString(buffer_len + 1);
 
-            memcpy(str_buf, buffer, buffer_len);
-            str_buf[buffer_len] = '\0';
+        char* str_buf = load_context->GetPointer(str_offset);
+        memcpy(str_buf, buffer, buffer_len);
+        str_buf[buffer_len] = '\0';
 
-            uintptr_t dest = array + repeated_field->m_ArrayCount * sizeof(const char*);
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
-            {
-                const char* offset = (const char*)(uintptr_t) load_context->GetOffset(str_buf);
-                memcpy((void*) dest, &offset, sizeof(const char*));
-            }
-            else
-            {
-                memcpy((void*) dest, &str_buf, sizeof(const char*));
-            }
-            repeated_field->m_ArrayCount++;
-        }
+        RepeatedField* repeated_field = (RepeatedField*) GetField(load_context, field);
+        uint32_t dest = (uint32_t) repeated_field->m_Array + repeated_field->m_ArrayCount * sizeof(const char*);
+        uintptr_t value = str_offset;
+        memcpy(load_context->GetPointer(dest), &value, sizeof(const char*));
+        repeated_field->m_ArrayCount++;
     }
 
     void Message::SetBytes(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len)
     {
         assert((Type) field->m_Type == TYPE_BYTES);
 
-        // Always alloc
-        char* bytes_buf = load_context->AllocBytes(buffer_len);
+        // Always alloc. Allocating may move the arena, so only fetch pointers after this point
+        uint32_t bytes_offset = load_context->AllocBytes(buffer_len);
+        memcpy(load_context->GetPointer(bytes_offset), buffer, buffer_len);
+
+        RepeatedField* repeated_field = (RepeatedField*) GetField(load_context, field);
+        assert(repeated_field->m_ArrayCount == 0);
+        repeated_field->m_Array = bytes_offset;
+        repeated_field->m_ArrayCount = buffer_len;
+    }
+
+    void Message::AllocateRepeatedBuffer(LoadContext* load_context, const FieldDescriptor* field, int element_count)
+    {
+        assert((Label) field->m_Label == LABEL_REPEATED);
+
+        uint32_t buf = load_context->AllocRepeated(field, element_count);
+        RepeatedField* repeated_field = (RepeatedField*) GetField(load_context, field);
+        repeated_field->m_Array = buf;
+        repeated_field->m_ArrayCount = 0;
+    }
+
+    static inline bool IsValidString(const char* base, uintptr_t offset, uint32_t size)
+    {
+        return offset < size && memchr(base + offset, 0, size - offset) != 0;
+    }
+
+    Result DoRelocatePointers(const Descriptor* desc, char* base, uint32_t offset, uint32_t size, uint32_t options)
+    {
+        uint64_t message_end = (uint64_t) offset + desc->m_Size;
+        if (message_end > size)
+        {
+            return RESULT_WIRE_FORMAT_ERROR;
+        }
 
-        if (!m_DryRun)
+        bool offset_pointers = (options & OPTION_OFFSET_POINTERS) != 0;
+        for (int i = 0; i < desc->m_FieldCount; ++i)
         {
-            memcpy(bytes_buf, buffer, buffer_len);
+            const FieldDescriptor* field = &desc->m_Fields[i];
+            uint32_t field_offset = offset + field->m_Offset;
+            Type type = (Type) field->m_Type;
+
+            if (field->m_Label == LABEL_REPEATED)
+            {
+                RepeatedField* repeated_field = (RepeatedField*) (base + field_offset);
+                uint32_t element_size;
+                if (type == TYPE_MESSAGE)
+                    element_size = field->m_MessageDescriptor->m_Size;
+                else if (type == TYPE_STRING)
+                    element_size = sizeof(const char*);
+                else
+                    element_size = ScalarTypeSize(type);
 
-            RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
-            assert(repeated_field->m_ArrayCount == 0);
+                // Arrays are always allocated after the owning message, which also guarantees that the recursion terminates
+                uint64_t array_end = (uint64_t) repeated_field->m_Array + (uint64_t) repeated_field->m_ArrayCount * element_size;
+                if (repeated_field->m_Array < message_end || array_end > size)
+                {
+                    return RESULT_WIRE_FORMAT_ERROR;
+                }
 
-            if (load_context->GetOptions() & OPTION_OFFSET_POINTERS)
+                if (type == TYPE_MESSAGE)
+                {
+                    for (uint32_t j = 0; j < repeated_field->m_ArrayCount; ++j)
+                    {
+                        Result r = DoRelocatePointers(field->m_MessageDescriptor, base, (uint32_t) repeated_field->m_Array + j * element_size, size, options);
+                        if (r != RESULT_OK)
+                        {
+                            return r;
+                        }
+                    }
+                }
+                else if (type == TYPE_STRING)
+                {
+                    uintptr_t* strings = (uintptr_t*) (base + repeated_field->m_Array);
+                    for (uint32_t j = 0; j < repeated_field->m_ArrayCount; ++j)
+                    {
+                        if (!IsValidString(base, strings[j], size))
+                        {
+                            return RESULT_WIRE_FORMAT_ERROR;
+                        }
+                        if (!offset_pointers)
+                        {
+                            strings[j] = (uintptr_t) base + strings[j];
+                        }
+                    }
+                    if (offset_pointers)
+                        continue;
+                }
+                repeated_field->m_Array = (uintptr_t) base + repeated_field->m_Array;
+            }
+            else if (type == TYPE_MESSAGE)
             {
-                repeated_field->m_Array = (uintptr_t) load_context->GetOffset(bytes_buf);
+                Result r = DoRelocatePointers(field->m_MessageDescriptor, base, field_offset, size, options);
+                if (r != RESULT_OK)
+                {
+                    return r;
+                }
             }
-            else
+            else if (type == TYPE_STRING)
             {
-                repeated_field->m_Array = (uintptr_t) bytes_buf;
+                uintptr_t* pointer = (uintptr_t*) (base + field_offset);
+                if (*pointer != 0)
+                {
+                    if (!IsValidString(base, *pointer, size))
+                    {
+                        return RESULT_WIRE_FORMAT_ERROR;
+                    }
+                    if (!offset_pointers)
+                    {
+                        *pointer = (uintptr_t) base + *pointer;
+                    }
+                }
+            }
+            else if (type == TYPE_BYTES)
+            {
+                RepeatedField* bytes_field = (RepeatedField*) (base + field_offset);
+                if (bytes_field->m_Array != 0)
+                {
+                    if ((uint64_t) bytes_field->m_Array + bytes_field->m_ArrayCount > size)
+                    {
+                        return RESULT_WIRE_FORMAT_ERROR;
+                    }
+                    if (!offset_pointers)
+                    {
+                        bytes_field->m_Array = (uintptr_t) base + bytes_field->m_Array;
+                    }
+                }
             }
-            repeated_field->m_ArrayCount = buffer_len;
         }
-    }
-
-    void Message::AllocateRepeatedBuffer(LoadContext* load_context, const FieldDescriptor* field, int element_count)
-    {
-        assert((Label) field->m_Label == LABEL_REPEATED);
-
-        void* buf = load_context->AllocRepeated(field, element_count);
-        SetRepeatedBuffer(field, buf);
+        return RESULT_OK;
     }
 
     Result DoResolvePointers(const Descriptor* desc, void* message)
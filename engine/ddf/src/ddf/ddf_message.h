@@ -25,18 +25,17 @@ namespace dmDDF
     class Message
     {
     public:
-        Message(const Descriptor* message_descriptor, char* buffer, uint32_t buffer_size, bool dry_run);
+        Message(const Descriptor* message_descriptor, uint32_t offset);
 
         Result ReadField(LoadContext* load_context,
                          WireType wire_type,
                          const FieldDescriptor* field,
                          InputBuffer* input_buffer);
 
-        void     SetScalar(const FieldDescriptor* field, const void* buffer, int buffer_size);
-        void*    AddScalar(const FieldDescriptor* field, const void* buffer, int buffer_size);
-        void*    AddMessage(const FieldDescriptor* field);
+        void     SetScalar(LoadContext* load_context, const FieldDescriptor* field, const void* buffer, int buffer_size);
+        void     AddScalar(LoadContext* load_context, const FieldDescriptor* field, const void* buffer, int buffer_size);
+        uint32_t AddMessage(LoadContext* load_context, const FieldDescriptor* field);
         void     AllocateRepeatedBuffer(LoadContext* load_context, const FieldDescriptor* field, int element_count);
-        void     SetRepeatedBuffer(const FieldDescriptor* field, void* buffer);
         void     SetString(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len);
         void     AddString(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len);
         void     SetBytes(LoadContext* load_context, const FieldDescriptor* field, const char* buffer, int buffer_len);
@@ -64,12 +63,18 @@ namespace dmDDF
                                 const FieldDescriptor* field,
                                 InputBuffer* input_buffer);
 
+        char* GetField(LoadContext* load_context, const FieldDescriptor* field);
+
         const Descriptor*     m_MessageDescriptor;
-        char*                 m_Start;
-        char*                 m_End;
-        bool                  m_DryRun;
+        uint32_t              m_Offset;
     };
 
+    /**
+     * Convert the offsets stored in a message loaded into a LoadContext, or stored in the flat format,
+     * into pointers relative to "base". With OPTION_OFFSET_POINTERS, strings and bytes are kept as offsets.
+     * All offsets are validated against "size", and arrays must be located after the message that owns them.
+     */
+    Result DoRelocatePointers(const Descriptor* message_descriptor, char* base, uint32_t offset, uint32_t size, uint32_t options);
 
     Result DoResolvePointers(const Descriptor* message_descriptor, void* message);
 }
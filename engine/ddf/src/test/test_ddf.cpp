@@ -516,6 +516,60 @@ TEST(NestedArray, Load)
     dmDDF::FreeMessage(message);
 }
 
+TEST(NestedArray, LoadInterleaved)
+{
+    const int count1 = 64;
+    const int count2 = 16;
+
+    // Concatenated messages are merged, which interleaves the repeated entries with other fields.
+    // The arrays are also large enough for the load arena to grow.
+    std::string pb_msg_str;
+    for (int k = 0; k < 2; ++k)
+    {
+        TestDDF::NestedArray pb_nested;
+        pb_nested.set_d(k);
+        pb_nested.set_e(k);
+
+        for (int i = 0; i < count1; ++i)
+        {
+            TestDDF::NestedArraySub1* sub1 = pb_nested.add_array1();
+            sub1->set_b(k*1000+i*2+0);
+            sub1->set_c(k*1000+i*2+1);
+            for (int j = 0; j < count2; ++j)
+            {
+                TestDDF::NestedArraySub2* sub2 = sub1->add_array2();
+                sub2->set_a(k*1000+j*10+0);
+            }
+        }
+        pb_msg_str += pb_nested.SerializeAsString();
+    }
+
+    TestDDF::NestedArray pb_nested;
+    ASSERT_TRUE(pb_nested.ParseFromString(pb_msg_str));
+
+    void* message;
+    dmDDF::Result e = dmDDF::LoadMessage((void*) pb_msg_str.c_str(), pb_msg_str.size(), &DUMMY::TestDDF_NestedArray_DESCRIPTOR, &message);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+    DUMMY::TestDDF::NestedArray* nested = (DUMMY::TestDDF::NestedArray*) message;
+
+    ASSERT_EQ((uint32_t) count1 * 2, nested->m_Array1.m_Count);
+    ASSERT_EQ(pb_nested.d(), nested->m_D);
+    ASSERT_EQ(pb_nested.e(), nested->m_E);
+
+    for (int i = 0; i < count1 * 2; ++i)
+    {
+        ASSERT_EQ((uint32_t) count2, nested->m_Array1.m_Data[i].m_Array2.m_Count);
+        ASSERT_EQ(pb_nested.array1(i).b(), nested->m_Array1.m_Data[i].m_B);
+        ASSERT_EQ(pb_nested.array1(i).c(), nested->m_Array1.m_Data[i].m_C);
+        for (int j = 0; j < count2; ++j)
+        {
+            ASSERT_EQ(pb_nested.array1(i).array2(j).a(), nested->m_Array1.m_Data[i].m_Array2.m_Data[j].m_A);
+        }
+    }
+
+    dmDDF::FreeMessage(message);
+}
+
 TEST(Bytes, Load)
 {
     TestDDF::Bytes bytes;
@@ -748,6 +802,118 @@ TEST(PointerOffset, ResolvePointers)
     free(msg);
 }
 
+// Converts the protobuf message to the flat format and checks that it loads into an identical message
+static void TestFlatRoundTrip(const std::string& pb_msg_str, const dmDDF::Descriptor* desc)
+{
+    std::string expected;
+    void* message;
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::LoadMessage((void*) pb_msg_str.c_str(), pb_msg_str.size(), desc, &message));
+    ASSERT_EQ(dmDDF::RESULT_OK, DDFSaveToString(message, desc, expected));
+    dmDDF::FreeMessage(message);
+
+    dmArray<uint8_t> flat;
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::SaveFlatMessage((void*) pb_msg_str.c_str(), pb_msg_str.size(), desc, flat));
+
+    std::string flat_msg_str;
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::LoadMessage(flat.Begin(), flat.Size(), desc, &message));
+    ASSERT_EQ(dmDDF::RESULT_OK, DDFSaveToString(message, desc, flat_msg_str));
+    ASSERT_EQ(expected, flat_msg_str);
+    dmDDF::FreeMessage(message);
+
+    void* buffer = 0;
+    ASSERT_EQ(dmMemory::RESULT_OK, dmMemory::AlignedMalloc(&buffer, 16, flat.Size()));
+    memcpy(buffer, flat.Begin(), flat.Size());
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::LoadFlatMessageInPlace(buffer, flat.Size(), desc, &message));
+    ASSERT_TRUE(message > buffer && message < (uint8_t*) buffer + flat.Size());
+    flat_msg_str.clear();
+    ASSERT_EQ(dmDDF::RESULT_OK, DDFSaveToString(message, desc, flat_msg_str));
+    ASSERT_EQ(expected, flat_msg_str);
+    dmMemory::AlignedFree(buffer);
+}
+
+TEST(Flat, LoadSave)
+{
+    TestDDF::Mesh mesh;
+    for (int i = 0; i < 100; ++i)
+    {
+        mesh.add_vertices((float) i);
+        mesh.add_indices(i);
+    }
+    mesh.set_primitive_count(100);
+    mesh.set_name("MyMesh");
+    mesh.set_primitive_type(TestDDF::Mesh_Primitive_TRIANGLES);
+    TestFlatRoundTrip(mesh.SerializeAsString(), &DUMMY::TestDDF_Mesh_DESCRIPTOR);
+
+    TestDDF::NestedArray nested;
+    nested.set_d(1);
+    nested.set_e(2);
+    for (int i = 0; i < 16; ++i)
+    {
+        TestDDF::NestedArraySub1* sub1 = nested.add_array1();
+        sub1->set_b(i);
+        sub1->set_c(i * 2);
+        for (int j = 0; j < 8; ++j)
+        {
+            sub1->add_array2()->set_a(i * 100 + j);
+        }
+    }
+    TestFlatRoundTrip(nested.SerializeAsString(), &DUMMY::TestDDF_NestedArray_DESCRIPTOR);
+
+    const char* names[] = {"Vyvyan", "Rik", "Neil", "Mike"};
+    TestDDF::ResolvePointers strings;
+    strings.set_data((uint8_t*) "data", 5);
+    strings.set_name("Bengan");
+    for (size_t i = 0; i < sizeof(names)/sizeof(names[0]); ++i)
+    {
+        strings.add_names(names[i]);
+    }
+    TestFlatRoundTrip(strings.SerializeAsString(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR);
+}
+
+TEST(Flat, Invalid)
+{
+    TestDDF::ResolvePointers strings;
+    strings.set_data((uint8_t*) "data", 5);
+    strings.set_name("Bengan");
+    strings.add_names("Rik");
+    std::string msg_str = strings.SerializeAsString();
+
+    dmArray<uint8_t> flat;
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::SaveFlatMessage((void*) msg_str.c_str(), msg_str.size(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, flat));
+
+    // The layout hash is computed when the type is registered
+    ASSERT_NE(0u, DUMMY::TestDDF_ResolvePointers_DESCRIPTOR.m_LayoutHash);
+    ASSERT_NE(DUMMY::TestDDF_Simple_DESCRIPTOR.m_LayoutHash, DUMMY::TestDDF_ResolvePointers_DESCRIPTOR.m_LayoutHash);
+
+    // Another message type
+    void* message;
+    ASSERT_EQ(dmDDF::RESULT_VERSION_MISMATCH, dmDDF::LoadMessage(flat.Begin(), flat.Size(), &DUMMY::TestDDF_Simple_DESCRIPTOR, &message));
+
+    // Another byte order or pointer size
+    const uint32_t byte_order_offset = 6;
+    const uint32_t pointer_size_offset = 7;
+    flat[byte_order_offset] ^= 1;
+    ASSERT_EQ(dmDDF::RESULT_VERSION_MISMATCH, dmDDF::LoadMessage(flat.Begin(), flat.Size(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, &message));
+    flat[byte_order_offset] ^= 1;
+    flat[pointer_size_offset] ^= 12;
+    ASSERT_EQ(dmDDF::RESULT_VERSION_MISMATCH, dmDDF::LoadMessage(flat.Begin(), flat.Size(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, &message));
+    flat[pointer_size_offset] ^= 12;
+
+    // Truncated
+    ASSERT_NE(dmDDF::RESULT_OK, dmDDF::LoadMessage(flat.Begin(), flat.Size() - 1, &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, &message));
+
+    // String pointing outside of the message
+    const uint32_t header_size = 32;
+    uintptr_t offset = flat.Size();
+    memcpy(&flat[header_size + DDF_OFFSET_OF(DUMMY::TestDDF::ResolvePointers, m_Name)], &offset, sizeof(offset));
+    ASSERT_EQ(dmDDF::RESULT_WIRE_FORMAT_ERROR, dmDDF::LoadMessage(flat.Begin(), flat.Size(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, &message));
+
+    // Array overlapping the message itself
+    offset = 0;
+    memcpy(&flat[header_size + DDF_OFFSET_OF(DUMMY::TestDDF::ResolvePointers, m_Names)], &offset, sizeof(offset));
+    ASSERT_EQ(dmDDF::RESULT_WIRE_FORMAT_ERROR, dmDDF::LoadMessage(flat.Begin(), flat.Size(), &DUMMY::TestDDF_ResolvePointers_DESCRIPTOR, &message));
+}
+
 TEST(AlignmentTests, AlignStruct)
 {
     DM_STATIC_ASSERT(sizeof(DUMMY::TestDDF::TestMessageAlignment) % 16 == 0, Invalid_Struct_Size);
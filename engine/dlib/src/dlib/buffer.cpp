@@ -51,6 +51,7 @@ namespace dmBuffer
         Stream*  m_Streams;
         uint32_t m_Stride;          // The struct size (in bytes)
         uint32_t m_Count;           // The number of "structs" in the buffer (e.g. vertex count)
+        uint32_t m_ContentVersion;  // Increased when the content has been changed
         uint16_t m_Version;
         uint8_t  m_NumStreams;
     };
@@ -387,6 +388,7 @@ namespace dmBuffer
         buffer->m_Streams = (Buffer::Stream*)((uintptr_t)data_block + sizeof(Buffer));
         buffer->m_Data = (void*)((uintptr_t)data_block + header_size);
         buffer->m_Stride = struct_size;
+        buffer->m_ContentVersion = 0;
 
         CreateStreamsInterleaved(buffer, streams_decl, offsets);
 
@@ -449,6 +451,8 @@ namespace dmBuffer
         // Copy memory
         memcpy(dst_bytes, src_bytes, src_size);
 
+        UpdateContentVersion(dst_buffer_handle);
+
         return RESULT_OK;
     }
 
@@ -586,4 +590,24 @@ namespace dmBuffer
         *type_count = stream->m_ValueCount;
         return RESULT_OK;
     }
+
+    Result GetContentVersion(HBuffer hbuffer, uint32_t* version)
+    {
+        Buffer* buffer = GetBuffer(g_BufferContext, hbuffer);
+        if (!buffer) {
+            return RESULT_BUFFER_INVALID;
+        }
+        *version = buffer->m_ContentVersion;
+        return RESULT_OK;
+    }
+
+    Result UpdateContentVersion(HBuffer hbuffer)
+    {
+        Buffer* buffer = GetBuffer(g_BufferContext, hbuffer);
+        if (!buffer) {
+            return RESULT_BUFFER_INVALID;
+        }
+        buffer->m_ContentVersion++;
+        return RESULT_OK;
+    }
 }
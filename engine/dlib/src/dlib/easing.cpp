@@ -59,5 +59,64 @@ namespace dmEasing
         float diff = (t - index1 * (1.0f / (sample_count-1))) * (sample_count-1);
         return val1 * (1.0f - diff) + val2 * diff;
     }
-}
 
+    void GetValues(Curve curve, const float* t, float* out, uint32_t count)
+    {
+        int sample_count;
+        float* lookup;
+
+        if (curve.type == dmEasing::TYPE_FLOAT_VECTOR)
+        {
+            sample_count = curve.vector->size;
+            lookup       = curve.vector->values;
+
+            if (sample_count <= 1)
+            {
+                float v = sample_count == 0 ? 0.0f : lookup[0];
+                for (uint32_t i = 0; i < count; ++i)
+                    out[i] = v;
+                return;
+            }
+        } else {
+            sample_count = EASING_SAMPLES;
+            lookup       = EASING_LOOKUP;
+            lookup      += curve.type * (EASING_SAMPLES + 1);
+        }
+
+        // Same expressions as GetValue(), so that the results are identical
+        const float scale = (float) (sample_count-1);
+        const float inv_scale = 1.0f / (sample_count-1);
+        const int max_index = sample_count-1;
+
+        // Processed in chunks so that the scratch arrays fit on the stack.
+        // The first and last loops are branch free and vectorize, the lookup in between is a gather.
+        const uint32_t chunk_size = 64;
+        int32_t index[chunk_size];
+        float diff[chunk_size];
+        float val1[chunk_size];
+        float val2[chunk_size];
+        for (uint32_t offset = 0; offset < count; offset += chunk_size)
+        {
+            uint32_t n = dmMath::Min(chunk_size, count - offset);
+            const float* chunk_t = t + offset;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                float x = dmMath::Clamp(chunk_t[i], 0.0f, 1.0f);
+                int32_t i1 = (int32_t) (x * scale);
+                index[i] = i1;
+                diff[i] = (x - i1 * inv_scale) * scale;
+            }
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                int32_t i1 = index[i];
+                val1[i] = lookup[i1];
+                val2[i] = lookup[dmMath::Min(i1 + 1, max_index)];
+            }
+            float* chunk_out = out + offset;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                chunk_out[i] = val1[i] * (1.0f - diff[i]) + val2[i] * diff[i];
+            }
+        }
+    }
+}
@@ -103,6 +103,16 @@ namespace dmEasing
      */
     float GetValue(Type type, float t);
     float GetValue(Curve curve, float t);
+
+    /**
+     * Batched easing-curve evaluation. Equivalent to calling GetValue() for
+     * each element, but laid out so that the per element math vectorizes.
+     * @param curve curve
+     * @param t array of times in the range [0,1]
+     * @param out array receiving the curve values. May alias t
+     * @param count number of elements
+     */
+    void GetValues(Curve curve, const float* t, float* out, uint32_t count);
 }
 
 #endif // DM_EASING
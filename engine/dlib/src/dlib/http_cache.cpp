@@ -35,7 +35,7 @@ namespace dmHttpCache
     // Magic file header for index file
     const uint32_t MAGIC = 0xCAAAAAAC;
     // Current index file version
-    const uint32_t VERSION = 7;
+    const uint32_t VERSION = 8;
 
     // Maximum number of cache entry creations in flight
     const uint32_t MAX_CACHE_CREATORS = 16;
@@ -85,6 +85,9 @@ namespace dmHttpCache
         uint64_t m_Expires;
         // Checksum
         uint64_t m_Checksum;
+        // Content encoding, see ContentEncoding
+        uint32_t m_ContentEncoding;
+        uint32_t m_Pad;
     };
 
     /*
@@ -98,6 +101,7 @@ namespace dmHttpCache
         uint64_t    m_IdentifierHash;
         uint64_t    m_UriHash;
         uint16_t    m_Index;
+        uint8_t     m_ContentEncoding;
         uint32_t    m_Error : 1;
     };
 
@@ -262,6 +266,7 @@ namespace dmHttpCache
                             e.m_Info.m_LastAccessed = entries[i].m_LastAccessed;
                             e.m_Info.m_Expires = entries[i].m_Expires;
                             e.m_Info.m_Checksum = entries[i].m_Checksum;
+                            e.m_Info.m_ContentEncoding = (uint8_t) entries[i].m_ContentEncoding;
                             c->m_CacheTable.Put(entries[i].m_UriHash, e);
                         }
                         else
@@ -314,6 +319,7 @@ namespace dmHttpCache
         file_entry.m_LastAccessed = entry->m_Info.m_LastAccessed;
         file_entry.m_Expires = entry->m_Info.m_Expires;
         file_entry.m_Checksum = entry->m_Info.m_Checksum;
+        file_entry.m_ContentEncoding = entry->m_Info.m_ContentEncoding;
 
         dmHashUpdateBuffer64(&context->m_HashState, &file_entry, sizeof(file_entry));
         size_t n_written = fwrite(&file_entry, 1, sizeof(file_entry), context->m_File);
@@ -501,6 +507,7 @@ namespace dmHttpCache
         handle->m_Filename = file_name;
         handle->m_IdentifierHash = identifier_hash;
         handle->m_UriHash = dmHashString64(uri);
+        handle->m_ContentEncoding = CONTENT_ENCODING_IDENTITY;
         handle->m_Error = 0;
         *cache_creator = handle;
 
@@ -558,6 +565,13 @@ namespace dmHttpCache
         return RESULT_OK;
     }
 
+    Result SetContentEncoding(HCache cache, HCacheCreator cache_creator, ContentEncoding encoding)
+    {
+        assert(cache_creator->m_File && cache_creator->m_Filename);
+        cache_creator->m_ContentEncoding = (uint8_t) encoding;
+        return RESULT_OK;
+    }
+
     Result End(HCache cache, HCacheCreator cache_creator)
     {
         dmMutex::ScopedLock lock(cache->m_Mutex);
@@ -620,6 +634,7 @@ namespace dmHttpCache
         assert(entry->m_Info.m_IdentifierHash == identifier_hash);
         entry->m_WriteLock = 0;
         entry->m_Info.m_Checksum = dmHashFinal64(&cache_creator->m_ChecksumState);
+        entry->m_Info.m_ContentEncoding = cache_creator->m_ContentEncoding;
 
         int ret = rename(cache_creator->m_Filename, path);
         if (ret != 0)
@@ -677,7 +692,7 @@ namespace dmHttpCache
         }
     }
 
-    Result Get(HCache cache, const char* uri, const char* etag, FILE** file, uint64_t* checksum)
+    Result Get(HCache cache, const char* uri, const char* etag, FILE** file, uint64_t* checksum, uint8_t* content_encoding)
     {
         dmMutex::ScopedLock lock(cache->m_Mutex);
 
@@ -707,6 +722,7 @@ namespace dmHttpCache
                 *file = f;
                 entry->m_ReadLockCount++;
                 *checksum = entry->m_Info.m_Checksum;
+                *content_encoding = entry->m_Info.m_ContentEncoding;
                 return RESULT_OK;
             }
             else
@@ -721,6 +737,12 @@ namespace dmHttpCache
         return RESULT_NO_ENTRY;
     }
 
+    Result Get(HCache cache, const char* uri, const char* etag, FILE** file, uint64_t* checksum)
+    {
+        uint8_t content_encoding;
+        return Get(cache, uri, etag, file, checksum, &content_encoding);
+    }
+
     Result SetVerified(HCache cache, const char* uri, bool verified)
     {
         dmMutex::ScopedLock lock(cache->m_Mutex);
@@ -49,6 +49,16 @@ namespace dmHttpCache
         CONSISTENCY_POLICY_TRUST_CACHE = 1,//!< Trust the local cache and avoid network round-trips
     };
 
+    /**
+     * Content encoding of the cached data
+     */
+    enum ContentEncoding
+    {
+        CONTENT_ENCODING_IDENTITY = 0, //!< Data is stored as is
+        CONTENT_ENCODING_GZIP     = 1, //!< Data is stored gzip compressed
+        CONTENT_ENCODING_DEFLATE  = 2, //!< Data is stored deflate compressed
+    };
+
     /// Maximum length of tags
     const uint32_t MAX_TAG_LEN = 64;
 
@@ -72,6 +82,8 @@ namespace dmHttpCache
         uint64_t m_Expires;
         /// Checksum
         uint64_t m_Checksum;
+        /// Content encoding of the cached data, see ContentEncoding
+        uint8_t  m_ContentEncoding;
         /// True if the entry is verified, ie the cached version is valid, during the session
         uint8_t  m_Verified : 1;
         /// Valid in terms of Cache-Control expires
@@ -151,6 +163,16 @@ namespace dmHttpCache
      */
     Result Add(HCache cache, HCacheCreator cache_creator, const void* content, uint32_t content_len);
 
+    /**
+     * Set the content encoding of the data added to a cache entry. The default is CONTENT_ENCODING_IDENTITY.
+     * The data is stored as added and should be decoded by the reader, see EntryInfo::m_ContentEncoding
+     * @param cache cache
+     * @param cache_creator cache creator handle
+     * @param encoding content encoding
+     * @return RESULT_OK on success
+     */
+    Result SetContentEncoding(HCache cache, HCacheCreator cache_creator, ContentEncoding encoding);
+
     /**
      * End cache entry creation
      * @param cache cache
@@ -182,6 +204,18 @@ namespace dmHttpCache
      */
     Result Get(HCache cache, const char* uri, const char* etag, FILE** file, uint64_t* checksum);
 
+    /**
+     * Get file and content encoding for cache entry, in a single lookup. See Get.
+     * @param cache cache
+     * @param uri uri
+     * @param etag etag
+     * @param file file representing the cached content
+     * @param checksum content checksum (dmHashString64)
+     * @param content_encoding content encoding of the cached data, see ContentEncoding
+     * @return RESULT_OK on success.
+     */
+    Result Get(HCache cache, const char* uri, const char* etag, FILE** file, uint64_t* checksum, uint8_t* content_encoding);
+
     /**
      * Set cache entry to verifed
      * @param cache cache
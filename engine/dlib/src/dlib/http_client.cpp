@@ -30,6 +30,8 @@
 #include "time.h"
 #include "connection_pool.h"
 #include "mutex.h"
+#include "array.h"
+#include "zlib.h"
 #include "mbedtls/ssl.h"
 #include "mbedtls/net_sockets.h"
 #include "dns.h"
@@ -50,6 +52,9 @@ namespace dmHttpClient
     // See https://tools.ietf.org/html/rfc8446, chapter 5.1
     const uint32_t MAX_HTTPS_POST_CHUNK_SIZE = 16384;
 
+    // Compression level used for request bodies, see OPTION_REQUEST_COMPRESSION
+    const int REQUEST_COMPRESSION_LEVEL = 5;
+
     // TODO: This is not good. Singleton like stuff
     // that requires a lock for initialization
     // See comment in GetPool()
@@ -119,8 +124,19 @@ namespace dmHttpClient
         char     m_ETag[64];
         uint32_t m_Chunked : 1;
         uint32_t m_CloseConnection : 1;
+        uint32_t m_ContentEncoding : 2;
         uint32_t m_MaxAge;
 
+        // Content decoding
+        dmZlib::HInflater m_Inflater;
+        // True if "Accept-Encoding" was sent by the client, ie the content should be decoded
+        uint32_t m_DecodeContent : 1;
+        // True if "Accept-Encoding" was written by the HttpWriteHeaders callback
+        uint32_t m_CustomAcceptEncoding : 1;
+        uint32_t m_DecodeError : 1;
+        // True while the request body is captured for compression
+        uint32_t m_CaptureBody : 1;
+
         // Cache
         dmHttpCache::HCacheCreator m_CacheCreator;
 
@@ -142,7 +158,13 @@ namespace dmHttpClient
             m_TotalReceived = 0;
             m_Chunked = 0;
             m_CloseConnection = 0;
+            m_ContentEncoding = dmHttpCache::CONTENT_ENCODING_IDENTITY;
             m_MaxAge = 0;
+            m_Inflater = 0;
+            m_DecodeContent = 0;
+            m_CustomAcceptEncoding = 0;
+            m_DecodeError = 0;
+            m_CaptureBody = 0;
             m_CacheCreator = 0;
             m_Pool = 0;
             m_Connection = 0;
@@ -178,6 +200,11 @@ namespace dmHttpClient
         HttpWriteHeaders    m_HttpWriteHeaders;
         int                 m_MaxGetRetries;
         int                 m_RequestTimeout;
+        bool                m_AcceptEncoding;
+        bool                m_RequestCompression;
+        // Request body, uncompressed and compressed, when OPTION_REQUEST_COMPRESSION is set
+        dmArray<char>       m_RequestData;
+        dmArray<char>       m_CompressedRequestData;
         uint64_t            m_RequestStart;
         Statistics          m_Statistics;
 
@@ -212,6 +239,9 @@ namespace dmHttpClient
 
     Response::~Response()
     {
+        if (m_Inflater) {
+            dmZlib::DeleteInflater(m_Inflater);
+        }
         if (m_Connection) {
             if (m_CloseConnection || m_Client->m_SocketResult != dmSocket::RESULT_OK) {
                 dmConnectionPool::Close(m_Pool, m_Connection);
@@ -281,6 +311,8 @@ namespace dmHttpClient
         client->m_HttpWriteHeaders = params->m_HttpWriteHeaders;
         client->m_MaxGetRetries = 1;
         client->m_RequestTimeout = 0;
+        client->m_AcceptEncoding = false;
+        client->m_RequestCompression = false;
         client->m_RequestStart = 0;
         memset(&client->m_Statistics, 0, sizeof(client->m_Statistics));
         client->m_HttpCache = params->m_HttpCache;
@@ -307,6 +339,12 @@ namespace dmHttpClient
             case OPTION_REQUEST_TIMEOUT:
                 client->m_RequestTimeout = (int) value;
                 break;
+            case OPTION_ACCEPT_ENCODING:
+                client->m_AcceptEncoding = value != 0;
+                break;
+            case OPTION_REQUEST_COMPRESSION:
+                client->m_RequestCompression = value != 0;
+                break;
             default:
                 return RESULT_INVAL_ERROR;
         }
@@ -482,6 +520,17 @@ namespace dmHttpClient
         {
             resp->m_CloseConnection = 1;
         }
+        else if (dmStrCaseCmp(key, "Content-Encoding") == 0)
+        {
+            if (dmStrCaseCmp(value, "gzip") == 0 || dmStrCaseCmp(value, "x-gzip") == 0)
+            {
+                resp->m_ContentEncoding = dmHttpCache::CONTENT_ENCODING_GZIP;
+            }
+            else if (dmStrCaseCmp(value, "deflate") == 0)
+            {
+                resp->m_ContentEncoding = dmHttpCache::CONTENT_ENCODING_DEFLATE;
+            }
+        }
         else if (dmStrCaseCmp(key, "ETag") == 0)
         {
             dmStrlCpy(resp->m_ETag, value, sizeof(resp->m_ETag));
@@ -500,6 +549,13 @@ namespace dmHttpClient
             }
         }
 
+        // Decoded content has neither the encoding nor the length sent by the server. The length of
+        // content that isn't encoded after all is passed on once all headers are parsed
+        if (resp->m_DecodeContent && dmStrCaseCmp(key, "Content-Length") == 0)
+            return;
+        if (resp->m_DecodeContent && dmStrCaseCmp(key, "Content-Encoding") == 0 && resp->m_ContentEncoding != dmHttpCache::CONTENT_ENCODING_IDENTITY)
+            return;
+
         HClient c = resp->m_Client;
         if (c->m_HttpHeader)
         {
@@ -586,6 +642,13 @@ namespace dmHttpClient
         if (client->m_SocketResult != dmSocket::RESULT_OK) {
             return RESULT_SOCKET_ERROR;
         }
+        if (response->m_CaptureBody) {
+            if (client->m_RequestData.Remaining() < buffer_size) {
+                client->m_RequestData.OffsetCapacity(buffer_size - client->m_RequestData.Remaining());
+            }
+            client->m_RequestData.PushArray((const char*) buffer, buffer_size);
+            return RESULT_OK;
+        }
         dmSocket::Result sock_res = SendAll(response, (const char*) buffer, buffer_size);
         if (sock_res != dmSocket::RESULT_OK)
         {
@@ -604,6 +667,10 @@ namespace dmHttpClient
         }
         dmSocket::Result sock_res;
 
+        if (dmStrCaseCmp(name, "Accept-Encoding") == 0) {
+            response->m_CustomAcceptEncoding = 1;
+        }
+
         // DEF-2889 most webservers have a header length limit of 8096 bytes
         char buf[8096];
         const int bufsize = sizeof(buf);
@@ -628,11 +695,52 @@ if (sock_res != dmSocket::RESULT_OK)\
 }\
 
 
+    static bool RequestDataWriter(void* context, const void* data, uint32_t data_len)
+    {
+        dmArray<char>* buffer = (dmArray<char>*) context;
+        if (buffer->Remaining() < data_len) {
+            buffer->OffsetCapacity(dmMath::Max(data_len - buffer->Remaining(), buffer->Capacity() / 2));
+        }
+        buffer->PushArray((const char*) data, data_len);
+        return true;
+    }
+
+    // Captures the request body from the HttpWrite callback and compresses it into m_CompressedRequestData.
+    // Returns false if the body should be sent as is, e.g. when it doesn't compress.
+    static bool CompressRequestData(HClient client, HResponse response, uint32_t content_length)
+    {
+        client->m_RequestData.SetSize(0);
+        client->m_RequestData.SetCapacity(content_length);
+        client->m_CompressedRequestData.SetSize(0);
+        client->m_CompressedRequestData.SetCapacity(content_length / 2 + 64);
+
+        response->m_CaptureBody = 1;
+        Result r = client->m_HttpWrite(response, 0, content_length, client->m_Userdata);
+        response->m_CaptureBody = 0;
+        if (r != RESULT_OK || client->m_RequestData.Size() != content_length) {
+            return false;
+        }
+
+        dmZlib::Result zr = dmZlib::DeflateBuffer(client->m_RequestData.Begin(), content_length, REQUEST_COMPRESSION_LEVEL, &client->m_CompressedRequestData, RequestDataWriter);
+        return zr == dmZlib::RESULT_OK && client->m_CompressedRequestData.Size() < content_length;
+    }
+
+    // Writes a part of the request body, either from the compressed request data or through the HttpWrite callback
+    static Result WriteRequestData(HClient client, HResponse response, bool compressed, uint32_t offset, uint32_t length)
+    {
+        if (compressed) {
+            return Write(response, client->m_CompressedRequestData.Begin() + offset, length);
+        }
+        return client->m_HttpWrite(response, offset, length, client->m_Userdata);
+    }
+
     static dmSocket::Result SendRequest(HClient client, HResponse response, const char* encoded_path, const char* method)
     {
         dmSocket::Result sock_res;
         uint32_t send_content_length = 0;
         int chunked = 0;
+        bool compressed = false;
+        bool has_body = strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0 || strcmp(method, "PATCH") == 0;
 
         HTTP_CLIENT_SENDALL_AND_BAIL(method);
         HTTP_CLIENT_SENDALL_AND_BAIL(" ")
@@ -647,6 +755,12 @@ if (sock_res != dmSocket::RESULT_OK)\
                 goto bail;
             }
         }
+        if (client->m_AcceptEncoding && !response->m_CustomAcceptEncoding && strcmp(method, "HEAD") != 0)
+        {
+            // If the user asked for a specific encoding the content is passed on as is
+            response->m_DecodeContent = 1;
+            HTTP_CLIENT_SENDALL_AND_BAIL("Accept-Encoding: gzip, deflate\r\n");
+        }
         if (client->m_HttpCache)
         {
             char etag[64];
@@ -659,9 +773,16 @@ if (sock_res != dmSocket::RESULT_OK)\
             }
         }
 
-        if (strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0 || strcmp(method, "PATCH") == 0) {
+        if (has_body) {
             send_content_length = client->m_HttpSendContentLength(response, client->m_Userdata);
 
+            if (client->m_RequestCompression && send_content_length > 0 && CompressRequestData(client, response, send_content_length))
+            {
+                compressed = true;
+                send_content_length = client->m_CompressedRequestData.Size();
+                HTTP_CLIENT_SENDALL_AND_BAIL("Content-Encoding: deflate\r\n");
+            }
+
             if (client->m_Secure && send_content_length > MAX_HTTPS_POST_CHUNK_SIZE)
             {
                 chunked = 1;
@@ -679,11 +800,11 @@ if (sock_res != dmSocket::RESULT_OK)\
 
         HTTP_CLIENT_SENDALL_AND_BAIL("\r\n")
 
-        if (strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0 || strcmp(method, "PATCH") == 0)
+        if (has_body)
         {
             if (!chunked)
             {
-                Result post_result = client->m_HttpWrite(response, 0, send_content_length, client->m_Userdata);
+                Result post_result = WriteRequestData(client, response, compressed, 0, send_content_length);
                 if (post_result != RESULT_OK) {
                     goto bail;
                 }
@@ -702,7 +823,7 @@ if (sock_res != dmSocket::RESULT_OK)\
                     HTTP_CLIENT_SENDALL_AND_BAIL(buf);
 
                     // Write the chunk payload
-                    Result post_result = client->m_HttpWrite(response, offset, length, client->m_Userdata);
+                    Result post_result = WriteRequestData(client, response, compressed, offset, length);
                     if (post_result != RESULT_OK) {
                         goto bail;
                     }
@@ -717,8 +838,13 @@ if (sock_res != dmSocket::RESULT_OK)\
             }
         }
 
-        return client->m_SocketResult;
 bail:
+        if (client->m_RequestCompression)
+        {
+            // Don't hold on to the memory of large request bodies between requests
+            client->m_RequestData.SetCapacity(0);
+            client->m_CompressedRequestData.SetCapacity(0);
+        }
         return client->m_SocketResult;
     }
 
@@ -818,6 +944,55 @@ bail:
         (void) content_data_size;
     }
 
+    static bool InflateWriter(void* context, const void* data, uint32_t data_len)
+    {
+        Response* response = (Response*) context;
+        HClient client = response->m_Client;
+        client->m_HttpContent(response, client->m_Userdata, response->m_Status, data, data_len);
+        return true;
+    }
+
+    // HttpContent callback used for compressed responses. Passes the inflated content on to the user callback
+    static void HttpContentInflate(HResponse response, void* user_data, int status_code, const void* content_data, uint32_t content_data_size)
+    {
+        (void) user_data;
+        (void) status_code;
+        if (content_data_size == 0 || response->m_DecodeError)
+            return;
+
+        dmZlib::Result r = dmZlib::Inflate(response->m_Inflater, content_data, content_data_size, response, InflateWriter);
+        if (r != dmZlib::RESULT_OK && r != dmZlib::RESULT_STREAM_END)
+        {
+            dmLogError("Failed to decode compressed content for '%s' (%d)", response->m_Client->m_URI, r);
+            response->m_DecodeError = 1;
+        }
+    }
+
+    static Result SendCachedContent(HClient client, Response* response, FILE* file, uint8_t content_encoding)
+    {
+        if (content_encoding != dmHttpCache::CONTENT_ENCODING_IDENTITY)
+        {
+            response->m_Inflater = dmZlib::NewInflater();
+            if (!response->m_Inflater)
+                return RESULT_IO_ERROR;
+        }
+
+        // NOTE: We have an extra byte for null-termination so no buffer overrun here.
+        size_t nread;
+        do
+        {
+            nread = fread(client->m_Buffer, 1, BUFFER_SIZE, file);
+            client->m_Buffer[nread] = '\0';
+            if (response->m_Inflater)
+                HttpContentInflate(response, client->m_Userdata, response->m_Status, client->m_Buffer, nread);
+            else
+                client->m_HttpContent(response, client->m_Userdata, response->m_Status, client->m_Buffer, nread);
+        }
+        while (nread > 0);
+
+        return response->m_DecodeError ? RESULT_IO_ERROR : RESULT_OK;
+    }
+
     static Result HandleCached(HClient client, const char* path, Response* response)
     {
         client->m_Statistics.m_CachedResponses++;
@@ -855,21 +1030,19 @@ bail:
             }
         }
 
+        // The content encoding is looked up together with the file, so that they belong to the same entry
         FILE* file = 0;
         uint64_t checksum;
-        cache_result = dmHttpCache::Get(client->m_HttpCache, client->m_URI, cache_etag, &file, &checksum);
+        uint8_t content_encoding;
+        cache_result = dmHttpCache::Get(client->m_HttpCache, client->m_URI, cache_etag, &file, &checksum, &content_encoding);
         if (cache_result == dmHttpCache::RESULT_OK)
         {
-            // NOTE: We have an extra byte for null-termination so no buffer overrun here.
-            size_t nread;
-            do
+            Result r = SendCachedContent(client, response, file, content_encoding);
+            dmHttpCache::Release(client->m_HttpCache, client->m_URI, cache_etag, file);
+            if (r != RESULT_OK)
             {
-                nread = fread(client->m_Buffer, 1, BUFFER_SIZE, file);
-                client->m_Buffer[nread] = '\0';
-                client->m_HttpContent(response, client->m_Userdata, response->m_Status, client->m_Buffer, nread);
+                return r;
             }
-            while (nread > 0);
-            dmHttpCache::Release(client->m_HttpCache, client->m_URI, cache_etag, file);
         }
         else
         {
@@ -887,11 +1060,14 @@ bail:
 
         client->m_HttpContent(response, client->m_Userdata, response->m_Status, 0, 0);
 
+        // Compressed responses are added to the cache as is and inflated before they are passed on
+        HttpContent http_content = response->m_Inflater ? &HttpContentInflate : client->m_HttpContent;
+
         if (strcmp(method, "HEAD") == 0) {
             // A response from a HEAD request should not attempt to read any body despite
             // content length being non-zero, but we still call DoTransfer (with a
             // content length of 0) to ensure that the response is setup properly
-            r = DoTransfer(client, response, 0, client->m_HttpContent, true);
+            r = DoTransfer(client, response, 0, http_content, true);
         }
         else if (response->m_Chunked)
         {
@@ -919,7 +1095,7 @@ bail:
 
                     // Move content-offset after chunk termination, ie after "\r\n"
                     response->m_ContentOffset = chunk_size_end - client->m_Buffer;
-                    r = DoTransfer(client, response, chunk_size, client->m_HttpContent, true);
+                    r = DoTransfer(client, response, chunk_size, http_content, true);
                     if (r != RESULT_OK)
                         break;
 
@@ -974,7 +1150,12 @@ bail:
         {
             // "Regular" transfer, single chunk
             assert(response->m_ContentOffset != -1);
-            r = DoTransfer(client, response, response->m_ContentLength, client->m_HttpContent, true);
+            r = DoTransfer(client, response, response->m_ContentLength, http_content, true);
+        }
+
+        if (r == RESULT_OK && response->m_DecodeError)
+        {
+            r = RESULT_INVALID_RESPONSE;
         }
 
         return r;
@@ -998,6 +1179,14 @@ bail:
             return r;
         }
 
+        if (response.m_DecodeContent && response.m_ContentEncoding == dmHttpCache::CONTENT_ENCODING_IDENTITY && response.m_ContentLength != -1 && client->m_HttpHeader)
+        {
+            // Held back by HandleHeader until the encoding was known
+            char content_length[16];
+            dmSnPrintf(content_length, sizeof(content_length), "%d", response.m_ContentLength);
+            client->m_HttpHeader(&response, client->m_Userdata, response.m_Status, "Content-Length", content_length);
+        }
+
         if (response.m_Status == 204 /* No Content*/)
         {
             assert(response.m_ContentLength == -1);
@@ -1035,6 +1224,15 @@ bail:
         else
         {
             // Non-cached response
+            if (response.m_DecodeContent && response.m_ContentEncoding != dmHttpCache::CONTENT_ENCODING_IDENTITY)
+            {
+                response.m_Inflater = dmZlib::NewInflater();
+                if (!response.m_Inflater)
+                {
+                    return RESULT_UNKNOWN;
+                }
+            }
+
             if (client->m_HttpCache && response.m_Status == 200 /* OK */)
             {
                 if (response.m_ETag[0] != '\0') {
@@ -1042,6 +1240,11 @@ bail:
                 } else if (response.m_MaxAge > 0) {
                     dmHttpCache::Begin(client->m_HttpCache, client->m_URI, response.m_MaxAge, &response.m_CacheCreator);
                 }
+
+                if (response.m_CacheCreator && response.m_Inflater)
+                {
+                    dmHttpCache::SetContentEncoding(client->m_HttpCache, response.m_CacheCreator, (dmHttpCache::ContentEncoding) response.m_ContentEncoding);
+                }
             }
 
             r = HandleResponse(client, path, method, &response);
@@ -1134,21 +1337,16 @@ bail:
 
         FILE* file = 0;
         uint64_t checksum;
+        uint8_t content_encoding;
 
-        dmHttpCache::Result cache_result = dmHttpCache::Get(client->m_HttpCache, client->m_URI, info->m_ETag, &file, &checksum);
+        // The entry may have been replaced since the info was read, use the content encoding of the file we get
+        dmHttpCache::Result cache_result = dmHttpCache::Get(client->m_HttpCache, client->m_URI, info->m_ETag, &file, &checksum, &content_encoding);
         if (cache_result == dmHttpCache::RESULT_OK)
         {
-            // NOTE: We have an extra byte for null-termination so no buffer overrun here.
-            size_t nread;
-            do
-            {
-                nread = fread(client->m_Buffer, 1, BUFFER_SIZE, file);
-                client->m_Buffer[nread] = '\0';
-                client->m_HttpContent(&response, client->m_Userdata, 304, client->m_Buffer, nread);
-            }
-            while (nread > 0);
+            response.m_Status = 304;
+            Result r = SendCachedContent(client, &response, file, content_encoding);
             dmHttpCache::Release(client->m_HttpCache, client->m_URI, info->m_ETag, file);
-            return RESULT_NOT_200_OK;
+            return r == RESULT_OK ? RESULT_NOT_200_OK : r;
         }
         else
         {
@@ -103,6 +103,12 @@ namespace dmHttpClient
         OPTION_MAX_GET_RETRIES,
         /// Request timeout in us
         OPTION_REQUEST_TIMEOUT,
+        /// Send "Accept-Encoding: gzip, deflate" and decode compressed responses before they are
+        /// passed to the HttpContent callback. Compressed responses are stored compressed in the http-cache.
+        /// "Content-Encoding" and "Content-Length" of decoded responses are not passed to the HttpHeader callback. Default is 0.
+        OPTION_ACCEPT_ENCODING,
+        /// Deflate the request body of POST, PUT and PATCH requests and send it with "Content-Encoding: deflate". Default is 0.
+        OPTION_REQUEST_COMPRESSION,
     };
 
     /**
@@ -16,12 +16,14 @@
 #include <assert.h>
 #include "dlib.h"
 #include "array.h"
+#include "atomic.h"
 #include "dstrings.h"
 #include "log.h"
 #include "socket.h"
 #include "message.h"
 #include "thread.h"
 #include "math.h"
+#include "mutex.h"
 #include "time.h"
 #include "path.h"
 #include "sys.h"
@@ -65,9 +67,52 @@ struct dmLogServer
     dmThread::Thread         m_Thread;
 };
 
+/*
+ * Asynchronous logging
+ *
+ * The log calls format the message on the calling thread and copy it into a ring buffer
+ * shared by all threads. A writer thread outputs the messages, writes them to the log file
+ * (flushed once per batch) and forwards them to the log server.
+ *
+ * Producers reserve space by advancing the write cursor with a compare-and-swap and publish
+ * the record by storing its size in the record header last. The writer thread outputs the
+ * records in reservation order, stops at the first record not yet published and clears each
+ * record before advancing the read cursor, so a zero size always means "not published".
+ * If a record does not fit before the end of the buffer a padding record fills the remainder.
+ * Messages that do not fit in the buffer are dropped and counted, the writer thread reports
+ * the number of dropped messages.
+ */
+struct dmLogRecordHeader
+{
+    int32_atomic_t m_Size;          // Size of the record including the header, stored last to publish the record
+    uint16_t       m_Severity;
+    uint16_t       m_Length;        // Length of the message string, excluding the null terminator
+};
+
+static const uint16_t DM_LOG_RECORD_PADDING = 0xffff;
+static const uint32_t DM_LOG_RECORD_ALIGNMENT = 8;
+static const uint32_t DM_LOG_ASYNC_MIN_BUFFER_SIZE = 16 * 1024;
+static const uint32_t DM_LOG_ASYNC_SLEEP_US = 4000;
+
+struct dmLogAsync
+{
+    char*            m_Buffer;
+    uint32_t         m_BufferSize;      // Power of two
+    int32_atomic_t   m_WriteCursor;     // Advanced by the producers when a record is reserved
+    int32_atomic_t   m_ReadCursor;      // Advanced by the writer thread when a record is consumed
+    int32_atomic_t   m_Dropped;         // Dropped messages not yet reported by the writer thread
+    int32_atomic_t   m_Running;
+    dmMutex::HMutex  m_FileMutex;       // Guards the log file between the writer thread and dmSetLogFile
+    dmThread::TlsKey m_WriterKey;       // Set on the writer thread
+    dmThread::Thread m_Thread;
+};
+
 static dmLogServer* g_dmLogServer = 0;
+static dmLogAsync* volatile g_LogAsync = 0;
+static int32_atomic_t g_LogAsyncProducers = 0;
+static int32_atomic_t g_LogDroppedCount = 0;
 static dmLogSeverity g_LogLevel = DM_LOG_SEVERITY_USER_DEBUG;
-static int g_TotalBytesLogged = 0;
+static int32_atomic_t g_TotalBytesLogged = 0;
 static FILE* g_LogFile = 0;
 static dmCustomLogCallback g_CustomLogCallback = 0;
 static void* g_CustomLogCallbackUserData = 0;
@@ -282,11 +327,9 @@ static void dmLogThread(void* args)
     }
 }
 
-void dmLogInitialize(const dmLogParams* params)
+static void dmLogInitServer()
 {
-    g_TotalBytesLogged = 0;
-
-    if (!dLib::IsDebugMode() || !dLib::FeaturesSupported(DM_FEATURE_BIT_SOCKET_SERVER_TCP))
+    if (!dLib::FeaturesSupported(DM_FEATURE_BIT_SOCKET_SERVER_TCP))
         return;
 
     if (g_dmLogServer)
@@ -330,8 +373,209 @@ void dmLogInitialize(const dmLogParams* params)
     dmLogInfo("Log server started on port %u", (unsigned int) port);
 }
 
+static void dmLogOutput(dmLogSeverity severity, dmLogMessage* msg, int actual_n, bool flush_file);
+
+static uint32_t dmLogAsyncDrain(dmLogAsync* async)
+{
+    uint32_t mask = async->m_BufferSize - 1;
+    uint32_t read = (uint32_t) dmAtomicAdd32(&async->m_ReadCursor, 0);
+    uint32_t count = 0;
+
+    dmMutex::Lock(async->m_FileMutex);
+    while (true)
+    {
+        dmLogRecordHeader* header = (dmLogRecordHeader*) &async->m_Buffer[read & mask];
+        int32_t size = dmAtomicAdd32(&header->m_Size, 0);
+        if (size == 0)
+            break;
+
+        if (header->m_Severity != DM_LOG_RECORD_PADDING)
+        {
+            dmLogOutput((dmLogSeverity) header->m_Severity, (dmLogMessage*) (header + 1), header->m_Length, false);
+        }
+        ++count;
+
+        // Clear the record so that the space reads as unpublished when it is reserved again
+        memset(header, 0, size);
+        read += size;
+        dmAtomicAdd32(&async->m_ReadCursor, size);
+    }
+
+    int32_t dropped = dmAtomicStore32(&async->m_Dropped, 0);
+    if (dropped > 0)
+    {
+        char tmp_buf[sizeof(dmLogMessage) + 128];
+        dmLogMessage* msg = (dmLogMessage*) &tmp_buf[0];
+        int n = dmSnPrintf(msg->m_Message, sizeof(tmp_buf) - sizeof(dmLogMessage), "WARNING:DLIB: %d log messages dropped, the log buffer is full\n", dropped);
+        dmLogOutput(DM_LOG_SEVERITY_WARNING, msg, n, false);
+        ++count;
+    }
+
+    if (count > 0 && g_LogFile)
+    {
+        fflush(g_LogFile);
+    }
+    dmMutex::Unlock(async->m_FileMutex);
+    return count;
+}
+
+static void dmLogAsyncThread(void* args)
+{
+    dmLogAsync* async = (dmLogAsync*) args;
+    dmThread::SetTlsValue(async->m_WriterKey, async);
+    while (true)
+    {
+        // Read the running flag before draining so that the records published before shutdown are written
+        bool running = dmAtomicAdd32(&async->m_Running, 0) != 0;
+        if (dmLogAsyncDrain(async) == 0)
+        {
+            if (!running)
+                break;
+            dmTime::Sleep(DM_LOG_ASYNC_SLEEP_US);
+        }
+    }
+}
+
+// Returns the write cursor after the record, or the current read cursor if the message was dropped.
+// If block is set the call waits for the writer thread to free up space instead of dropping the message
+static uint32_t dmLogAsyncPush(dmLogAsync* async, dmLogSeverity severity, const dmLogMessage* msg, int actual_n, bool block)
+{
+    uint32_t data_size = sizeof(dmLogMessage) + actual_n + 1;
+    uint32_t record_size = (sizeof(dmLogRecordHeader) + data_size + DM_LOG_RECORD_ALIGNMENT - 1) & ~(DM_LOG_RECORD_ALIGNMENT - 1);
+    uint32_t buffer_size = async->m_BufferSize;
+    uint32_t mask = buffer_size - 1;
+
+    uint32_t write;
+    uint32_t padding;
+    while (true)
+    {
+        write = (uint32_t) dmAtomicAdd32(&async->m_WriteCursor, 0);
+        uint32_t read = (uint32_t) dmAtomicAdd32(&async->m_ReadCursor, 0);
+        uint32_t offset = write & mask;
+        padding = offset + record_size > buffer_size ? buffer_size - offset : 0;
+        if (write + padding + record_size - read > buffer_size)
+        {
+            if (block)
+            {
+                dmTime::Sleep(100);
+                continue;
+            }
+            dmAtomicIncrement32(&async->m_Dropped);
+            dmAtomicIncrement32(&g_LogDroppedCount);
+            return read;
+        }
+
+        uint32_t end = write + padding + record_size;
+        if ((uint32_t) dmAtomicCompareStore32(&async->m_WriteCursor, (int32_t) end, (int32_t) write) == write)
+            break;
+    }
+
+    if (padding > 0)
+    {
+        dmLogRecordHeader* header = (dmLogRecordHeader*) &async->m_Buffer[write & mask];
+        header->m_Severity = DM_LOG_RECORD_PADDING;
+        header->m_Length = 0;
+        dmAtomicCompareStore32(&header->m_Size, (int32_t) padding, 0);
+        write += padding;
+    }
+
+    dmLogRecordHeader* header = (dmLogRecordHeader*) &async->m_Buffer[write & mask];
+    header->m_Severity = (uint16_t) severity;
+    header->m_Length = (uint16_t) actual_n;
+    memcpy(header + 1, msg, data_size);
+    // The compare-and-swap is a full barrier, the record is complete when the writer thread sees the size
+    dmAtomicCompareStore32(&header->m_Size, (int32_t) record_size, 0);
+    return write + record_size;
+}
+
+static void dmLogInitAsync(uint32_t buffer_size)
+{
+#if defined(__EMSCRIPTEN__)
+    // No threads, always log synchronously
+    buffer_size = 0;
+#endif
+    if (buffer_size == 0 || g_LogAsync)
+        return;
+
+    uint32_t size = DM_LOG_ASYNC_MIN_BUFFER_SIZE;
+    while (size < buffer_size && size < 0x40000000)
+    {
+        size *= 2;
+    }
+
+    dmLogAsync* async = new dmLogAsync;
+    async->m_Buffer = (char*) malloc(size);
+    memset(async->m_Buffer, 0, size);
+    async->m_BufferSize = size;
+    async->m_WriteCursor = 0;
+    async->m_ReadCursor = 0;
+    async->m_Dropped = 0;
+    async->m_Running = 1;
+    async->m_FileMutex = dmMutex::New();
+    async->m_WriterKey = dmThread::AllocTls();
+    async->m_Thread = dmThread::New(dmLogAsyncThread, 0x80000, async, "log_writer");
+    dmAtomicStore32(&g_LogDroppedCount, 0);
+    dmAtomicAdd32(&g_LogAsyncProducers, 0); // Full barrier, the buffer is initialized before it is published
+    g_LogAsync = async;
+}
+
+static void dmLogFinalizeAsync()
+{
+    dmLogAsync* async = g_LogAsync;
+    if (!async)
+        return;
+
+    // New log calls write synchronously from here, wait for the ones already writing to the buffer
+    g_LogAsync = 0;
+    while (dmAtomicAdd32(&g_LogAsyncProducers, 0) != 0)
+    {
+        dmTime::Sleep(100);
+    }
+
+    dmAtomicStore32(&async->m_Running, 0);
+    dmThread::Join(async->m_Thread);
+    dmMutex::Delete(async->m_FileMutex);
+    dmThread::FreeTls(async->m_WriterKey);
+    free(async->m_Buffer);
+    delete async;
+}
+
+void dmLogInitialize(const dmLogParams* params)
+{
+    g_TotalBytesLogged = 0;
+
+    if (!dLib::IsDebugMode())
+        return;
+
+    dmLogInitServer();
+
+    uint32_t async_buffer_size = params->m_AsyncBufferSize;
+
+    // If the env variable DM_LOG_ASYNC_BUFFER_SIZE is set we will log
+    // asynchronously with a buffer of that size (in bytes).
+    const char* env_async_buffer_size = getenv("DM_LOG_ASYNC_BUFFER_SIZE");
+    if (env_async_buffer_size != 0x0)
+    {
+        long t_size = strtol(env_async_buffer_size, 0, 10);
+        if (t_size > 0)
+        {
+            async_buffer_size = (uint32_t) t_size;
+        }
+    }
+
+    dmLogInitAsync(async_buffer_size);
+}
+
+void dmLogEnableAsync(uint32_t buffer_size)
+{
+    dmLogInitAsync(buffer_size);
+}
+
 void dmLogFinalize()
 {
+    // The writer thread forwards messages to the log server, shut it down first
+    dmLogFinalizeAsync();
+
     if (!g_dmLogServer)
         return;
     dmLogServer* self = g_dmLogServer;
@@ -371,6 +615,11 @@ void dmLogFinalize()
     }
 }
 
+uint32_t dmLogGetDroppedCount()
+{
+    return (uint32_t) dmAtomicAdd32(&g_LogDroppedCount, 0);
+}
+
 uint16_t dmLogGetPort()
 {
     if (!g_dmLogServer)
@@ -474,7 +723,7 @@ void dmLogInternal(dmLogSeverity severity, const char* domain, const char* forma
     str_buf[DM_LOG_MAX_STRING_SIZE-1] = '\0';
     int actual_n = dmMath::Min(n, (int)(DM_LOG_MAX_STRING_SIZE-1));
 
-    g_TotalBytesLogged += actual_n;
+    dmAtomicAdd32(&g_TotalBytesLogged, actual_n);
 
     va_end(lst);
 
@@ -484,6 +733,33 @@ void dmLogInternal(dmLogSeverity severity, const char* domain, const char* forma
         return;
     }
 
+    // The increment is a full barrier, dmLogFinalizeAsync either sees this producer or we see the cleared buffer
+    dmAtomicIncrement32(&g_LogAsyncProducers);
+    dmLogAsync* async = g_LogAsync;
+    if (async)
+    {
+        // Make sure fatal messages are written before returning, unless called from the writer thread itself
+        bool block = severity == DM_LOG_SEVERITY_FATAL && dmThread::GetTlsValue(async->m_WriterKey) == 0x0;
+        uint32_t end = dmLogAsyncPush(async, severity, msg, actual_n, block);
+        if (block)
+        {
+            while ((int32_t) (end - (uint32_t) dmAtomicAdd32(&async->m_ReadCursor, 0)) > 0)
+            {
+                dmTime::Sleep(100);
+            }
+        }
+        dmAtomicDecrement32(&g_LogAsyncProducers);
+        return;
+    }
+    dmAtomicDecrement32(&g_LogAsyncProducers);
+
+    dmLogOutput(severity, msg, actual_n, true);
+}
+
+static void dmLogOutput(dmLogSeverity severity, dmLogMessage* msg, int actual_n, bool flush_file)
+{
+    const char* str_buf = msg->m_Message;
+
 #ifdef ANDROID
     __android_log_print(ToAndroidPriority(severity), "defold", str_buf);
 
@@ -506,9 +782,11 @@ void dmLogInternal(dmLogSeverity severity, const char* domain, const char* forma
     if(!dLib::FeaturesSupported(DM_FEATURE_BIT_SOCKET_SERVER_TCP))
         return;
 
-    if (g_LogFile && g_TotalBytesLogged < DM_LOG_MAX_LOG_FILE_SIZE) {
+    if (g_LogFile && dmAtomicAdd32(&g_TotalBytesLogged, 0) < DM_LOG_MAX_LOG_FILE_SIZE) {
         fwrite(str_buf, 1, actual_n, g_LogFile);
-        fflush(g_LogFile);
+        if (flush_file) {
+            fflush(g_LogFile);
+        }
     }
 
     dmLogServer* self = g_dmLogServer;
@@ -519,17 +797,24 @@ void dmLogInternal(dmLogSeverity severity, const char* domain, const char* forma
         receiver.m_Socket = self->m_MessgeSocket;
         receiver.m_Path = 0;
         receiver.m_Fragment = 0;
-        dmMessage::Post(0, &receiver, 0, 0, 0, msg, dmMath::Min(sizeof(dmLogMessage) + actual_n + 1, sizeof(tmp_buf)), 0);
+        dmMessage::Post(0, &receiver, 0, 0, 0, msg, dmMath::Min(sizeof(dmLogMessage) + actual_n + 1, sizeof(dmLogMessage) + DM_LOG_MAX_STRING_SIZE), 0);
     }
 }
 
 void dmSetLogFile(const char* path)
 {
+    dmLogAsync* async = g_LogAsync;
+    if (async) {
+        dmMutex::Lock(async->m_FileMutex);
+    }
     if (g_LogFile) {
         fclose(g_LogFile);
         g_LogFile = 0;
     }
     g_LogFile = fopen(path, "wb");
+    if (async) {
+        dmMutex::Unlock(async->m_FileMutex);
+    }
     if (g_LogFile) {
         dmLogInfo("Writing log to: %s", path);
     } else {
@@ -49,7 +49,15 @@ struct dmLogParams
 {
     dmLogParams()
     {
+        m_AsyncBufferSize = 0;
     }
+
+    /// Size in bytes of the buffer used for asynchronous logging. When non-zero the log calls only
+    /// format the message and a background thread writes the output, the log file and forwards
+    /// the messages to the log server. Messages are dropped when the buffer is full.
+    /// 0 (default) logs synchronously on the calling thread.
+    /// Can be overridden with the env variable DM_LOG_ASYNC_BUFFER_SIZE
+    uint32_t m_AsyncBufferSize;
 };
 
 /**
@@ -72,6 +80,20 @@ void dmLogFinalize();
 uint16_t dmLogGetPort();
 
 
+/**
+ * Start logging asynchronously after dmLogInitialize, eg once the buffer size is read from the
+ * project settings. Does nothing if logging is already asynchronous, see dmLogParams::m_AsyncBufferSize
+ * @param buffer_size size of the log buffer in bytes. 0 keeps logging synchronous
+ */
+void dmLogEnableAsync(uint32_t buffer_size);
+
+/**
+ * Get the number of log messages dropped since dmLogInitialize because the
+ * asynchronous log buffer was full
+ * @return number of dropped messages
+ */
+uint32_t dmLogGetDroppedCount();
+
 /**
  * Set log level
  * @param severity Log severity
@@ -95,6 +117,7 @@ typedef void (*dmCustomLogCallback)(void* user_data, const char* s);
  * Sets a custom callback for log output, if this function is set output
  * will only be sent to this callback.
  * Useful for testing purposes to validate logging output from a test
+ * The callback is always called on the logging thread, also when logging asynchronously
  * Calling dmSetCustomLogCallback with (0x0, 0x0) will restore normal operation
  * @param callback the callback to call with output, once per logging call
  * @param user_data user data pointer that is provided as context in the callback
@@ -0,0 +1,170 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "thread_pool.h"
+#include "array.h"
+#include "atomic.h"
+#include "condition_variable.h"
+#include "mutex.h"
+#include "thread.h"
+
+namespace dmThreadPool
+{
+    static const uint32_t THREAD_STACK_SIZE = 0x20000;
+
+    struct Batch
+    {
+        JobFunction     m_Function;
+        void*           m_Context;
+        uint32_t        m_Count;
+        int32_atomic_t  m_Next;
+        // Number of workers currently referencing the batch. Protected by the pool mutex.
+        uint32_t        m_Users;
+    };
+
+    struct ThreadPool
+    {
+        dmArray<dmThread::Thread>               m_Threads;
+        dmArray<Batch*>                         m_Batches;
+        dmMutex::HMutex                         m_Mutex;
+        dmConditionVariable::HConditionVariable m_WorkCondition;
+        dmConditionVariable::HConditionVariable m_DoneCondition;
+        bool                                    m_Active;
+    };
+
+    static void ProcessBatch(Batch* batch)
+    {
+        while (true)
+        {
+            uint32_t index = (uint32_t) dmAtomicIncrement32(&batch->m_Next);
+            if (index >= batch->m_Count)
+                break;
+            batch->m_Function(batch->m_Context, index);
+        }
+    }
+
+    // Must be called with the pool mutex held
+    static void RemoveBatch(ThreadPool* pool, Batch* batch)
+    {
+        for (uint32_t i = 0; i < pool->m_Batches.Size(); ++i)
+        {
+            if (pool->m_Batches[i] == batch)
+            {
+                pool->m_Batches.EraseSwap(i);
+                return;
+            }
+        }
+    }
+
+    static void WorkerThread(void* arg)
+    {
+        ThreadPool* pool = (ThreadPool*) arg;
+        dmMutex::Lock(pool->m_Mutex);
+        while (pool->m_Active)
+        {
+            if (pool->m_Batches.Empty())
+            {
+                dmConditionVariable::Wait(pool->m_WorkCondition, pool->m_Mutex);
+                continue;
+            }
+
+            Batch* batch = pool->m_Batches[0];
+            batch->m_Users++;
+            dmMutex::Unlock(pool->m_Mutex);
+
+            ProcessBatch(batch);
+
+            dmMutex::Lock(pool->m_Mutex);
+            // All jobs are taken, no need for other workers to look at it
+            RemoveBatch(pool, batch);
+            batch->m_Users--;
+            dmConditionVariable::Broadcast(pool->m_DoneCondition);
+        }
+        dmMutex::Unlock(pool->m_Mutex);
+    }
+
+    HThreadPool New(uint32_t thread_count, const char* name)
+    {
+#if defined(__EMSCRIPTEN__)
+        thread_count = 0;
+#endif
+        ThreadPool* pool = new ThreadPool;
+        pool->m_Mutex = dmMutex::New();
+        pool->m_WorkCondition = dmConditionVariable::New();
+        pool->m_DoneCondition = dmConditionVariable::New();
+        pool->m_Active = true;
+        pool->m_Batches.SetCapacity(4);
+        pool->m_Threads.SetCapacity(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            pool->m_Threads.Push(dmThread::New(WorkerThread, THREAD_STACK_SIZE, pool, name));
+        }
+        return pool;
+    }
+
+    void Delete(HThreadPool pool)
+    {
+        {
+            DM_MUTEX_SCOPED_LOCK(pool->m_Mutex);
+            pool->m_Active = false;
+            dmConditionVariable::Broadcast(pool->m_WorkCondition);
+        }
+        for (uint32_t i = 0; i < pool->m_Threads.Size(); ++i)
+        {
+            dmThread::Join(pool->m_Threads[i]);
+        }
+        dmConditionVariable::Delete(pool->m_DoneCondition);
+        dmConditionVariable::Delete(pool->m_WorkCondition);
+        dmMutex::Delete(pool->m_Mutex);
+        delete pool;
+    }
+
+    uint32_t GetThreadCount(HThreadPool pool)
+    {
+        return pool->m_Threads.Size();
+    }
+
+    void Run(HThreadPool pool, JobFunction function, void* context, uint32_t count)
+    {
+        Batch batch;
+        batch.m_Function = function;
+        batch.m_Context = context;
+        batch.m_Count = count;
+        batch.m_Next = 0;
+        batch.m_Users = 0;
+
+        if (pool == 0 || pool->m_Threads.Empty() || count <= 1)
+        {
+            ProcessBatch(&batch);
+            return;
+        }
+
+        {
+            DM_MUTEX_SCOPED_LOCK(pool->m_Mutex);
+            if (pool->m_Batches.Full())
+                pool->m_Batches.OffsetCapacity(4);
+            pool->m_Batches.Push(&batch);
+            dmConditionVariable::Broadcast(pool->m_WorkCondition);
+        }
+
+        ProcessBatch(&batch);
+
+        DM_MUTEX_SCOPED_LOCK(pool->m_Mutex);
+        RemoveBatch(pool, &batch);
+        // All jobs have been taken at this point. The batch lives on this stack frame,
+        // so wait until the workers still running jobs from it are finished.
+        while (batch.m_Users > 0)
+        {
+            dmConditionVariable::Wait(pool->m_DoneCondition, pool->m_Mutex);
+        }
+    }
+}
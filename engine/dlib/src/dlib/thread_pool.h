@@ -0,0 +1,71 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_THREAD_POOL_H
+#define DM_THREAD_POOL_H
+
+#include <stdint.h>
+
+/**
+ * Small pool of worker threads for fork/join style work, e.g. decoding
+ * independent chunks of a resource in parallel.
+ */
+namespace dmThreadPool
+{
+    /**
+     * Thread pool handle
+     */
+    typedef struct ThreadPool* HThreadPool;
+
+    /**
+     * Job function. Called once for each index in [0, count)
+     * @param context User context passed to Run()
+     * @param index Job index
+     */
+    typedef void (*JobFunction)(void* context, uint32_t index);
+
+    /**
+     * Create a new thread pool
+     * @note On platforms without thread support no worker threads are created
+     *       and all jobs are executed on the calling thread
+     * @param thread_count Number of worker threads. Zero is valid.
+     * @param name Worker thread name
+     * @return Thread pool handle
+     */
+    HThreadPool New(uint32_t thread_count, const char* name);
+
+    /**
+     * Delete a thread pool. Blocks until all worker threads have exited.
+     * @param pool Thread pool handle
+     */
+    void Delete(HThreadPool pool);
+
+    /**
+     * Get the number of worker threads
+     * @param pool Thread pool handle
+     * @return Number of worker threads
+     */
+    uint32_t GetThreadCount(HThreadPool pool);
+
+    /**
+     * Run a job function for each index in [0, count) and wait for all jobs to
+     * complete. The calling thread takes part in the work. Several threads may
+     * call Run() on the same pool concurrently.
+     * @param pool Thread pool handle. If 0, all jobs run on the calling thread.
+     * @param function Job function
+     * @param context User context
+     * @param count Number of jobs
+     */
+    void Run(HThreadPool pool, JobFunction function, void* context, uint32_t count);
+}
+
+#endif // DM_THREAD_POOL_H
@@ -11,6 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <assert.h>
+#include <string.h>
 #include "zlib.h"
 #include "../zlib/zlib.h"
 
@@ -117,4 +118,112 @@ namespace dmZlib
         return RESULT_OK;
     }
 
+    struct Inflater
+    {
+        z_stream m_Stream;
+        // The first bytes of the stream, kept until there are enough of them to tell the format
+        uint8_t  m_Header[2];
+        uint32_t m_HeaderSize : 2;
+        uint32_t m_FormatKnown : 1;
+        uint32_t m_Finished : 1;
+    };
+
+    HInflater NewInflater()
+    {
+        Inflater* inflater = new Inflater;
+        memset(inflater, 0, sizeof(*inflater));
+        inflater->m_Stream.zalloc = Z_NULL;
+        inflater->m_Stream.zfree = Z_NULL;
+        inflater->m_Stream.opaque = Z_NULL;
+        inflater->m_Stream.avail_in = 0;
+        inflater->m_Stream.next_in = Z_NULL;
+
+        if (inflateInit2(&inflater->m_Stream, MAX_WBITS) != Z_OK)
+        {
+            delete inflater;
+            return 0;
+        }
+        return inflater;
+    }
+
+    void DeleteInflater(HInflater inflater)
+    {
+        (void)inflateEnd(&inflater->m_Stream);
+        delete inflater;
+    }
+
+    // Window bits for the format of a stream starting with the two header bytes: gzip, zlib or raw deflate
+    static int GetWindowBits(const uint8_t* header)
+    {
+        if (header[0] == 0x1f && header[1] == 0x8b)
+            return MAX_WBITS + 16;
+        if ((header[0] & 0x0f) == Z_DEFLATED && (header[0] >> 4) + 8 <= MAX_WBITS && ((header[0] << 8) | header[1]) % 31 == 0)
+            return MAX_WBITS;
+        return -MAX_WBITS;
+    }
+
+    static Result InflateData(Inflater* inflater, const uint8_t* buffer, uint32_t buffer_size, void* context, Writer writer)
+    {
+        z_stream& strm = inflater->m_Stream;
+        unsigned char out[16384];
+
+        strm.avail_in = buffer_size;
+        strm.next_in = buffer;
+
+        do {
+            strm.avail_out = sizeof(out);
+            strm.next_out = out;
+            int ret = inflate(&strm, Z_NO_FLUSH);
+            assert(ret != Z_STREAM_ERROR);
+
+            if (ret == Z_BUF_ERROR)
+                break; // No progress possible, ie all input consumed
+            if (ret < 0 || ret == Z_NEED_DICT)
+                return RESULT_DATA_ERROR;
+
+            uint32_t have = sizeof(out) - strm.avail_out;
+            if (have > 0 && !writer(context, out, have))
+                return RESULT_ERRNO;
+
+            if (ret == Z_STREAM_END)
+            {
+                inflater->m_Finished = 1;
+                return RESULT_STREAM_END;
+            }
+        } while (strm.avail_in > 0 || strm.avail_out == 0);
+
+        return RESULT_OK;
+    }
+
+    Result Inflate(HInflater inflater, const void* buffer, uint32_t buffer_size, void* context, Writer writer)
+    {
+        if (inflater->m_Finished)
+            return RESULT_STREAM_END;
+
+        const uint8_t* data = (const uint8_t*) buffer;
+        if (!inflater->m_FormatKnown)
+        {
+            // The format is decided once, from the first two bytes, however the stream is split
+            while (inflater->m_HeaderSize < sizeof(inflater->m_Header) && buffer_size > 0)
+            {
+                inflater->m_Header[inflater->m_HeaderSize++] = *data++;
+                --buffer_size;
+            }
+            if (inflater->m_HeaderSize < sizeof(inflater->m_Header))
+                return RESULT_OK;
+
+            if (inflateReset2(&inflater->m_Stream, GetWindowBits(inflater->m_Header)) != Z_OK)
+                return RESULT_DATA_ERROR;
+            inflater->m_FormatKnown = 1;
+
+            Result r = InflateData(inflater, inflater->m_Header, sizeof(inflater->m_Header), context, writer);
+            if (r != RESULT_OK)
+                return r;
+        }
+
+        if (buffer_size == 0)
+            return RESULT_OK;
+        return InflateData(inflater, data, buffer_size, context, writer);
+    }
+
 }
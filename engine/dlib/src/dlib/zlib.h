@@ -65,6 +65,37 @@ namespace dmZlib
      * @return RESULT_OK on success
      */
     Result DeflateBuffer(const void* buffer, uint32_t buffer_size, int level, void* context, Writer writer);
+
+    /**
+     * Streaming inflater handle
+     */
+    typedef struct Inflater* HInflater;
+
+    /**
+     * Create a streaming inflater. Gzip and zlib format is auto-detected from the first two
+     * bytes of the stream. Other streams are inflated as raw deflate data, as sent by some
+     * http-servers for "Content-Encoding: deflate".
+     * @return inflater handle, 0 on failure
+     */
+    HInflater NewInflater();
+
+    /**
+     * Delete a streaming inflater
+     * @param inflater inflater handle
+     */
+    void DeleteInflater(HInflater inflater);
+
+    /**
+     * Inflate (decompress) the next part of a stream. The input can be split at
+     * arbitrary positions. Data following the end of the stream is ignored.
+     * @param inflater inflater handle
+     * @param buffer buffer to inflate
+     * @param buffer_size buffer size
+     * @param context context
+     * @param writer writer (inflated data)
+     * @return RESULT_OK if more data is expected, RESULT_STREAM_END when the end of the stream is reached
+     */
+    Result Inflate(HInflater inflater, const void* buffer, uint32_t buffer_size, void* context, Writer writer);
 }
 
 
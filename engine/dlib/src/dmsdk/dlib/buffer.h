@@ -346,6 +346,42 @@ namespace dmBuffer
      */
     Result GetStreamType(HBuffer buffer, dmhash_t stream_name, dmBuffer::ValueType* type, uint32_t* components);
 
+    /*# get the content version of a buffer
+     *
+     * Gets the current content version of a buffer. The version is increased
+     * each time the content has been marked as changed with dmBuffer::UpdateContentVersion,
+     * which allows systems to cache data derived from the buffer.
+     *
+     * @name dmBuffer::GetContentVersion
+     * @param buffer [type:dmBuffer::HBuffer] The buffer
+     * @param version [type:uint32_t*] The current content version
+     * @return result [type:dmBuffer::Result] RESULT_OK if the buffer is valid
+     */
+    Result GetContentVersion(HBuffer buffer, uint32_t* version);
+
+    /*# update the content version of a buffer
+     *
+     * Marks the content of a buffer as changed. Call this function after writing
+     * to the streams of a buffer, to make sure that systems caching data derived
+     * from the buffer (e.g. the vertex data of a mesh) picks up the change.
+     *
+     * @name dmBuffer::UpdateContentVersion
+     * @param buffer [type:dmBuffer::HBuffer] The buffer
+     * @return result [type:dmBuffer::Result] RESULT_OK if the buffer is valid
+     * @examples
+     *
+     * ```cpp
+     * float* positions = 0x0;
+     * uint32_t count = 0;
+     * uint32_t components = 0;
+     * uint32_t stride = 0;
+     * dmBuffer::GetStream(buffer, dmHashString64("position"), (void**)&positions, &count, &components, &stride);
+     * positions[0] = 1.0f;
+     * dmBuffer::UpdateContentVersion(buffer);
+     * ```
+     */
+    Result UpdateContentVersion(HBuffer buffer);
+
     /*# get size of a value type
      *
      * Gets the size of a value type
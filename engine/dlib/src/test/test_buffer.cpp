@@ -176,6 +176,50 @@ TEST_F(BufferTest, ValueTypes)
     }
 }
 
+TEST_F(BufferTest, ContentVersion)
+{
+    dmBuffer::HBuffer buffer = 0x0;
+    dmBuffer::StreamDeclaration streams_decl[] = {
+        {dmHashString64("dummy"), dmBuffer::VALUE_TYPE_UINT8, 1}
+    };
+
+    uint32_t version = 0;
+    ASSERT_EQ(dmBuffer::RESULT_BUFFER_INVALID, dmBuffer::GetContentVersion(buffer, &version));
+    ASSERT_EQ(dmBuffer::RESULT_BUFFER_INVALID, dmBuffer::UpdateContentVersion(buffer));
+
+    dmBuffer::Result r = dmBuffer::Create(4, streams_decl, 1, &buffer);
+    ASSERT_EQ(dmBuffer::RESULT_OK, r);
+
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetContentVersion(buffer, &version));
+    ASSERT_EQ(0u, version);
+
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::UpdateContentVersion(buffer));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetContentVersion(buffer, &version));
+    ASSERT_EQ(1u, version);
+
+    // Copying into a buffer changes its content
+    dmBuffer::HBuffer src_buffer = 0x0;
+    r = dmBuffer::Create(4, streams_decl, 1, &src_buffer);
+    ASSERT_EQ(dmBuffer::RESULT_OK, r);
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::Copy(buffer, src_buffer));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetContentVersion(buffer, &version));
+    ASSERT_EQ(2u, version);
+
+    // Reading the data doesn't change its content
+    void* data = 0x0;
+    uint32_t size = 0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetBytes(buffer, &data, &size));
+    uint32_t count, components, stride;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(buffer, dmHashString64("dummy"), &data, &count, &components, &stride));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetContentVersion(buffer, &version));
+    ASSERT_EQ(2u, version);
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetContentVersion(src_buffer, &version));
+    ASSERT_EQ(0u, version);
+
+    dmBuffer::Destroy(src_buffer);
+    dmBuffer::Destroy(buffer);
+}
+
 TEST_F(BufferTest, ValidateBuffer)
 {
     dmBuffer::HBuffer buffer = 0x0;
@@ -106,6 +106,50 @@ TEST(dmEasing, CurstomCurve)
     }
 }
 
+TEST(dmEasing, GetValues)
+{
+    const uint32_t count = 150; // more than one internal chunk
+    float t[count];
+    float values[count];
+    for (uint32_t i = 0; i < count; ++i) {
+        t[i] = -0.1f + 1.2f * i / (float) (count - 1);
+    }
+
+    for (int type = 0; type < dmEasing::TYPE_FLOAT_VECTOR; ++type) {
+        dmEasing::Curve curve((dmEasing::Type) type);
+        dmEasing::GetValues(curve, t, values, count);
+        for (uint32_t i = 0; i < count; ++i) {
+            ASSERT_EQ(dmEasing::GetValue(curve, t[i]), values[i]);
+        }
+    }
+
+    dmVMath::FloatVector vector(17);
+    for (int i = 0; i < 17; ++i) {
+        vector.values[i] = i * 0.5f;
+    }
+    dmEasing::Curve curve(dmEasing::TYPE_FLOAT_VECTOR);
+    curve.vector = &vector;
+    dmEasing::GetValues(curve, t, values, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(dmEasing::GetValue(curve, t[i]), values[i]);
+    }
+
+    dmVMath::FloatVector vector_single(1);
+    vector_single.values[0] = 0.7f;
+    curve.vector = &vector_single;
+    dmEasing::GetValues(curve, t, values, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(0.7f, values[i]);
+    }
+
+    // In place
+    memcpy(values, t, sizeof(t));
+    dmEasing::GetValues(dmEasing::Curve(dmEasing::TYPE_INQUAD), values, values, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_EQ(dmEasing::GetValue(dmEasing::TYPE_INQUAD, t[i]), values[i]);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -682,6 +682,64 @@ TEST_F(dmHttpCacheTest, Persist)
     dmHttpCache::Close(cache);
 }
 
+TEST_F(dmHttpCacheTest, ContentEncoding)
+{
+    dmHttpCache::HCache cache;
+    dmHttpCache::NewParams params;
+    params.m_Path = "tmp/cache";
+    dmHttpCache::Result r = dmHttpCache::Open(&params, &cache);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+
+    r = Put(cache, "uri1", "etag1", "data1", strlen("data1"));
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+
+    dmHttpCache::HCacheCreator cache_creator;
+    r = dmHttpCache::Begin(cache, "uri2", "etag2", &cache_creator);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    r = dmHttpCache::SetContentEncoding(cache, cache_creator, dmHttpCache::CONTENT_ENCODING_GZIP);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    r = dmHttpCache::Add(cache, cache_creator, "data2", strlen("data2"));
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    r = dmHttpCache::End(cache, cache_creator);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+
+    dmHttpCache::EntryInfo info;
+    r = dmHttpCache::GetInfo(cache, "uri1", &info);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    ASSERT_EQ((uint8_t) dmHttpCache::CONTENT_ENCODING_IDENTITY, info.m_ContentEncoding);
+    r = dmHttpCache::GetInfo(cache, "uri2", &info);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    ASSERT_EQ((uint8_t) dmHttpCache::CONTENT_ENCODING_GZIP, info.m_ContentEncoding);
+
+    // The encoding is persisted in the index
+    dmHttpCache::Close(cache);
+    r = dmHttpCache::Open(&params, &cache);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+
+    r = dmHttpCache::GetInfo(cache, "uri2", &info);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    ASSERT_EQ((uint8_t) dmHttpCache::CONTENT_ENCODING_GZIP, info.m_ContentEncoding);
+
+    // The encoding can be read together with the content
+    FILE* file = 0;
+    uint64_t checksum;
+    uint8_t content_encoding = 0xff;
+    r = dmHttpCache::Get(cache, "uri2", "etag2", &file, &checksum, &content_encoding);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    ASSERT_EQ((uint8_t) dmHttpCache::CONTENT_ENCODING_GZIP, content_encoding);
+    r = dmHttpCache::Release(cache, "uri2", "etag2", file);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+
+    // Updated entries get the encoding of the new data
+    r = Put(cache, "uri2", "etag3", "data3", strlen("data3"));
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    r = dmHttpCache::GetInfo(cache, "uri2", &info);
+    ASSERT_EQ(dmHttpCache::RESULT_OK, r);
+    ASSERT_EQ((uint8_t) dmHttpCache::CONTENT_ENCODING_IDENTITY, info.m_ContentEncoding);
+
+    dmHttpCache::Close(cache);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
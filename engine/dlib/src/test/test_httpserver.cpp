@@ -23,6 +23,7 @@
 #include "../dlib/http_server_private.h"
 #include "../dlib/http_client.h"
 #include "../dlib/hash.h"
+#include "../dlib/zlib.h"
 #include "../dlib/network_constants.h"
 
 #define JC_TEST_IMPLEMENTATION
@@ -41,8 +42,29 @@ public:
     std::string m_Content;
     volatile bool m_Quit;
     std::string m_ClientData;
+    std::string m_ClientPostData;
+    std::map<std::string, std::string> m_ClientHeaders;
     volatile bool m_ServerStarted;
 
+    static std::string GenerateContent(int n)
+    {
+        std::string buf;
+        for (int i = 0; i < n; ++i)
+        {
+            int c = (n + i*97) % ('z' - 'a');
+            char s[2] = { (char)('a' + (char)c), '\0' };
+            buf.append(s, 1);
+        }
+        return buf;
+    }
+
+    static bool StringWriter(void* context, const void* data, uint32_t data_len)
+    {
+        std::string* s = (std::string*) context;
+        s->append((const char*) data, data_len);
+        return true;
+    }
+
     static void HttpHeader(void* user_data, const char* key, const char* value)
     {
         dmHttpServerTest* self = (dmHttpServerTest*) user_data;
@@ -63,13 +85,7 @@ public:
             int n;
             sscanf(self->m_Resource.c_str(), "/respond_with_n/%d", &n);
 
-            std::string buf;
-            for (int i = 0; i < n; ++i)
-            {
-                int c = (n + i*97) % ('z' - 'a');
-                char s[2] = { (char)('a' + (char)c), '\0' };
-                buf.append(s, 1);
-            }
+            std::string buf = GenerateContent(n);
 
             int sent_bytes = 0;
             while (n > 0)
@@ -80,6 +96,22 @@ public:
                 sent_bytes += n_to_send;
             }
         }
+        else if (strstr(self->m_Resource.c_str(), "/deflate_with_n/"))
+        {
+            int n;
+            sscanf(self->m_Resource.c_str(), "/deflate_with_n/%d", &n);
+
+            std::string buf = GenerateContent(n);
+            std::string compressed;
+            dmZlib::DeflateBuffer(buf.c_str(), buf.size(), 5, &compressed, StringWriter);
+
+            dmHttpServer::SendAttribute(request, "Content-Encoding", "deflate");
+            // NOTE: Small parts to test the content decoding across chunk boundaries
+            for (uint32_t i = 0; i < compressed.size(); i += 17)
+            {
+                dmHttpServer::Send(request, compressed.c_str() + i, dmMath::Min(17U, (uint32_t) compressed.size() - i));
+            }
+        }
         else if (strstr(self->m_Resource.c_str(), "/mul/"))
         {
             int a,b;
@@ -119,6 +151,17 @@ public:
                 self->m_Content.append((const char*) recv_buf, recv_bytes);
             }
 
+            if (self->m_Headers["Content-Encoding"] == "deflate")
+            {
+                std::string inflated;
+                if (dmZlib::InflateBuffer(self->m_Content.c_str(), self->m_Content.size(), &inflated, StringWriter) != dmZlib::RESULT_OK)
+                {
+                    dmHttpServer::SetStatusCode(request, 400);
+                    return;
+                }
+                self->m_Content = inflated;
+            }
+
             char str_buf[32];
             dmSnPrintf(str_buf, sizeof(str_buf), "%llu", (unsigned long long)dmHashBuffer64(self->m_Content.c_str(), self->m_Content.size()));
             dmHttpServer::Send(request, str_buf, strlen(str_buf));
@@ -135,6 +178,24 @@ public:
         self->m_ClientData.append((const char*) content_data, content_data_size);
     }
 
+    static void ClientHttpHeader(dmHttpClient::HResponse response, void* user_data, int status_code, const char* key, const char* value)
+    {
+        dmHttpServerTest* self = (dmHttpServerTest*) user_data;
+        self->m_ClientHeaders[key] = value;
+    }
+
+    static uint32_t ClientHttpSendContentLength(dmHttpClient::HResponse response, void* user_data)
+    {
+        dmHttpServerTest* self = (dmHttpServerTest*) user_data;
+        return self->m_ClientPostData.size();
+    }
+
+    static dmHttpClient::Result ClientHttpWrite(dmHttpClient::HResponse response, uint32_t offset, uint32_t length, void* user_data)
+    {
+        dmHttpServerTest* self = (dmHttpServerTest*) user_data;
+        return dmHttpClient::Write(response, self->m_ClientPostData.c_str() + offset, length);
+    }
+
     static void ServerThread(void* user_data)
     {
         dmHttpServerTest* self = (dmHttpServerTest*) user_data;
@@ -343,6 +404,74 @@ TEST_F(dmHttpServerTest, TestServerClient)
     dmThread::Join(thread);
 }
 
+TEST_F(dmHttpServerTest, TestServerClientCompression)
+{
+    dmThread::Thread thread = dmThread::New(&ServerThread, 0x8000, this, "test");
+
+    while (!m_ServerStarted)
+    {
+        dmTime::Sleep(10 * 1000);
+    }
+
+    dmHttpClient::NewParams client_params;
+    client_params.m_HttpContent = &ClientHttpContent;
+    client_params.m_HttpHeader = &ClientHttpHeader;
+    client_params.m_HttpSendContentLength = &ClientHttpSendContentLength;
+    client_params.m_HttpWrite = &ClientHttpWrite;
+    client_params.m_Userdata = this;
+    client_params.m_DNSChannel = m_DNSChannel;
+    dmHttpClient::HClient client = dmHttpClient::New(&client_params, DM_LOOPBACK_ADDRESS_IPV4, 8500);
+
+    dmHttpClient::Result r;
+    r = dmHttpClient::SetOptionInt(client, dmHttpClient::OPTION_ACCEPT_ENCODING, 1);
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+
+    for (int i = 0; i < 20000; i += 997)
+    {
+        char uri[64];
+        dmSnPrintf(uri, sizeof(uri), "/deflate_with_n/%d", i);
+        m_ClientData = "";
+        m_ClientHeaders.clear();
+
+        r = dmHttpClient::Get(client, uri);
+        ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+        ASSERT_TRUE(GenerateContent(i) == m_ClientData);
+        // The encoding of the decoded content isn't passed on
+        ASSERT_EQ(0U, m_ClientHeaders.count("Content-Encoding"));
+    }
+
+    // Without the option the content is passed on as is
+    r = dmHttpClient::SetOptionInt(client, dmHttpClient::OPTION_ACCEPT_ENCODING, 0);
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+    m_ClientData = "";
+    m_ClientHeaders.clear();
+    r = dmHttpClient::Get(client, "/deflate_with_n/5000");
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+    ASSERT_STREQ("deflate", m_ClientHeaders["Content-Encoding"].c_str());
+    std::string inflated;
+    ASSERT_EQ(dmZlib::RESULT_OK, dmZlib::InflateBuffer(m_ClientData.c_str(), m_ClientData.size(), &inflated, StringWriter));
+    ASSERT_TRUE(GenerateContent(5000) == inflated);
+
+    r = dmHttpClient::SetOptionInt(client, dmHttpClient::OPTION_REQUEST_COMPRESSION, 1);
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+
+    m_ClientPostData = GenerateContent(30000);
+    m_ClientData = "";
+    r = dmHttpClient::Post(client, "/post");
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+    char expected[32];
+    dmSnPrintf(expected, sizeof(expected), "%llu", (unsigned long long)dmHashBuffer64(m_ClientPostData.c_str(), m_ClientPostData.size()));
+    ASSERT_STREQ(expected, m_ClientData.c_str());
+    ASSERT_STREQ("deflate", m_Headers["Content-Encoding"].c_str());
+
+    r = dmHttpClient::Get(client, "/quit");
+    ASSERT_EQ(dmHttpClient::RESULT_OK, r);
+
+    dmHttpClient::Delete(client);
+
+    dmThread::Join(thread);
+}
+
 int main(int argc, char **argv)
 {
     dmSocket::Initialize();
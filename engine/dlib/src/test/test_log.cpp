@@ -111,6 +111,107 @@ TEST(dmLog, LogFile)
     fclose(f);
 }
 
+static const uint32_t ASYNC_LOG_THREAD_COUNT = 4;
+static const uint32_t ASYNC_LOG_MESSAGE_COUNT = 2000;
+
+static void AsyncLogThread(void* arg)
+{
+    uint32_t thread_index = (uint32_t)(uintptr_t)arg;
+    for (uint32_t i = 0; i < ASYNC_LOG_MESSAGE_COUNT; ++i)
+    {
+        dmLogInfo("ASYNC_LOG %u %u", thread_index, i);
+    }
+}
+
+TEST(dmLog, AsyncLogFile)
+{
+    char path[DMPATH_MAX_PATH];
+    dmSys::GetLogPath(path, sizeof(path));
+    dmStrlCat(path, "/log_async.txt", sizeof(path));
+
+    dmLogParams params;
+    params.m_AsyncBufferSize = 32 * 1024;
+    dmLogInitialize(&params);
+    dmSetLogFile(path);
+
+    dmThread::Thread threads[ASYNC_LOG_THREAD_COUNT];
+    for (uint32_t i = 0; i < ASYNC_LOG_THREAD_COUNT; ++i)
+    {
+        threads[i] = dmThread::New(AsyncLogThread, 0x80000, (void*)(uintptr_t)i, "test");
+    }
+    for (uint32_t i = 0; i < ASYNC_LOG_THREAD_COUNT; ++i)
+    {
+        dmThread::Join(threads[i]);
+    }
+
+    dmLogFatal("ASYNC_LOG_FATAL");
+    uint32_t dropped = dmLogGetDroppedCount();
+    dmLogFinalize();
+
+    FILE* f = fopen(path, "rb");
+    ASSERT_NE((FILE*) 0, f);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* log = new char[size + 1];
+    ASSERT_EQ((size_t) size, fread(log, 1, size, f));
+    log[size] = '\0';
+    fclose(f);
+    dmSys::Unlink(path);
+
+    // The messages of each thread are written in order and no message is lost without being counted
+    uint32_t next[ASYNC_LOG_THREAD_COUNT] = { 0 };
+    uint32_t written = 0;
+    const char* cursor = log;
+    while ((cursor = strstr(cursor, "ASYNC_LOG ")) != 0)
+    {
+        uint32_t thread_index, message_index;
+        ASSERT_EQ(2, sscanf(cursor, "ASYNC_LOG %u %u", &thread_index, &message_index));
+        ASSERT_LT(thread_index, ASYNC_LOG_THREAD_COUNT);
+        ASSERT_LE(next[thread_index], message_index);
+        next[thread_index] = message_index + 1;
+        ++written;
+        ++cursor;
+    }
+    ASSERT_EQ(ASYNC_LOG_THREAD_COUNT * ASYNC_LOG_MESSAGE_COUNT, written + dropped);
+    ASSERT_TRUE(strstr(log, "ASYNC_LOG_FATAL") != 0);
+    if (dropped > 0)
+    {
+        ASSERT_TRUE(strstr(log, "log messages dropped") != 0);
+    }
+    delete[] log;
+}
+
+TEST(dmLog, EnableAsync)
+{
+    char path[DMPATH_MAX_PATH];
+    dmSys::GetLogPath(path, sizeof(path));
+    dmStrlCat(path, "/log_enable_async.txt", sizeof(path));
+
+    // Logging starts synchronously, as in the engine before the project settings are loaded
+    dmLogParams params;
+    dmLogInitialize(&params);
+    dmSetLogFile(path);
+    dmLogInfo("SYNC_LOG");
+    dmLogEnableAsync(16 * 1024);
+    dmLogInfo("ASYNC_LOG");
+    dmLogFinalize();
+
+    FILE* f = fopen(path, "rb");
+    ASSERT_NE((FILE*) 0, f);
+    char log[1024];
+    size_t size = fread(log, 1, sizeof(log) - 1, f);
+    log[size] = '\0';
+    fclose(f);
+    dmSys::Unlink(path);
+
+    const char* sync_log = strstr(log, "SYNC_LOG");
+    const char* async_log = strstr(log, "ASYNC_LOG");
+    ASSERT_TRUE(sync_log != 0);
+    ASSERT_TRUE(async_log != 0);
+    ASSERT_LT(sync_log, async_log);
+}
+
 static void TestLogCaptureCallback(void* user_data, const char* log)
 {
     dmArray<char>* log_output = (dmArray<char>*)user_data;
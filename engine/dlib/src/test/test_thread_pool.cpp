@@ -0,0 +1,121 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include "../dlib/atomic.h"
+#include "../dlib/thread.h"
+#include "../dlib/thread_pool.h"
+
+struct JobContext
+{
+    uint32_t*       m_Values;
+    int32_atomic_t  m_Calls;
+};
+
+static void SquareJob(void* context, uint32_t index)
+{
+    JobContext* ctx = (JobContext*) context;
+    ctx->m_Values[index] = index * index;
+    dmAtomicIncrement32(&ctx->m_Calls);
+}
+
+static void RunSquares(dmThreadPool::HThreadPool pool, uint32_t count)
+{
+    uint32_t* values = new uint32_t[count];
+    memset(values, 0xff, count * sizeof(uint32_t));
+    JobContext ctx;
+    ctx.m_Values = values;
+    ctx.m_Calls = 0;
+
+    dmThreadPool::Run(pool, SquareJob, &ctx, count);
+
+    ASSERT_EQ((int32_t) count, ctx.m_Calls);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(i * i, values[i]);
+    }
+    delete[] values;
+}
+
+TEST(dmThreadPool, NoPool)
+{
+    RunSquares(0, 100);
+}
+
+TEST(dmThreadPool, NoThreads)
+{
+    dmThreadPool::HThreadPool pool = dmThreadPool::New(0, "test_pool");
+    ASSERT_EQ(0u, dmThreadPool::GetThreadCount(pool));
+    RunSquares(pool, 100);
+    dmThreadPool::Delete(pool);
+}
+
+TEST(dmThreadPool, Run)
+{
+    dmThreadPool::HThreadPool pool = dmThreadPool::New(4, "test_pool");
+    RunSquares(pool, 0);
+    RunSquares(pool, 1);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        RunSquares(pool, 1 + i * 7);
+    }
+    dmThreadPool::Delete(pool);
+}
+
+struct CallerArg
+{
+    dmThreadPool::HThreadPool m_Pool;
+    int32_atomic_t            m_Errors;
+};
+
+static void CallerThread(void* arg)
+{
+    CallerArg* a = (CallerArg*) arg;
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        const uint32_t count = 64;
+        uint32_t values[count];
+        JobContext ctx;
+        ctx.m_Values = values;
+        ctx.m_Calls = 0;
+        dmThreadPool::Run(a->m_Pool, SquareJob, &ctx, count);
+        for (uint32_t j = 0; j < count; ++j)
+        {
+            if (values[j] != j * j)
+                dmAtomicIncrement32(&a->m_Errors);
+        }
+    }
+}
+
+TEST(dmThreadPool, ConcurrentCallers)
+{
+    CallerArg a;
+    a.m_Pool = dmThreadPool::New(3, "test_pool");
+    a.m_Errors = 0;
+
+    dmThread::Thread t1 = dmThread::New(&CallerThread, 0x80000, &a, "caller1");
+    dmThread::Thread t2 = dmThread::New(&CallerThread, 0x80000, &a, "caller2");
+    CallerThread(&a);
+    dmThread::Join(t1);
+    dmThread::Join(t2);
+
+    ASSERT_EQ(0, a.m_Errors);
+    dmThreadPool::Delete(a.m_Pool);
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -91,6 +91,82 @@ TEST(dmZlib, Stress)
     }
 }
 
+static dmZlib::Result InflateStream(const void* buffer, uint32_t buffer_size, uint32_t part_size, std::string* out)
+{
+    dmZlib::HInflater inflater = dmZlib::NewInflater();
+    if (!inflater)
+        return dmZlib::RESULT_MEM_ERROR;
+
+    dmZlib::Result r = dmZlib::RESULT_OK;
+    for (uint32_t offset = 0; offset < buffer_size && r == dmZlib::RESULT_OK; offset += part_size)
+    {
+        uint32_t size = buffer_size - offset < part_size ? buffer_size - offset : part_size;
+        r = dmZlib::Inflate(inflater, (const char*) buffer + offset, size, out, Writer);
+    }
+    dmZlib::DeleteInflater(inflater);
+    return r;
+}
+
+TEST(dmZlib, InflateStream)
+{
+    std::string buf;
+    dmZlib::Result r;
+
+    r = InflateStream(FOO_GZ, FOO_GZ_SIZE, FOO_GZ_SIZE, &buf);
+    ASSERT_EQ(dmZlib::RESULT_STREAM_END, r);
+    ASSERT_STREQ("foo", buf.c_str());
+
+    buf = "";
+    r = InflateStream(FOO_GZ, FOO_GZ_SIZE, 1, &buf);
+    ASSERT_EQ(dmZlib::RESULT_STREAM_END, r);
+    ASSERT_STREQ("foo", buf.c_str());
+
+    buf = "";
+    r = InflateStream(FOO_DEFLATE, FOO_DEFLATE_SIZE, 1, &buf);
+    ASSERT_EQ(dmZlib::RESULT_STREAM_END, r);
+    ASSERT_STREQ("foo", buf.c_str());
+
+    std::string ref = RandomString(100000);
+    std::string compressed;
+    r = dmZlib::DeflateBuffer(ref.c_str(), ref.size(), 5, &compressed, Writer);
+    ASSERT_EQ(dmZlib::RESULT_OK, r);
+
+    const uint32_t part_sizes[] = {1, 7, 1024, 65536, (uint32_t) compressed.size()};
+    for (uint32_t i = 0; i < sizeof(part_sizes) / sizeof(part_sizes[0]); ++i)
+    {
+        std::string decompressed;
+        r = InflateStream(compressed.c_str(), compressed.size(), part_sizes[i], &decompressed);
+        ASSERT_EQ(dmZlib::RESULT_STREAM_END, r);
+        ASSERT_TRUE(ref == decompressed);
+    }
+
+    // Raw deflate data, ie without the zlib header and adler32 trailer. The format is told
+    // from the first two bytes, also when they arrive in separate parts
+    std::string raw = compressed.substr(2, compressed.size() - 6);
+    std::string decompressed;
+    for (uint32_t i = 0; i < sizeof(part_sizes) / sizeof(part_sizes[0]); ++i)
+    {
+        decompressed = "";
+        r = InflateStream(raw.c_str(), raw.size(), part_sizes[i], &decompressed);
+        ASSERT_EQ(dmZlib::RESULT_STREAM_END, r);
+        ASSERT_TRUE(ref == decompressed);
+    }
+
+    // Truncated stream
+    decompressed = "";
+    r = InflateStream(compressed.c_str(), compressed.size() / 2, 1024, &decompressed);
+    ASSERT_EQ(dmZlib::RESULT_OK, r);
+    ASSERT_TRUE(ref.compare(0, decompressed.size(), decompressed) == 0);
+
+    // Corrupt stream
+    std::string corrupt = compressed;
+    for (uint32_t i = 16; i < corrupt.size(); i += 16)
+        corrupt[i] = ~corrupt[i];
+    decompressed = "";
+    r = InflateStream(corrupt.c_str(), corrupt.size(), 1024, &decompressed);
+    ASSERT_EQ(dmZlib::RESULT_DATA_ERROR, r);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -233,6 +233,7 @@ namespace dmEngine
         m_PhysicsContext.m_Context3D = 0x0;
         m_PhysicsContext.m_Debug = false;
         m_PhysicsContext.m_3D = false;
+        m_PhysicsContext.m_UseEventBuffer = false;
         m_GuiContext.m_GuiContext = 0x0;
         m_GuiContext.m_RenderContext = 0x0;
         m_SpriteContext.m_RenderContext = 0x0;
@@ -319,6 +320,8 @@ namespace dmEngine
             dmResource::DeleteFactory(engine->m_Factory);
         }
 
+        dmGameSystem::FinalizeTextureContext(engine->m_TextureContext);
+
         if (engine->m_GraphicsContext)
         {
             dmGraphics::CloseWindow(engine->m_GraphicsContext);
@@ -572,6 +575,11 @@ namespace dmEngine
             }
         }
 
+        int log_async_buffer_size = dmConfigFile::GetInt(engine->m_Config, "project.log_async_buffer_size", 0);
+        if (log_async_buffer_size > 0) {
+            dmLogEnableAsync((uint32_t) log_async_buffer_size);
+        }
+
         const char* update_order = dmConfigFile::GetString(engine->m_Config, "gameobject.update_order", 0);
 
         // This scope is mainly here to make sure the "Main" scope is created first
@@ -864,6 +872,7 @@ namespace dmEngine
         physics_params.m_RayCastLimit2D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_2d", 64);
         physics_params.m_RayCastLimit3D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_3d", 128);
         physics_params.m_TriggerOverlapCapacity = dmConfigFile::GetInt(engine->m_Config, "physics.trigger_overlap_capacity", 16);
+        physics_params.m_SolverThreadCount = dmConfigFile::GetInt(engine->m_Config, "physics.solver_threads", 1);
         if (physics_params.m_Scale < dmPhysics::MIN_SCALE || physics_params.m_Scale > dmPhysics::MAX_SCALE)
         {
             dmLogWarning("Physics scale must be in the range %.2f - %.2f and has been clamped.", dmPhysics::MIN_SCALE, dmPhysics::MAX_SCALE);
@@ -892,6 +901,7 @@ namespace dmEngine
         }
         engine->m_PhysicsContext.m_MaxCollisionCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_MAX_COLLISIONS_KEY, 64);
         engine->m_PhysicsContext.m_MaxContactPointCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_MAX_CONTACTS_KEY, 128);
+        engine->m_PhysicsContext.m_UseEventBuffer = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_USE_EVENT_BUFFER_KEY, 0) != 0;
         // TODO: Should move inside the ifdef release? Is this usable without the debug callbacks?
         engine->m_PhysicsContext.m_Debug = (bool) dmConfigFile::GetInt(engine->m_Config, "physics.debug", 0);
 
@@ -917,6 +927,8 @@ namespace dmEngine
         engine->m_ModelContext.m_RenderContext = engine->m_RenderContext;
         engine->m_ModelContext.m_Factory = engine->m_Factory;
         engine->m_ModelContext.m_MaxModelCount = max_model_count;
+        engine->m_ModelContext.m_OffscreenUpdateInterval = dmConfigFile::GetInt(engine->m_Config, "model.offscreen_update_interval", 1);
+        engine->m_ModelContext.m_OffscreenPoseTimeout = dmConfigFile::GetInt(engine->m_Config, "model.offscreen_pose_timeout", 0);
 
         engine->m_MeshContext.m_RenderContext = engine->m_RenderContext;
         engine->m_MeshContext.m_Factory       = engine->m_Factory;
@@ -925,6 +937,8 @@ namespace dmEngine
         engine->m_SpineModelContext.m_RenderContext = engine->m_RenderContext;
         engine->m_SpineModelContext.m_Factory = engine->m_Factory;
         engine->m_SpineModelContext.m_MaxSpineModelCount = max_spine_count;
+        engine->m_SpineModelContext.m_OffscreenUpdateInterval = dmConfigFile::GetInt(engine->m_Config, "spine.offscreen_update_interval", 1);
+        engine->m_SpineModelContext.m_OffscreenPoseTimeout = dmConfigFile::GetInt(engine->m_Config, "spine.offscreen_pose_timeout", 0);
 
         engine->m_LabelContext.m_RenderContext      = engine->m_RenderContext;
         engine->m_LabelContext.m_MaxLabelCount      = dmConfigFile::GetInt(engine->m_Config, "label.max_count", 64);
@@ -958,7 +972,8 @@ namespace dmEngine
         fact_result = dmGameObject::RegisterResourceTypes(engine->m_Factory, engine->m_Register, engine->m_GOScriptContext, &engine->m_ModuleContext);
         if (fact_result != dmResource::RESULT_OK)
             goto bail;
-        fact_result = dmGameSystem::RegisterResourceTypes(engine->m_Factory, engine->m_RenderContext, &engine->m_GuiContext, engine->m_InputContext, &engine->m_PhysicsContext);
+        dmGameSystem::InitializeTextureContext(engine->m_TextureContext, engine->m_GraphicsContext);
+        fact_result = dmGameSystem::RegisterResourceTypes(engine->m_Factory, engine->m_RenderContext, &engine->m_GuiContext, engine->m_InputContext, &engine->m_PhysicsContext, &engine->m_TextureContext);
         if (fact_result != dmResource::RESULT_OK)
             goto bail;
 
@@ -1668,6 +1683,11 @@ bail:
                 RecordData* record_data = &self->m_RecordData;
                 if (record_data->m_Recorder)
                 {
+                    uint32_t dropped_frames = dmRecord::GetDroppedFrameCount(record_data->m_Recorder);
+                    if (dropped_frames > 0)
+                    {
+                        dmLogWarning("%u frames were dropped while recording since the encoder could not keep up", dropped_frames);
+                    }
                     dmRecord::Delete(record_data->m_Recorder);
                     delete[] record_data->m_Buffer;
                     record_data->m_Recorder = 0;
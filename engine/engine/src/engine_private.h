@@ -123,6 +123,7 @@ namespace dmEngine
         dmGraphics::HContext                        m_GraphicsContext;
         dmRender::HRenderContext                    m_RenderContext;
         dmGameSystem::PhysicsContext                m_PhysicsContext;
+        dmGameSystem::TextureContext                m_TextureContext;
         dmGameSystem::ParticleFXContext             m_ParticleFXContext;
         /// If the shared context is set, the three environment specific contexts below will point to the same context
         dmScript::HContext                          m_SharedScriptContext;
@@ -29,8 +29,8 @@ extern "C"
 
 namespace dmGameObject
 {
-#define INVALID_INDEX 0xffff
-#define MAX_CAPACITY 65000u
+#define INVALID_INDEX 0xffffffff
+#define INITIAL_CAPACITY 512u
 #define MIN_CAPACITY_GROWTH 2048u
 
     struct Animation
@@ -50,10 +50,10 @@ namespace dmGameObject
         AnimationStopped    m_AnimationStopped;
         void*               m_Userdata1;
         void*               m_Userdata2;
-        uint16_t            m_PreviousListener;
-        uint16_t            m_NextListener;
-        uint16_t            m_Index;
-        uint16_t            m_Next;
+        uint32_t            m_PreviousListener;
+        uint32_t            m_NextListener;
+        uint32_t            m_Index;
+        uint32_t            m_Next;
         uint16_t            m_Playing : 1;
         uint16_t            m_Finished : 1;
         uint16_t            m_Composite : 1;
@@ -61,27 +61,56 @@ namespace dmGameObject
         uint16_t            m_FirstUpdate : 1;
     };
 
+    /*
+     * Per frame evaluation data for the animations that write a value, stored as
+     * structure of arrays. Entries are in animation order, m_Order sorts them by
+     * easing type so that each curve is evaluated as one batch.
+     */
+    struct AnimEvalData
+    {
+        dmArray<uint32_t>   m_Animation;
+        dmArray<float>      m_T;
+        dmArray<float>      m_From;
+        dmArray<float>      m_Delta;
+        dmArray<uint32_t>   m_Order;
+        dmArray<float>      m_Scratch;
+        uint32_t            m_TypeCount[dmEasing::TYPE_COUNT];
+    };
+
     struct AnimWorld
     {
         dmArray<Animation>                  m_Animations;
-        dmArray<uint16_t>                   m_AnimMap;
-        dmIndexPool<uint16_t>               m_AnimMapIndexPool;
-        dmHashTable<uintptr_t, uint16_t>    m_InstanceToIndex;
-        dmHashTable<uintptr_t, uint16_t>    m_ListenerInstanceToIndex;
+        dmArray<uint32_t>                   m_AnimMap;
+        dmIndexPool<uint32_t>               m_AnimMapIndexPool;
+        dmHashTable<uintptr_t, uint32_t>    m_InstanceToIndex;
+        dmHashTable<uintptr_t, uint32_t>    m_ListenerInstanceToIndex;
+        AnimEvalData                        m_EvalData;
         uint32_t                            m_InUpdate : 1;
     };
 
+    static void SetCapacity(AnimWorld* world, uint32_t capacity)
+    {
+        world->m_Animations.SetCapacity(capacity);
+        world->m_AnimMap.SetCapacity(capacity);
+        world->m_AnimMap.SetSize(capacity);
+        world->m_AnimMapIndexPool.SetCapacity(capacity);
+
+        AnimEvalData& eval = world->m_EvalData;
+        eval.m_Animation.SetCapacity(capacity);
+        eval.m_T.SetCapacity(capacity);
+        eval.m_From.SetCapacity(capacity);
+        eval.m_Delta.SetCapacity(capacity);
+        eval.m_Order.SetCapacity(capacity);
+        eval.m_Scratch.SetCapacity(capacity);
+    }
+
     CreateResult CompAnimNewWorld(const ComponentNewWorldParams& params)
     {
         if (params.m_World != 0x0)
         {
             AnimWorld* world = new AnimWorld();
             *params.m_World = world;
-            const uint32_t anim_count = 512;
-            world->m_Animations.SetCapacity(anim_count);
-            world->m_AnimMap.SetCapacity(MAX_CAPACITY);
-            world->m_AnimMap.SetSize(MAX_CAPACITY);
-            world->m_AnimMapIndexPool.SetCapacity(MAX_CAPACITY);
+            SetCapacity(world, INITIAL_CAPACITY);
             // This is fetched from res_collection.cpp (ResCollectionCreate)
             const int32_t instance_count = params.m_MaxInstances;
             const uint32_t table_count = dmMath::Max(1, instance_count/3);
@@ -115,11 +144,11 @@ namespace dmGameObject
         anim->m_Playing = 0;
     }
 
-    static void StopAnimations(AnimWorld* world, uint16_t* head_ptr, dmhash_t component_id, dmhash_t property_id)
+    static void StopAnimations(AnimWorld* world, uint32_t* head_ptr, dmhash_t component_id, dmhash_t property_id)
     {
         if (head_ptr != 0x0)
         {
-            uint16_t index = *head_ptr;
+            uint32_t index = *head_ptr;
             while (index != INVALID_INDEX)
             {
                 Animation* anim = &world->m_Animations[world->m_AnimMap[index]];
@@ -132,11 +161,11 @@ namespace dmGameObject
         }
     }
 
-    static void StopAllAnimations(AnimWorld* world, uint16_t* head_ptr)
+    static void StopAllAnimations(AnimWorld* world, uint32_t* head_ptr)
     {
         if (head_ptr != 0x0)
         {
-            uint16_t index = *head_ptr;
+            uint32_t index = *head_ptr;
             while (index != INVALID_INDEX)
             {
                 Animation* anim = &world->m_Animations[world->m_AnimMap[index]];
@@ -153,6 +182,91 @@ namespace dmGameObject
         return CREATE_RESULT_OK;
     }
 
+    /*
+     * Evaluates the easing curves of the animations gathered in AnimWorld::m_EvalData and
+     * writes the resulting values. Animations are bucketed by easing type so that all
+     * animations sharing a built in curve are evaluated with one dmEasing::GetValues call.
+     * Values are written back in animation order, which keeps the result identical to
+     * evaluating the animations one by one.
+     */
+    static void EvaluateAnimations(AnimWorld* world)
+    {
+        AnimEvalData& eval = world->m_EvalData;
+        uint32_t count = eval.m_Animation.Size();
+        if (count == 0)
+            return;
+
+        // Counting sort by easing type
+        uint32_t type_offset[dmEasing::TYPE_COUNT];
+        uint32_t offset = 0;
+        for (uint32_t type = 0; type < dmEasing::TYPE_COUNT; ++type)
+        {
+            type_offset[type] = offset;
+            offset += eval.m_TypeCount[type];
+        }
+        eval.m_Order.SetSize(count);
+        eval.m_Scratch.SetSize(count);
+        uint32_t* order = eval.m_Order.Begin();
+        float* scratch = eval.m_Scratch.Begin();
+        float* t = eval.m_T.Begin();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const Animation& anim = world->m_Animations[eval.m_Animation[i]];
+            uint32_t k = type_offset[anim.m_Easing.type]++;
+            order[k] = i;
+            scratch[k] = t[i];
+        }
+
+        offset = 0;
+        for (uint32_t type = 0; type < dmEasing::TYPE_COUNT; ++type)
+        {
+            uint32_t type_count = eval.m_TypeCount[type];
+            if (type_count == 0)
+                continue;
+            if (type == dmEasing::TYPE_FLOAT_VECTOR)
+            {
+                // Custom curves are unique per animation
+                for (uint32_t k = offset; k < offset + type_count; ++k)
+                {
+                    const Animation& anim = world->m_Animations[eval.m_Animation[order[k]]];
+                    scratch[k] = dmEasing::GetValue(anim.m_Easing, scratch[k]);
+                }
+            }
+            else
+            {
+                dmEasing::GetValues(dmEasing::Curve((dmEasing::Type) type), scratch + offset, scratch + offset, type_count);
+            }
+            offset += type_count;
+        }
+
+        for (uint32_t k = 0; k < count; ++k)
+        {
+            t[order[k]] = scratch[k];
+        }
+
+        const float* from = eval.m_From.Begin();
+        const float* delta = eval.m_Delta.Begin();
+        float* values = scratch;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            values[i] = from[i] + delta[i] * t[i];
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Animation& anim = world->m_Animations[eval.m_Animation[i]];
+            float v = values[i];
+            if (anim.m_Value != 0x0)
+            {
+                *anim.m_Value = v;
+            }
+            else
+            {
+                SetProperty(anim.m_Instance, anim.m_ComponentId, anim.m_PropertyId, PropertyVar(v));
+            }
+        }
+    }
+
     UpdateResult CompAnimUpdate(const ComponentsUpdateParams& params, ComponentsUpdateResult& update_result)
     {
         DM_PROFILE(Animation, "Update");
@@ -207,13 +321,13 @@ namespace dmGameObject
                     }
                 }
                 // Cancel other currently playing animations
-                uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim.m_Instance);
+                uint32_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim.m_Instance);
                 if (head_ptr != 0x0)
                 {
-                    uint16_t index = *head_ptr;
+                    uint32_t index = *head_ptr;
                     while (index != INVALID_INDEX)
                     {
-                        uint16_t anim_index = world->m_AnimMap[index];
+                        uint32_t anim_index = world->m_AnimMap[index];
                         Animation* a2 = &world->m_Animations[anim_index];
                         if (anim_index != i && !a2->m_FirstUpdate && a2->m_ComponentId == anim.m_ComponentId
                                 && a2->m_PropertyId == anim.m_PropertyId && a2->m_Delay <= 0.0f)
@@ -225,6 +339,12 @@ namespace dmGameObject
                 }
             }
         }
+        AnimEvalData& eval = world->m_EvalData;
+        eval.m_Animation.SetSize(0);
+        eval.m_T.SetSize(0);
+        eval.m_From.SetSize(0);
+        eval.m_Delta.SetSize(0);
+        memset(eval.m_TypeCount, 0, sizeof(eval.m_TypeCount));
         i = 0;
         for (i = 0; i < size; ++i)
         {
@@ -299,22 +419,19 @@ namespace dmGameObject
                         t = 2.0f - t;
                     }
                 }
-                t = dmEasing::GetValue(anim.m_Easing, t);
-                float v = anim.m_From + (anim.m_To - anim.m_From) * t;
-                if (anim.m_Value != 0x0)
-                {
-                    *anim.m_Value = v;
-                }
-                else
-                {
-                    SetProperty(anim.m_Instance, anim.m_ComponentId, anim.m_PropertyId, PropertyVar(v));
-                }
+                // Easing and write-back are done in batch below
+                eval.m_Animation.Push(i);
+                eval.m_T.Push(t);
+                eval.m_From.Push(anim.m_From);
+                eval.m_Delta.Push(anim.m_To - anim.m_From);
+                eval.m_TypeCount[anim.m_Easing.type]++;
             }
             if (completed)
             {
                 StopAnimation(&anim, true);
             }
         }
+        EvaluateAnimations(world);
         i = 0;
         // Prune canceled animations and call callbacks
         while (i < size)
@@ -338,8 +455,8 @@ namespace dmGameObject
                         anim->m_Easing.release_callback(&anim->m_Easing);
                     }
                 }
-                uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim->m_Instance);
-                uint16_t* index_ptr = head_ptr;
+                uint32_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)anim->m_Instance);
+                uint32_t* index_ptr = head_ptr;
                 while (*index_ptr != INVALID_INDEX)
                 {
                     if (*index_ptr == anim->m_Index)
@@ -401,14 +518,16 @@ namespace dmGameObject
                      void* userdata1, void* userdata2,
                      bool composite)
     {
-        uint32_t top = world->m_Animations.Size();
-        if (top == MAX_CAPACITY)
+        if (world->m_Animations.Full())
         {
-            dmLogError("Animation could not be stored since the buffer is full (%d).", MAX_CAPACITY);
-            return false;
+            // Growth heuristic is to grow with the mean of MIN_CAPACITY_GROWTH and half current capacity, and at least MIN_CAPACITY_GROWTH
+            uint32_t capacity = world->m_Animations.Capacity();
+            uint32_t growth = dmMath::Max(MIN_CAPACITY_GROWTH, (MIN_CAPACITY_GROWTH + capacity / 2) / 2);
+            SetCapacity(world, capacity + growth);
         }
-        uint16_t index = world->m_AnimMapIndexPool.Pop();
-        uint16_t* index_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
+        uint32_t top = world->m_Animations.Size();
+        uint32_t index = world->m_AnimMapIndexPool.Pop();
+        uint32_t* index_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
         if (index_ptr == 0x0)
         {
             if (world->m_InstanceToIndex.Full())
@@ -429,14 +548,6 @@ namespace dmGameObject
             last_anim->m_Next = index;
         }
 
-        if (world->m_Animations.Full())
-        {
-            // Growth heuristic is to grow with the mean of MIN_CAPACITY_GROWTH and half current capacity, and at least MIN_CAPACITY_GROWTH
-            uint32_t capacity = world->m_Animations.Capacity();
-            uint32_t growth = dmMath::Min(MIN_CAPACITY_GROWTH, (MIN_CAPACITY_GROWTH + capacity / 2) / 2);
-            capacity = dmMath::Min(capacity + growth, MAX_CAPACITY);
-            world->m_Animations.SetCapacity(capacity);
-        }
         uint32_t anim_count = top + 1;
         world->m_Animations.SetSize(anim_count);
 
@@ -608,7 +719,7 @@ namespace dmGameObject
             return PROPERTY_RESULT_UNSUPPORTED_TYPE;
         }
         AnimWorld* world = GetWorld(collection);
-        uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
+        uint32_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
         StopAnimations(world, head_ptr, component_id, property_id);
         if (element_count > 1)
         {
@@ -630,14 +741,14 @@ namespace dmGameObject
         }
         else
         {
-            uint16_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
+            uint32_t* head_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
             if (head_ptr != 0x0)
             {
                 uint32_t anim_count = world->m_Animations.Size();
-                uint16_t index = *head_ptr;
+                uint32_t index = *head_ptr;
                 while (index != INVALID_INDEX)
                 {
-                    uint16_t anim_index = world->m_AnimMap[index];
+                    uint32_t anim_index = world->m_AnimMap[index];
                     Animation* anim = &world->m_Animations[anim_index];
                     StopAnimation(anim, false);
                     if (anim->m_AnimationStopped != 0x0)
@@ -653,7 +764,7 @@ namespace dmGameObject
                     world->m_AnimMapIndexPool.Push(index);
                     index = anim->m_Next;
                     // delete the instance from the list
-                    anim_index = (uint16_t)(anim - world->m_Animations.Begin());
+                    anim_index = (uint32_t)(anim - world->m_Animations.Begin());
                     anim = &world->m_Animations.EraseSwap(anim_index);
                     --anim_count;
                     if (anim_count > anim_index)
@@ -669,17 +780,17 @@ namespace dmGameObject
 
     static void RemoveAnimationCallback(AnimWorld* world, Animation* anim)
     {
-        uint16_t previous = anim->m_PreviousListener;
-        uint16_t next = anim->m_NextListener;
+        uint32_t previous = anim->m_PreviousListener;
+        uint32_t next = anim->m_NextListener;
 
         if (INVALID_INDEX != previous)
         {
-            uint16_t anim_index_prev = world->m_AnimMap[previous];
+            uint32_t anim_index_prev = world->m_AnimMap[previous];
             world->m_Animations[anim_index_prev].m_NextListener = next;
         }
         if (INVALID_INDEX != next)
         {
-            uint16_t anim_index_next = world->m_AnimMap[next];
+            uint32_t anim_index_next = world->m_AnimMap[next];
             world->m_Animations[anim_index_next].m_PreviousListener = previous;
         }
         if (INVALID_INDEX == previous)
@@ -705,13 +816,13 @@ namespace dmGameObject
     void CancelAnimationCallbacks(HCollection collection, void* userdata1)
     {
         AnimWorld* const world = GetWorld(collection);
-        uint16_t* head_ptr = world->m_ListenerInstanceToIndex.Get((uintptr_t)userdata1);
+        uint32_t* head_ptr = world->m_ListenerInstanceToIndex.Get((uintptr_t)userdata1);
         if (0x0 != head_ptr)
         {
-            uint16_t index = *head_ptr;
+            uint32_t index = *head_ptr;
             while (INVALID_INDEX != index)
             {
-                uint16_t anim_index = world->m_AnimMap[index];
+                uint32_t anim_index = world->m_AnimMap[index];
                 Animation* const anim = &world->m_Animations[anim_index];
 
                 index = anim->m_NextListener;
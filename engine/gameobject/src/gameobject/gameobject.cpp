@@ -48,6 +48,8 @@ namespace dmGameObject
     const uint32_t MAX_DISPATCH_ITERATION_COUNT = 10;
 
     static Prototype EMPTY_PROTOTYPE;
+    // Last generation given to an instance, see Instance::m_Generation
+    static uint32_t g_InstanceGeneration = 0;
 
     static void Unlink(Collection* collection, Instance* instance);
 
@@ -194,6 +196,9 @@ namespace dmGameObject
         m_InstanceIndices.SetCapacity(max_instances);
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
+        m_ChangedTransforms.SetCapacity(max_instances);
+        m_TransformChanged.SetCapacity(max_instances);
+        m_TransformChanged.SetSize(max_instances);
         m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
         m_InputFocusStack.SetCapacity(max_input_stack_entries);
         m_NameHash = 0;
@@ -219,10 +224,31 @@ namespace dmGameObject
 
         memset(&m_Instances[0], 0, sizeof(Instance*) * max_instances);
         memset(&m_WorldTransforms[0], 0xcc, sizeof(dmTransform::Transform) * max_instances);
+        memset(&m_TransformChanged[0], 0, sizeof(uint8_t) * max_instances);
         memset(&m_LevelIndices[0], 0, sizeof(m_LevelIndices));
         memset(&m_ComponentInstanceCount[0], 0, sizeof(uint32_t) * MAX_COMPONENT_TYPES);
     }
 
+    static inline void MarkTransformChanged(Collection* collection, uint16_t index)
+    {
+        if (!collection->m_TransformChanged[index])
+        {
+            collection->m_TransformChanged[index] = 1;
+            collection->m_ChangedTransforms.Push(index);
+        }
+    }
+
+    // Stores the world transform of an instance, and records it as changed only if it differs from the previous one
+    static inline void StoreWorldTransform(Collection* collection, uint16_t index, const Matrix4& transform)
+    {
+        Matrix4& world = collection->m_WorldTransforms[index];
+        if (memcmp(&world, &transform, sizeof(Matrix4)) != 0)
+        {
+            world = transform;
+            MarkTransformChanged(collection, index);
+        }
+    }
+
     Result SetCollectionDefaultCapacity(HRegister regist, uint32_t capacity)
     {
         assert(regist != 0x0);
@@ -652,6 +678,14 @@ namespace dmGameObject
         operator delete (instance_memory);
     }
 
+    static uint32_t NextInstanceGeneration()
+    {
+        // 0 is never used, so that a zeroed PropertyHandle is invalid
+        if (++g_InstanceGeneration == 0)
+            ++g_InstanceGeneration;
+        return g_InstanceGeneration;
+    }
+
     HInstance NewInstance(Collection* collection, Prototype* proto, const char* prototype_name) {
         if (collection->m_InstanceIndices.Remaining() == 0)
         {
@@ -663,6 +697,7 @@ namespace dmGameObject
         instance->m_ScaleAlongZ = collection->m_ScaleAlongZ;
         uint16_t instance_index = collection->m_InstanceIndices.Pop();
         instance->m_Index = instance_index;
+        instance->m_Generation = NextInstanceGeneration();
         assert(collection->m_Instances[instance_index] == 0);
         collection->m_Instances[instance_index] = instance;
 
@@ -1059,7 +1094,7 @@ namespace dmGameObject
         SetPosition(instance, position);
         SetRotation(instance, rotation);
         SetScale(instance, scale);
-        collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(instance->m_Transform);
+        StoreWorldTransform(collection, instance->m_Index, dmTransform::ToMatrix4(instance->m_Transform));
 
         dmHashInit64(&instance->m_CollectionPathHashState, true);
         dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, ID_SEPARATOR, strlen(ID_SEPARATOR));
@@ -1230,7 +1265,7 @@ namespace dmGameObject
                 }
 
                 // world transforms need to be up to date in time for the script init calls
-                collection->m_WorldTransforms[new_instances[i]->m_Index] = dmTransform::ToMatrix4(new_instances[i]->m_Transform);
+                StoreWorldTransform(collection, new_instances[i]->m_Index, dmTransform::ToMatrix4(new_instances[i]->m_Transform));
             }
         }
 
@@ -1580,21 +1615,20 @@ namespace dmGameObject
             assert(collection->m_Instances[instance->m_Index] == instance);
 
             // Update world transforms since some components might need them in their init-callback
-            Matrix4* trans = &collection->m_WorldTransforms[instance->m_Index];
             if (instance->m_Parent == INVALID_INSTANCE_INDEX)
             {
-                *trans = dmTransform::ToMatrix4(instance->m_Transform);
+                StoreWorldTransform(collection, instance->m_Index, dmTransform::ToMatrix4(instance->m_Transform));
             }
             else
             {
                 const Matrix4* parent_trans = &collection->m_WorldTransforms[instance->m_Parent];
                 if (instance->m_ScaleAlongZ)
                 {
-                    *trans = (*parent_trans) * dmTransform::ToMatrix4(instance->m_Transform);
+                    StoreWorldTransform(collection, instance->m_Index, (*parent_trans) * dmTransform::ToMatrix4(instance->m_Transform));
                 }
                 else
                 {
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, dmTransform::ToMatrix4(instance->m_Transform));
+                    StoreWorldTransform(collection, instance->m_Index, dmTransform::MulNoScaleZ(*parent_trans, dmTransform::ToMatrix4(instance->m_Transform)));
                 }
             }
             return InitComponents(collection, instance);
@@ -2146,14 +2180,13 @@ namespace dmGameObject
 
                 if (sp->m_KeepWorldTransform == 0)
                 {
-                    Matrix4& world = collection->m_WorldTransforms[instance->m_Index];
                     if (instance->m_ScaleAlongZ)
                     {
-                        world = parent_t * dmTransform::ToMatrix4(instance->m_Transform);
+                        StoreWorldTransform(collection, instance->m_Index, parent_t * dmTransform::ToMatrix4(instance->m_Transform));
                     }
                     else
                     {
-                        world = dmTransform::MulNoScaleZ(parent_t, dmTransform::ToMatrix4(instance->m_Transform));
+                        StoreWorldTransform(collection, instance->m_Index, dmTransform::MulNoScaleZ(parent_t, dmTransform::ToMatrix4(instance->m_Transform)));
                     }
                 }
                 else
@@ -2348,7 +2381,7 @@ namespace dmGameObject
             uint16_t index = root_level[i];
             Instance* instance = collection->m_Instances[index];
             CheckEuler(instance);
-            collection->m_WorldTransforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
+            StoreWorldTransform(collection, index, dmTransform::ToMatrix4(instance->m_Transform));
             uint16_t parent_index = instance->m_Parent;
             assert(parent_index == INVALID_INSTANCE_INDEX);
         }
@@ -2364,14 +2397,13 @@ namespace dmGameObject
                     uint16_t index = level[i];
                     Instance* instance = collection->m_Instances[index];
                     CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
 
                     uint16_t parent_index = instance->m_Parent;
                     assert(parent_index != INVALID_INSTANCE_INDEX);
 
                     Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
                     Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = *parent_trans * own;
+                    StoreWorldTransform(collection, index, *parent_trans * own);
                 }
             }
         } else {
@@ -2384,14 +2416,13 @@ namespace dmGameObject
                     uint16_t index = level[i];
                     Instance* instance = collection->m_Instances[index];
                     CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
 
                     uint16_t parent_index = instance->m_Parent;
                     assert(parent_index != INVALID_INSTANCE_INDEX);
 
                     Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
                     Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, own);
+                    StoreWorldTransform(collection, index, dmTransform::MulNoScaleZ(*parent_trans, own));
                 }
             }
         }
@@ -2404,6 +2435,29 @@ namespace dmGameObject
         UpdateTransforms(hcollection->m_Collection);
     }
 
+    uint32_t GetTransformIndex(HInstance instance)
+    {
+        return instance->m_Index;
+    }
+
+    const uint16_t* GetChangedTransforms(HCollection hcollection, uint32_t* count)
+    {
+        Collection* collection = hcollection->m_Collection;
+        *count = collection->m_ChangedTransforms.Size();
+        return collection->m_ChangedTransforms.Begin();
+    }
+
+    void ClearChangedTransforms(HCollection hcollection)
+    {
+        Collection* collection = hcollection->m_Collection;
+        uint32_t count = collection->m_ChangedTransforms.Size();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            collection->m_TransformChanged[collection->m_ChangedTransforms[i]] = 0;
+        }
+        collection->m_ChangedTransforms.SetSize(0);
+    }
+
     static bool Update(Collection* collection, const UpdateContext* update_context)
     {
         DM_PROFILE(GameObject, "Update");
@@ -3020,6 +3074,20 @@ namespace dmGameObject
         instance->m_Transform.SetRotation(dmVMath::EulerToQuat(instance->m_EulerRotation));
     }
 
+    static uintptr_t* GetComponentUserDataPtr(HInstance instance, uint16_t component_index)
+    {
+        Prototype::Component* components = instance->m_Prototype->m_Components;
+        if (!components[component_index].m_Type->m_InstanceHasUserData)
+            return 0;
+        uint32_t next_component_instance_data = 0;
+        for (uint32_t i = 0; i < component_index; ++i)
+        {
+            if (components[i].m_Type->m_InstanceHasUserData)
+                ++next_component_instance_data;
+        }
+        return &instance->m_ComponentInstanceUserData[next_component_instance_data];
+    }
+
     PropertyResult GetProperty(HInstance instance, dmhash_t component_id, dmhash_t property_id, PropertyDesc& out_value)
     {
         if (instance == 0)
@@ -3163,17 +3231,7 @@ namespace dmGameObject
                 ComponentType* type = component.m_Type;
                 if (type->m_GetPropertyFunction)
                 {
-                    uintptr_t* user_data = 0;
-                    if (type->m_InstanceHasUserData)
-                    {
-                        uint32_t next_component_instance_data = 0;
-                        for (uint32_t i = 0; i < component_index; ++i)
-                        {
-                            if (components[i].m_Type->m_InstanceHasUserData)
-                                ++next_component_instance_data;
-                        }
-                        user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
-                    }
+                    uintptr_t* user_data = GetComponentUserDataPtr(instance, component_index);
                     ComponentGetPropertyParams p;
                     p.m_Context = type->m_Context;
                     p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
@@ -3363,17 +3421,7 @@ namespace dmGameObject
                 ComponentType* type = component.m_Type;
                 if (type->m_SetPropertyFunction)
                 {
-                    uintptr_t* user_data = 0;
-                    if (type->m_InstanceHasUserData)
-                    {
-                        uint32_t next_component_instance_data = 0;
-                        for (uint32_t i = 0; i < component_index; ++i)
-                        {
-                            if (components[i].m_Type->m_InstanceHasUserData)
-                                ++next_component_instance_data;
-                        }
-                        user_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
-                    }
+                    uintptr_t* user_data = GetComponentUserDataPtr(instance, component_index);
                     ComponentSetPropertyParams p;
                     p.m_Context = type->m_Context;
                     p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
@@ -3396,6 +3444,92 @@ namespace dmGameObject
         return PROPERTY_RESULT_OK;
     }
 
+    PropertyResult GetPropertyHandle(HInstance instance, dmhash_t component_id, dmhash_t property_id, PropertyHandle& out_handle)
+    {
+        // Validates that the property exists
+        PropertyDesc desc;
+        PropertyResult result = GetProperty(instance, component_id, property_id, desc);
+        if (result != PROPERTY_RESULT_OK)
+            return result;
+
+        out_handle.m_Collection = instance->m_Collection->m_HCollection;
+        out_handle.m_UserData = 0;
+        out_handle.m_InstanceId = instance->m_Identifier;
+        out_handle.m_ComponentId = component_id;
+        out_handle.m_PropertyId = property_id;
+        out_handle.m_Generation = instance->m_Generation;
+        out_handle.m_InstanceIndex = instance->m_Index;
+        out_handle.m_ComponentIndex = 0;
+        if (component_id != 0)
+        {
+            GetComponentIndex(instance, component_id, &out_handle.m_ComponentIndex);
+            out_handle.m_UserData = GetComponentUserDataPtr(instance, out_handle.m_ComponentIndex);
+        }
+        return PROPERTY_RESULT_OK;
+    }
+
+    static HInstance GetPropertyHandleInstance(const PropertyHandle& handle)
+    {
+        if (handle.m_Generation == 0)
+            return 0;
+        HInstance instance = handle.m_Collection->m_Collection->m_Instances[handle.m_InstanceIndex];
+        if (instance == 0 || instance->m_Generation != handle.m_Generation)
+            return 0;
+        return instance;
+    }
+
+    bool IsPropertyHandleValid(const PropertyHandle& handle)
+    {
+        return GetPropertyHandleInstance(handle) != 0;
+    }
+
+    PropertyResult GetProperty(const PropertyHandle& handle, PropertyDesc& out_value)
+    {
+        HInstance instance = GetPropertyHandleInstance(handle);
+        if (instance == 0)
+            return PROPERTY_RESULT_INVALID_INSTANCE;
+        if (handle.m_ComponentId == 0)
+            return GetProperty(instance, 0, handle.m_PropertyId, out_value);
+
+        Prototype::Component& component = instance->m_Prototype->m_Components[handle.m_ComponentIndex];
+        ComponentType* type = component.m_Type;
+        ComponentGetPropertyParams p;
+        p.m_Context = type->m_Context;
+        p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
+        p.m_Instance = instance;
+        p.m_PropertyId = handle.m_PropertyId;
+        p.m_UserData = handle.m_UserData;
+        PropertyDesc prop_desc;
+        PropertyResult result = type->m_GetPropertyFunction(p, prop_desc);
+        if (result == PROPERTY_RESULT_OK)
+        {
+            out_value = prop_desc;
+        }
+        return result;
+    }
+
+    PropertyResult SetProperty(const PropertyHandle& handle, const PropertyVar& value)
+    {
+        HInstance instance = GetPropertyHandleInstance(handle);
+        if (instance == 0)
+            return PROPERTY_RESULT_INVALID_INSTANCE;
+        if (handle.m_ComponentId == 0)
+            return SetProperty(instance, 0, handle.m_PropertyId, value);
+
+        Prototype::Component& component = instance->m_Prototype->m_Components[handle.m_ComponentIndex];
+        ComponentType* type = component.m_Type;
+        if (type->m_SetPropertyFunction == 0)
+            return PROPERTY_RESULT_NOT_FOUND;
+        ComponentSetPropertyParams p;
+        p.m_Context = type->m_Context;
+        p.m_World = instance->m_Collection->m_ComponentWorlds[component.m_TypeIndex];
+        p.m_Instance = instance;
+        p.m_PropertyId = handle.m_PropertyId;
+        p.m_UserData = handle.m_UserData;
+        p.m_Value = value;
+        return type->m_SetPropertyFunction(p);
+    }
+
     // Recreate the instance at the given index with a new prototype.
     // Specifically:
     //  - recreate components and call init/final functions
@@ -3412,6 +3546,8 @@ namespace dmGameObject
             return;
         }
         new_instance->m_Collection = instance->m_Collection;
+        // The component user data is recreated, so old property handles must not match
+        new_instance->m_Generation = NextInstanceGeneration();
         // hierarchy-related
         new_instance->m_Index = instance->m_Index;
         new_instance->m_LevelIndex = instance->m_LevelIndex;
@@ -1000,6 +1000,32 @@ namespace dmGameObject
      */
     void SetDirtyTransforms(HCollection collection);
 
+    /**
+     * Get the index of the instance world transform in its collection.
+     * The index is stable for the lifetime of the instance and is the one reported by GetChangedTransforms.
+     * @param instance Instance
+     * @return Transform index, less than the max instance count of the collection
+     */
+    uint32_t GetTransformIndex(HInstance instance);
+
+    /**
+     * Get the transform indices of the instances whose world transforms have changed since the last
+     * call to ClearChangedTransforms. Each index is reported at most once. The instance at an index
+     * might have been deleted, or replaced by a new instance, since the change was recorded.
+     * The list is shared by all readers of the collection, it is meant for the single component
+     * type that keeps an external system in sync with the game objects (e.g. physics).
+     * @param collection Collection
+     * @param count Out-parameter of the number of indices
+     * @return Pointer to the indices
+     */
+    const uint16_t* GetChangedTransforms(HCollection collection, uint32_t* count);
+
+    /**
+     * Clear the list of changed transforms, see GetChangedTransforms.
+     * @param collection Collection
+     */
+    void ClearChangedTransforms(HCollection collection);
+
     /**
      * Set whether the instance should be flagged as a bone.
      * Instances flagged as bones can have their transforms updated in a batch through SetBoneTransforms.
@@ -1304,6 +1330,66 @@ namespace dmGameObject
      */
     PropertyResult SetProperty(HInstance instance, dmhash_t component_id, dmhash_t property_id, const PropertyVar& value);
 
+    /**
+     * A property of an instance or component that has been resolved once, so that it can be
+     * read and written without looking up the instance and component again.
+     * The handle is validated against the instance it was created for on every use and
+     * becomes invalid when that instance is deleted. It must not be used after its
+     * collection has been deleted.
+     */
+    struct PropertyHandle
+    {
+        /// Collection of the instance
+        HCollection m_Collection;
+        /// Component user data, 0 for game object properties or components without user data
+        uintptr_t*  m_UserData;
+        /// Id of the instance
+        dmhash_t    m_InstanceId;
+        /// Id of the component, 0 for game object properties
+        dmhash_t    m_ComponentId;
+        /// Id of the property
+        dmhash_t    m_PropertyId;
+        /// Generation of the instance when the handle was created
+        uint32_t    m_Generation;
+        /// Index of the instance in the collection
+        uint16_t    m_InstanceIndex;
+        /// Index of the component in the prototype of the instance
+        uint16_t    m_ComponentIndex;
+    };
+
+    /**
+     * Resolve a property into a handle that can be passed to GetProperty and SetProperty.
+     * @param instance Instance of the game object
+     * @param component_id Id of the component, 0 for properties of the game object itself
+     * @param property_id Id of the property
+     * @param out_handle The resolved handle
+     * @return PROPERTY_RESULT_OK if the property exists and the handle was written
+     */
+    PropertyResult GetPropertyHandle(HInstance instance, dmhash_t component_id, dmhash_t property_id, PropertyHandle& out_handle);
+
+    /**
+     * Check if the instance of a property handle still exists.
+     * @param handle Property handle
+     * @return True if the handle can be used
+     */
+    bool IsPropertyHandleValid(const PropertyHandle& handle);
+
+    /**
+     * Retrieve a property through a handle.
+     * @param handle Handle from GetPropertyHandle
+     * @param out_value Description of the retrieved property value
+     * @return PROPERTY_RESULT_OK if the out-parameters were written, PROPERTY_RESULT_INVALID_INSTANCE if the instance has been deleted
+     */
+    PropertyResult GetProperty(const PropertyHandle& handle, PropertyDesc& out_value);
+
+    /**
+     * Sets the value of a property through a handle.
+     * @param handle Handle from GetPropertyHandle
+     * @param var Value and type of the property
+     * @return PROPERTY_RESULT_OK if the value could be set, PROPERTY_RESULT_INVALID_INSTANCE if the instance has been deleted
+     */
+    PropertyResult SetProperty(const PropertyHandle& handle, const PropertyVar& value);
+
     typedef void (*AnimationStopped)(dmGameObject::HInstance instance, dmhash_t component_id, dmhash_t property_id,
                                         bool finished, void* userdata1, void* userdata2);
 
@@ -97,6 +97,7 @@ namespace dmGameObject
             m_Prototype = prototype;
             m_IdentifierIndex = INVALID_INSTANCE_POOL_INDEX;
             m_Identifier = UNNAMED_IDENTIFIER;
+            m_Generation = 0;
             dmHashInit64(&m_CollectionPathHashState, false);
             m_Depth = 0;
             m_Initialized = 0;
@@ -132,6 +133,9 @@ namespace dmGameObject
         uint32_t        m_IdentifierIndex;
         dmhash_t        m_Identifier;
 
+        // Unique for every instance that is added to a collection, used to validate PropertyHandle
+        uint32_t        m_Generation;
+
         // Collection path hash-state. Used for calculating global identifiers. Contains the hash-state for the collection-path to the instance.
         // We might, in the future, for memory reasons, move this hash-state to a data-structure shared among all instances from the same collection.
         HashState64     m_CollectionPathHashState;
@@ -264,6 +268,11 @@ namespace dmGameObject
         // Array of world transforms. Calculated using m_LevelIndices above
         dmArray<Matrix4>         m_WorldTransforms;
 
+        // Indices of instances whose world transforms changed since the last call to ClearChangedTransforms
+        dmArray<uint16_t>        m_ChangedTransforms;
+        // One entry per instance index, set while the index is present in m_ChangedTransforms
+        dmArray<uint8_t>         m_TransformChanged;
+
         // Identifier to Instance mapping
         dmHashTable64<Instance*> m_IDToInstance;
 
@@ -144,9 +144,11 @@ namespace dmGameObject
 
 #define SCRIPTINSTANCE "GOScriptInstance"
 #define SCRIPT "GOScript"
+#define PROPERTYHANDLE "GOPropertyHandle"
 
     static uint32_t SCRIPT_TYPE_HASH = 0;
     static uint32_t SCRIPTINSTANCE_TYPE_HASH = 0;
+    static uint32_t PROPERTYHANDLE_TYPE_HASH = 0;
 
     using namespace dmPropertiesDDF;
 
@@ -366,6 +368,31 @@ namespace dmGameObject
         {0, 0}
     };
 
+    static int PropertyHandle_tostring(lua_State *L)
+    {
+        PropertyHandle* handle = (PropertyHandle*)lua_touserdata(L, 1);
+        if (handle->m_ComponentId != 0)
+        {
+            lua_pushfstring(L, "PropertyHandle: %s#%s.%s", dmHashReverseSafe64(handle->m_InstanceId), dmHashReverseSafe64(handle->m_ComponentId), dmHashReverseSafe64(handle->m_PropertyId));
+        }
+        else
+        {
+            lua_pushfstring(L, "PropertyHandle: %s.%s", dmHashReverseSafe64(handle->m_InstanceId), dmHashReverseSafe64(handle->m_PropertyId));
+        }
+        return 1;
+    }
+
+    static const luaL_reg PropertyHandle_methods[] =
+    {
+        {0,0}
+    };
+
+    static const luaL_reg PropertyHandle_meta[] =
+    {
+        {"__tostring", PropertyHandle_tostring},
+        {0, 0}
+    };
+
     /**
      * Get instance utility function helper.
      * The function will use the default "this" instance by default
@@ -535,7 +562,31 @@ namespace dmGameObject
         }
     }
 
+    // Fast path for go.get/go.set with a handle from go.get_handle
+    static PropertyHandle* CheckPropertyHandle(lua_State* L, ScriptInstance* i, const char* function_name)
+    {
+        PropertyHandle* handle = (PropertyHandle*)dmScript::ToUserType(L, 1, PROPERTYHANDLE_TYPE_HASH);
+        if (handle == 0)
+        {
+            return 0;
+        }
+        // A handle from another collection might refer to a deleted collection
+        if (handle->m_Collection != i->m_Instance->m_Collection->m_HCollection)
+        {
+            luaL_error(L, "%s can only access instances within the same collection.", function_name);
+            return 0; // Actually never reached
+        }
+        if (!IsPropertyHandleValid(*handle))
+        {
+            luaL_error(L, "the instance '%s' of the property handle has been deleted", dmHashReverseSafe64(handle->m_InstanceId));
+            return 0; // Actually never reached
+        }
+        return handle;
+    }
+
     /*# gets a named property of the specified game object or component
+     *
+     * The url and property can be replaced by a handle from [ref:go.get_handle], i.e. `go.get(handle)`.
      *
      * @name go.get
      * @param url [type:string|hash|url] url of the game object or component having the property
@@ -559,6 +610,18 @@ namespace dmGameObject
     {
         ScriptInstance* i = ScriptInstance_Check(L);
         Instance* instance = i->m_Instance;
+        PropertyHandle* handle = CheckPropertyHandle(L, i, "go.get");
+        if (handle != 0)
+        {
+            dmGameObject::PropertyDesc property_desc;
+            dmGameObject::PropertyResult result = dmGameObject::GetProperty(*handle, property_desc);
+            if (result != dmGameObject::PROPERTY_RESULT_OK)
+            {
+                return luaL_error(L, "go.get failed with error code %d", result);
+            }
+            dmGameObject::LuaPushVar(L, property_desc.m_Variant);
+            return 1;
+        }
         dmMessage::URL sender;
         dmScript::GetURL(L, &sender);
         dmMessage::URL target;
@@ -631,6 +694,8 @@ namespace dmGameObject
     }
 
     /*# sets a named property of the specified game object or component
+     *
+     * The url and property can be replaced by a handle from [ref:go.get_handle], i.e. `go.set(handle, value)`.
      *
      * @name go.set
      * @param url [type:string|hash|url] url of the game object or component having the property
@@ -654,6 +719,34 @@ namespace dmGameObject
     {
         ScriptInstance* i = ScriptInstance_Check(L);
         Instance* instance = i->m_Instance;
+        PropertyHandle* handle = CheckPropertyHandle(L, i, "go.set");
+        if (handle != 0)
+        {
+            dmGameObject::PropertyVar property_var;
+            dmGameObject::PropertyResult result = dmGameObject::LuaToVar(L, 2, property_var);
+            if (result == PROPERTY_RESULT_OK)
+            {
+                result = dmGameObject::SetProperty(*handle, property_var);
+            }
+            switch (result)
+            {
+            case dmGameObject::PROPERTY_RESULT_OK:
+                return 0;
+            case PROPERTY_RESULT_UNSUPPORTED_TYPE:
+            case PROPERTY_RESULT_TYPE_MISMATCH:
+                {
+                    dmGameObject::PropertyDesc property_desc;
+                    dmGameObject::GetProperty(*handle, property_desc);
+                    return luaL_error(L, "the property '%s' of '%s' must be a %s", dmHashReverseSafe64(handle->m_PropertyId), dmHashReverseSafe64(handle->m_InstanceId), GetPropertyTypeName(property_desc.m_Variant.m_Type));
+                }
+            case dmGameObject::PROPERTY_RESULT_UNSUPPORTED_VALUE:
+                return luaL_error(L, "go.set failed because the value is unsupported");
+            case dmGameObject::PROPERTY_RESULT_UNSUPPORTED_OPERATION:
+                return luaL_error(L, "could not perform unsupported operation on '%s'", dmHashReverseSafe64(handle->m_PropertyId));
+            default:
+                return luaL_error(L, "go.set failed with error code %d", result);
+            }
+        }
         dmMessage::URL sender;
         dmScript::GetURL(L, &sender);
         dmMessage::URL target;
@@ -718,6 +811,94 @@ namespace dmGameObject
         }
     }
 
+    /*# gets a handle to a named property of the specified game object or component
+     *
+     * Resolves the game object, component and property once, so that the handle can be passed
+     * to [ref:go.get] and [ref:go.set] instead of a url and a property id. This is faster
+     * when the same property is accessed repeatedly, e.g. every frame.
+     *
+     * Using a handle after its game object has been deleted results in an error.
+     *
+     * @name go.get_handle
+     * @param url [type:string|hash|url] url of the game object or component having the property
+     * @param property [type:string|hash] id of the property
+     * @return handle [type:userdata] the property handle
+     * @examples
+     *
+     * Resolve the handles once and then move the enemies every frame:
+     *
+     * ```lua
+     * function init(self)
+     *     self.handles = {}
+     *     for i, id in ipairs(self.enemies) do
+     *         self.handles[i] = go.get_handle(id, "position.y")
+     *     end
+     * end
+     *
+     * function update(self, dt)
+     *     for _, handle in ipairs(self.handles) do
+     *         go.set(handle, go.get(handle) + dt * 10)
+     *     end
+     * end
+     * ```
+     */
+    int Script_GetHandle(lua_State* L)
+    {
+        ScriptInstance* i = ScriptInstance_Check(L);
+        Instance* instance = i->m_Instance;
+        dmMessage::URL sender;
+        dmScript::GetURL(L, &sender);
+        dmMessage::URL target;
+        dmScript::ResolveURL(L, 1, &target, &sender);
+        if (target.m_Socket != dmGameObject::GetMessageSocket(i->m_Instance->m_Collection->m_HCollection))
+        {
+            return luaL_error(L, "go.get_handle can only access instances within the same collection.");
+        }
+        dmhash_t property_id = 0;
+        if (lua_isstring(L, 2))
+        {
+            property_id = dmHashString64(lua_tostring(L, 2));
+        }
+        else
+        {
+            property_id = dmScript::CheckHash(L, 2);
+        }
+        dmGameObject::HInstance target_instance = dmGameObject::GetInstanceFromIdentifier(dmGameObject::GetCollection(instance), target.m_Path);
+        if (target_instance == 0)
+            return luaL_error(L, "Could not find any instance with id '%s'.", dmHashReverseSafe64(target.m_Path));
+        PropertyHandle handle;
+        dmGameObject::PropertyResult result = dmGameObject::GetPropertyHandle(target_instance, target.m_Fragment, property_id, handle);
+        switch (result)
+        {
+        case dmGameObject::PROPERTY_RESULT_OK:
+            {
+                PropertyHandle* lua_handle = (PropertyHandle*)lua_newuserdata(L, sizeof(PropertyHandle));
+                *lua_handle = handle;
+                luaL_getmetatable(L, PROPERTYHANDLE);
+                lua_setmetatable(L, -2);
+                return 1;
+            }
+        case dmGameObject::PROPERTY_RESULT_NOT_FOUND:
+            {
+                const char* path = dmHashReverseSafe64(target.m_Path);
+                const char* property = dmHashReverseSafe64(property_id);
+                if (target.m_Fragment)
+                {
+                    return luaL_error(L, "'%s#%s' does not have any property called '%s'", path, dmHashReverseSafe64(target.m_Fragment), property);
+                }
+                else
+                {
+                    return luaL_error(L, "'%s' does not have any property called '%s'", path, property);
+                }
+            }
+        case dmGameObject::PROPERTY_RESULT_COMP_NOT_FOUND:
+            return luaL_error(L, "could not find component '%s' when resolving '%s'", dmHashReverseSafe64(target.m_Fragment), lua_tostring(L, 1));
+        default:
+            // Should never happen, programmer error
+            return luaL_error(L, "go.get_handle failed with error code %d", result);
+        }
+    }
+
     /*# gets the position of a game object instance
      * The position is relative the parent (if any). Use [ref:go.get_world_position] to retrieve the global world position.
      *
@@ -1867,6 +2048,7 @@ namespace dmGameObject
     {
         {"get",                     Script_Get},
         {"set",                     Script_Set},
+        {"get_handle",              Script_GetHandle},
         {"get_position",            Script_GetPosition},
         {"get_rotation",            Script_GetRotation},
         {"get_scale",               Script_GetScale},
@@ -1904,6 +2086,8 @@ namespace dmGameObject
 
         SCRIPTINSTANCE_TYPE_HASH = dmScript::RegisterUserType(L, SCRIPTINSTANCE, ScriptInstance_methods, ScriptInstance_meta);
 
+        PROPERTYHANDLE_TYPE_HASH = dmScript::RegisterUserType(L, PROPERTYHANDLE, PropertyHandle_methods, PropertyHandle_meta);
+
         luaL_register(L, "go", GO_methods);
 
 #define SETPLAYBACK(name) \
@@ -467,6 +467,42 @@ TEST_F(AnimTest, LoadTest)
     }
 }
 
+// Animation storage grows past the previous fixed limit of 65000 animations
+TEST_F(AnimTest, GrowCapacity)
+{
+    const uint32_t count = 1000;
+    const uint32_t anims_per_instance = 18; // 4 animations each (composite + 3 elements)
+    m_UpdateContext.m_DT = 0.25f;
+    dmhash_t id = hash("position");
+    float duration = 1.0f;
+    float delay = 0.0f;
+
+    dmGameObject::HInstance* gos = new dmGameObject::HInstance[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        gos[i] = dmGameObject::New(m_Collection, "/dummy.goc");
+        for (uint32_t j = 0; j < anims_per_instance; ++j)
+        {
+            dmGameObject::PropertyVar var(Vector3((float) j, 0.0f, 0.0f));
+            dmGameObject::PropertyResult result = Animate(m_Collection, gos[i], 0, id, dmGameObject::PLAYBACK_ONCE_FORWARD, var, dmEasing::Curve(dmEasing::TYPE_LINEAR), duration, delay, 0x0, 0x0, 0x0);
+            ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, result);
+        }
+    }
+
+    // The last started animation cancels the others of the same property
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_NEAR((anims_per_instance - 1) * 0.25f, X(gos[i]), EPSILON);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::Delete(m_Collection, gos[i], false);
+    }
+    delete [] gos;
+}
+
 TEST_F(AnimTest, LinkedList)
 {
     m_UpdateContext.m_DT = 0.25f;
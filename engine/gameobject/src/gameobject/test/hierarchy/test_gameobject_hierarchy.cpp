@@ -888,6 +888,62 @@ TEST_F(HierarchyTest, TestEmptyInstance)
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+static bool HasChangedTransform(dmGameObject::HCollection collection, dmGameObject::HInstance instance)
+{
+    uint32_t count;
+    const uint16_t* changed = dmGameObject::GetChangedTransforms(collection, &count);
+    uint32_t index = dmGameObject::GetTransformIndex(instance);
+    return std::find(changed, changed + count, index) != changed + count;
+}
+
+TEST_F(HierarchyTest, TestChangedTransforms)
+{
+    dmGameObject::HInstance parent = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance child = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance other = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::SetParent(child, parent);
+    dmGameObject::SetPosition(other, Point3(1, 2, 3));
+    dmGameObject::SetDirtyTransforms(m_Collection);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_TRUE(HasChangedTransform(m_Collection, parent));
+    ASSERT_TRUE(HasChangedTransform(m_Collection, child));
+    ASSERT_TRUE(HasChangedTransform(m_Collection, other));
+
+    // Nothing moved
+    uint32_t count;
+    dmGameObject::ClearChangedTransforms(m_Collection);
+    dmGameObject::SetDirtyTransforms(m_Collection);
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    dmGameObject::GetChangedTransforms(m_Collection, &count);
+    ASSERT_EQ(0U, count);
+
+    // Moving the parent changes the child world transform too
+    dmGameObject::SetPosition(parent, Point3(4, 5, 6));
+    dmGameObject::SetDirtyTransforms(m_Collection);
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    dmGameObject::GetChangedTransforms(m_Collection, &count);
+    ASSERT_EQ(2U, count);
+    ASSERT_TRUE(HasChangedTransform(m_Collection, parent));
+    ASSERT_TRUE(HasChangedTransform(m_Collection, child));
+    ASSERT_FALSE(HasChangedTransform(m_Collection, other));
+
+    // Changes are accumulated, and reported once, until cleared
+    dmGameObject::SetPosition(parent, Point3(7, 8, 9));
+    dmGameObject::SetDirtyTransforms(m_Collection);
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    dmGameObject::GetChangedTransforms(m_Collection, &count);
+    ASSERT_EQ(2U, count);
+
+    dmGameObject::ClearChangedTransforms(m_Collection);
+    dmGameObject::GetChangedTransforms(m_Collection, &count);
+    ASSERT_EQ(0U, count);
+
+    dmGameObject::Delete(m_Collection, parent, false);
+    dmGameObject::Delete(m_Collection, child, false);
+    dmGameObject::Delete(m_Collection, other, false);
+}
+
 #undef EPSILON
 
 int main(int argc, char **argv)
@@ -519,6 +519,105 @@ TEST_F(PropsTest, PropsGetSetScript)
     dmResource::Release(m_Factory, collection);
 }
 
+TEST_F(PropsTest, PropsHandle)
+{
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/props_get_set_b.goc", dmHashString64("/b"), 0x0, 0, Point3(0.0f, 0.0f, 0.0f), Quat(0.0f, 0.0f, 0.0f, 1.0f), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    dmhash_t script_id = dmHashString64("script");
+    dmhash_t number_id = dmHashString64("number");
+    dmGameObject::PropertyDesc desc;
+
+    dmGameObject::PropertyHandle handle;
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_NOT_FOUND, dmGameObject::GetPropertyHandle(go, script_id, dmHashString64("not_found"), handle));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_COMP_NOT_FOUND, dmGameObject::GetPropertyHandle(go, dmHashString64("not_found"), number_id, handle));
+
+    // Component property
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::GetPropertyHandle(go, script_id, number_id, handle));
+    ASSERT_TRUE(dmGameObject::IsPropertyHandleValid(handle));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::GetProperty(handle, desc));
+    ASSERT_EQ(1.0, desc.m_Variant.m_Number);
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(handle, dmGameObject::PropertyVar(2.0)));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::GetProperty(go, script_id, number_id, desc));
+    ASSERT_EQ(2.0, desc.m_Variant.m_Number);
+
+    // Game object property
+    dmGameObject::PropertyHandle position_handle;
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::GetPropertyHandle(go, 0, dmHashString64("position.x"), position_handle));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(position_handle, dmGameObject::PropertyVar(3.0f)));
+    ASSERT_EQ(3.0f, dmGameObject::GetPosition(go).getX());
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_TYPE_MISMATCH, dmGameObject::SetProperty(position_handle, dmGameObject::PropertyVar(Vector3(1, 2, 3))));
+
+    dmGameObject::Delete(m_Collection, go, false);
+    dmGameObject::PostUpdate(m_Collection);
+
+    ASSERT_FALSE(dmGameObject::IsPropertyHandleValid(handle));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_INVALID_INSTANCE, dmGameObject::GetProperty(handle, desc));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_INVALID_INSTANCE, dmGameObject::SetProperty(position_handle, dmGameObject::PropertyVar(1.0f)));
+
+    // A new instance reusing the slot of the deleted one does not make the handle valid again
+    go = Spawn(m_Factory, m_Collection, "/props_get_set_b.goc", dmHashString64("/b"), 0x0, 0, Point3(0.0f, 0.0f, 0.0f), Quat(0.0f, 0.0f, 0.0f, 1.0f), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+    ASSERT_FALSE(dmGameObject::IsPropertyHandleValid(handle));
+    ASSERT_FALSE(dmGameObject::IsPropertyHandleValid(position_handle));
+
+    dmGameObject::PropertyHandle zero_handle;
+    memset(&zero_handle, 0, sizeof(zero_handle));
+    ASSERT_FALSE(dmGameObject::IsPropertyHandleValid(zero_handle));
+
+    dmGameObject::Delete(m_Collection, go, false);
+}
+
+TEST_F(PropsTest, PropsHandleMany)
+{
+    const uint32_t count = 10000;
+    dmGameObject::HCollection collection = dmGameObject::NewCollection("handles", m_Factory, m_Register, count);
+
+    dmhash_t script_id = dmHashString64("script");
+    dmhash_t number_id = dmHashString64("number");
+
+    dmArray<dmhash_t> ids;
+    ids.SetCapacity(count);
+    dmArray<dmGameObject::PropertyHandle> handles;
+    handles.SetCapacity(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char id[32];
+        dmSnPrintf(id, sizeof(id), "/go%d", i);
+        ids.Push(dmHashString64(id));
+        dmGameObject::HInstance go = Spawn(m_Factory, collection, "/props_get_set_b.goc", ids.Back(), 0x0, 0, Point3(0.0f, 0.0f, 0.0f), Quat(0.0f, 0.0f, 0.0f, 1.0f), Vector3(1, 1, 1));
+        ASSERT_NE((void*)0, go);
+        handles.SetSize(i + 1);
+        ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::GetPropertyHandle(go, script_id, number_id, handles.Back()));
+    }
+
+    dmGameObject::PropertyVar var(2.0);
+    dmGameObject::PropertyDesc desc;
+    double sum = 0.0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::HInstance go = dmGameObject::GetInstanceFromIdentifier(collection, ids[i]);
+        dmGameObject::SetProperty(go, script_id, number_id, var);
+        dmGameObject::GetProperty(go, script_id, number_id, desc);
+        sum += desc.m_Variant.m_Number;
+    }
+    ASSERT_EQ(2.0 * count, sum);
+
+    var = dmGameObject::PropertyVar(3.0);
+    sum = 0.0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::SetProperty(handles[i], var);
+        dmGameObject::GetProperty(handles[i], desc);
+        sum += desc.m_Variant.m_Number;
+    }
+    ASSERT_EQ(3.0 * count, sum);
+
+    dmGameObject::DeleteCollection(collection);
+}
+
 #define ASSERT_SPAWN_FAILS(path)\
     dmGameObject::HInstance i = Spawn(m_Factory, m_Collection, path, dmHashString64("id"), (uint8_t*)0x0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));\
     ASSERT_EQ(0, i);
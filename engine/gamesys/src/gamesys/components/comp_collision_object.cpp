@@ -36,6 +36,8 @@ namespace dmGameSystem
     const char* PHYSICS_MAX_COLLISIONS_KEY  = "physics.max_collisions";
     /// Config key to use for tweaking maximum number of contacts reported
     const char* PHYSICS_MAX_CONTACTS_KEY    = "physics.max_contacts";
+    /// Config key to use for reporting collisions through the world event buffer instead of messages
+    const char* PHYSICS_USE_EVENT_BUFFER_KEY = "physics.use_event_buffer";
 
     static const dmhash_t PROP_LINEAR_DAMPING = dmHashString64("linear_damping");
     static const dmhash_t PROP_ANGULAR_DAMPING = dmHashString64("angular_damping");
@@ -87,6 +89,9 @@ namespace dmGameSystem
         /// Linked list of joints TO this component.
         JointEndPoint* m_JointEndPoints;
 
+        /// Next collision component of the same instance, see CollisionWorld::m_InstanceComponents
+        CollisionComponent* m_NextInstanceComponent;
+
         uint16_t m_Mask;
         uint16_t m_ComponentIndex;
         // True if the physics is 3D
@@ -115,7 +120,19 @@ namespace dmGameSystem
         float m_LastDT; // Used to calculate joint reaction force and torque.
         uint8_t m_ComponentIndex;
         uint8_t m_3D : 1;
+        // Set from PhysicsContext::m_UseEventBuffer at the start of each step
+        uint8_t m_UseEventBuffer : 1;
         dmArray<CollisionComponent*> m_Components;
+        // Events reported during the last step, when m_UseEventBuffer is set
+        dmArray<CollisionEvent> m_Events;
+        // Linked lists of the collision components of each instance, indexed by instance transform index
+        dmArray<CollisionComponent*> m_InstanceComponents;
+        // Transform indices of instances with collision objects created since the last step
+        dmArray<uint16_t> m_CreatedInstances;
+        // Collision objects to sync with their game objects in the next step
+        dmArray<void*> m_DirtyObjects;
+        // Scratch buffer for batched grid shape hull updates
+        dmArray<dmPhysics::GridShapeCell> m_GridShapeCells;
     };
 
     // Forward declarations
@@ -197,6 +214,11 @@ namespace dmGameSystem
         world->m_ComponentIndex = params.m_ComponentIndex;
         world->m_3D = physics_context->m_3D;
         world->m_Components.SetCapacity(32);
+        world->m_InstanceComponents.SetCapacity(params.m_MaxInstances);
+        world->m_InstanceComponents.SetSize(params.m_MaxInstances);
+        memset(world->m_InstanceComponents.Begin(), 0, sizeof(CollisionComponent*) * params.m_MaxInstances);
+        world->m_CreatedInstances.SetCapacity(32);
+        world->m_DirtyObjects.SetCapacity(32);
         *params.m_World = world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -280,12 +302,18 @@ namespace dmGameSystem
             TextureSetResource* texture_set_resource = tile_grid_resource->m_TextureSet;
             dmGameSystemDDF::TextureSet* tile_set = texture_set_resource->m_TextureSet;
 
+            dmArray<dmPhysics::GridShapeCell>& grid_cells = world->m_GridShapeCells;
             for (uint32_t i = 0; i < shape_count; ++i)
             {
                 dmGameSystemDDF::TileLayer* layer = &tile_grid->m_Layers[i];
 
                 // Set non-empty tiles
                 uint32_t cell_count = layer->m_Cell.m_Count;
+                grid_cells.SetSize(0);
+                if (grid_cells.Capacity() < cell_count)
+                {
+                    grid_cells.SetCapacity(cell_count);
+                }
                 for (uint32_t j = 0; j < cell_count; ++j)
                 {
                     dmGameSystemDDF::TileCell* cell = &layer->m_Cell[j];
@@ -293,14 +321,17 @@ namespace dmGameSystem
 
                     if (tile < tile_set->m_ConvexHulls.m_Count && tile_set->m_ConvexHulls[tile].m_Count > 0)
                     {
-                        uint32_t cell_x = cell->m_X - tile_grid_resource->m_MinCellX;
-                        uint32_t cell_y = cell->m_Y - tile_grid_resource->m_MinCellY;
-                        dmPhysics::SetGridShapeHull(component->m_Object2D, i, cell_y, cell_x, tile, flags);
-                        uint32_t child = cell_x + tile_grid_resource->m_ColumnCount * cell_y;
-                        uint16_t group = GetGroupBitIndex(world, texture_set_resource->m_HullCollisionGroups[tile]);
-                        dmPhysics::SetCollisionObjectFilter(component->m_Object2D, i, child, group, component->m_Mask);
+                        dmPhysics::GridShapeCell grid_cell;
+                        grid_cell.m_Column = cell->m_X - tile_grid_resource->m_MinCellX;
+                        grid_cell.m_Row = cell->m_Y - tile_grid_resource->m_MinCellY;
+                        grid_cell.m_Hull = tile;
+                        grid_cell.m_Flags = flags;
+                        grid_cell.m_Group = GetGroupBitIndex(world, texture_set_resource->m_HullCollisionGroups[tile]);
+                        grid_cell.m_Mask = component->m_Mask;
+                        grid_cells.Push(grid_cell);
                     }
                 }
+                dmPhysics::SetGridShapeHulls(component->m_Object2D, i, grid_cells.Begin(), grid_cells.Size());
 
                 dmPhysics::SetGridShapeEnable(component->m_Object2D, i, layer->m_IsVisible);
             }
@@ -326,6 +357,14 @@ namespace dmGameSystem
         }
     }
 
+    // The game object might move before the next step, without being reported as changed (e.g. during init)
+    static void PushCreatedInstance(CollisionWorld* world, dmGameObject::HInstance instance)
+    {
+        if (world->m_CreatedInstances.Full())
+            world->m_CreatedInstances.OffsetCapacity(dmMath::Max(world->m_CreatedInstances.Capacity(), 32U));
+        world->m_CreatedInstances.Push((uint16_t)dmGameObject::GetTransformIndex(instance));
+    }
+
     static bool CreateCollisionObject(PhysicsContext* physics_context, CollisionWorld* world, dmGameObject::HInstance instance, CollisionComponent* component, bool enabled)
     {
         if (world == 0x0)
@@ -337,6 +376,7 @@ namespace dmGameSystem
         dmPhysics::CollisionObjectData data;
         SetCollisionObjectData(world, component, resource, ddf, enabled, data);
         component->m_Mask = data.m_Mask;
+        PushCreatedInstance(world, instance);
         if (physics_context->m_3D)
         {
             if (resource->m_TileGrid)
@@ -424,6 +464,9 @@ namespace dmGameSystem
             delete component;
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        CollisionComponent** instance_components = &world->m_InstanceComponents[dmGameObject::GetTransformIndex(params.m_Instance)];
+        component->m_NextInstanceComponent = *instance_components;
+        *instance_components = component;
         *params.m_UserData = (uintptr_t)component;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -499,6 +542,13 @@ namespace dmGameSystem
             }
         }
 
+        CollisionComponent** instance_component = &world->m_InstanceComponents[dmGameObject::GetTransformIndex(component->m_Instance)];
+        while (*instance_component != component)
+        {
+            instance_component = &(*instance_component)->m_NextInstanceComponent;
+        }
+        *instance_component = component->m_NextInstanceComponent;
+
         delete component;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -536,10 +586,33 @@ namespace dmGameSystem
         }
     }
 
+    // The event buffer has no fixed cap, it grows to hold all events of a step
+    static CollisionEvent* PushCollisionEvent(CollisionWorld* world, CollisionEventType type, CollisionComponent* component_a, uint16_t group_a, CollisionComponent* component_b, uint16_t group_b)
+    {
+        dmArray<CollisionEvent>& events = world->m_Events;
+        if (events.Full())
+        {
+            events.OffsetCapacity(dmMath::Max(events.Capacity(), 64U));
+        }
+        events.SetSize(events.Size() + 1);
+        CollisionEvent* event = &events.Back();
+        event->m_Type = (uint8_t)type;
+        event->m_IdA = dmGameObject::GetIdentifier(component_a->m_Instance);
+        event->m_IdB = dmGameObject::GetIdentifier(component_b->m_Instance);
+        event->m_GroupA = GetLSBGroupHash(world, group_a);
+        event->m_GroupB = GetLSBGroupHash(world, group_b);
+        return event;
+    }
+
     bool CollisionCallback(void* user_data_a, uint16_t group_a, void* user_data_b, uint16_t group_b, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
-        if (cud->m_Count < cud->m_Context->m_MaxCollisionCount)
+        if (cud->m_World->m_UseEventBuffer)
+        {
+            PushCollisionEvent(cud->m_World, COLLISION_EVENT_TYPE_COLLISION, (CollisionComponent*)user_data_a, group_a, (CollisionComponent*)user_data_b, group_b);
+            return true;
+        }
+        else if (cud->m_Count < cud->m_Context->m_MaxCollisionCount)
         {
             cud->m_Count += 1;
 
@@ -582,7 +655,22 @@ namespace dmGameSystem
     bool ContactPointCallback(const dmPhysics::ContactPoint& contact_point, void* user_data)
     {
         CollisionUserData* cud = (CollisionUserData*)user_data;
-        if (cud->m_Count < cud->m_Context->m_MaxContactPointCount)
+        if (cud->m_World->m_UseEventBuffer)
+        {
+            CollisionEvent* event = PushCollisionEvent(cud->m_World, COLLISION_EVENT_TYPE_CONTACT_POINT,
+                                                       (CollisionComponent*)contact_point.m_UserDataA, contact_point.m_GroupA,
+                                                       (CollisionComponent*)contact_point.m_UserDataB, contact_point.m_GroupB);
+            event->m_PositionA = contact_point.m_PositionA;
+            event->m_PositionB = contact_point.m_PositionB;
+            event->m_Normal = contact_point.m_Normal;
+            event->m_RelativeVelocity = contact_point.m_RelativeVelocity;
+            event->m_Distance = contact_point.m_Distance;
+            event->m_AppliedImpulse = contact_point.m_AppliedImpulse;
+            event->m_MassA = dmMath::Select(-contact_point.m_MassA, 0.0f, contact_point.m_MassA);
+            event->m_MassB = dmMath::Select(-contact_point.m_MassB, 0.0f, contact_point.m_MassB);
+            return true;
+        }
+        else if (cud->m_Count < cud->m_Context->m_MaxContactPointCount)
         {
             cud->m_Count += 1;
 
@@ -648,6 +736,12 @@ namespace dmGameSystem
         CollisionWorld* world = (CollisionWorld*)user_data;
         CollisionComponent* component_a = (CollisionComponent*)trigger_enter.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_enter.m_UserDataB;
+        if (world->m_UseEventBuffer)
+        {
+            PushCollisionEvent(world, COLLISION_EVENT_TYPE_TRIGGER_ENTER, component_a, trigger_enter.m_GroupA, component_b, trigger_enter.m_GroupB);
+            return;
+        }
+
         dmGameObject::HInstance instance_a = component_a->m_Instance;
         dmGameObject::HInstance instance_b = component_b->m_Instance;
         dmhash_t instance_a_id = dmGameObject::GetIdentifier(instance_a);
@@ -679,6 +773,12 @@ namespace dmGameSystem
         CollisionWorld* world = (CollisionWorld*)user_data;
         CollisionComponent* component_a = (CollisionComponent*)trigger_exit.m_UserDataA;
         CollisionComponent* component_b = (CollisionComponent*)trigger_exit.m_UserDataB;
+        if (world->m_UseEventBuffer)
+        {
+            PushCollisionEvent(world, COLLISION_EVENT_TYPE_TRIGGER_EXIT, component_a, trigger_exit.m_GroupA, component_b, trigger_exit.m_GroupB);
+            return;
+        }
+
         dmGameObject::HInstance instance_a = component_a->m_Instance;
         dmGameObject::HInstance instance_b = component_b->m_Instance;
         dmhash_t instance_a_id = dmGameObject::GetIdentifier(instance_a);
@@ -849,6 +949,35 @@ namespace dmGameSystem
     // than the current one being updated.
     //
     // TODO: Make a nicer solution for this, perhaps a per-collection physics socket
+    static void PushDirtyObjects(CollisionWorld* world, const uint16_t* indices, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // Deleted instances have no components left, and reused indices refer to the components of the new instance
+            for (CollisionComponent* c = world->m_InstanceComponents[indices[i]]; c != 0x0; c = c->m_NextInstanceComponent)
+            {
+                if (c->m_Object2D == 0x0)
+                    continue;
+                if (world->m_DirtyObjects.Full())
+                    world->m_DirtyObjects.OffsetCapacity(dmMath::Max(world->m_DirtyObjects.Capacity(), 32U));
+                world->m_DirtyObjects.Push(c->m_3D ? c->m_Object3D : c->m_Object2D);
+            }
+        }
+    }
+
+    // Collects the collision objects whose game objects moved since the last step, so that
+    // the physics world only needs to retrieve the transforms of those
+    static void GatherDirtyObjects(CollisionWorld* world, dmGameObject::HCollection collection)
+    {
+        world->m_DirtyObjects.SetSize(0);
+        uint32_t changed_count;
+        const uint16_t* changed = dmGameObject::GetChangedTransforms(collection, &changed_count);
+        PushDirtyObjects(world, changed, changed_count);
+        dmGameObject::ClearChangedTransforms(collection);
+        PushDirtyObjects(world, world->m_CreatedInstances.Begin(), world->m_CreatedInstances.Size());
+        world->m_CreatedInstances.SetSize(0);
+    }
+
     bool CompCollisionObjectDispatchPhysicsMessages(PhysicsContext *physics_context, CollisionWorld *world, dmGameObject::HCollection collection)
     {
         DispatchContext dispatch_context;
@@ -901,6 +1030,7 @@ namespace dmGameSystem
                     dmPhysics::DeleteCollisionObject2D(world->m_World2D, c->m_Object2D);
                     dmArray<dmPhysics::HCollisionShape2D>& shapes = resource->m_TileGridResource->m_GridShapes;
                     c->m_Object2D = dmPhysics::NewCollisionObject2D(world->m_World2D, data, &shapes.Front(), shapes.Size());
+                    PushCreatedInstance(world, c->m_Instance);
 
                     SetupEmptyTileGrid(world, c);
                     SetupTileGrid(world, c);
@@ -909,6 +1039,13 @@ namespace dmGameSystem
             }
         }
 
+        world->m_UseEventBuffer = physics_context->m_UseEventBuffer;
+        world->m_Events.SetSize(0);
+        if (world->m_UseEventBuffer && world->m_Events.Capacity() == 0)
+        {
+            world->m_Events.SetCapacity(dmMath::Max(physics_context->m_MaxCollisionCount + physics_context->m_MaxContactPointCount, 64U));
+        }
+
         CollisionUserData collision_user_data;
         collision_user_data.m_World = world;
         collision_user_data.m_Context = physics_context;
@@ -931,6 +1068,11 @@ namespace dmGameSystem
         step_world_context.m_RayCastCallback = RayCastCallback;
         step_world_context.m_RayCastUserData = world;
 
+        GatherDirtyObjects(world, params.m_Collection);
+        step_world_context.m_DirtyCollisionObjects = world->m_DirtyObjects.Begin();
+        step_world_context.m_DirtyCollisionObjectCount = world->m_DirtyObjects.Size();
+        step_world_context.m_SyncDirtyOnly = 1;
+
         world->m_LastDT = params.m_UpdateContext->m_DT;
 
         g_NumPhysicsTransformsUpdated = 0;
@@ -946,29 +1088,33 @@ namespace dmGameSystem
 
         update_result.m_TransformsUpdated = g_NumPhysicsTransformsUpdated > 0;
 
-        if (collision_user_data.m_Count >= physics_context->m_MaxCollisionCount)
+        // The event buffer grows as needed, so only messages can be lost
+        if (!world->m_UseEventBuffer)
         {
-            if (!g_CollisionOverflowWarning)
+            if (collision_user_data.m_Count >= physics_context->m_MaxCollisionCount)
             {
-                dmLogWarning("Maximum number of collisions (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxCollisionCount, PHYSICS_MAX_COLLISIONS_KEY);
-                g_CollisionOverflowWarning = true;
+                if (!g_CollisionOverflowWarning)
+                {
+                    dmLogWarning("Maximum number of collisions (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxCollisionCount, PHYSICS_MAX_COLLISIONS_KEY);
+                    g_CollisionOverflowWarning = true;
+                }
             }
-        }
-        else
-        {
-            g_CollisionOverflowWarning = false;
-        }
-        if (contact_user_data.m_Count >= physics_context->m_MaxContactPointCount)
-        {
-            if (!g_ContactOverflowWarning)
+            else
             {
-                dmLogWarning("Maximum number of contacts (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxContactPointCount, PHYSICS_MAX_CONTACTS_KEY);
-                g_ContactOverflowWarning = true;
+                g_CollisionOverflowWarning = false;
+            }
+            if (contact_user_data.m_Count >= physics_context->m_MaxContactPointCount)
+            {
+                if (!g_ContactOverflowWarning)
+                {
+                    dmLogWarning("Maximum number of contacts (%d) reached, messages have been lost. Tweak \"%s\" in the config file.", physics_context->m_MaxContactPointCount, PHYSICS_MAX_CONTACTS_KEY);
+                    g_ContactOverflowWarning = true;
+                }
+            }
+            else
+            {
+                g_ContactOverflowWarning = false;
             }
-        }
-        else
-        {
-            g_ContactOverflowWarning = false;
         }
         if (physics_context->m_3D)
             dmPhysics::SetDrawDebug3D(world->m_World3D, physics_context->m_Debug);
@@ -993,6 +1139,66 @@ namespace dmGameSystem
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
+    // Applies the hulls in runs of the same shape so that each run only refreshes the touched cells
+    static bool SetGridShapeHulls(CollisionWorld* world, CollisionComponent* component, const dmPhysicsDDF::SetGridShapeHull* hulls, uint32_t hull_count)
+    {
+        TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
+        dmArray<dmPhysics::GridShapeCell>& grid_cells = world->m_GridShapeCells;
+        grid_cells.SetSize(0);
+        if (grid_cells.Capacity() < hull_count)
+        {
+            grid_cells.SetCapacity(hull_count);
+        }
+
+        bool result = true;
+        uint32_t shape = hull_count > 0 ? hulls[0].m_Shape : 0;
+        for (uint32_t i = 0; i < hull_count; ++i)
+        {
+            const dmPhysicsDDF::SetGridShapeHull* ddf = &hulls[i];
+            if (ddf->m_Shape != shape)
+            {
+                dmPhysics::SetGridShapeHulls(component->m_Object2D, shape, grid_cells.Begin(), grid_cells.Size());
+                grid_cells.SetSize(0);
+                shape = ddf->m_Shape;
+            }
+
+            uint32_t column = ddf->m_Column;
+            uint32_t row = ddf->m_Row;
+            uint32_t hull = ddf->m_Hull;
+
+            if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+            {
+                dmLogError("SetGridShapeHull: <row,column> out of bounds");
+                result = false;
+                continue;
+            }
+            if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+            {
+                dmLogError("SetGridShapHull: specified hull index is out of bounds.");
+                result = false;
+                continue;
+            }
+
+            dmPhysics::GridShapeCell grid_cell;
+            grid_cell.m_Row = row;
+            grid_cell.m_Column = column;
+            grid_cell.m_Hull = hull;
+            grid_cell.m_Flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
+            grid_cell.m_Flags.m_FlipVertical = ddf->m_FlipVertical;
+            grid_cell.m_Group = 0;
+            grid_cell.m_Mask = 0;
+            // Hull-index of 0xffffffff is empty cell
+            if (hull != ~0u)
+            {
+                grid_cell.m_Group = GetGroupBitIndex(world, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull]);
+                grid_cell.m_Mask = component->m_Mask;
+            }
+            grid_cells.Push(grid_cell);
+        }
+        dmPhysics::SetGridShapeHulls(component->m_Object2D, shape, grid_cells.Begin(), grid_cells.Size());
+        return result;
+    }
+
     dmGameObject::UpdateResult CompCollisionObjectOnMessage(const dmGameObject::ComponentOnMessageParams& params)
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
@@ -1061,7 +1267,8 @@ namespace dmGameSystem
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
         }
-        else if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash)
+        else if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash ||
+                 params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash)
         {
             if (physics_context->m_3D)
             {
@@ -1073,38 +1280,30 @@ namespace dmGameSystem
                 dmLogError("Hulls can only be set for collision objects with tile grids as shape.");
                 return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            dmPhysicsDDF::SetGridShapeHull* ddf = (dmPhysicsDDF::SetGridShapeHull*) params.m_Message->m_Data;
-            uint32_t column = ddf->m_Column;
-            uint32_t row = ddf->m_Row;
-            uint32_t hull = ddf->m_Hull;
 
-            TileGridResource* tile_grid_resource = component->m_Resource->m_TileGridResource;
-
-            if (row >= tile_grid_resource->m_RowCount || column >= tile_grid_resource->m_ColumnCount)
+            const dmPhysicsDDF::SetGridShapeHull* hulls;
+            uint32_t hull_count;
+            if (params.m_Message->m_Id == dmPhysicsDDF::SetGridShapeHull::m_DDFDescriptor->m_NameHash)
             {
-                dmLogError("SetGridShapeHull: <row,column> out of bounds");
-                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                hulls = (dmPhysicsDDF::SetGridShapeHull*) params.m_Message->m_Data;
+                hull_count = 1;
             }
-            if (hull != ~0u && hull >= tile_grid_resource->m_TextureSet->m_HullCollisionGroups.Size())
+            else
             {
-                dmLogError("SetGridShapHull: specified hull index is out of bounds.");
-                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                dmPhysicsDDF::SetGridShapeHulls* ddf = (dmPhysicsDDF::SetGridShapeHulls*) params.m_Message->m_Data;
+                hulls = (dmPhysicsDDF::SetGridShapeHull*) (ddf + 1);
+                hull_count = ddf->m_CellCount;
+                if (sizeof(*ddf) + hull_count * sizeof(*hulls) > params.m_Message->m_DataSize)
+                {
+                    dmLogError("SetGridShapeHulls: message data is truncated");
+                    return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+                }
             }
 
-            dmPhysics::HullFlags flags;
-            flags.m_FlipHorizontal = ddf->m_FlipHorizontal;
-            flags.m_FlipVertical = ddf->m_FlipVertical;
-            dmPhysics::SetGridShapeHull(component->m_Object2D, ddf->m_Shape, row, column, hull, flags);
-            uint16_t child = column + tile_grid_resource->m_ColumnCount * row;
-            uint16_t group = 0;
-            uint16_t mask = 0;
-            // Hull-index of 0xffffffff is empty cell
-            if (hull != ~0u)
+            if (!SetGridShapeHulls((CollisionWorld*)params.m_World, component, hulls, hull_count))
             {
-                group = GetGroupBitIndex((CollisionWorld*)params.m_World, tile_grid_resource->m_TextureSet->m_HullCollisionGroups[hull]);
-                mask = component->m_Mask;
+                return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
             }
-            dmPhysics::SetCollisionObjectFilter(component->m_Object2D, ddf->m_Shape, child, group, mask);
         }
         else if(params.m_Message->m_Id == dmPhysicsDDF::EnableGridShapeLayer::m_DDFDescriptor->m_NameHash)
         {
@@ -1240,6 +1439,32 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, count, responses);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, count, responses);
+        }
+    }
+
+    void OverlapBatch(void* _world, const dmPhysics::OverlapRequest* requests, uint32_t count, dmPhysics::OverlapResponse* responses, dmArray<dmPhysics::OverlapHit>& hits)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        if (world->m_3D)
+        {
+            dmPhysics::OverlapBatch3D(world->m_World3D, requests, count, responses, hits);
+        }
+        else
+        {
+            dmPhysics::OverlapBatch2D(world->m_World2D, requests, count, responses, hits);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
@@ -1540,6 +1765,13 @@ namespace dmGameSystem
         return !world->m_3D;
     }
 
+    const CollisionEvent* GetCollisionEvents(void* _world, uint32_t* count)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        *count = world->m_Events.Size();
+        return world->m_Events.Begin();
+    }
+
     void SetCollisionFlipH(void* _component, bool flip)
     {
         CollisionComponent* component = (CollisionComponent*)_component;
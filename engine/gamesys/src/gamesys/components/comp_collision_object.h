@@ -22,6 +22,40 @@ template <typename T> class dmArray;
 
 namespace dmGameSystem
 {
+    /// Type of a CollisionEvent
+    enum CollisionEventType
+    {
+        COLLISION_EVENT_TYPE_COLLISION      = 0,
+        COLLISION_EVENT_TYPE_CONTACT_POINT  = 1,
+        COLLISION_EVENT_TYPE_TRIGGER_ENTER  = 2,
+        COLLISION_EVENT_TYPE_TRIGGER_EXIT   = 3,
+    };
+
+    /**
+     * Collision, contact point or trigger event stored in the world event buffer
+     * when PhysicsContext::m_UseEventBuffer is set. One event is stored per pair,
+     * where the contact point data is given as reported to object B in a
+     * contact_point_response message, i.e. the normal points from A towards B.
+     */
+    struct CollisionEvent
+    {
+        // Only valid for contact points
+        Vectormath::Aos::Point3     m_PositionA;
+        Vectormath::Aos::Point3     m_PositionB;
+        Vectormath::Aos::Vector3    m_Normal;
+        Vectormath::Aos::Vector3    m_RelativeVelocity;
+        float                       m_Distance;
+        float                       m_AppliedImpulse;
+        float                       m_MassA;
+        float                       m_MassB;
+
+        dmhash_t                    m_IdA;
+        dmhash_t                    m_IdB;
+        dmhash_t                    m_GroupA;
+        dmhash_t                    m_GroupB;
+        uint8_t                     m_Type; // CollisionEventType
+    };
+
     dmGameObject::CreateResult CompCollisionObjectNewWorld(const dmGameObject::ComponentNewWorldParams& params);
 
     dmGameObject::CreateResult CompCollisionObjectDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params);
@@ -50,6 +84,8 @@ namespace dmGameSystem
 
     // For script_physics.cpp
     void RayCast(void* world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    void RayCastBatch(void* world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
+    void OverlapBatch(void* world, const dmPhysics::OverlapRequest* requests, uint32_t count, dmPhysics::OverlapResponse* responses, dmArray<dmPhysics::OverlapHit>& hits);
     uint64_t GetLSBGroupHash(void* world, uint16_t mask);
     dmhash_t CompCollisionObjectGetIdentifier(void* component);
 
@@ -65,6 +101,8 @@ namespace dmGameSystem
     Vectormath::Aos::Vector3 GetGravity(void* _world);
 
     bool IsCollision2D(void* _world);
+    /// Events reported during the last step of the world, empty unless PhysicsContext::m_UseEventBuffer is set
+    const CollisionEvent* GetCollisionEvents(void* world, uint32_t* count);
     void SetCollisionFlipH(void* _component, bool flip);
     void SetCollisionFlipV(void* _component, bool flip);
 }
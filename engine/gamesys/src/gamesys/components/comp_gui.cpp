@@ -635,6 +635,16 @@ namespace dmGameSystem
             dmLogError("Could not send spine_event to listener.");
     }
 
+    static void DeleteNodeVertexCaches(GuiComponent* gui_component)
+    {
+        dmArray<GuiNodeVertexCache>& caches = gui_component->m_NodeVertexCaches;
+        for (uint32_t i = 0; i < caches.Size(); ++i)
+        {
+            free(caches[i].m_Vertices);
+        }
+        caches.SetSize(0);
+    }
+
     dmGameObject::CreateResult CompGuiDestroy(const dmGameObject::ComponentDestroyParams& params)
     {
         GuiWorld* gui_world = (GuiWorld*)params.m_World;
@@ -646,6 +656,7 @@ namespace dmGameSystem
                 if (gui_component->m_Material) {
                     dmResource::Release(dmGameObject::GetFactory(params.m_Instance), gui_component->m_Material);
                 }
+                DeleteNodeVertexCaches(gui_component);
                 dmGui::DeleteScene(gui_component->m_Scene);
                 delete gui_component;
                 gui_world->m_Components.EraseSwap(i);
@@ -695,6 +706,9 @@ namespace dmGameSystem
 
         // true if the stencil is the first rendered (per scene)
         bool                        m_FirstStencil;
+
+        // Number of box and pie nodes whose vertices were copied from the vertex cache (per scene)
+        uint32_t                    m_VertexCacheHits;
     };
 
     inline uint32_t MakeFinalRenderOrder(uint32_t scene_order, uint32_t sub_order)
@@ -1057,6 +1071,257 @@ namespace dmGameSystem
         gui_world->m_ClientVertexBuffer.SetSize(vb_end - gui_world->m_ClientVertexBuffer.Begin());
     }
 
+    static GuiNodeVertexCache* GetNodeVertexCache(GuiComponent* gui_component, dmGui::HScene scene, dmGui::HNode node)
+    {
+        dmArray<GuiNodeVertexCache>& caches = gui_component->m_NodeVertexCaches;
+        uint32_t index = dmGui::GetNodeIndex(scene, node);
+        if (index >= caches.Size())
+        {
+            uint32_t old_size = caches.Size();
+            if (index >= caches.Capacity())
+            {
+                caches.SetCapacity(dmMath::Max(index + 1, caches.Capacity() * 2));
+            }
+            caches.SetSize(index + 1);
+            memset(&caches[old_size], 0, (index + 1 - old_size) * sizeof(GuiNodeVertexCache));
+        }
+        return &caches[index];
+    }
+
+    // Appends the vertices from the last time the node was rendered, if it was rendered with the same key
+    static bool PushCachedNodeVertices(GuiComponent* gui_component, dmGui::HScene scene, dmGui::HNode node, const GuiNodeVertexCacheKey& key, dmArray<BoxVertex>& vertices)
+    {
+        GuiNodeVertexCache* cache = GetNodeVertexCache(gui_component, scene, node);
+        if (cache->m_Node != node || memcmp(&cache->m_Key, &key, sizeof(key)) != 0)
+        {
+            return false;
+        }
+
+        uint32_t count = cache->m_VertexCount;
+        if (vertices.Remaining() < count)
+        {
+            vertices.OffsetCapacity(dmMath::Max(128U, count));
+        }
+        uint32_t size = vertices.Size();
+        vertices.SetSize(size + count);
+        memcpy(vertices.Begin() + size, cache->m_Vertices, count * sizeof(BoxVertex));
+        return true;
+    }
+
+    static void CacheNodeVertices(GuiComponent* gui_component, dmGui::HScene scene, dmGui::HNode node, const GuiNodeVertexCacheKey& key, const BoxVertex* vertices, uint32_t count)
+    {
+        GuiNodeVertexCache* cache = GetNodeVertexCache(gui_component, scene, node);
+        if (cache->m_VertexCapacity < count)
+        {
+            cache->m_Vertices = (BoxVertex*)realloc(cache->m_Vertices, count * sizeof(BoxVertex));
+            cache->m_VertexCapacity = count;
+        }
+        memcpy(cache->m_Vertices, vertices, count * sizeof(BoxVertex));
+        cache->m_VertexCount = count;
+        cache->m_Node = node;
+        cache->m_Key = key;
+    }
+
+    // Generates the vertices of a single box node, see RenderBoxNodes
+    static void GenerateBoxNodeVertices(dmGui::HScene scene, dmGui::HNode node, const Matrix4& transform, const Vector4& pm_color,
+                                        const Point3& size, const float* tc, bool manually_set_texture, const Vector4& slice9, bool use_slice_nine,
+                                        bool flip_u, bool flip_v, dmGraphics::HTexture texture, float org_width, float org_height,
+                                        dmArray<BoxVertex>& vertices)
+    {
+        // render simple quad ignoring 9-slicing
+        if ((!use_slice_nine && manually_set_texture) || !texture)
+        {
+            BoxVertex v00;
+            v00.SetColor(pm_color);
+            v00.SetPosition(transform * Vectormath::Aos::Point3(0, 0, 0));
+            v00.SetUV(0, 0);
+
+            BoxVertex v10;
+            v10.SetColor(pm_color);
+            v10.SetPosition(transform * Vectormath::Aos::Point3(1, 0, 0));
+            v10.SetUV(1, 0);
+
+            BoxVertex v01;
+            v01.SetColor(pm_color);
+            v01.SetPosition(transform * Vectormath::Aos::Point3(0, 1, 0));
+            v01.SetUV(0, 1);
+
+            BoxVertex v11;
+            v11.SetColor(pm_color);
+            v11.SetPosition(transform * Vectormath::Aos::Point3(1, 1, 0));
+            v11.SetUV(1, 1);
+
+            vertices.Push(v00);
+            vertices.Push(v10);
+            vertices.Push(v11);
+            vertices.Push(v00);
+            vertices.Push(v11);
+            vertices.Push(v01);
+
+            return;
+        }
+
+        dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
+        dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
+        bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
+
+        // render using geometries without 9-slicing
+        if (!use_slice_nine && use_geometries)
+        {
+            int32_t frame_index = dmGui::GetNodeAnimationFrame(scene, node);
+            frame_index = texture_set_ddf->m_FrameIndices[frame_index];
+
+            const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+
+            const Matrix4& w = transform;
+
+            // NOTE: The original rendering code is from the comp_sprite.cpp.
+            // Compare with that one if you do any changes to either.
+            uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+
+            const float* points = geometry->m_Vertices.m_Data;
+            const float* uvs = geometry->m_Uvs.m_Data;
+
+            // Depending on the sprite is flipped or not, we loop the vertices forward or backward
+            // to respect face winding (and backface culling)
+            int reverse = (int)flip_u ^ (int)flip_v;
+
+            float scaleX = flip_u ? -1 : 1;
+            float scaleY = flip_v ? -1 : 1;
+
+            // Since we don't use an index buffer, we duplicate the vertices manually
+            uint32_t index_count = geometry->m_Indices.m_Count;
+            for (uint32_t index = 0; index < index_count; ++index)
+            {
+                uint32_t i = geometry->m_Indices.m_Data[index];
+                i = reverse ? (num_points - i - 1) : i;
+
+                const float* point = &points[i * 2];
+                const float* uv = &uvs[i * 2];
+                // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
+                float x = point[0] * scaleX + 0.5f;
+                float y = point[1] * scaleY + 0.5f;
+
+                Vector4 p = w * Point3(x, y, 0.0f);
+                BoxVertex v(p, uv[0], uv[1], pm_color);
+                vertices.Push(v);
+            }
+
+            return;
+        }
+
+        // render 9-sliced node
+
+        //   0 1     2 3
+        // 0 *-*-----*-*
+        //   | |  y  | |
+        // 1 *-*-----*-*
+        //   | |     | |
+        //   |x|     |z|
+        //   | |     | |
+        // 2 *-*-----*-*
+        //   | |  w  | |
+        // 3 *-*-----*-*
+        float us[4], vs[4], xs[4], ys[4];
+
+        // v are '1-v'
+        xs[0] = ys[0] = 0;
+        xs[3] = ys[3] = 1;
+
+        // disable slice9 computation below a certain dimension
+        // (avoid div by zero)
+        const float s9_min_dim = 0.001f;
+
+        const float su = 1.0f / org_width;
+        const float sv = 1.0f / org_height;
+
+        const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
+        const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+
+        static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
+        bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+        if(uv_rotated)
+        {
+            const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getW());
+            us[uI[2]] = tc[2] - (su * slice9.getY());
+            us[uI[3]] = tc[2];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] - (sv * slice9.getX());
+            vs[vI[2]] = tc[5] + (sv * slice9.getZ());
+            vs[vI[3]] = tc[5];
+        }
+        else
+        {
+            const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getX());
+            us[uI[2]] = tc[4] - (su * slice9.getZ());
+            us[uI[3]] = tc[4];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] + (sv * slice9.getW());
+            vs[vI[2]] = tc[3] - (sv * slice9.getY());
+            vs[vI[3]] = tc[3];
+        }
+
+        xs[1] = sx * slice9.getX();
+        xs[2] = 1 - sx * slice9.getZ();
+        ys[1] = sy * slice9.getW();
+        ys[2] = 1 - sy * slice9.getY();
+
+        Vectormath::Aos::Vector4 pts[4][4];
+        for (int y=0;y<4;y++)
+        {
+            for (int x=0;x<4;x++)
+            {
+                pts[y][x] = (transform * Vectormath::Aos::Point3(xs[x], ys[y], 0));
+            }
+        }
+
+        BoxVertex v00, v10, v01, v11;
+        v00.SetColor(pm_color);
+        v10.SetColor(pm_color);
+        v01.SetColor(pm_color);
+        v11.SetColor(pm_color);
+        for (int y=0;y<3;y++)
+        {
+            for (int x=0;x<3;x++)
+            {
+                const int x0 = x;
+                const int x1 = x+1;
+                const int y0 = y;
+                const int y1 = y+1;
+                v00.SetPosition(pts[y0][x0]);
+                v10.SetPosition(pts[y0][x1]);
+                v01.SetPosition(pts[y1][x0]);
+                v11.SetPosition(pts[y1][x1]);
+                if(uv_rotated)
+                {
+                    v00.SetUV(us[y0], vs[x0]);
+                    v10.SetUV(us[y0], vs[x1]);
+                    v01.SetUV(us[y1], vs[x0]);
+                    v11.SetUV(us[y1], vs[x1]);
+                }
+                else
+                {
+                    v00.SetUV(us[x0], vs[y0]);
+                    v10.SetUV(us[x1], vs[y0]);
+                    v01.SetUV(us[x0], vs[y1]);
+                    v11.SetUV(us[x1], vs[y1]);
+                }
+                vertices.Push(v00);
+                vertices.Push(v10);
+                vertices.Push(v11);
+                vertices.Push(v00);
+                vertices.Push(v11);
+                vertices.Push(v01);
+            }
+        }
+    }
+
     void RenderBoxNodes(dmGui::HScene scene,
                         const dmGui::RenderEntry* entries,
                         const Matrix4* node_transforms,
@@ -1114,6 +1379,9 @@ namespace dmGameSystem
         float org_height = (float)dmGraphics::GetOriginalTextureHeight(ro.m_Textures[0]);
         assert(org_width > 0 && org_height > 0);
 
+        GuiComponent* gui_component = (GuiComponent*)dmGui::GetSceneUserData(scene);
+        dmArray<BoxVertex>& vertices = gui_world->m_ClientVertexBuffer;
+
         int rendered_vert_count = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
@@ -1140,227 +1408,185 @@ namespace dmGameSystem
             Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
             bool use_slice_nine = sum(slice9) != 0;
 
-            // render simple quad ignoring 9-slicing
-            if ((!use_slice_nine && manually_set_texture) || !texture)
-            {
-                BoxVertex v00;
-                v00.SetColor(pm_color);
-                v00.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(0, 0, 0));
-                v00.SetUV(0, 0);
-
-                BoxVertex v10;
-                v10.SetColor(pm_color);
-                v10.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(1, 0, 0));
-                v10.SetUV(1, 0);
-
-                BoxVertex v01;
-                v01.SetColor(pm_color);
-                v01.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(0, 1, 0));
-                v01.SetUV(0, 1);
-
-                BoxVertex v11;
-                v11.SetColor(pm_color);
-                v11.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(1, 1, 0));
-                v11.SetUV(1, 1);
-
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v10);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v01);
-
-                rendered_vert_count += 6;
-                continue;
-            }
-
-            dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
-            dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
-            bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
-
             bool flip_u = false;
             bool flip_v = false;
             if (!manually_set_texture)
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
 
-            // render using geometries without 9-slicing
-            if (!use_slice_nine && use_geometries)
+            GuiNodeVertexCacheKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform = node_transforms[i];
+            key.m_Color = pm_color;
+            key.m_Slice9 = slice9;
+            Point3 size = dmGui::GetNodeSize(scene, node);
+            key.m_Size[0] = size.getX();
+            key.m_Size[1] = size.getY();
+            memcpy(key.m_TexCoords, tc, sizeof(key.m_TexCoords));
+            key.m_TextureSize[0] = org_width;
+            key.m_TextureSize[1] = org_height;
+            key.m_Texture = texture;
+            key.m_Frame = dmGui::GetNodeAnimationFrame(scene, node);
+            key.m_HasTexCoords = !manually_set_texture;
+            key.m_FlipU = flip_u;
+            key.m_FlipV = flip_v;
+
+            uint32_t vertex_start = vertices.Size();
+            if (PushCachedNodeVertices(gui_component, scene, node, key, vertices))
             {
-                int32_t frame_index = dmGui::GetNodeAnimationFrame(scene, node);
-                frame_index = texture_set_ddf->m_FrameIndices[frame_index];
-
-                const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
-
-                const Matrix4& w = node_transforms[i];
-
-                // NOTE: The original rendering code is from the comp_sprite.cpp.
-                // Compare with that one if you do any changes to either.
-                uint32_t num_points = geometry->m_Vertices.m_Count / 2;
-
-                const float* points = geometry->m_Vertices.m_Data;
-                const float* uvs = geometry->m_Uvs.m_Data;
-
-                // Depending on the sprite is flipped or not, we loop the vertices forward or backward
-                // to respect face winding (and backface culling)
-                int reverse = (int)flip_u ^ (int)flip_v;
-
-                float scaleX = flip_u ? -1 : 1;
-                float scaleY = flip_v ? -1 : 1;
+                ++gui_context->m_VertexCacheHits;
+            }
+            else
+            {
+                GenerateBoxNodeVertices(scene, node, node_transforms[i], pm_color, size, tc, manually_set_texture, slice9, use_slice_nine,
+                                        flip_u, flip_v, texture, org_width, org_height, vertices);
+                CacheNodeVertices(gui_component, scene, node, key, vertices.Begin() + vertex_start, vertices.Size() - vertex_start);
+            }
+            rendered_vert_count += vertices.Size() - vertex_start;
+        }
 
-                // Since we don't use an index buffer, we duplicate the vertices manually
-                uint32_t index_count = geometry->m_Indices.m_Count;
-                for (uint32_t index = 0; index < index_count; ++index)
-                {
-                    uint32_t i = geometry->m_Indices.m_Data[index];
-                    i = reverse ? (num_points - i - 1) : i;
-
-                    const float* point = &points[i * 2];
-                    const float* uv = &uvs[i * 2];
-                    // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
-                    float x = point[0] * scaleX + 0.5f;
-                    float y = point[1] * scaleY + 0.5f;
-
-                    Vector4 p = w * Point3(x, y, 0.0f);
-                    BoxVertex v(p, uv[0], uv[1], pm_color);
-                    gui_world->m_ClientVertexBuffer.Push(v);
-                }
+        ro.m_VertexCount = rendered_vert_count;
+    }
 
-                rendered_vert_count += index_count;
-                continue;
-            }
+    // Computes max vertices required in the vertex buffer to draw a pie node with a
+    // given number of perimeter vertices in its configuration.
+    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
+    {
+        // 1.  Minimum is capped to 4
+        // 2a. There will always be one extra needed to complete a full fill.
+        //     I.e. an 8-gon will need 9 vertices around, where the first and last
+        //     overlap. (+1)
+        // 2b. If the shape has rectangular bounds and pass through all four corners,
+        //     there will be 4 vertices inserted around the loop. (+4)
+        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
+        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
+        //     doubled vertices to tie it together (+2)
+        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+    }
 
-            // render 9-sliced node
+    // Generates the vertices of a single pie node, see RenderPieNodes
+    static void GeneratePieNodeVertices(dmGui::HScene scene, dmGui::HNode node, const Matrix4& transform, const Vector4& pm_color,
+                                        const Point3& size, const float* tc, bool flip_u, bool flip_v, dmArray<BoxVertex>& vertices)
+    {
+        const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
+        const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
+        const dmGui::PieBounds outerBounds = dmGui::GetNodeOuterBounds(scene, node);
 
-            //   0 1     2 3
-            // 0 *-*-----*-*
-            //   | |  y  | |
-            // 1 *-*-----*-*
-            //   | |     | |
-            //   |x|     |z|
-            //   | |     | |
-            // 2 *-*-----*-*
-            //   | |  w  | |
-            // 3 *-*-----*-*
-            float us[4], vs[4], xs[4], ys[4];
+        const float PI = 3.1415926535f;
+        const float ad = PI * 2.0f / (float)perimeterVertices;
 
-            // v are '1-v'
-            xs[0] = ys[0] = 0;
-            xs[3] = ys[3] = 1;
+        float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
+        bool backwards = false;
+        if (stopAngle < 0)
+        {
+            stopAngle = -stopAngle;
+            backwards = true;
+        }
 
-            // disable slice9 computation below a certain dimension
-            // (avoid div by zero)
-            const float s9_min_dim = 0.001f;
+        stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
 
-            const float su = 1.0f / org_width;
-            const float sv = 1.0f / org_height;
+        // 1. Division computes number of cirlce segments needed, and we need 1 more
+        // vertex than that (1 lone segment = 2 perimeter vertices).
+        // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
+        // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
+        // floating point imprecision)
+        const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
 
-            Point3 size = dmGui::GetNodeSize(scene, node);
-            const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
-            const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+        float lastAngle = 0;
+        float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
+        bool first = true;
 
-            static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
-            bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-            if(uv_rotated)
+        float u0,su,v0,sv;
+        bool uv_rotated;
+        if(tc)
+        {
+            uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+            if(uv_rotated ? flip_v : flip_u)
             {
-                const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getW());
-                us[uI[2]] = tc[2] - (su * slice9.getY());
-                us[uI[3]] = tc[2];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] - (sv * slice9.getX());
-                vs[vI[2]] = tc[5] + (sv * slice9.getZ());
-                vs[vI[3]] = tc[5];
+                su = -(tc[4] - tc[0]);
+                u0 = tc[0] - su;
             }
             else
             {
-                const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getX());
-                us[uI[2]] = tc[4] - (su * slice9.getZ());
-                us[uI[3]] = tc[4];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] + (sv * slice9.getW());
-                vs[vI[2]] = tc[3] - (sv * slice9.getY());
-                vs[vI[3]] = tc[3];
+                u0 = tc[0];
+                su = tc[4] - u0;
             }
+            uint32_t v0i = uv_rotated ? 1 : 3;
+            uint32_t v1i = uv_rotated ? 5 : 1;
+            if(uv_rotated ? flip_u : flip_v)
+            {
+                sv = -(tc[v1i] - tc[v0i]);
+                v0 = tc[v0i] - sv;
+            }
+            else
+            {
+                v0 = tc[v0i];
+                sv = tc[v1i] - v0;
+            }
+        }
+        else
+        {
+            uv_rotated = false;
+            u0 = 0.0f;
+            su = 1.0f;
+            v0 = 1.0f;
+            sv = -1.0f;
+        }
 
-            xs[1] = sx * slice9.getX();
-            xs[2] = 1 - sx * slice9.getZ();
-            ys[1] = sy * slice9.getW();
-            ys[2] = 1 - sy * slice9.getY();
+        for (uint32_t j = 0; j != generate; j++)
+        {
+            float a;
+            if (j == (generate-1))
+                a = stopAngle;
+            else
+                a = ad * j;
 
-            const Matrix4* transform = &node_transforms[i];
-            Vectormath::Aos::Vector4 pts[4][4];
-            for (int y=0;y<4;y++)
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
             {
-                for (int x=0;x<4;x++)
+                // insert extra vertex (and ignore == case)
+                if (lastAngle < nextCorner && a >= nextCorner)
                 {
-                    pts[y][x] = (*transform * Vectormath::Aos::Point3(xs[x], ys[y], 0));
+                    a = nextCorner;
+                    nextCorner += 0.50f * PI;
+                    --j;
                 }
+
+                lastAngle = a;
             }
 
-            BoxVertex v00, v10, v01, v11;
-            v00.SetColor(pm_color);
-            v10.SetColor(pm_color);
-            v01.SetColor(pm_color);
-            v11.SetColor(pm_color);
-            for (int y=0;y<3;y++)
+            const float s = dmTrigLookup::Sin(backwards ? -a : a);
+            const float c = dmTrigLookup::Cos(backwards ? -a : a);
+
+            // make inner vertex
+            float u = 0.5f + innerMultiplier * c;
+            float v = 0.5f + innerMultiplier * s;
+            BoxVertex vInner(transform * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // make outer vertex
+            float d;
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
+                d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
+            else
+                d = 0.5f;
+
+            u = 0.5f + d * c;
+            v = 0.5f + d * s;
+            BoxVertex vOuter(transform * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // both inner & outer are doubled at first / last entry to generate degenerate triangles
+            // for the triangle strip, allowing more than one pie to be chained together in the same
+            // drawcall.
+            if (first)
             {
-                for (int x=0;x<3;x++)
-                {
-                    const int x0 = x;
-                    const int x1 = x+1;
-                    const int y0 = y;
-                    const int y1 = y+1;
-                    v00.SetPosition(pts[y0][x0]);
-                    v10.SetPosition(pts[y0][x1]);
-                    v01.SetPosition(pts[y1][x0]);
-                    v11.SetPosition(pts[y1][x1]);
-                    if(uv_rotated)
-                    {
-                        v00.SetUV(us[y0], vs[x0]);
-                        v10.SetUV(us[y0], vs[x1]);
-                        v01.SetUV(us[y1], vs[x0]);
-                        v11.SetUV(us[y1], vs[x1]);
-                    }
-                    else
-                    {
-                        v00.SetUV(us[x0], vs[y0]);
-                        v10.SetUV(us[x1], vs[y0]);
-                        v01.SetUV(us[x0], vs[y1]);
-                        v11.SetUV(us[x1], vs[y1]);
-                    }
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v10);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v01);
-                }
+                vertices.Push(vInner);
+                first = false;
             }
-            rendered_vert_count += verts_per_node;
-        }
 
-        ro.m_VertexCount = rendered_vert_count;
-    }
+            vertices.Push(vInner);
+            vertices.Push(vOuter);
 
-    // Computes max vertices required in the vertex buffer to draw a pie node with a
-    // given number of perimeter vertices in its configuration.
-    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
-    {
-        // 1.  Minimum is capped to 4
-        // 2a. There will always be one extra needed to complete a full fill.
-        //     I.e. an 8-gon will need 9 vertices around, where the first and last
-        //     overlap. (+1)
-        // 2b. If the shape has rectangular bounds and pass through all four corners,
-        //     there will be 4 vertices inserted around the loop. (+4)
-        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
-        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
-        //     doubled vertices to tie it together (+2)
-        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+            if (j == generate-1)
+                vertices.Push(vOuter);
+        }
     }
 
     void RenderPieNodes(dmGui::HScene scene,
@@ -1418,6 +1644,9 @@ namespace dmGameSystem
             gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, max_total_vertices));
         }
 
+        GuiComponent* gui_component = (GuiComponent*)dmGui::GetSceneUserData(scene);
+        dmArray<BoxVertex>& vertices = gui_world->m_ClientVertexBuffer;
+
         for (uint32_t i = 0; i < node_count; ++i)
         {
             const dmGui::HNode node = entries[i].m_Node;
@@ -1431,132 +1660,40 @@ namespace dmGameSystem
             // Pre-multiplied alpha
             Vector4 pm_color(color.getXYZ(), node_opacities[i]);
 
-            const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
-            const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
-            const dmGui::PieBounds outerBounds = dmGui::GetNodeOuterBounds(scene, node);
-
-            const float PI = 3.1415926535f;
-            const float ad = PI * 2.0f / (float)perimeterVertices;
-
-            float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
-            bool backwards = false;
-            if (stopAngle < 0)
-            {
-                stopAngle = -stopAngle;
-                backwards = true;
-            }
-
-            stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
-
-            // 1. Division computes number of cirlce segments needed, and we need 1 more
-            // vertex than that (1 lone segment = 2 perimeter vertices).
-            // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
-            // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
-            // floating point imprecision)
-            const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
-
-            float lastAngle = 0;
-            float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
-            bool first = true;
-
-            float u0,su,v0,sv;
-            bool uv_rotated;
+            bool flip_u = false;
+            bool flip_v = false;
             const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-            if(tc)
-            {
-                bool flip_u, flip_v;
+            if (tc)
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
-                uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-                if(uv_rotated ? flip_v : flip_u)
-                {
-                    su = -(tc[4] - tc[0]);
-                    u0 = tc[0] - su;
-                }
-                else
-                {
-                    u0 = tc[0];
-                    su = tc[4] - u0;
-                }
-                uint32_t v0i = uv_rotated ? 1 : 3;
-                uint32_t v1i = uv_rotated ? 5 : 1;
-                if(uv_rotated ? flip_u : flip_v)
-                {
-                    sv = -(tc[v1i] - tc[v0i]);
-                    v0 = tc[v0i] - sv;
-                }
-                else
-                {
-                    v0 = tc[v0i];
-                    sv = tc[v1i] - v0;
-                }
-            }
-            else
+
+            GuiNodeVertexCacheKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform = node_transforms[i];
+            key.m_Color = pm_color;
+            key.m_Size[0] = size.getX();
+            key.m_Size[1] = size.getY();
+            if (tc)
+                memcpy(key.m_TexCoords, tc, sizeof(key.m_TexCoords));
+            key.m_PerimeterVertices = dmGui::GetNodePerimeterVertices(scene, node);
+            key.m_InnerRadius = dmGui::GetNodeInnerRadius(scene, node);
+            key.m_FillAngle = dmGui::GetNodePieFillAngle(scene, node);
+            key.m_HasTexCoords = tc != 0;
+            key.m_FlipU = flip_u;
+            key.m_FlipV = flip_v;
+            key.m_OuterBounds = dmGui::GetNodeOuterBounds(scene, node) == dmGui::PIEBOUNDS_RECTANGLE;
+
+            uint32_t vertex_start = vertices.Size();
+            if (PushCachedNodeVertices(gui_component, scene, node, key, vertices))
             {
-                uv_rotated = false;
-                u0 = 0.0f;
-                su = 1.0f;
-                v0 = 1.0f;
-                sv = -1.0f;
+                ++gui_context->m_VertexCacheHits;
             }
-
-            uint32_t sizeBefore = gui_world->m_ClientVertexBuffer.Size();
-            for (uint32_t j = 0; j != generate; j++)
+            else
             {
-                float a;
-                if (j == (generate-1))
-                    a = stopAngle;
-                else
-                    a = ad * j;
-
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                {
-                    // insert extra vertex (and ignore == case)
-                    if (lastAngle < nextCorner && a >= nextCorner)
-                    {
-                        a = nextCorner;
-                        nextCorner += 0.50f * PI;
-                        --j;
-                    }
-
-                    lastAngle = a;
-                }
-
-                const float s = dmTrigLookup::Sin(backwards ? -a : a);
-                const float c = dmTrigLookup::Cos(backwards ? -a : a);
-
-                // make inner vertex
-                float u = 0.5f + innerMultiplier * c;
-                float v = 0.5f + innerMultiplier * s;
-                BoxVertex vInner(node_transforms[i] * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // make outer vertex
-                float d;
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                    d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
-                else
-                    d = 0.5f;
-
-                u = 0.5f + d * c;
-                v = 0.5f + d * s;
-                BoxVertex vOuter(node_transforms[i] * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // both inner & outer are doubled at first / last entry to generate degenerate triangles
-                // for the triangle strip, allowing more than one pie to be chained together in the same
-                // drawcall.
-                if (first)
-                {
-                    gui_world->m_ClientVertexBuffer.Push(vInner);
-                    first = false;
-                }
-
-                gui_world->m_ClientVertexBuffer.Push(vInner);
-                gui_world->m_ClientVertexBuffer.Push(vOuter);
-
-                if (j == generate-1)
-                    gui_world->m_ClientVertexBuffer.Push(vOuter);
+                GeneratePieNodeVertices(scene, node, node_transforms[i], pm_color, size, tc, flip_u, flip_v, vertices);
+                CacheNodeVertices(gui_component, scene, node, key, vertices.Begin() + vertex_start, vertices.Size() - vertex_start);
             }
 
-            assert((gui_world->m_ClientVertexBuffer.Size() - sizeBefore) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node)));
+            assert((vertices.Size() - vertex_start) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node)));
         }
 
         ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
@@ -1578,6 +1715,7 @@ namespace dmGameSystem
 
         gui_world->m_RenderedParticlesSize = 0;
         gui_context->m_FirstStencil = true;
+        gui_context->m_VertexCacheHits = 0;
 
         dmGui::HNode first_node = entries[0].m_Node;
         dmGui::BlendMode prev_blend_mode = dmGui::GetNodeBlendMode(scene, first_node);
@@ -1685,6 +1823,7 @@ namespace dmGameSystem
                                         gui_world->m_ClientVertexBuffer.Begin(),
                                         dmGraphics::BUFFER_USAGE_STREAM_DRAW);
         DM_COUNTER("Gui.VertexCount", gui_world->m_ClientVertexBuffer.Size());
+        DM_COUNTER("Gui.VertexCacheHits", gui_context->m_VertexCacheHits);
     }
 
     static dmGraphics::TextureFormat ToGraphicsFormat(dmImage::Type type) {
@@ -25,6 +25,37 @@ namespace dmGameSystem
     extern dmRender::HRenderType g_GuiRenderType;
 
     struct GuiSceneResource;
+    struct BoxVertex;
+
+    // Everything the generated vertices of a box or pie node depend on
+    struct GuiNodeVertexCacheKey
+    {
+        Vectormath::Aos::Matrix4    m_Transform;
+        Vectormath::Aos::Vector4    m_Color;
+        Vectormath::Aos::Vector4    m_Slice9;
+        float                       m_Size[2];
+        float                       m_TexCoords[6];
+        float                       m_TextureSize[2];
+        dmGraphics::HTexture        m_Texture;
+        int32_t                     m_Frame;
+        uint32_t                    m_PerimeterVertices;
+        float                       m_InnerRadius;
+        float                       m_FillAngle;
+        uint32_t                    m_HasTexCoords : 1;
+        uint32_t                    m_FlipU : 1;
+        uint32_t                    m_FlipV : 1;
+        uint32_t                    m_OuterBounds : 1;
+    };
+
+    // The vertices generated for a node the last time it was rendered
+    struct GuiNodeVertexCache
+    {
+        GuiNodeVertexCacheKey   m_Key;
+        BoxVertex*              m_Vertices;
+        dmGui::HNode            m_Node;
+        uint32_t                m_VertexCount;
+        uint32_t                m_VertexCapacity;
+    };
 
     struct GuiComponent
     {
@@ -32,6 +63,8 @@ namespace dmGameSystem
         dmGui::HScene           m_Scene;
         dmGameObject::HInstance m_Instance;
         dmRender::HMaterial     m_Material;
+        // Indexed by node index, see dmGui::GetNodeIndex
+        dmArray<GuiNodeVertexCache> m_NodeVertexCaches;
         uint16_t                m_ComponentIndex;
         uint8_t                 m_Enabled : 1;
         uint8_t                 m_AddedToUpdate : 1;
@@ -70,20 +70,8 @@ namespace dmGameSystem
         uint8_t                     m_ReHash : 1;
     };
 
-    struct MeshWorld
-    {
-        dmResource::HFactory               m_ResourceFactory;
-        uint32_t                           m_CurrentVertexBuffer;
-        dmArray<dmGraphics::HVertexBuffer> m_VertexBuffers;
-        void*                              m_WorldVertexData;
-        size_t                             m_WorldVertexDataSize;
-        /// Keep track of how much vertex data we have rendered so it can be
-        /// reported to the profiler at end of the render dispatching.
-        uint32_t                           m_RenderedVertexSize;
-
-        dmObjectPool<MeshComponent*>       m_Components;
-        dmArray<dmRender::RenderObject>    m_RenderObjects;
-    };
+    /// Number of frames a world space batch can be unused before its data is freed
+    static const uint32_t MAX_UNUSED_WORLD_BATCH_FRAMES = 2;
 
     static const uint32_t MAX_TEXTURE_COUNT = dmRender::RenderObject::MAX_TEXTURE_COUNT;
 
@@ -104,10 +92,12 @@ namespace dmGameSystem
         world->m_VertexBuffers.SetCapacity(0);
         world->m_VertexBuffers.SetSize(0);
 
-        world->m_WorldVertexData = 0x0;
-        world->m_WorldVertexDataSize = 0;
+        world->m_WorldBatches.SetCapacity(0);
+        world->m_Frame = 0;
+        world->m_Dispatch = 0;
 
         world->m_RenderedVertexSize = 0;
+        world->m_UploadedVertexSize = 0;
 
         *params.m_World = world;
 
@@ -116,6 +106,38 @@ namespace dmGameSystem
         return dmGameObject::CREATE_RESULT_OK;
     }
 
+    static void DeleteWorldBatch(MeshWorldBatch* batch)
+    {
+        dmGraphics::DeleteVertexBuffer(batch->m_VertexBuffer);
+        free(batch->m_VertexData);
+        delete batch;
+    }
+
+    // Forces all world space batches to regenerate their vertex data the next time they are rendered
+    static void InvalidateWorldBatches(MeshWorld* world)
+    {
+        for(uint32_t i = 0; i < world->m_WorldBatches.Size(); ++i)
+        {
+            world->m_WorldBatches[i]->m_Entries.SetSize(0);
+        }
+    }
+
+    static void DeleteUnusedWorldBatches(MeshWorld* world)
+    {
+        uint32_t i = 0;
+        while (i < world->m_WorldBatches.Size())
+        {
+            MeshWorldBatch* batch = world->m_WorldBatches[i];
+            if (world->m_Frame - batch->m_LastUsedFrame > MAX_UNUSED_WORLD_BATCH_FRAMES)
+            {
+                DeleteWorldBatch(batch);
+                world->m_WorldBatches.EraseSwap(i);
+                continue;
+            }
+            ++i;
+        }
+    }
+
     dmGameObject::CreateResult CompMeshDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params)
     {
         MeshWorld* world = (MeshWorld*)params.m_World;
@@ -124,9 +146,9 @@ namespace dmGameSystem
             dmGraphics::DeleteVertexBuffer(world->m_VertexBuffers[i]);
         }
 
-        if (world->m_WorldVertexData)
+        for(uint32_t i = 0; i < world->m_WorldBatches.Size(); ++i)
         {
-            free(world->m_WorldVertexData);
+            DeleteWorldBatch(world->m_WorldBatches[i]);
         }
 
         dmResource::UnregisterResourceReloadedCallback(((MeshContext*)params.m_Context)->m_Factory, ResourceReloadedCallback, world);
@@ -229,6 +251,9 @@ namespace dmGameSystem
             }
         }
 
+        // The world space batches refers to the component, and a new component might reuse its address
+        InvalidateWorldBatches(world);
+
         delete component;
         world->m_Components.Free(index, true);
 
@@ -435,19 +460,59 @@ namespace dmGameSystem
         return world->m_VertexBuffers[world->m_CurrentVertexBuffer++];
     }
 
+    static MeshWorldBatch* GetWorldBatch(MeshWorld* world, dmRender::HRenderContext render_context, uint32_t batch_key)
+    {
+        // The render objects of a dispatch are drawn after all its batches are rendered,
+        // so a batch already used by another range in this dispatch can't be reused
+        for (uint32_t i = 0; i < world->m_WorldBatches.Size(); ++i)
+        {
+            MeshWorldBatch* batch = world->m_WorldBatches[i];
+            if (batch->m_BatchKey == batch_key && batch->m_LastUsedDispatch != world->m_Dispatch)
+            {
+                batch->m_LastUsedFrame = world->m_Frame;
+                batch->m_LastUsedDispatch = world->m_Dispatch;
+                return batch;
+            }
+        }
+
+        MeshWorldBatch* batch = new MeshWorldBatch;
+        batch->m_VertexBuffer = dmGraphics::NewVertexBuffer(dmRender::GetGraphicsContext(render_context), 0, 0x0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        batch->m_VertexData = 0x0;
+        batch->m_VertexDataCapacity = 0;
+        batch->m_VertexBufferSize = 0;
+        batch->m_BatchKey = batch_key;
+        batch->m_LastUsedFrame = world->m_Frame;
+        batch->m_LastUsedDispatch = world->m_Dispatch;
+
+        if (world->m_WorldBatches.Full())
+        {
+            world->m_WorldBatches.OffsetCapacity(4);
+        }
+        world->m_WorldBatches.Push(batch);
+        return batch;
+    }
+
+    static inline bool IsWorldBatchEntryValid(const MeshWorldBatchEntry& entry, const MeshComponent* component, dmBuffer::HBuffer buffer, uint32_t content_version, uint32_t offset)
+    {
+        return entry.m_Component == component &&
+               entry.m_Buffer == buffer &&
+               entry.m_ContentVersion == content_version &&
+               entry.m_Offset == offset &&
+               memcmp(&entry.m_World, &component->m_World, sizeof(Matrix4)) == 0;
+    }
+
     static inline void RenderBatchWorldVS(MeshWorld* world, dmRender::HMaterial material, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE(Mesh, "RenderBatchWorld");
 
-        dmGraphics::HVertexBuffer vert_buffer = GetFreeVertexBuffer(world, render_context);
-        assert(vert_buffer);
-
         dmRender::RenderObject& ro = *world->m_RenderObjects.End();
         world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
 
         const MeshComponent* first = (MeshComponent*) buf[*begin].m_UserData;
         const MeshResource* mr = first->m_Resource;
 
+        MeshWorldBatch* batch = GetWorldBatch(world, render_context, first->m_MixedHash);
+
         // Setup vertex declaration, count and sizes etc.
         // These defaults to values in the mesh and buffer resources,
         // but will be overwritten if the component instance has a "custom"
@@ -456,7 +521,6 @@ namespace dmGameSystem
         uint32_t vert_size = mr->m_VertSize;
 
         // Find out how many elements/vertices all instances in this batch has
-        // TODO: We might want to calculate this only when a mesh/buffer changes.
         uint32_t element_count = 0;
         for (uint32_t *i=begin;i!=end;i++)
         {
@@ -466,23 +530,51 @@ namespace dmGameSystem
             element_count += br->m_ElementCount;
         }
 
-        // Allocate a larger scratch buffer if vert count * vert size is larger than current buffer.
-        if (world->m_WorldVertexDataSize < vert_size * element_count)
+        // Allocate a larger buffer if vert count * vert size is larger than the current buffer.
+        uint32_t data_size = vert_size * element_count;
+        if (batch->m_VertexDataCapacity < data_size)
         {
-            world->m_WorldVertexDataSize = vert_size * element_count;
-            world->m_WorldVertexData = realloc(world->m_WorldVertexData, world->m_WorldVertexDataSize);
+            batch->m_VertexDataCapacity = data_size;
+            batch->m_VertexData = realloc(batch->m_VertexData, batch->m_VertexDataCapacity);
+            batch->m_Entries.SetSize(0);
         }
 
-        // Fill scratch buffer with data
-        void* dst_data_ptr = world->m_WorldVertexData;
+        uint32_t entry_count = (uint32_t)(end - begin);
+        if (batch->m_Entries.Capacity() < entry_count)
+        {
+            batch->m_Entries.SetCapacity(entry_count);
+        }
+        // New entries are cleared so that they are regenerated below
+        uint32_t prev_entry_count = batch->m_Entries.Size();
+        batch->m_Entries.SetSize(entry_count);
+        for (uint32_t i = prev_entry_count; i < entry_count; ++i)
+        {
+            batch->m_Entries[i].m_Component = 0x0;
+        }
+
+        // Regenerate the vertices of the components that have changed since last time, and keep
+        // track of the range of data that needs to be uploaded.
+        uint32_t dirty_begin = data_size;
+        uint32_t dirty_end = 0;
+        uint32_t offset = 0;
         for (uint32_t *i=begin;i!=end;i++)
         {
             const MeshComponent* component = (MeshComponent*) buf[*i].m_UserData;
             const MeshResource* mr = component->m_Resource;
             const BufferResource* br = GetVerticesBuffer(component, mr);
+            MeshWorldBatchEntry& entry = batch->m_Entries[(uint32_t)(i - begin)];
 
             // No idea of rendering with zero element count.
             if (br->m_ElementCount == 0) {
+                entry.m_Component = 0x0;
+                continue;
+            }
+
+            uint32_t content_version = 0;
+            dmBuffer::GetContentVersion(br->m_Buffer, &content_version);
+            if (IsWorldBatchEntryValid(entry, component, br->m_Buffer, content_version, offset))
+            {
+                offset += entry.m_Size;
                 continue;
             }
 
@@ -491,9 +583,12 @@ namespace dmGameSystem
             dmBuffer::Result r = dmBuffer::GetBytes(br->m_Buffer, &raw_data, &size);
             if (r != dmBuffer::RESULT_OK) {
                 dmLogError("Could not get bytes from buffer when rendering mesh in world space (%d).", r);
+                entry.m_Component = 0x0;
                 continue;
             }
 
+            void* dst_data_ptr = (void*)((uint8_t*)batch->m_VertexData + offset);
+
             // Copy all buffer data
             memcpy(dst_data_ptr, raw_data, size);
 
@@ -509,13 +604,34 @@ namespace dmGameSystem
                 FillAndApplyStream(br, false, normal_matrix, mr->m_NormalStreamId, mr->m_NormalStreamType, raw_data, dst_data_ptr);
             }
 
-            dst_data_ptr = (void*)((uint8_t*)dst_data_ptr + size);
+            entry.m_Component = component;
+            entry.m_World = component->m_World;
+            entry.m_Buffer = br->m_Buffer;
+            entry.m_ContentVersion = content_version;
+            entry.m_Offset = offset;
+            entry.m_Size = size;
+
+            dirty_begin = dmMath::Min(dirty_begin, offset);
+            dirty_end = dmMath::Max(dirty_end, offset + size);
+
+            offset += size;
         }
 
-        world->m_RenderedVertexSize += vert_size * element_count;
+        world->m_RenderedVertexSize += data_size;
 
-        FillRenderObject(ro, mr->m_PrimitiveType, material, mr->m_Textures, vert_decl, vert_buffer, 0, element_count, Matrix4::identity(), first->m_RenderConstants);
-        dmGraphics::SetVertexBufferData(vert_buffer, vert_size * element_count, world->m_WorldVertexData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        if (batch->m_VertexBufferSize != data_size)
+        {
+            dmGraphics::SetVertexBufferData(batch->m_VertexBuffer, data_size, batch->m_VertexData, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+            batch->m_VertexBufferSize = data_size;
+            world->m_UploadedVertexSize += data_size;
+        }
+        else if (dirty_begin < dirty_end)
+        {
+            dmGraphics::SetVertexBufferSubData(batch->m_VertexBuffer, dirty_begin, dirty_end - dirty_begin, (uint8_t*)batch->m_VertexData + dirty_begin);
+            world->m_UploadedVertexSize += dirty_end - dirty_begin;
+        }
+
+        FillRenderObject(ro, mr->m_PrimitiveType, material, mr->m_Textures, vert_decl, batch->m_VertexBuffer, 0, element_count, Matrix4::identity(), first->m_RenderConstants);
         dmRender::AddToRender(render_context, &ro);
     }
 
@@ -602,6 +718,8 @@ namespace dmGameSystem
             case dmRender::RENDER_LIST_OPERATION_BEGIN:
             {
                 world->m_RenderedVertexSize = 0;
+                world->m_UploadedVertexSize = 0;
+                world->m_Dispatch++;
                 world->m_CurrentVertexBuffer = 0;
                 world->m_RenderObjects.SetSize(0);
                 break;
@@ -614,6 +732,7 @@ namespace dmGameSystem
             case dmRender::RENDER_LIST_OPERATION_END:
             {
                 DM_COUNTER("MeshVertexBuffer", world->m_RenderedVertexSize);
+                DM_COUNTER("MeshVertexUpload", world->m_UploadedVertexSize);
                 break;
             }
             default:
@@ -630,6 +749,9 @@ namespace dmGameSystem
 
         UpdateTransforms(world);
 
+        world->m_Frame++;
+        DeleteUnusedWorldBatches(world);
+
         dmArray<MeshComponent*>& components = world->m_Components.m_Objects;
         const uint32_t count = components.Size();
 
@@ -807,6 +929,8 @@ namespace dmGameSystem
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams& params)
     {
         MeshWorld* world = (MeshWorld*) params.m_UserData;
+        InvalidateWorldBatches(world);
+
         dmArray<MeshComponent*>& components = world->m_Components.m_Objects;
         uint32_t n = components.Size();
         for (uint32_t i = 0; i < n; ++i)
@@ -13,10 +13,66 @@
 #ifndef DM_GAMESYS_COMP_MESH_H
 #define DM_GAMESYS_COMP_MESH_H
 
+#include <dlib/array.h>
+#include <dlib/object_pool.h>
+#include <dlib/vmath.h>
+#include <dlib/buffer.h>
+#include <graphics/graphics.h>
+#include <render/render.h>
+#include <resource/resource.h>
 #include <gameobject/gameobject.h>
 
 namespace dmGameSystem
 {
+    struct MeshComponent;
+
+    /// The state a component had when its vertices were written to a world space batch
+    struct MeshWorldBatchEntry
+    {
+        const MeshComponent*        m_Component;
+        Vectormath::Aos::Matrix4    m_World;
+        dmBuffer::HBuffer           m_Buffer;
+        uint32_t                    m_ContentVersion;
+        /// Byte offset and size of the component vertices in the batch vertex data
+        uint32_t                    m_Offset;
+        uint32_t                    m_Size;
+    };
+
+    /// World space vertex data for a dispatched batch range, kept between frames so that only
+    /// the vertices of changed components needs to be regenerated and uploaded.
+    /// Z-sorting can split components with the same batch key into several ranges, so there
+    /// can be several batches with the same key, each used at most once per dispatch.
+    struct MeshWorldBatch
+    {
+        dmArray<MeshWorldBatchEntry>    m_Entries;
+        dmGraphics::HVertexBuffer       m_VertexBuffer;
+        void*                           m_VertexData;
+        uint32_t                        m_VertexDataCapacity;
+        /// Size of the data currently in the vertex buffer
+        uint32_t                        m_VertexBufferSize;
+        uint32_t                        m_BatchKey;
+        uint32_t                        m_LastUsedFrame;
+        uint32_t                        m_LastUsedDispatch;
+    };
+
+    struct MeshWorld
+    {
+        dmResource::HFactory               m_ResourceFactory;
+        uint32_t                           m_CurrentVertexBuffer;
+        dmArray<dmGraphics::HVertexBuffer> m_VertexBuffers;
+        dmArray<MeshWorldBatch*>           m_WorldBatches;
+        uint32_t                           m_Frame;
+        uint32_t                           m_Dispatch;
+        /// Keep track of how much vertex data we have rendered so it can be
+        /// reported to the profiler at end of the render dispatching.
+        uint32_t                           m_RenderedVertexSize;
+        /// Keep track of how much world space vertex data we have uploaded
+        uint32_t                           m_UploadedVertexSize;
+
+        dmObjectPool<MeshComponent*>       m_Components;
+        dmArray<dmRender::RenderObject>    m_RenderObjects;
+    };
+
     dmGameObject::CreateResult CompMeshNewWorld(const dmGameObject::ComponentNewWorldParams& params);
 
     dmGameObject::CreateResult CompMeshDeleteWorld(const dmGameObject::ComponentDeleteWorldParams& params);
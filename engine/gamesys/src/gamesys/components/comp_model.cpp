@@ -75,6 +75,8 @@ namespace dmGameSystem
         dmArray<dmRig::RigModelVertex>* m_VertexBufferData;
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance> m_ScratchInstances;
+        // Temporary scratch array for the instances of a render batch
+        dmArray<dmRig::RigVertexDataEntry> m_ScratchVertexDataEntries;
         dmRig::HRigContext              m_RigContext;
         uint32_t                        m_MaxElementsVertices;
         uint32_t                        m_VertexBufferSwapChainIndex;
@@ -102,6 +104,8 @@ namespace dmGameSystem
         dmRig::NewContextParams rig_params = {0};
         rig_params.m_Context = &world->m_RigContext;
         rig_params.m_MaxRigInstanceCount = context->m_MaxModelCount;
+        rig_params.m_OffscreenUpdateInterval = context->m_OffscreenUpdateInterval;
+        rig_params.m_OffscreenPoseTimeout = context->m_OffscreenPoseTimeout;
         dmRig::Result rr = dmRig::NewContext(rig_params);
         if (rr != dmRig::RESULT_OK)
         {
@@ -518,16 +522,22 @@ namespace dmGameSystem
         dmGraphics::HVertexBuffer& gfx_vertex_buffer = world->m_VertexBuffers[batchIndex];
 
         // Fill in vertex buffer
-        dmRig::RigModelVertex *vb_begin = vertex_buffer.End();
-        dmRig::RigModelVertex *vb_end = vb_begin;
+        dmArray<dmRig::RigVertexDataEntry>& entries = world->m_ScratchVertexDataEntries;
+        uint32_t entry_count = end - begin;
+        if (entries.Capacity() < entry_count)
+            entries.OffsetCapacity(entry_count - entries.Capacity());
+        entries.SetSize(entry_count);
         for (uint32_t *i=begin;i!=end;i++)
         {
             const ModelComponent* c = (ModelComponent*) buf[*i].m_UserData;
-            dmRig::HRigContext rig_context = world->m_RigContext;
-            Matrix4 normal_matrix = inverse(c->m_World);
-            normal_matrix = transpose(normal_matrix);
-            vb_end = (dmRig::RigModelVertex *)dmRig::GenerateVertexData(rig_context, c->m_RigInstance, c->m_World, normal_matrix, Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)vb_end);
+            dmRig::RigVertexDataEntry& entry = entries[i - begin];
+            entry.m_Instance = c->m_RigInstance;
+            entry.m_ModelMatrix = c->m_World;
+            entry.m_NormalMatrix = transpose(inverse(c->m_World));
+            entry.m_Color = Vector4(1.0);
         }
+        dmRig::RigModelVertex *vb_begin = vertex_buffer.End();
+        dmRig::RigModelVertex *vb_end = (dmRig::RigModelVertex *)dmRig::GenerateVertexData(world->m_RigContext, entries.Begin(), entry_count, dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)vb_begin);
         vertex_buffer.SetSize(vb_end - vertex_buffer.Begin());
 
         // Ninja in-place writing of render object.
@@ -1059,4 +1069,9 @@ namespace dmGameSystem
     {
         return world->m_Components.Get(user_data);;
     }
+
+    void CompModelSetVisible(ModelWorld* world, ModelComponent* component, bool visible)
+    {
+        dmRig::SetVisible(world->m_RigContext, component->m_RigInstance, visible);
+    }
 }
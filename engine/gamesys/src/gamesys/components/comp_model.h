@@ -57,6 +57,7 @@ namespace dmGameSystem
     ModelComponent* CompModelGetComponent(ModelWorld* world, uintptr_t user_data);
     ModelResource* CompModelGetModelResource(ModelComponent* component);
     dmGameObject::HInstance CompModelGetNodeInstance(ModelComponent* component, uint32_t bone_index);
+    void CompModelSetVisible(ModelWorld* world, ModelComponent* component, bool visible);
 }
 
 #endif // DM_GAMESYS_COMP_MODEL_H
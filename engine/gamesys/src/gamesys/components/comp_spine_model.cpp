@@ -76,6 +76,8 @@ namespace dmGameSystem
         dmRig::NewContextParams rig_params = {0};
         rig_params.m_Context = &world->m_RigContext;
         rig_params.m_MaxRigInstanceCount = context->m_MaxSpineModelCount;
+        rig_params.m_OffscreenUpdateInterval = context->m_OffscreenUpdateInterval;
+        rig_params.m_OffscreenPoseTimeout = context->m_OffscreenPoseTimeout;
         dmRig::Result rr = dmRig::NewContext(rig_params);
         if (rr != dmRig::RESULT_OK)
         {
@@ -439,14 +441,22 @@ namespace dmGameSystem
             vertex_buffer.OffsetCapacity(vertex_count - vertex_buffer.Remaining());
 
         // Fill in vertex buffer
-        dmRig::RigSpineModelVertex *vb_begin = vertex_buffer.End();
-        dmRig::RigSpineModelVertex *vb_end = vb_begin;
-        dmRig::HRigContext rig_context = world->m_RigContext;
+        dmArray<dmRig::RigVertexDataEntry>& entries = world->m_ScratchVertexDataEntries;
+        uint32_t entry_count = end - begin;
+        if (entries.Capacity() < entry_count)
+            entries.OffsetCapacity(entry_count - entries.Capacity());
+        entries.SetSize(entry_count);
         for (uint32_t *i=begin;i!=end;i++)
         {
             const SpineModelComponent* c = (SpineModelComponent*) buf[*i].m_UserData;
-            vb_end = (dmRig::RigSpineModelVertex*)dmRig::GenerateVertexData(rig_context, c->m_RigInstance, c->m_World, Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_SPINE, (void*)vb_end);
+            dmRig::RigVertexDataEntry& entry = entries[i - begin];
+            entry.m_Instance = c->m_RigInstance;
+            entry.m_ModelMatrix = c->m_World;
+            entry.m_NormalMatrix = Matrix4::identity();
+            entry.m_Color = Vector4(1.0);
         }
+        dmRig::RigSpineModelVertex *vb_begin = vertex_buffer.End();
+        dmRig::RigSpineModelVertex *vb_end = (dmRig::RigSpineModelVertex*)dmRig::GenerateVertexData(world->m_RigContext, entries.Begin(), entry_count, dmRig::RIG_VERTEX_FORMAT_SPINE, (void*)vb_begin);
         vertex_buffer.SetSize(vb_end - vertex_buffer.Begin());
 
         // Ninja in-place writing of render object.
@@ -943,4 +953,9 @@ namespace dmGameSystem
         return r == dmRig::RESULT_OK;
     }
 
+    void CompSpineModelSetVisible(SpineModelWorld* world, SpineModelComponent* component, bool visible)
+    {
+        dmRig::SetVisible(world->m_RigContext, component->m_RigInstance, visible);
+    }
+
 }
@@ -57,6 +57,8 @@ namespace dmGameSystem
         dmArray<dmRig::RigSpineModelVertex> m_VertexBufferData;
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance>    m_ScratchInstances;
+        // Temporary scratch array for the instances of a render batch
+        dmArray<dmRig::RigVertexDataEntry>  m_ScratchVertexDataEntries;
         dmRig::HRigContext                  m_RigContext;
     };
 
@@ -89,6 +91,8 @@ namespace dmGameSystem
     bool CompSpineModelSetSkin(SpineModelComponent* component, dmhash_t skin_id);
     bool CompSpineModelSetSkinSlot(SpineModelComponent* component, dmhash_t skin_id, dmhash_t slot_id);
 
+    void CompSpineModelSetVisible(SpineModelWorld* world, SpineModelComponent* component, bool visible);
+
 }
 
 #endif // DM_GAMESYS_COMP_SPINE_MODEL_H
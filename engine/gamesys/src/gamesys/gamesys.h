@@ -14,6 +14,7 @@
 #define DM_GAMESYS_H
 
 #include <dlib/configfile.h>
+#include <dlib/thread_pool.h>
 
 #include <script/script.h>
 
@@ -34,6 +35,8 @@ namespace dmGameSystem
     extern const char* PHYSICS_MAX_COLLISIONS_KEY;
     /// Config key to use for tweaking maximum number of contacts reported
     extern const char* PHYSICS_MAX_CONTACTS_KEY;
+    /// Config key to use for reporting collisions through the physics event buffer instead of messages
+    extern const char* PHYSICS_USE_EVENT_BUFFER_KEY;
     /// Config key to use for tweaking maximum number of collection proxies
     extern const char* COLLECTION_PROXY_MAX_COUNT_KEY;
     /// Config key to use for tweaking maximum number of factories
@@ -41,6 +44,17 @@ namespace dmGameSystem
     /// Config key to use for tweaking maximum number of collection factories
     extern const char* COLLECTION_FACTORY_MAX_COUNT_KEY;
 
+    struct TextureContext
+    {
+        TextureContext()
+        {
+            memset(this, 0, sizeof(*this));
+        }
+        dmGraphics::HContext        m_GraphicsContext;
+        /// Pool used to decode the mip levels of WebP compressed textures in parallel
+        dmThreadPool::HThreadPool   m_DecodePool;
+    };
+
     struct TilemapContext
     {
         TilemapContext()
@@ -74,6 +88,8 @@ namespace dmGameSystem
         uint32_t m_MaxContactPointCount;
         bool m_Debug;
         bool m_3D;
+        // Report collisions, contacts and triggers through the world event buffer (physics.events) instead of messages
+        bool m_UseEventBuffer;
     };
 
     struct ParticleFXContext
@@ -131,6 +147,8 @@ namespace dmGameSystem
         dmRender::HRenderContext    m_RenderContext;
         dmResource::HFactory        m_Factory;
         uint32_t                    m_MaxSpineModelCount;
+        uint32_t                    m_OffscreenUpdateInterval;
+        uint32_t                    m_OffscreenPoseTimeout;
     };
 
     struct ModelContext
@@ -142,6 +160,8 @@ namespace dmGameSystem
         dmRender::HRenderContext    m_RenderContext;
         dmResource::HFactory        m_Factory;
         uint32_t                    m_MaxModelCount;
+        uint32_t                    m_OffscreenUpdateInterval;
+        uint32_t                    m_OffscreenPoseTimeout;
     };
 
     struct SoundContext
@@ -207,11 +227,15 @@ namespace dmGameSystem
     bool InitializeScriptLibs(const ScriptLibContext& context);
     void FinalizeScriptLibs(const ScriptLibContext& context);
 
+    void InitializeTextureContext(TextureContext& context, dmGraphics::HContext graphics_context);
+    void FinalizeTextureContext(TextureContext& context);
+
     dmResource::Result RegisterResourceTypes(dmResource::HFactory factory,
         dmRender::HRenderContext render_context,
         GuiContext* gui_context,
         dmInput::HContext input_context,
-        PhysicsContext* physics_context);
+        PhysicsContext* physics_context,
+        TextureContext* texture_context);
 
     dmGameObject::Result RegisterComponentTypes(dmResource::HFactory factory,
                                                   dmGameObject::HRegister regist,
@@ -11,8 +11,11 @@
 // specific language governing permissions and limitations under the License.
 
 #include "res_texture.h"
+#include "../gamesys.h"
 
+#include <dlib/atomic.h>
 #include <dlib/log.h>
+#include <dlib/thread_pool.h>
 #include <dlib/webp.h>
 #include <dlib/time.h>
 #include <graphics/graphics.h>
@@ -24,9 +27,29 @@ namespace dmGameSystem
     {
         dmGraphics::TextureImage* m_DDFImage;
         uint8_t* m_DecompressedData[m_MaxMipCount];
+        // Single allocation backing all decompressed mip levels
+        uint8_t* m_DecompressedDataBuffer;
         bool m_UseBlankTexture;
     };
 
+    // Number of worker threads decoding WebP mip levels, in addition to the loading thread
+    static const uint32_t WEBP_DECODE_THREAD_COUNT = 3;
+
+    void InitializeTextureContext(TextureContext& context, dmGraphics::HContext graphics_context)
+    {
+        context.m_GraphicsContext = graphics_context;
+        context.m_DecodePool = dmThreadPool::New(WEBP_DECODE_THREAD_COUNT, "webp_decode");
+    }
+
+    void FinalizeTextureContext(TextureContext& context)
+    {
+        if (context.m_DecodePool != 0)
+        {
+            dmThreadPool::Delete(context.m_DecodePool);
+            context.m_DecodePool = 0;
+        }
+    }
+
     static dmWebP::TextureEncodeFormat TextureFormatFormatToEncodeFormat(dmGraphics::TextureImage::TextureFormat format)
     {
         switch (format)
@@ -119,24 +142,11 @@ namespace dmGameSystem
         dmGraphics::SetTextureAsync(texture, params);
     }
 
-    bool WebPDecodeTexture(uint32_t mipmap, uint32_t width, int32_t height, dmGraphics::TextureImage::Image* image, uint8_t*& decompressed_data, uint32_t& decompressed_data_size)
+    static bool WebPDecodeTexture(uint32_t mipmap, uint32_t width, int32_t height, dmGraphics::TextureImage::Image* image, uint8_t* decompressed_data)
     {
         uint32_t compressed_data_size = image->m_MipMapSizeCompressed[mipmap];
-        if(!compressed_data_size)
-        {
-            decompressed_data = 0;
-            decompressed_data_size = 0;
-            return true;
-        }
-
         uint8_t* compressed_data = &image->m_Data[image->m_MipMapOffset[mipmap]];
-        decompressed_data_size = image->m_MipMapSize[mipmap];
-        decompressed_data = new uint8_t[decompressed_data_size];
-        if(!decompressed_data)
-        {
-            dmLogError("Not enough memory to decode WebP encoded image (%u bytes). Using blank texture.", decompressed_data_size);
-            return false;
-        }
+        uint32_t decompressed_data_size = image->m_MipMapSize[mipmap];
 
         dmWebP::Result webp_res;
         uint32_t stride = decompressed_data_size/height;
@@ -168,7 +178,6 @@ namespace dmGameSystem
         if(webp_res != dmWebP::RESULT_OK)
         {
             dmLogError("Failed to decode WebP encoded image, code(%d). Using blank texture.", (int32_t) webp_res);
-            delete[] decompressed_data;
             return false;
         }
 
@@ -308,7 +317,79 @@ namespace dmGameSystem
         return result;
     }
 
-    ImageDesc* CreateImage(dmGraphics::HContext context, dmGraphics::TextureImage* texture_image)
+    struct WebPDecodeContext
+    {
+        dmGraphics::TextureImage::Image* m_Image;
+        ImageDesc*                       m_ImageDesc;
+        uint32_t                         m_Width[m_MaxMipCount];
+        uint32_t                         m_Height[m_MaxMipCount];
+        int32_atomic_t                   m_Failed;
+    };
+
+    static void WebPDecodeMipMapJob(void* context, uint32_t mipmap)
+    {
+        WebPDecodeContext* ctx = (WebPDecodeContext*) context;
+        uint8_t* decompressed_data = ctx->m_ImageDesc->m_DecompressedData[mipmap];
+        if (decompressed_data == 0)
+            return;
+        if (!WebPDecodeTexture(mipmap, ctx->m_Width[mipmap], ctx->m_Height[mipmap], ctx->m_Image, decompressed_data))
+        {
+            dmAtomicStore32(&ctx->m_Failed, 1);
+        }
+    }
+
+    // Decodes all mip levels of the image, one job per level. Cube map faces are stored in the
+    // same WebP payload as the mip level they belong to, and are decoded as part of that job.
+    static bool WebPDecodeImage(dmThreadPool::HThreadPool pool, dmGraphics::TextureImage::Image* image, ImageDesc* image_desc)
+    {
+        uint32_t mipmap_count = image->m_MipMapOffset.m_Count;
+        assert(mipmap_count <= m_MaxMipCount);
+
+        WebPDecodeContext ctx;
+        ctx.m_Image = image;
+        ctx.m_ImageDesc = image_desc;
+        ctx.m_Failed = 0;
+
+        uint32_t total_size = 0;
+        uint32_t w = image->m_Width;
+        uint32_t h = image->m_Height;
+        for (uint32_t i = 0; i < mipmap_count; ++i)
+        {
+            ctx.m_Width[i] = w;
+            ctx.m_Height[i] = h;
+            if (image->m_MipMapSizeCompressed[i])
+                total_size += image->m_MipMapSize[i];
+            w >>= 1;
+            h >>= 1;
+            if (w == 0) w = 1;
+            if (h == 0) h = 1;
+        }
+        if (total_size == 0)
+            return true;
+
+        uint8_t* buffer = new uint8_t[total_size];
+        if (!buffer)
+        {
+            dmLogError("Not enough memory to decode WebP encoded image (%u bytes). Using blank texture.", total_size);
+            return false;
+        }
+        image_desc->m_DecompressedDataBuffer = buffer;
+
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < mipmap_count; ++i)
+        {
+            if (image->m_MipMapSizeCompressed[i])
+            {
+                image_desc->m_DecompressedData[i] = buffer + offset;
+                offset += image->m_MipMapSize[i];
+            }
+        }
+
+        dmThreadPool::Run(pool, WebPDecodeMipMapJob, &ctx, mipmap_count);
+        return ctx.m_Failed == 0;
+    }
+
+    ImageDesc* CreateImage(TextureContext* context, dmGraphics::TextureImage* texture_image)
     {
         ImageDesc* image_desc = new ImageDesc;
         memset(image_desc, 0x0, sizeof(ImageDesc));
@@ -316,7 +397,7 @@ namespace dmGameSystem
         for(uint32_t i = 0; i < texture_image->m_Alternatives.m_Count; ++i)
         {
             dmGraphics::TextureImage::Image* image = &texture_image->m_Alternatives[i];
-            if (!dmGraphics::IsTextureFormatSupported(context, TextureImageToTextureFormat(image)))
+            if (!dmGraphics::IsTextureFormatSupported(context->m_GraphicsContext, TextureImageToTextureFormat(image)))
             {
                 continue;
             }
@@ -325,25 +406,9 @@ namespace dmGameSystem
                 case dmGraphics::TextureImage::COMPRESSION_TYPE_WEBP:
                 case dmGraphics::TextureImage::COMPRESSION_TYPE_WEBP_LOSSY:
                 {
-                    uint32_t w = image->m_Width;
-                    uint32_t h = image->m_Height;
-                    for (int i = 0; i < (int) image->m_MipMapOffset.m_Count; ++i)
+                    if (!WebPDecodeImage(context->m_DecodePool, image, image_desc))
                     {
-                        uint8_t* decompressed_data;
-                        uint32_t decompressed_data_size;
-                        if(WebPDecodeTexture(i, w, h, image, decompressed_data, decompressed_data_size))
-                        {
-                            image_desc->m_DecompressedData[i] = decompressed_data;
-                        }
-                        else
-                        {
-                            image_desc->m_UseBlankTexture = true;
-                            break;
-                        }
-                        w >>= 1;
-                        h >>= 1;
-                        if (w == 0) w = 1;
-                        if (h == 0) h = 1;
+                        image_desc->m_UseBlankTexture = true;
                     }
                 }
                 break;
@@ -358,11 +423,7 @@ namespace dmGameSystem
 
     void DestroyImage(ImageDesc* image_desc)
     {
-        for (uint32_t i = 0; i < m_MaxMipCount; ++i)
-        {
-            if(image_desc->m_DecompressedData[i])
-                delete[] image_desc->m_DecompressedData[i];
-        }
+        delete[] image_desc->m_DecompressedDataBuffer;
         delete image_desc;
     }
 
@@ -375,7 +436,7 @@ namespace dmGameSystem
             return dmResource::RESULT_FORMAT_ERROR;
         }
 
-        ImageDesc* image_desc = CreateImage((dmGraphics::HContext) params.m_Context, texture_image);
+        ImageDesc* image_desc = CreateImage((TextureContext*) params.m_Context, texture_image);
         *params.m_PreloadData = image_desc;
         return dmResource::RESULT_OK;
     }
@@ -398,7 +459,7 @@ namespace dmGameSystem
 
     dmResource::Result ResTextureCreate(const dmResource::ResourceCreateParams& params)
     {
-        dmGraphics::HContext graphics_context = (dmGraphics::HContext) params.m_Context;
+        dmGraphics::HContext graphics_context = ((TextureContext*) params.m_Context)->m_GraphicsContext;
         dmGraphics::HTexture texture;
         dmResource::Result r = AcquireResources(params.m_Resource, graphics_context, (ImageDesc*) params.m_PreloadData, 0, &texture);
         if (r == dmResource::RESULT_OK)
@@ -425,12 +486,12 @@ namespace dmGameSystem
                 return dmResource::RESULT_FORMAT_ERROR;
             }
         }
-        dmGraphics::HContext graphics_context = (dmGraphics::HContext) params.m_Context;
+        dmGraphics::HContext graphics_context = ((TextureContext*) params.m_Context)->m_GraphicsContext;
         dmGraphics::HTexture texture = (dmGraphics::HTexture) params.m_Resource->m_Resource;
 
         // Create the image from the DDF data.
         // Note that the image desc for performance reasons keeps references to the DDF image, meaning they're invalid after the DDF message has been free'd!
-        ImageDesc* image_desc = CreateImage((dmGraphics::HContext) params.m_Context, texture_image);
+        ImageDesc* image_desc = CreateImage((TextureContext*) params.m_Context, texture_image);
 
         // Set up the new texture (version), wait for it to finish before issuing new requests
         SynchronizeTexture(texture, true);
@@ -19,6 +19,7 @@
 #include <dlib/buffer.h>
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dmsdk/vectormath/cpp/vectormath_aos.h>
 
 #include "script_buffer.h"
 #include "../resources/res_buffer.h"
@@ -550,6 +551,7 @@ namespace dmGameSystem
             {
                 return DM_LUA_ERROR("Unknown stream value type: %d", dststream->m_Type);
             }
+            dmBuffer::UpdateContentVersion(dststream->m_Buffer);
         }
         return 0;
     }
@@ -666,6 +668,355 @@ namespace dmGameSystem
             }
         }
 
+        dmBuffer::UpdateContentVersion(dstbuffer);
+        return 0;
+    }
+
+
+    // Converts a value type offset into a struct pointer and a component offset
+    template<typename T>
+    static inline T* GetStreamStart(T* data, uint32_t* offset, uint32_t stride, uint32_t components)
+    {
+        uint32_t struct_index = *offset / components;
+        *offset = *offset % components;
+        return data + struct_index * stride;
+    }
+
+    // Offsets and count is in "value type"
+    template<typename T>
+    static void SetStreamFromTableT(lua_State* L, int table_index, T* dst, uint32_t dstoffset, uint32_t dststride, uint32_t count, uint32_t components)
+    {
+        dst = GetStreamStart(dst, &dstoffset, dststride, components);
+        for (uint32_t i = 1; i <= count; ++i)
+        {
+            lua_rawgeti(L, table_index, i);
+            dst[dstoffset] = (T)lua_tonumber(L, -1);
+            lua_pop(L, 1);
+            dstoffset = (dstoffset+1) % components;
+            if (dstoffset == 0)
+            {
+                dst += dststride;
+            }
+        }
+    }
+
+    template<typename T>
+    static void FillStreamT(T* dst, uint32_t dstoffset, uint32_t dststride, uint32_t count, uint32_t components, lua_Number value)
+    {
+        const T v = (T)value;
+        dst = GetStreamStart(dst, &dstoffset, dststride, components);
+        while (count > 0)
+        {
+            dst[dstoffset] = v;
+            dstoffset = (dstoffset+1) % components;
+            if (dstoffset == 0)
+            {
+                dst += dststride;
+            }
+            count--;
+        }
+    }
+
+    template<typename T>
+    static void ScaleOffsetStreamT(T* dst, uint32_t dstoffset, uint32_t dststride, uint32_t count, uint32_t components, lua_Number scale, lua_Number bias)
+    {
+        dst = GetStreamStart(dst, &dstoffset, dststride, components);
+        while (count > 0)
+        {
+            dst[dstoffset] = (T)(dst[dstoffset] * scale + bias);
+            dstoffset = (dstoffset+1) % components;
+            if (dstoffset == 0)
+            {
+                dst += dststride;
+            }
+            count--;
+        }
+    }
+
+    // Used when the source and destination streams have different value types
+    static void ConvertStreamInternal(BufferStream* dststream, uint32_t dstoffset,
+                                      const BufferStream* srcstream, uint32_t srcoffset,
+                                      uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t dstindex = dstoffset + i;
+            uint32_t srcindex = srcoffset + i;
+            lua_Number v = srcstream->m_Get(srcstream->m_Data, (srcindex / srcstream->m_TypeCount) * srcstream->m_Stride + srcindex % srcstream->m_TypeCount);
+            dststream->m_Set(dststream->m_Data, (dstindex / dststream->m_TypeCount) * dststream->m_Stride + dstindex % dststream->m_TypeCount, v);
+        }
+    }
+
+    static bool IsStreamRangeValid(const BufferStream* stream, int offset, int count)
+    {
+        return offset >= 0 && count >= 0 && (uint32_t)(offset + count) <= stream->m_Count * stream->m_TypeCount;
+    }
+
+    /*# sets multiple values in a stream
+     *
+     * Write a sequence of values to a stream in one call. The values can be
+     * either a Lua table (array) of numbers or another stream. This is much faster
+     * than indexing the stream value by value from Lua.
+     *
+     * If the source is a stream, all of its values are written.
+     * If the source stream has a different value type, each value is converted.
+     *
+     * @name buffer.set_stream
+     * @param stream [type:bufferstream] the destination stream
+     * @param offset [type:number] the offset to start writing data to (measured in value type)
+     * @param values [type:table|bufferstream] the values to write
+     *
+     * @examples
+     * How to update the positions of a mesh in one call
+     *
+     * ```lua
+     * local positions = buffer.get_stream(self.buffer, hash("position"))
+     * local values = {}
+     * for i=1,#positions do
+     *     values[i] = math.random()
+     * end
+     * buffer.set_stream(positions, 0, values)
+     * ```
+     */
+    static int SetStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* dststream = CheckStream(L, 1);
+        int dstoffset = luaL_checkint(L, 2);
+
+        if (lua_istable(L, 3))
+        {
+            int count = (int)lua_objlen(L, 3);
+            if (!IsStreamRangeValid(dststream, dstoffset, count))
+            {
+                return DM_LUA_ERROR("buffer.set_stream: Trying to write outside of the stream: Stream length: %u, Offset: %d, Values to write: %d", dststream->m_Count * dststream->m_TypeCount, dstoffset, count);
+            }
+
+            #define DM_SET_STREAM(_T_) SetStreamFromTableT<_T_>(L, 3, (_T_*)dststream->m_Data, dstoffset, dststream->m_Stride, count, dststream->m_TypeCount)
+            switch(dststream->m_Type)
+            {
+            case dmBuffer::VALUE_TYPE_UINT8:      DM_SET_STREAM(uint8_t); break;
+            case dmBuffer::VALUE_TYPE_UINT16:     DM_SET_STREAM(uint16_t); break;
+            case dmBuffer::VALUE_TYPE_UINT32:     DM_SET_STREAM(uint32_t); break;
+            case dmBuffer::VALUE_TYPE_UINT64:     DM_SET_STREAM(uint64_t); break;
+            case dmBuffer::VALUE_TYPE_INT8:       DM_SET_STREAM(int8_t); break;
+            case dmBuffer::VALUE_TYPE_INT16:      DM_SET_STREAM(int16_t); break;
+            case dmBuffer::VALUE_TYPE_INT32:      DM_SET_STREAM(int32_t); break;
+            case dmBuffer::VALUE_TYPE_INT64:      DM_SET_STREAM(int64_t); break;
+            case dmBuffer::VALUE_TYPE_FLOAT32:    DM_SET_STREAM(float); break;
+            default:
+                return DM_LUA_ERROR("Unknown stream value type: %d", dststream->m_Type);
+            }
+            #undef DM_SET_STREAM
+            dmBuffer::UpdateContentVersion(dststream->m_Buffer);
+            return 0;
+        }
+
+        if (!IsStream(L, 3))
+        {
+            return luaL_typerror(L, 3, "table or bufferstream");
+        }
+
+        BufferStream* srcstream = CheckStream(L, 3);
+        int count = (int)(srcstream->m_Count * srcstream->m_TypeCount);
+        if (!IsStreamRangeValid(dststream, dstoffset, count))
+        {
+            return DM_LUA_ERROR("buffer.set_stream: Trying to write outside of the stream: Stream length: %u, Offset: %d, Values to write: %d", dststream->m_Count * dststream->m_TypeCount, dstoffset, count);
+        }
+
+        if (dststream->m_Type == srcstream->m_Type && dststream->m_TypeCount == srcstream->m_TypeCount)
+        {
+            if (!CopyStreamInternal(dststream, dstoffset, srcstream, 0, count))
+            {
+                return DM_LUA_ERROR("Unknown stream value type: %d", dststream->m_Type);
+            }
+        }
+        else
+        {
+            ConvertStreamInternal(dststream, dstoffset, srcstream, 0, count);
+        }
+        dmBuffer::UpdateContentVersion(dststream->m_Buffer);
+        return 0;
+    }
+
+    /*# sets a range of values in a stream to a single value
+     *
+     * Set `count` values in a stream, starting at `offset`, to the same value.
+     *
+     * @name buffer.fill_stream
+     * @param stream [type:bufferstream] the destination stream
+     * @param offset [type:number] the offset to start writing data to (measured in value type)
+     * @param count [type:number] the number of values to write (measured in value type)
+     * @param value [type:number] the value to write
+     *
+     * @examples
+     * How to clear the alpha channel of an image
+     *
+     * ```lua
+     * local alpha = buffer.get_stream(self.image, hash("a"))
+     * buffer.fill_stream(alpha, 0, #alpha, 255)
+     * ```
+     */
+    static int FillStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+        int count = luaL_checkint(L, 3);
+        lua_Number value = luaL_checknumber(L, 4);
+        if (!IsStreamRangeValid(stream, offset, count))
+        {
+            return DM_LUA_ERROR("buffer.fill_stream: Trying to write outside of the stream: Stream length: %u, Offset: %d, Values to write: %d", stream->m_Count * stream->m_TypeCount, offset, count);
+        }
+
+        #define DM_FILL_STREAM(_T_) FillStreamT<_T_>((_T_*)stream->m_Data, offset, stream->m_Stride, count, stream->m_TypeCount, value)
+        switch(stream->m_Type)
+        {
+        case dmBuffer::VALUE_TYPE_UINT8:      DM_FILL_STREAM(uint8_t); break;
+        case dmBuffer::VALUE_TYPE_UINT16:     DM_FILL_STREAM(uint16_t); break;
+        case dmBuffer::VALUE_TYPE_UINT32:     DM_FILL_STREAM(uint32_t); break;
+        case dmBuffer::VALUE_TYPE_UINT64:     DM_FILL_STREAM(uint64_t); break;
+        case dmBuffer::VALUE_TYPE_INT8:       DM_FILL_STREAM(int8_t); break;
+        case dmBuffer::VALUE_TYPE_INT16:      DM_FILL_STREAM(int16_t); break;
+        case dmBuffer::VALUE_TYPE_INT32:      DM_FILL_STREAM(int32_t); break;
+        case dmBuffer::VALUE_TYPE_INT64:      DM_FILL_STREAM(int64_t); break;
+        case dmBuffer::VALUE_TYPE_FLOAT32:    DM_FILL_STREAM(float); break;
+        default:
+            return DM_LUA_ERROR("Unknown stream value type: %d", stream->m_Type);
+        }
+        #undef DM_FILL_STREAM
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+    /*# scales and offsets a range of values in a stream
+     *
+     * Multiply `count` values in a stream, starting at `offset`, with `scale` and then add `bias`:
+     * `value = value * scale + bias`
+     *
+     * @name buffer.scale_offset_stream
+     * @param stream [type:bufferstream] the stream to modify
+     * @param offset [type:number] the offset to start modifying data at (measured in value type)
+     * @param count [type:number] the number of values to modify (measured in value type)
+     * @param scale [type:number] the scale
+     * @param bias [type:number] the value added after scaling
+     */
+    static int ScaleOffsetStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+        int count = luaL_checkint(L, 3);
+        lua_Number scale = luaL_checknumber(L, 4);
+        lua_Number bias = luaL_checknumber(L, 5);
+        if (!IsStreamRangeValid(stream, offset, count))
+        {
+            return DM_LUA_ERROR("buffer.scale_offset_stream: Trying to write outside of the stream: Stream length: %u, Offset: %d, Values to write: %d", stream->m_Count * stream->m_TypeCount, offset, count);
+        }
+
+        #define DM_SCALE_OFFSET_STREAM(_T_) ScaleOffsetStreamT<_T_>((_T_*)stream->m_Data, offset, stream->m_Stride, count, stream->m_TypeCount, scale, bias)
+        switch(stream->m_Type)
+        {
+        case dmBuffer::VALUE_TYPE_UINT8:      DM_SCALE_OFFSET_STREAM(uint8_t); break;
+        case dmBuffer::VALUE_TYPE_UINT16:     DM_SCALE_OFFSET_STREAM(uint16_t); break;
+        case dmBuffer::VALUE_TYPE_UINT32:     DM_SCALE_OFFSET_STREAM(uint32_t); break;
+        case dmBuffer::VALUE_TYPE_UINT64:     DM_SCALE_OFFSET_STREAM(uint64_t); break;
+        case dmBuffer::VALUE_TYPE_INT8:       DM_SCALE_OFFSET_STREAM(int8_t); break;
+        case dmBuffer::VALUE_TYPE_INT16:      DM_SCALE_OFFSET_STREAM(int16_t); break;
+        case dmBuffer::VALUE_TYPE_INT32:      DM_SCALE_OFFSET_STREAM(int32_t); break;
+        case dmBuffer::VALUE_TYPE_INT64:      DM_SCALE_OFFSET_STREAM(int64_t); break;
+        case dmBuffer::VALUE_TYPE_FLOAT32:    DM_SCALE_OFFSET_STREAM(float); break;
+        default:
+            return DM_LUA_ERROR("Unknown stream value type: %d", stream->m_Type);
+        }
+        #undef DM_SCALE_OFFSET_STREAM
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+    /*# transforms a range of elements in a stream with a matrix
+     *
+     * Transform `count` elements in a stream, starting at element `offset`, with a matrix.
+     * The stream must be of type `buffer.VALUE_TYPE_FLOAT32` and have 3 or 4 components per element.
+     *
+     * For 3 component streams, `w` decides if the elements are transformed as points (`w` = 1, the default)
+     * or as directions (`w` = 0). Elements of 4 component streams are transformed as is.
+     *
+     * @name buffer.transform_stream
+     * @param stream [type:bufferstream] the stream to modify
+     * @param offset [type:number] the first element to transform (measured in elements)
+     * @param count [type:number] the number of elements to transform (measured in elements)
+     * @param matrix [type:matrix4] the transform
+     * @param [w] [type:number] 1 to transform points, 0 to transform directions. Defaults to 1.
+     *
+     * @examples
+     * How to rotate the positions and normals of a mesh
+     *
+     * ```lua
+     * local m = vmath.matrix4_rotation_z(math.pi * 0.5)
+     * local positions = buffer.get_stream(self.buffer, hash("position"))
+     * local normals = buffer.get_stream(self.buffer, hash("normal"))
+     * buffer.transform_stream(positions, 0, #positions / 3, m)
+     * buffer.transform_stream(normals, 0, #normals / 3, m, 0)
+     * ```
+     */
+    static int TransformStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+        int count = luaL_checkint(L, 3);
+        Vectormath::Aos::Matrix4 m = *dmScript::CheckMatrix4(L, 4);
+        lua_Number w = luaL_optnumber(L, 5, 1.0);
+
+        if (stream->m_Type != dmBuffer::VALUE_TYPE_FLOAT32)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: Expected stream of type 'buffer.%s', got 'buffer.%s'",
+                                    dmBuffer::GetValueTypeString(dmBuffer::VALUE_TYPE_FLOAT32), dmBuffer::GetValueTypeString(stream->m_Type));
+        }
+        if (stream->m_TypeCount != 3 && stream->m_TypeCount != 4)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: Expected stream with 3 or 4 components, got %u", stream->m_TypeCount);
+        }
+        if (offset < 0 || count < 0 || (uint32_t)(offset + count) > stream->m_Count)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: Trying to write outside of the stream: Stream length: %u elements, Offset: %d, Elements to write: %d", stream->m_Count, offset, count);
+        }
+
+        float* data = (float*)stream->m_Data + offset * stream->m_Stride;
+        uint32_t stride = stream->m_Stride;
+        if (stream->m_TypeCount == 4)
+        {
+            for (int i = 0; i < count; ++i, data += stride)
+            {
+                Vectormath::Aos::Vector4 v = m * Vectormath::Aos::Vector4(data[0], data[1], data[2], data[3]);
+                data[0] = v.getX();
+                data[1] = v.getY();
+                data[2] = v.getZ();
+                data[3] = v.getW();
+            }
+        }
+        else if (w != 0.0)
+        {
+            for (int i = 0; i < count; ++i, data += stride)
+            {
+                Vectormath::Aos::Vector4 v = m * Vectormath::Aos::Point3(data[0], data[1], data[2]);
+                data[0] = v.getX();
+                data[1] = v.getY();
+                data[2] = v.getZ();
+            }
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i, data += stride)
+            {
+                Vectormath::Aos::Vector4 v = m * Vectormath::Aos::Vector3(data[0], data[1], data[2]);
+                data[0] = v.getX();
+                data[1] = v.getY();
+                data[2] = v.getZ();
+            }
+        }
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
         return 0;
     }
 
@@ -868,6 +1219,7 @@ namespace dmGameSystem
         uint32_t count = index / stream->m_TypeCount;
         uint32_t component = index % stream->m_TypeCount;
         stream->m_Set(stream->m_Data, count * stream->m_Stride + component, luaL_checknumber(L, 3));
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
         return 0;
     }
 
@@ -894,6 +1246,10 @@ namespace dmGameSystem
         {"get_bytes", GetBytes},
         {"copy_stream", CopyStream},
         {"copy_buffer", CopyBuffer},
+        {"set_stream", SetStream},
+        {"fill_stream", FillStream},
+        {"scale_offset_stream", ScaleOffsetStream},
+        {"transform_stream", TransformStream},
         {0, 0}
     };
 
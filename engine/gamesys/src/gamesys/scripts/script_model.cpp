@@ -522,6 +522,55 @@ namespace dmGameSystem
         return 0;
     }
 
+    /*# sets whether a model is visible
+     * Tells the model whether it is visible, typically from a script that knows what the camera sees.
+     * Models are visible when created.
+     *
+     * The animation of a model that is not visible keeps playing, and animation events are still sent,
+     * but the bone pose is only evaluated every `model.offscreen_update_interval` update and not at all once the
+     * model has not been visible for `model.offscreen_pose_timeout` updates, as set in the project settings.
+     * The bone game objects only follow the evaluated poses. When the model is made visible again, the pose
+     * and the bone game objects are brought up to date right away.
+     *
+     * @name model.set_visible
+     * @param url [type:string|hash|url] the model to set the visibility for
+     * @param visible [type:boolean] true if the model is visible
+     * @examples
+     *
+     * ```lua
+     * function on_message(self, message_id, message, sender)
+     *     if message_id == hash("left_room") then
+     *         model.set_visible("#model", false)
+     *     elseif message_id == hash("entered_room") then
+     *         model.set_visible("#model", true)
+     *     end
+     * end
+     * ```
+     */
+    int LuaModelComp_SetVisible(lua_State* L)
+    {
+        int top = lua_gettop(L);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        uintptr_t user_data;
+        dmMessage::URL receiver;
+        ModelWorld* world = 0;
+        dmGameObject::GetComponentUserDataFromLua(L, 1, collection, MODEL_EXT, &user_data, &receiver, (void**) &world);
+        ModelComponent* component = CompModelGetComponent(world, user_data);
+        if (!component)
+        {
+            return luaL_error(L, "the component '%s' could not be found", lua_tostring(L, 1));
+        }
+
+        luaL_checktype(L, 2, LUA_TBOOLEAN);
+        CompModelSetVisible(world, component, lua_toboolean(L, 2));
+
+        assert(top == lua_gettop(L));
+        return 0;
+    }
+
     static const luaL_reg MODEL_COMP_FUNCTIONS[] =
     {
             {"play",    LuaModelComp_Play},
@@ -530,6 +579,7 @@ namespace dmGameSystem
             {"get_go",  LuaModelComp_GetGO},
             {"set_constant",    LuaModelComp_SetConstant},
             {"reset_constant",  LuaModelComp_ResetConstant},
+            {"set_visible",     LuaModelComp_SetVisible},
             {0, 0}
     };
 
@@ -109,6 +109,38 @@ namespace dmGameSystem
      * @variable
      */
 
+    /*# collision event type
+     *
+     * See `physics.events()`.
+     *
+     * @name physics.EVENT_COLLISION
+     * @variable
+     */
+
+    /*# contact point event type
+     *
+     * See `physics.events()`.
+     *
+     * @name physics.EVENT_CONTACT_POINT
+     * @variable
+     */
+
+    /*# trigger enter event type
+     *
+     * See `physics.events()`.
+     *
+     * @name physics.EVENT_TRIGGER_ENTER
+     * @variable
+     */
+
+    /*# trigger exit event type
+     *
+     * See `physics.events()`.
+     *
+     * @name physics.EVENT_TRIGGER_EXIT
+     * @variable
+     */
+
     struct PhysicsScriptContext
     {
         dmMessage::HSocket m_Socket;
@@ -465,6 +497,339 @@ namespace dmGameSystem
         return 1;
     }
 
+    static uint32_t CheckGroupMask(lua_State* L, int index, void* world)
+    {
+        uint32_t mask = 0;
+        luaL_checktype(L, index, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, index) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+        return mask;
+    }
+
+    // Arrays of the result of physics.raycast_batch, see Physics_RayCastBatch
+    enum RayCastBatchField
+    {
+        RAY_CAST_BATCH_FIELD_INDEX,
+        RAY_CAST_BATCH_FIELD_ID,
+        RAY_CAST_BATCH_FIELD_GROUP,
+        RAY_CAST_BATCH_FIELD_FRACTION,
+        RAY_CAST_BATCH_FIELD_POSITION, // Packed, three numbers per hit
+        RAY_CAST_BATCH_FIELD_NORMAL,   // Packed, three numbers per hit
+        RAY_CAST_BATCH_FIELD_COUNT
+    };
+
+    static const char* RAY_CAST_BATCH_FIELD_NAMES[RAY_CAST_BATCH_FIELD_COUNT] = {
+        "index", "id", "group", "fraction", "position", "normal"
+    };
+
+    /*# performs several ray casts at once
+     *
+     * Performs a list of ray casts synchronously, in the same way as [ref:physics.raycast].
+     * Each ray only reports its closest hit. Large batches are spread over several
+     * threads, which makes this considerably cheaper than calling [ref:physics.raycast]
+     * once per ray.
+     *
+     * The hits are returned as parallel arrays instead of one table per hit, so the
+     * number of tables created does not grow with the size of the batch.
+     *
+     * @name physics.raycast_batch
+     * @param from [type:table] a lua table with the world positions of the start of each ray
+     * @param to [type:table] a lua table with the world positions of the end of each ray. Must have the same length as `from`.
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] a table with one array per field of the hits. Hit `n` is made up of the `n`th
+     * element of each array, in ray order:
+     *
+     * `count`
+     * : [type:number] number of rays that hit something
+     *
+     * `index`
+     * : [type:table] index of the ray in `from`/`to`
+     *
+     * `id`
+     * : [type:table] instance id of the hit collision object, a [type:hash]
+     *
+     * `group`
+     * : [type:table] collision group of the hit collision object, a [type:hash]
+     *
+     * `fraction`
+     * : [type:table] fraction of the ray at which the hit occurred, a [type:number]
+     *
+     * `position`
+     * : [type:table] world positions of the hits, packed as three numbers per hit. The position of hit `n` is at `3*n-2`, `3*n-1` and `3*n`
+     *
+     * `normal`
+     * : [type:table] normals of the hit surfaces, packed like `position`
+     *
+     * @examples
+     *
+     * How to cast a fan of rays:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local from = {}
+     *     local to = {}
+     *     local pos = go.get_position()
+     *     for i = 1, 32 do
+     *         local angle = i * math.pi / 16
+     *         from[i] = pos
+     *         to[i] = pos + vmath.vector3(math.cos(angle), math.sin(angle), 0) * 100
+     *     end
+     *     local result = physics.raycast_batch(from, to, self.groups)
+     *     local position = result.position
+     *     for n = 1, result.count do
+     *         local p = vmath.vector3(position[3*n-2], position[3*n-1], position[3*n])
+     *         handle_hit(result.index[n], result.id[n], p)
+     *     end
+     * end
+     * ```
+     */
+    int Physics_RayCastBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.raycast_batch");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        uint32_t count = (uint32_t)lua_objlen(L, 1);
+        if (count != (uint32_t)lua_objlen(L, 2))
+        {
+            return luaL_error(L, "physics.raycast_batch: 'from' and 'to' must have the same length (%d vs %d)", (int)count, (int)lua_objlen(L, 2));
+        }
+
+        uint32_t mask = CheckGroupMask(L, 3, world);
+
+        dmArray<dmPhysics::RayCastRequest> requests;
+        requests.SetCapacity(count);
+        requests.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::RayCastRequest& request = requests[i];
+            lua_rawgeti(L, 1, i+1);
+            request.m_From = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            lua_rawgeti(L, 2, i+1);
+            request.m_To = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+            request.m_Mask = mask;
+        }
+
+        dmArray<dmPhysics::RayCastResponse> responses;
+        responses.SetCapacity(count);
+        responses.SetSize(count);
+        dmGameSystem::RayCastBatch(world, requests.Begin(), count, responses.Begin());
+
+        uint32_t hit_count = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            hit_count += responses[i].m_Hit;
+        }
+
+        lua_createtable(L, 0, RAY_CAST_BATCH_FIELD_COUNT + 1);
+        int result = lua_gettop(L);
+        lua_pushinteger(L, hit_count);
+        lua_setfield(L, result, "count");
+        for (uint32_t f = 0; f < RAY_CAST_BATCH_FIELD_COUNT; ++f)
+        {
+            lua_createtable(L, f >= RAY_CAST_BATCH_FIELD_POSITION ? hit_count * 3 : hit_count, 0);
+            lua_pushvalue(L, -1);
+            lua_setfield(L, result, RAY_CAST_BATCH_FIELD_NAMES[f]);
+        }
+
+        // The field arrays are on the stack above the result, in RayCastBatchField order
+        int hit = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmPhysics::RayCastResponse& response = responses[i];
+            if (!response.m_Hit)
+                continue;
+            ++hit;
+
+            lua_pushinteger(L, i+1);
+            lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_INDEX, hit);
+            dmScript::PushHash(L, dmGameSystem::CompCollisionObjectGetIdentifier(response.m_CollisionObjectUserData));
+            lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_ID, hit);
+            dmScript::PushHash(L, dmGameSystem::GetLSBGroupHash(world, response.m_CollisionObjectGroup));
+            lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_GROUP, hit);
+            lua_pushnumber(L, response.m_Fraction);
+            lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_FRACTION, hit);
+            for (int c = 0; c < 3; ++c)
+            {
+                lua_pushnumber(L, response.m_Position.getElem(c));
+                lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_POSITION, hit * 3 - 2 + c);
+                lua_pushnumber(L, response.m_Normal.getElem(c));
+                lua_rawseti(L, result + 1 + RAY_CAST_BATCH_FIELD_NORMAL, hit * 3 - 2 + c);
+            }
+        }
+        lua_pop(L, RAY_CAST_BATCH_FIELD_COUNT);
+
+        return 1;
+    }
+
+    /*# tests several shapes for overlapping collision objects at once
+     *
+     * Tests a list of boxes and spheres against the collision objects in the physics world
+     * and reports which objects each of them overlaps. Trigger objects are not reported.
+     * In 3D worlds the test is made against the bounding boxes of the collision objects.
+     * Large batches are spread over several threads.
+     *
+     * The overlaps are returned as parallel arrays instead of one table per overlap, so the
+     * number of tables created does not grow with the size of the batch.
+     *
+     * @name physics.overlap_batch
+     * @param queries [type:table] a lua table with one table per query. Each query has a `position` [type:vector3] and
+     * either a `size` [type:vector3] for an axis aligned box or a `radius` [type:number] for a sphere.
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @return result [type:table] a table with one array per field of the overlaps. Overlap `n` is made up of the `n`th
+     * element of each array, in query order:
+     *
+     * `count`
+     * : [type:number] number of overlaps found
+     *
+     * `index`
+     * : [type:table] index of the query in `queries`
+     *
+     * `id`
+     * : [type:table] instance id of the overlapped collision object, a [type:hash]
+     *
+     * `group`
+     * : [type:table] collision group of the overlapped collision object, a [type:hash]
+     *
+     * @examples
+     *
+     * How to find enemies close to a list of points:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local queries = {}
+     *     for i,p in ipairs(self.points) do
+     *         queries[i] = { position = p, radius = 16 }
+     *     end
+     *     local result = physics.overlap_batch(queries, {hash("enemy")})
+     *     for n = 1, result.count do
+     *         msg.post(result.id[n], "alert")
+     *     end
+     * end
+     * ```
+     */
+    int Physics_OverlapBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.overlap_batch");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+
+        luaL_checktype(L, 1, LUA_TTABLE);
+        uint32_t count = (uint32_t)lua_objlen(L, 1);
+        uint32_t mask = CheckGroupMask(L, 2, world);
+
+        dmArray<dmPhysics::OverlapRequest> requests;
+        requests.SetCapacity(count);
+        requests.SetSize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::OverlapRequest& request = requests[i];
+            request = dmPhysics::OverlapRequest();
+            request.m_Mask = mask;
+
+            lua_rawgeti(L, 1, i+1);
+            luaL_checktype(L, -1, LUA_TTABLE);
+
+            lua_getfield(L, -1, "position");
+            request.m_Position = Vectormath::Aos::Point3(*dmScript::CheckVector3(L, -1));
+            lua_pop(L, 1);
+
+            lua_getfield(L, -1, "radius");
+            if (!lua_isnil(L, -1))
+            {
+                request.m_Shape = dmPhysics::OVERLAP_SHAPE_SPHERE;
+                request.m_Radius = (float)luaL_checknumber(L, -1);
+                lua_pop(L, 1);
+            }
+            else
+            {
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "size");
+                if (lua_isnil(L, -1))
+                {
+                    lua_pop(L, 2);
+                    return luaL_error(L, "physics.overlap_batch: query %d must have either a 'size' or a 'radius'", (int)(i+1));
+                }
+                request.m_Shape = dmPhysics::OVERLAP_SHAPE_BOX;
+                request.m_HalfExtents = *dmScript::CheckVector3(L, -1) * 0.5f;
+                lua_pop(L, 1);
+            }
+
+            lua_pop(L, 1);
+        }
+
+        dmArray<dmPhysics::OverlapResponse> responses;
+        responses.SetCapacity(count);
+        responses.SetSize(count);
+        dmArray<dmPhysics::OverlapHit> hits;
+        dmGameSystem::OverlapBatch(world, requests.Begin(), count, responses.Begin(), hits);
+
+        uint32_t hit_count = hits.Size();
+        lua_createtable(L, 0, 4);
+        int result = lua_gettop(L);
+        lua_pushinteger(L, hit_count);
+        lua_setfield(L, result, "count");
+        lua_createtable(L, hit_count, 0);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, result, "index");
+        lua_createtable(L, hit_count, 0);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, result, "id");
+        lua_createtable(L, hit_count, 0);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, result, "group");
+
+        // The index, id and group arrays are on the stack above the result.
+        // The hits are already stored in request order.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmPhysics::OverlapResponse& response = responses[i];
+            for (uint32_t h = response.m_HitOffset; h < response.m_HitOffset + response.m_HitCount; ++h)
+            {
+                const dmPhysics::OverlapHit& hit = hits[h];
+                lua_pushinteger(L, i+1);
+                lua_rawseti(L, result + 1, h+1);
+                dmScript::PushHash(L, dmGameSystem::CompCollisionObjectGetIdentifier(hit.m_CollisionObjectUserData));
+                lua_rawseti(L, result + 2, h+1);
+                dmScript::PushHash(L, dmGameSystem::GetLSBGroupHash(world, hit.m_CollisionObjectGroup));
+                lua_rawseti(L, result + 3, h+1);
+            }
+        }
+        lua_pop(L, 3);
+
+        return 1;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1057,11 +1422,219 @@ namespace dmGameSystem
         return Physics_SetFlipInternal(L, false);
     }
 
+    // Upvalues of the events iterator
+    enum EventsIteratorUpvalue
+    {
+        EVENTS_UPVALUE_FILTER = 1,
+        EVENTS_UPVALUE_TABLE,
+        EVENTS_UPVALUE_POSITION_A,
+        EVENTS_UPVALUE_POSITION_B,
+        EVENTS_UPVALUE_NORMAL,
+        EVENTS_UPVALUE_RELATIVE_VELOCITY,
+        EVENTS_UPVALUE_COUNT = EVENTS_UPVALUE_RELATIVE_VELOCITY
+    };
+
+    static void SetVector3Field(lua_State* L, int upvalue, const char* name, const Vectormath::Aos::Vector3& value)
+    {
+        *dmScript::CheckVector3(L, lua_upvalueindex(upvalue)) = value;
+        lua_pushvalue(L, lua_upvalueindex(upvalue));
+        lua_setfield(L, -2, name);
+    }
+
+    static void ClearField(lua_State* L, const char* name)
+    {
+        lua_pushnil(L);
+        lua_setfield(L, -2, name);
+    }
+
+    // Writes the event to the table of the iterator, which is reused for all events
+    static void PushCollisionEvent(lua_State* L, const CollisionEvent& event)
+    {
+        lua_pushvalue(L, lua_upvalueindex(EVENTS_UPVALUE_TABLE));
+
+        lua_pushinteger(L, event.m_Type);
+        lua_setfield(L, -2, "type");
+        dmScript::PushHash(L, event.m_IdA);
+        lua_setfield(L, -2, "id_a");
+        dmScript::PushHash(L, event.m_IdB);
+        lua_setfield(L, -2, "id_b");
+        dmScript::PushHash(L, event.m_GroupA);
+        lua_setfield(L, -2, "group_a");
+        dmScript::PushHash(L, event.m_GroupB);
+        lua_setfield(L, -2, "group_b");
+
+        if (event.m_Type == COLLISION_EVENT_TYPE_CONTACT_POINT)
+        {
+            SetVector3Field(L, EVENTS_UPVALUE_POSITION_A, "position_a", Vectormath::Aos::Vector3(event.m_PositionA));
+            SetVector3Field(L, EVENTS_UPVALUE_POSITION_B, "position_b", Vectormath::Aos::Vector3(event.m_PositionB));
+            SetVector3Field(L, EVENTS_UPVALUE_NORMAL, "normal", event.m_Normal);
+            SetVector3Field(L, EVENTS_UPVALUE_RELATIVE_VELOCITY, "relative_velocity", event.m_RelativeVelocity);
+            lua_pushnumber(L, event.m_Distance);
+            lua_setfield(L, -2, "distance");
+            lua_pushnumber(L, event.m_AppliedImpulse);
+            lua_setfield(L, -2, "applied_impulse");
+            lua_pushnumber(L, event.m_MassA);
+            lua_setfield(L, -2, "mass_a");
+            lua_pushnumber(L, event.m_MassB);
+            lua_setfield(L, -2, "mass_b");
+        }
+        else
+        {
+            ClearField(L, "position_a");
+            ClearField(L, "position_b");
+            ClearField(L, "normal");
+            ClearField(L, "relative_velocity");
+            ClearField(L, "distance");
+            ClearField(L, "applied_impulse");
+            ClearField(L, "mass_a");
+            ClearField(L, "mass_b");
+        }
+    }
+
+    // Generic for iterator, the control variable is the 1-based index of the last returned event.
+    // The world is looked up on every call so that a stored iterator can't outlive it.
+    static int Physics_EventsNext(lua_State* L)
+    {
+        int filter = (int)lua_tointeger(L, lua_upvalueindex(EVENTS_UPVALUE_FILTER));
+        uint32_t index = (uint32_t)luaL_checkinteger(L, 2);
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(CheckGoInstance(L));
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+
+        uint32_t count = 0;
+        const CollisionEvent* events = world ? GetCollisionEvents(world, &count) : 0x0;
+        while (index < count && filter >= 0 && events[index].m_Type != filter)
+        {
+            ++index;
+        }
+        if (index >= count)
+        {
+            return 0;
+        }
+
+        lua_pushinteger(L, index + 1);
+        PushCollisionEvent(L, events[index]);
+        return 2;
+    }
+
+    /*# iterates over the collision events of the last physics step
+     *
+     * Iterates over the collisions, contact points and trigger events reported during the most recent
+     * physics step of the collection that the function is called from.
+     *
+     * The event buffer is only filled when `physics.use_event_buffer` is set in the game.project file.
+     * In that mode no `collision_response`, `contact_point_response` or `trigger_response` messages are sent,
+     * and all events of a step are kept, regardless of `physics.max_collisions` and `physics.max_contacts`.
+     * When the setting is off, the iterator yields nothing.
+     *
+     * Each event is reported once per pair of collision objects, instead of once to each of them.
+     * The events are replaced when the physics world is stepped next, so they are typically read
+     * in the `update` function of a script.
+     *
+     * To avoid allocations, the iterator returns the same table for every event, and the same vector3 values
+     * for the contact point fields, overwritten with each new event. Copy the values that need to be kept
+     * after the next step of the loop.
+     *
+     * @name physics.events
+     * @param [type] [type:constant] only iterate over events of this type
+     *
+     * - `physics.EVENT_COLLISION`
+     * - `physics.EVENT_CONTACT_POINT`
+     * - `physics.EVENT_TRIGGER_ENTER`
+     * - `physics.EVENT_TRIGGER_EXIT`
+     *
+     * @return iterator [type:function] iterator returning the index and a table for each event:
+     *
+     * `type`
+     * : [type:constant] the event type
+     *
+     * `id_a`
+     * : [type:hash] the id of the instance of the first collision object
+     *
+     * `id_b`
+     * : [type:hash] the id of the instance of the second collision object
+     *
+     * `group_a`
+     * : [type:hash] the collision group of the first collision object
+     *
+     * `group_b`
+     * : [type:hash] the collision group of the second collision object
+     *
+     * Contact point events also have the following fields:
+     *
+     * `position_a`
+     * : [type:vector3] world position of the contact point on the first collision object
+     *
+     * `position_b`
+     * : [type:vector3] world position of the contact point on the second collision object
+     *
+     * `normal`
+     * : [type:vector3] normal in world space of the contact point, which points from the first object towards the second
+     *
+     * `relative_velocity`
+     * : [type:vector3] the relative velocity of the second collision object as observed from the first
+     *
+     * `distance`
+     * : [type:number] the penetration distance between the objects, which is always positive
+     *
+     * `applied_impulse`
+     * : [type:number] the impulse the contact resulted in
+     *
+     * `mass_a`
+     * : [type:number] the mass of the first collision object in kg
+     *
+     * `mass_b`
+     * : [type:number] the mass of the second collision object in kg
+     *
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     for _, event in physics.events(physics.EVENT_CONTACT_POINT) do
+     *         if event.applied_impulse > 100 then
+     *             play_impact(event.position_a, event.applied_impulse)
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    static int Physics_Events(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 3);
+
+        int filter = -1;
+        if (!lua_isnoneornil(L, 1))
+        {
+            filter = luaL_checkinteger(L, 1);
+            if (filter < COLLISION_EVENT_TYPE_COLLISION || filter > COLLISION_EVENT_TYPE_TRIGGER_EXIT)
+            {
+                return DM_LUA_ERROR("invalid event type: %d", filter);
+            }
+        }
+
+        lua_pushinteger(L, filter);
+        lua_createtable(L, 0, 13);
+        dmScript::PushVector3(L, Vectormath::Aos::Vector3(0.0f));
+        dmScript::PushVector3(L, Vectormath::Aos::Vector3(0.0f));
+        dmScript::PushVector3(L, Vectormath::Aos::Vector3(0.0f));
+        dmScript::PushVector3(L, Vectormath::Aos::Vector3(0.0f));
+        lua_pushcclosure(L, Physics_EventsNext, EVENTS_UPVALUE_COUNT);
+        lua_pushnil(L);
+        lua_pushinteger(L, 0);
+        return 3;
+    }
+
     static const luaL_reg PHYSICS_FUNCTIONS[] =
     {
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_batch",   Physics_RayCastBatch},
+        {"overlap_batch",   Physics_OverlapBatch},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
@@ -1075,6 +1648,8 @@ namespace dmGameSystem
 
         {"set_hflip",       Physics_SetFlipH},
         {"set_vflip",       Physics_SetFlipV},
+
+        {"events",          Physics_Events},
         {0, 0}
     };
 
@@ -1083,14 +1658,19 @@ namespace dmGameSystem
         lua_State* L = context.m_LuaState;
         luaL_register(L, "physics", PHYSICS_FUNCTIONS);
 
-#define SETCONSTANT(name) \
-    lua_pushnumber(L, (lua_Number) dmPhysics::name); \
+#define SETCONSTANT(name, val) \
+    lua_pushnumber(L, (lua_Number) val); \
     lua_setfield(L, -2, #name);\
 
-        SETCONSTANT(JOINT_TYPE_SPRING)
-        SETCONSTANT(JOINT_TYPE_FIXED)
-        SETCONSTANT(JOINT_TYPE_HINGE)
-        SETCONSTANT(JOINT_TYPE_SLIDER)
+        SETCONSTANT(JOINT_TYPE_SPRING, dmPhysics::JOINT_TYPE_SPRING)
+        SETCONSTANT(JOINT_TYPE_FIXED, dmPhysics::JOINT_TYPE_FIXED)
+        SETCONSTANT(JOINT_TYPE_HINGE, dmPhysics::JOINT_TYPE_HINGE)
+        SETCONSTANT(JOINT_TYPE_SLIDER, dmPhysics::JOINT_TYPE_SLIDER)
+
+        SETCONSTANT(EVENT_COLLISION, COLLISION_EVENT_TYPE_COLLISION)
+        SETCONSTANT(EVENT_CONTACT_POINT, COLLISION_EVENT_TYPE_CONTACT_POINT)
+        SETCONSTANT(EVENT_TRIGGER_ENTER, COLLISION_EVENT_TYPE_TRIGGER_ENTER)
+        SETCONSTANT(EVENT_TRIGGER_EXIT, COLLISION_EVENT_TYPE_TRIGGER_EXIT)
 
  #undef SETCONSTANT
 
@@ -746,6 +746,50 @@ namespace dmGameSystem
         return 0;
     }
 
+    /*# sets whether a spine model is visible
+     * Tells the spine model whether it is visible, typically from a script that knows what the camera sees.
+     * Spine models are visible when created.
+     *
+     * The animation of a spine model that is not visible keeps playing, and animation events are still sent,
+     * but the bone pose is only evaluated every `spine.offscreen_update_interval` update and not at all once the
+     * spine model has not been visible for `spine.offscreen_pose_timeout` updates, as set in the project settings.
+     * The bone game objects only follow the evaluated poses. When the spine model is made visible again, the pose
+     * and the bone game objects are brought up to date right away.
+     *
+     * @name spine.set_visible
+     * @param url [type:string|hash|url] the spine model to set the visibility for
+     * @param visible [type:boolean] true if the spine model is visible
+     * @examples
+     *
+     * The following examples assumes that the spine model has id "spinemodel".
+     *
+     * ```lua
+     * function update(self, dt)
+     *   -- self.view_min and self.view_max are the world space corners of the camera view
+     *   local p = go.get_world_position()
+     *   local inside = p.x > self.view_min.x and p.x < self.view_max.x and p.y > self.view_min.y and p.y < self.view_max.y
+     *   spine.set_visible("#spinemodel", inside)
+     * end
+     * ```
+     */
+    int SpineComp_SetVisible(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        uintptr_t user_data;
+        dmMessage::URL receiver;
+        SpineModelWorld* world = 0;
+        dmGameObject::GetComponentUserDataFromLua(L, 1, collection, SPINE_MODEL_EXT, &user_data, &receiver, (void**) &world);
+        SpineModelComponent* component = world->m_Components.Get(user_data);
+
+        luaL_checktype(L, 2, LUA_TBOOLEAN);
+        CompSpineModelSetVisible(world, component, lua_toboolean(L, 2));
+        return 0;
+    }
+
     static const luaL_reg SPINE_COMP_FUNCTIONS[] =
     {
             {"play",    SpineComp_Play},
@@ -758,6 +802,7 @@ namespace dmGameSystem
             {"reset_ik_target",        SpineComp_ResetIK},
             {"set_constant",    SpineComp_SetConstant},
             {"reset_constant",  SpineComp_ResetConstant},
+            {"set_visible",     SpineComp_SetVisible},
             {0, 0}
     };
 
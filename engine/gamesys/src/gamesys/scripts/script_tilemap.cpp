@@ -13,6 +13,7 @@
 
 #include <dlib/configfile.h>
 #include <dlib/log.h>
+#include <dlib/message.h>
 #include <ddf/ddf.h>
 #include <gameobject/gameobject.h>
 #include <render/render.h>
@@ -299,6 +300,185 @@ namespace dmGameSystem
         return 1;
     }
 
+    // Flip flag of a tile in tilemap.set_tiles, given either for all tiles or as a list with one entry per tile
+    static bool GetTileFlip(lua_State* L, int index, int tile_index)
+    {
+        if (!lua_istable(L, index))
+        {
+            return lua_toboolean(L, index);
+        }
+        lua_rawgeti(L, index, tile_index + 1);
+        bool flip = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        return flip;
+    }
+
+    static const uint32_t MAX_GRID_SHAPE_HULLS_PER_MESSAGE = (dmMessage::DM_MESSAGE_MAX_DATA_SIZE - sizeof(dmPhysicsDDF::SetGridShapeHulls)) / sizeof(dmPhysicsDDF::SetGridShapeHull);
+
+    static void PostSetGridShapeHulls(const dmMessage::URL* sender, const dmMessage::URL* receiver, dmPhysicsDDF::SetGridShapeHulls* ddf)
+    {
+        dmhash_t message_id = dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_NameHash;
+        uintptr_t descriptor = (uintptr_t)dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor;
+        uint32_t data_size = sizeof(dmPhysicsDDF::SetGridShapeHulls) + ddf->m_CellCount * sizeof(dmPhysicsDDF::SetGridShapeHull);
+        dmMessage::Result result = dmMessage::Post(sender, receiver, message_id, 0, descriptor, ddf, data_size, 0);
+        if (result != dmMessage::RESULT_OK)
+        {
+            dmLogError("Could not send %s to components, result: %d.", dmPhysicsDDF::SetGridShapeHulls::m_DDFDescriptor->m_Name, result);
+        }
+    }
+
+    /*# set multiple tiles in a tile map
+     * Replace a rectangular area of tiles in a tile map with new tiles.
+     * The tiles are given as a flat list, row by row, starting with the
+     * bottom left tile at coordinates x,y and continuing to the right and then upwards.
+     * The last row may be shorter than the width. The coordinates are indexed the same way as
+     * in [ref:tilemap.set_tile()].
+     *
+     * All tiles must be within the bounds of the tile map, otherwise no tile is changed.
+     * To clear a tile, set the tile to number 0.
+     *
+     * Changing many tiles with a single call is considerably cheaper than calling
+     * [ref:tilemap.set_tile()] for each tile, since any collision objects using the tile map
+     * are updated once for the whole area.
+     *
+     * @name tilemap.set_tiles
+     * @param url [type:string|hash|url] the tile map
+     * @param layer [type:string|hash] name of the layer for the tiles
+     * @param x [type:number] x-coordinate of the bottom left tile
+     * @param y [type:number] y-coordinate of the bottom left tile
+     * @param width [type:number] number of tiles per row
+     * @param tiles [type:table] indices of the new tiles
+     * @param [h-flipped] [type:boolean|table] optional if the tiles should be horizontally flipped, either for all tiles or as a list with one entry per tile
+     * @param [v-flipped] [type:boolean|table] optional if the tiles should be vertically flipped, either for all tiles or as a list with one entry per tile
+     * @return success [type:boolean] true if the tiles were set
+     * @examples
+     *
+     * ```lua
+     * -- Clear a 3x3 area around the explosion.
+     * local empty = { 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+     * tilemap.set_tiles("/level#tilemap", "foreground", self.explosion_x - 1, self.explosion_y - 1, 3, empty)
+     * ```
+     *
+     * ```lua
+     * -- Mirror a 2x1 door, flipping only the right half.
+     * tilemap.set_tiles("/level#tilemap", "foreground", x, y, 2, { 7, 7 }, { false, true })
+     * ```
+     */
+    static int TileMap_SetTiles(lua_State* L)
+    {
+        int top = lua_gettop(L);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        uintptr_t user_data;
+        dmMessage::URL receiver;
+        dmGameObject::GetComponentUserDataFromLua(L, 1, collection, TILE_MAP_EXT, &user_data, &receiver, 0);
+        TileGridComponent* component = (TileGridComponent*) user_data;
+
+        dmhash_t layer_id = dmScript::CheckHashOrString(L, 2);
+
+        uint32_t layer_index = GetLayerIndex(component, layer_id);
+        if (layer_index == ~0u)
+        {
+            dmLogError("Could not find layer '%s'.", dmHashReverseSafe64(layer_id));
+            lua_pushboolean(L, 0);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        int x = luaL_checkinteger(L, 3) - 1;
+        int y = luaL_checkinteger(L, 4) - 1;
+        int width = luaL_checkinteger(L, 5);
+        if (width <= 0)
+        {
+            return luaL_error(L, "tilemap.set_tiles called with invalid width (%d)", width);
+        }
+        luaL_checktype(L, 6, LUA_TTABLE);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender))
+        {
+            return luaL_error(L, "tilemap.set_tiles is not available from this script-type.");
+        }
+
+        int count = (int)lua_objlen(L, 6);
+        int height = (count + width - 1) / width;
+
+        int min_x, min_y, grid_w, grid_h;
+        GetTileGridBounds(component, &min_x, &min_y, &grid_w, &grid_h);
+
+        int32_t cell_x, cell_y;
+        GetTileGridCellCoord(component, x, y, cell_x, cell_y);
+
+        if (count > 0 && (cell_x < 0 || cell_x + width > grid_w || cell_y < 0 || cell_y + height > grid_h))
+        {
+            dmLogError("Could not set the tiles since the supplied area was out of range.");
+            lua_pushboolean(L, 0);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        // Validate all tiles before changing any of them, see tilemap.set_tile for the valid range
+        int tile_count = (int)GetTileCount(component);
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(L, 6, i + 1);
+            if (!lua_isnumber(L, -1))
+            {
+                return luaL_error(L, "tilemap.set_tiles expected a tile index at position %d, got %s", i + 1, luaL_typename(L, -1));
+            }
+            int lua_tile = lua_tointeger(L, -1);
+            lua_pop(L, 1);
+            if (lua_tile < 0 || lua_tile > tile_count)
+            {
+                return luaL_error(L, "tilemap.set_tiles called with out-of-range tile index (%d)", lua_tile);
+            }
+        }
+
+        // Broadcast to any collision object components, in as few messages as possible
+        uint32_t buffer[dmMessage::DM_MESSAGE_MAX_DATA_SIZE / sizeof(uint32_t)];
+        dmPhysicsDDF::SetGridShapeHulls* set_hulls_ddf = (dmPhysicsDDF::SetGridShapeHulls*) buffer;
+        dmPhysicsDDF::SetGridShapeHull* set_hull_ddfs = (dmPhysicsDDF::SetGridShapeHull*) (set_hulls_ddf + 1);
+        set_hulls_ddf->m_CellCount = 0;
+        receiver.m_Fragment = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            lua_rawgeti(L, 6, i + 1);
+            // See TileMap_SetTile for why the tile index is subtracted by 1
+            uint32_t tile = lua_tointeger(L, -1) - 1;
+            lua_pop(L, 1);
+
+            int32_t tile_x = cell_x + i % width;
+            int32_t tile_y = cell_y + i / width;
+            bool flip_h = GetTileFlip(L, 7, i);
+            bool flip_v = GetTileFlip(L, 8, i);
+            SetTileGridTile(component, layer_index, tile_x, tile_y, tile, flip_h, flip_v);
+
+            dmPhysicsDDF::SetGridShapeHull* set_hull_ddf = &set_hull_ddfs[set_hulls_ddf->m_CellCount++];
+            set_hull_ddf->m_Shape = layer_index;
+            set_hull_ddf->m_Column = tile_x;
+            set_hull_ddf->m_Row = tile_y;
+            set_hull_ddf->m_Hull = tile;
+            set_hull_ddf->m_FlipHorizontal = flip_h;
+            set_hull_ddf->m_FlipVertical = flip_v;
+            if (set_hulls_ddf->m_CellCount == MAX_GRID_SHAPE_HULLS_PER_MESSAGE)
+            {
+                PostSetGridShapeHulls(&sender, &receiver, set_hulls_ddf);
+                set_hulls_ddf->m_CellCount = 0;
+            }
+        }
+        if (set_hulls_ddf->m_CellCount > 0)
+        {
+            PostSetGridShapeHulls(&sender, &receiver, set_hulls_ddf);
+        }
+
+        lua_pushboolean(L, 1);
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
     /*# get a tile from a tile map
      * Get the tile set at the specified position in the tilemap.
      * The position is identified by the tile index starting at origo
@@ -475,6 +655,7 @@ namespace dmGameSystem
         {"set_constant",    TileMap_SetConstant},
         {"reset_constant",  TileMap_ResetConstant},
         {"set_tile",        TileMap_SetTile},
+        {"set_tiles",       TileMap_SetTiles},
         {"get_tile",        TileMap_GetTile},
         {"get_bounds",      TileMap_GetBounds},
         {"set_visible",     TileMap_SetVisible},
@@ -0,0 +1,8 @@
+components {
+  id: "collisionobject"
+  component: "/collision_object/joint_test_sphere_kinematic.collisionobject"
+}
+components {
+  id: "script"
+  component: "/collision_object/batch_query_test.script"
+}
@@ -0,0 +1,4 @@
+components {
+  id: "collisionobject"
+  component: "/collision_object/joint_test_sphere.collisionobject"
+}
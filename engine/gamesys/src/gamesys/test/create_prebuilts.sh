@@ -51,3 +51,4 @@ cp build/default/mesh/no_data.bufferc ../mesh/no_data.prebuilt_bufferc
 cp build/default/mesh/no_data.meshc ../mesh/no_data.prebuilt_meshc
 cp build/default/mesh/triangle.bufferc ../mesh/triangle.prebuilt_bufferc
 cp build/default/mesh/triangle.meshc ../mesh/triangle.prebuilt_meshc
+cp build/default/mesh/triangle_world.meshc ../mesh/triangle_world.prebuilt_meshc
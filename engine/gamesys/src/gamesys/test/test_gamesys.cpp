@@ -18,16 +18,20 @@
 #include "gamesys/resources/res_textureset.h"
 
 #include <stdio.h>
+#include <float.h>
 
 #include <dlib/dstrings.h>
 #include <dlib/time.h>
 #include <dlib/path.h>
+#include <dlib/sys.h>
 
 #include <ddf/ddf.h>
 #include <gameobject/gameobject_ddf.h>
 #include "../proto/gamesys_ddf.h"
 #include "../proto/sprite_ddf.h"
 #include "../components/comp_label.h"
+#include "../components/comp_mesh.h"
+#include "../resources/res_buffer.h"
 
 namespace dmGameSystem
 {
@@ -154,6 +158,44 @@ TEST_F(ResourceTest, TestReloadTextureSet)
     dmResource::Release(m_Factory, (void**) resource);
 }
 
+TEST_F(ResourceTest, TestFlatTextureSet)
+{
+    const char* texture_set_path      = "/textureset/valid_a.texturesetc";
+    const char* flat_texture_set_path = "/textureset/flat.texturesetc";
+
+    void* buffer = 0;
+    uint32_t buffer_size = 0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetRaw(m_Factory, texture_set_path, &buffer, &buffer_size));
+    dmArray<uint8_t> flat;
+    ASSERT_EQ(dmDDF::RESULT_OK, dmDDF::SaveFlatMessage(buffer, buffer_size, dmGameSystemDDF::TextureSet::m_DDFDescriptor, flat));
+    free(buffer);
+
+    char path[128];
+    dmSnPrintf(path, sizeof(path), "%s/%s", ROOT, flat_texture_set_path);
+    FILE* f = fopen(path, "wb");
+    ASSERT_NE((FILE*)0, f);
+    ASSERT_EQ(flat.Size(), fwrite(flat.Begin(), 1, flat.Size(), f));
+    fclose(f);
+
+    // The flat format is loaded by the resource type like any other texture set
+    dmGameSystem::TextureSetResource* resource = NULL;
+    dmGameSystem::TextureSetResource* flat_resource = NULL;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, texture_set_path, (void**) &resource));
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, flat_texture_set_path, (void**) &flat_resource));
+
+    ASSERT_EQ(resource->m_Texture, flat_resource->m_Texture);
+    ASSERT_EQ(resource->m_TextureSet->m_Animations.m_Count, flat_resource->m_TextureSet->m_Animations.m_Count);
+    for (uint32_t i = 0; i < resource->m_TextureSet->m_Animations.m_Count; ++i)
+    {
+        ASSERT_STREQ(resource->m_TextureSet->m_Animations[i].m_Id, flat_resource->m_TextureSet->m_Animations[i].m_Id);
+    }
+    ASSERT_EQ(resource->m_TextureSet->m_TexCoords.m_Count, flat_resource->m_TextureSet->m_TexCoords.m_Count);
+    ASSERT_EQ(0, memcmp(resource->m_TextureSet->m_TexCoords.m_Data, flat_resource->m_TextureSet->m_TexCoords.m_Data, resource->m_TextureSet->m_TexCoords.m_Count));
+
+    dmResource::Release(m_Factory, (void*) flat_resource);
+    dmResource::Release(m_Factory, (void*) resource);
+}
+
 TEST_P(ResourceFailTest, Test)
 {
     const ResourceFailParams& p = GetParam();
@@ -1169,6 +1211,134 @@ TEST_P(BoxRenderTest, BoxRender)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+/* GUI node vertex cache */
+
+// Renders the collection and returns the largest x-coordinate of the generated gui vertices
+static float RenderGuiMaxX(dmRender::HRenderContext render_context, dmGameObject::HCollection collection, dmGameSystem::GuiWorld* world)
+{
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0);
+
+    float max_x = -FLT_MAX;
+    for (uint32_t i = 0; i < world->m_ClientVertexBuffer.Size(); ++i)
+    {
+        max_x = dmMath::Max(max_x, world->m_ClientVertexBuffer[i].m_Position[0]);
+    }
+    return max_x;
+}
+
+TEST_F(ComponentTest, GuiNodeVertexCache)
+{
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/gui/render_box_test7.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    dmGameSystem::GuiWorld* world = (dmGameSystem::GuiWorld*)m_GuiContext.m_Worlds[0];
+    dmGameSystem::GuiComponent* component = world->m_Components[0];
+    dmGui::HScene scene = component->m_Scene;
+    dmGui::SetSceneAdjustReference(scene, dmGui::ADJUST_REFERENCE_DISABLED);
+
+    // Only render a plain box node made by the test
+    dmGui::SetNodeEnabled(scene, dmGui::GetNodeById(scene, "box"), false);
+    dmGui::HNode node = dmGui::NewNode(scene, Point3(0, 0, 0), Vector3(10, 10, 0), dmGui::NODE_TYPE_BOX);
+    ASSERT_NE((dmGui::HNode)0, node);
+    uint16_t index = dmGui::GetNodeIndex(scene, node);
+
+    ASSERT_NEAR(5.0f, RenderGuiMaxX(m_RenderContext, m_Collection, world), 0.0001f);
+    ASSERT_LT(index, component->m_NodeVertexCaches.Size());
+    ASSERT_EQ(node, component->m_NodeVertexCaches[index].m_Node);
+
+    // Unchanged, the cached vertices are used
+    ASSERT_NEAR(5.0f, RenderGuiMaxX(m_RenderContext, m_Collection, world), 0.0001f);
+
+    // A changed property misses the cache
+    dmGui::SetNodeProperty(scene, node, dmGui::PROPERTY_SIZE, Vector4(20, 20, 0, 0));
+    ASSERT_NEAR(10.0f, RenderGuiMaxX(m_RenderContext, m_Collection, world), 0.0001f);
+    dmGui::SetNodeProperty(scene, node, dmGui::PROPERTY_COLOR, Vector4(1, 0, 0, 1));
+    RenderGuiMaxX(m_RenderContext, m_Collection, world);
+    ASSERT_EQ(0.0f, component->m_NodeVertexCaches[index].m_Key.m_Color.getY());
+
+    // A new node that reuses the index is never served the vertices of the deleted node,
+    // even when it has the same properties. The cache slot is only refilled on a miss.
+    dmGui::DeleteNode(scene, node, true);
+    dmGui::HNode new_node = dmGui::NewNode(scene, Point3(0, 0, 0), Vector3(20, 20, 0), dmGui::NODE_TYPE_BOX);
+    dmGui::SetNodeProperty(scene, new_node, dmGui::PROPERTY_COLOR, Vector4(1, 0, 0, 1));
+    ASSERT_NE(node, new_node);
+    ASSERT_EQ(index, dmGui::GetNodeIndex(scene, new_node));
+    ASSERT_NEAR(10.0f, RenderGuiMaxX(m_RenderContext, m_Collection, world), 0.0001f);
+    ASSERT_EQ(new_node, component->m_NodeVertexCaches[index].m_Node);
+
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+/* Mesh world space batch cache */
+
+// Updates and renders the collection and returns the amount of world space vertex data uploaded
+static uint32_t RenderMeshUploadedVertexSize(dmRender::HRenderContext render_context, dmGameObject::HCollection collection, const dmGameObject::UpdateContext* update_context, dmGameSystem::MeshWorld* world)
+{
+    dmGameObject::Update(collection, update_context);
+
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0);
+
+    dmGameObject::PostUpdate(collection);
+    return world->m_UploadedVertexSize;
+}
+
+TEST_F(ComponentTest, MeshWorldBatchSharedBuffer)
+{
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    // Two components sharing the same buffer
+    dmGameObject::HInstance go1 = Spawn(m_Factory, m_Collection, "/mesh/triangle_world.goc", dmHashString64("/go1"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go1);
+    dmGameObject::HInstance go2 = Spawn(m_Factory, m_Collection, "/mesh/triangle_world.goc", dmHashString64("/go2"), 0, 0, Point3(10, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go2);
+
+    dmResource::ResourceType resource_type;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, "meshc", &resource_type));
+    uint32_t component_index;
+    ASSERT_NE((void*)0, dmGameObject::FindComponentType(m_Register, resource_type, &component_index));
+    dmGameSystem::MeshWorld* world = (dmGameSystem::MeshWorld*)dmGameObject::GetWorld(m_Collection, component_index);
+    ASSERT_NE((void*)0, world);
+
+    dmGameSystem::BufferResource* buffer_resource = 0x0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/mesh/triangle.bufferc", (void**)&buffer_resource));
+    uint32_t size = 0;
+    void* data = 0x0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetBytes(buffer_resource->m_Buffer, &data, &size));
+
+    // The first frame generates the vertices of both components
+    ASSERT_EQ(2 * size, RenderMeshUploadedVertexSize(m_RenderContext, m_Collection, &m_UpdateContext, world));
+
+    // Unchanged, the cached vertices are used
+    ASSERT_EQ(0u, RenderMeshUploadedVertexSize(m_RenderContext, m_Collection, &m_UpdateContext, world));
+    ASSERT_EQ(0u, RenderMeshUploadedVertexSize(m_RenderContext, m_Collection, &m_UpdateContext, world));
+
+    // A changed buffer misses the cache for both components
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::UpdateContentVersion(buffer_resource->m_Buffer));
+    ASSERT_EQ(2 * size, RenderMeshUploadedVertexSize(m_RenderContext, m_Collection, &m_UpdateContext, world));
+
+    // A moved component only misses the cache for itself
+    dmGameObject::SetPosition(go2, Point3(20, 0, 0));
+    ASSERT_EQ(size, RenderMeshUploadedVertexSize(m_RenderContext, m_Collection, &m_UpdateContext, world));
+
+    dmResource::Release(m_Factory, buffer_resource);
+    dmGraphics::Flip(m_GraphicsContext);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 /* Gamepad connected */
 
 TEST_F(GamepadConnectedTest, TestGamepadConnectedInputEvent)
@@ -1281,6 +1451,86 @@ TEST_F(ComponentTest, JointTest)
 
 }
 
+/* Physics event buffer */
+TEST_F(ComponentTest, EventBufferTest)
+{
+    /* Setup:
+    ** event_buffer_test_a
+    ** - [collisionobject] collision_object/joint_test_sphere_kinematic.collisionobject
+    ** - [script] collision_object/event_buffer_test.script
+    ** event_buffer_test_b
+    ** - [collisionobject] collision_object/joint_test_sphere.collisionobject
+    */
+
+    dmHashEnableReverseHash(true);
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    m_PhysicsContext.m_UseEventBuffer = true;
+
+    dmGameObject::HInstance go_b = Spawn(m_Factory, m_Collection, "/collision_object/event_buffer_test_b.goc", dmHashString64("/event_buffer_test_b"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_b);
+
+    dmGameObject::HInstance go_a = Spawn(m_Factory, m_Collection, "/collision_object/event_buffer_test_a.goc", dmHashString64("/event_buffer_test_a"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go_a);
+
+    // The overlapping spheres should be reported within a few steps
+    bool tests_done = false;
+    for (uint32_t i = 0; i < 10 && !tests_done; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+        lua_getglobal(L, "tests_done");
+        tests_done = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+    ASSERT_TRUE(tests_done);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+
+    m_PhysicsContext.m_UseEventBuffer = false;
+
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
+/* Physics batch queries */
+TEST_F(ComponentTest, BatchQueryTest)
+{
+    /* Setup:
+    ** batch_query_test
+    ** - [collisionobject] collision_object/joint_test_sphere_kinematic.collisionobject
+    ** - [script] collision_object/batch_query_test.script
+    */
+
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/collision_object/batch_query_test.goc", dmHashString64("/batch_query_test"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+
+    lua_getglobal(L, "tests_done");
+    ASSERT_TRUE(lua_toboolean(L, -1));
+    lua_pop(L, 1);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
 /* Camera */
 
 const char* valid_camera_resources[] = {"/camera/valid.camerac"};
@@ -1461,7 +1711,7 @@ INSTANTIATE_TEST_CASE_P(Buffer, ResourceTest, jc_test_values_in(valid_buffer_res
 
 /* Mesh */
 
-const char* valid_mesh_resources[] = {"/mesh/no_data.meshc", "/mesh/triangle.meshc"};
+const char* valid_mesh_resources[] = {"/mesh/no_data.meshc", "/mesh/triangle.meshc", "/mesh/triangle_world.meshc"};
 INSTANTIATE_TEST_CASE_P(Mesh, ResourceTest, jc_test_values_in(valid_mesh_resources));
 
 /* MeshSet */
@@ -1660,6 +1910,42 @@ INSTANTIATE_TEST_CASE_P(TileGrid, ResourceTest, jc_test_values_in(valid_tilegrid
 const char* valid_tileset_gos[] = {"/tile/valid_tilegrid.goc", "/tile/valid_tilegrid_collisionobject.goc"};
 INSTANTIATE_TEST_CASE_P(TileSet, ComponentTest, jc_test_values_in(valid_tileset_gos));
 
+TEST_F(ComponentTest, TileMapSetTiles)
+{
+    /* Setup:
+    ** set_tiles
+    ** - [tilegrid] tile/valid.tilegrid
+    ** - [collisionobject] collision_object/valid_tilegrid.collisionobject
+    ** - [script] tile/set_tiles.script
+    */
+
+    lua_State* L = dmScript::GetLuaState(m_ScriptContext);
+
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory = m_Factory;
+    scriptlibcontext.m_Register = m_Register;
+    scriptlibcontext.m_LuaState = L;
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/tile/set_tiles.goc", dmHashString64("/set_tiles"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    // The second update makes sure the hull messages posted by the script have been handled
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+    }
+
+    lua_getglobal(L, "tests_done");
+    ASSERT_TRUE(lua_toboolean(L, -1));
+    lua_pop(L, 1);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
 /* Texture */
 
 const char* valid_texture_resources[] = {"/texture/valid_png.texturec", "/texture/blank_4096_png.texturec"};
@@ -2601,6 +2887,174 @@ const CopyBufferTestParams buffer_copy_setups[] = {
 INSTANTIATE_TEST_CASE_P(ScriptBufferCopySequence, ScriptBufferCopyTest, jc_test_values_in(buffer_copy_setups));
 
 
+TEST_F(ScriptBufferTest, SetStream)
+{
+    int top = lua_gettop(L);
+
+    uint16_t* stream_rgb = 0;
+    uint32_t count_rgb = 0;
+    uint32_t components_rgb = 0;
+    uint32_t stride_rgb = 0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(m_Buffer, dmHashString64("rgb"), (void**)&stream_rgb, &count_rgb, &components_rgb, &stride_rgb));
+
+    float* stream_a = 0;
+    uint32_t count_a = 0;
+    uint32_t components_a = 0;
+    uint32_t stride_a = 0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(m_Buffer, dmHashString64("a"), (void**)&stream_a, &count_a, &components_a, &stride_a));
+
+    dmScript::LuaHBuffer luabuf = {m_Buffer, dmScript::OWNER_C};
+    dmScript::PushBuffer(L, luabuf);
+    lua_setglobal(L, "test_buffer");
+
+    // From a table, offset from aligned boundaries
+    memset_stream(stream_rgb, count_rgb, components_rgb, stride_rgb, (uint16_t)0);
+    ASSERT_TRUE(RunString(L, "local stream = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                               local values = {} \
+                               for i=1,10 do \
+                                   values[i] = i \
+                               end \
+                               buffer.set_stream(stream, 4, values) \
+                              "));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(m_Buffer));
+
+    uint16_t* rgb = stream_rgb;
+    for (uint32_t i = 0, x = 0; i < 8; ++i)
+    {
+        for (uint32_t c = 0; c < components_rgb; ++c, ++x)
+        {
+            if (x < 4 || x >= 14)
+                ASSERT_EQ(0, rgb[c]);
+            else
+                ASSERT_EQ(x - 3, rgb[c]);
+        }
+        rgb += stride_rgb;
+    }
+
+    // From a stream of a different value type
+    memset_stream(stream_a, count_a, components_a, stride_a, 0.0f);
+    ASSERT_TRUE(RunString(L, "local srcbuffer = buffer.create( 16, { {name=hash(\"temp\"), type=buffer.VALUE_TYPE_UINT8, count=1 } } ) \
+                               local srcstream = buffer.get_stream(srcbuffer, \"temp\") \
+                               for i=1,#srcstream do \
+                                   srcstream[i] = i * 2 \
+                               end \
+                               local dststream = buffer.get_stream(test_buffer, hash(\"a\")) \
+                               buffer.set_stream(dststream, 16, srcstream) \
+                              "));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(m_Buffer));
+
+    float* a = stream_a;
+    for (uint32_t i = 0; i < 48; ++i)
+    {
+        if (i < 16 || i >= 32)
+            ASSERT_EQ(0.0f, a[0]);
+        else
+            ASSERT_EQ((float)((i - 15) * 2), a[0]);
+        a += stride_a;
+    }
+
+    dmLogWarning("Expected error outputs ->");
+
+    // Buffer overrun (write)
+    memset_stream(stream_a, count_a, components_a, stride_a, 76.0f);
+    ASSERT_FALSE(RunString(L, "local stream = buffer.get_stream(test_buffer, hash(\"a\")) \
+                                buffer.set_stream(stream, #stream - 1, {1, 2, 3}) \
+                               "));
+    lua_pop(L, 1);
+
+    a = stream_a;
+    for (uint32_t i = 0; i < count_a; ++i)
+    {
+        ASSERT_EQ(76.0f, a[0]);
+        a += stride_a;
+    }
+
+    dmLogWarning("<- Expected error outputs end.");
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
+TEST_F(ScriptBufferTest, FillAndScaleOffsetStream)
+{
+    int top = lua_gettop(L);
+
+    uint16_t* stream_rgb = 0;
+    uint32_t count_rgb = 0;
+    uint32_t components_rgb = 0;
+    uint32_t stride_rgb = 0;
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(m_Buffer, dmHashString64("rgb"), (void**)&stream_rgb, &count_rgb, &components_rgb, &stride_rgb));
+
+    dmScript::LuaHBuffer luabuf = {m_Buffer, dmScript::OWNER_C};
+    dmScript::PushBuffer(L, luabuf);
+    lua_setglobal(L, "test_buffer");
+
+    memset_stream(stream_rgb, count_rgb, components_rgb, stride_rgb, (uint16_t)0);
+    ASSERT_TRUE(RunString(L, "local stream = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                               buffer.fill_stream(stream, 2, #stream - 4, 3) \
+                               buffer.scale_offset_stream(stream, 0, #stream, 4, 1) \
+                              "));
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(m_Buffer));
+
+    uint32_t length = count_rgb * components_rgb;
+    uint16_t* rgb = stream_rgb;
+    for (uint32_t i = 0, x = 0; i < count_rgb; ++i)
+    {
+        for (uint32_t c = 0; c < components_rgb; ++c, ++x)
+        {
+            if (x < 2 || x >= length - 2)
+                ASSERT_EQ(1, rgb[c]);
+            else
+                ASSERT_EQ(13, rgb[c]);
+        }
+        rgb += stride_rgb;
+    }
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
+TEST_F(ScriptBufferTest, TransformStream)
+{
+    int top = lua_gettop(L);
+
+    ASSERT_TRUE(RunString(L, "local buf = buffer.create( 4, { {name=hash(\"position\"), type=buffer.VALUE_TYPE_FLOAT32, count=3 }, \
+                                                            {name=hash(\"normal\"), type=buffer.VALUE_TYPE_FLOAT32, count=3 } } ) \
+                               local positions = buffer.get_stream(buf, \"position\") \
+                               local normals = buffer.get_stream(buf, \"normal\") \
+                               buffer.set_stream(positions, 0, {1,0,0, 0,1,0, 0,0,1, 1,1,1}) \
+                               buffer.set_stream(normals, 0, {1,0,0, 0,1,0, 0,0,1, 1,1,1}) \
+                               local m = vmath.matrix4_translation(vmath.vector3(10, 20, 30)) \
+                               buffer.transform_stream(positions, 1, 2, m) \
+                               buffer.transform_stream(normals, 1, 2, m, 0) \
+                               local expected_positions = {1,0,0, 10,21,30, 10,20,31, 1,1,1} \
+                               local expected_normals = {1,0,0, 0,1,0, 0,0,1, 1,1,1} \
+                               for i=1,#positions do \
+                                   assert(positions[i] == expected_positions[i]) \
+                                   assert(normals[i] == expected_normals[i]) \
+                               end \
+                              "));
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
+// Compares writing a stream value by value from Lua with buffer.set_stream
+TEST_F(ScriptBufferTest, SetStreamLarge)
+{
+    const uint32_t count = 50000;
+    char program[1024];
+    dmSnPrintf(program, sizeof(program),
+        "local buf = buffer.create(%u, { {name=hash(\"position\"), type=buffer.VALUE_TYPE_FLOAT32, count=3 } })\n"
+        "local stream = buffer.get_stream(buf, \"position\")\n"
+        "local values = {}\n"
+        "for i=1,#stream do\n"
+        "    values[i] = i * 0.5\n"
+        "end\n"
+        "buffer.set_stream(stream, 0, values)\n"
+        "for i=1,#stream do\n"
+        "    assert(stream[i] == values[i])\n"
+        "end\n", count);
+    ASSERT_TRUE(RunString(L, program));
+}
+
 TEST_F(ScriptBufferTest, RefCount)
 {
     bool run;
@@ -2639,6 +3093,43 @@ TEST_F(ScriptBufferTest, RefCount)
 #endif
 }
 
+// Loads and frees compiled resources from the test data with dmDDF::LoadMessage
+TEST(DDFLoad, CompiledResources)
+{
+    struct DDFFile
+    {
+        const char*              m_Path;
+        const dmDDF::Descriptor* m_Descriptor;
+    } files[] = {
+        {"/collection_proxy/valid.collectionc", dmGameObjectDDF::CollectionDesc::m_DDFDescriptor},
+        {"/collection_factory/collectionfactory_test.collectionc", dmGameObjectDDF::CollectionDesc::m_DDFDescriptor},
+        {"/collection_proxy/input_consume.collectionc", dmGameObjectDDF::CollectionDesc::m_DDFDescriptor},
+        {"/resource/res_getset_prop.goc", dmGameObjectDDF::PrototypeDesc::m_DDFDescriptor},
+        {"/collection_factory/collectionfactory_resource.goc", dmGameObjectDDF::PrototypeDesc::m_DDFDescriptor},
+        {"/sprite/valid_sprite.goc", dmGameObjectDDF::PrototypeDesc::m_DDFDescriptor},
+        {"/textureset/valid_a.texturesetc", dmGameSystemDDF::TextureSet::m_DDFDescriptor},
+        {"/tile/valid.texturesetc", dmGameSystemDDF::TextureSet::m_DDFDescriptor},
+    };
+
+    for (uint32_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+    {
+        char path[128];
+        dmSnPrintf(path, sizeof(path), "%s%s", ROOT, files[i].m_Path);
+
+        uint32_t size = 0;
+        ASSERT_EQ(dmSys::RESULT_OK, dmSys::ResourceSize(path, &size));
+        char* buffer = (char*) malloc(size);
+        ASSERT_EQ(dmSys::RESULT_OK, dmSys::LoadResource(path, buffer, size, &size));
+
+        void* message = 0;
+        dmDDF::Result r = dmDDF::LoadMessage(buffer, size, files[i].m_Descriptor, &message);
+        free(buffer);
+        ASSERT_EQ(dmDDF::RESULT_OK, r);
+        ASSERT_NE((void*)0, message);
+        dmDDF::FreeMessage(message);
+    }
+}
+
 int main(int argc, char **argv)
 {
     dmHashEnableReverseHash(true);
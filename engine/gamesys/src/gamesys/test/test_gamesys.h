@@ -49,6 +49,7 @@ protected:
     dmGraphics::HContext m_GraphicsContext;
     dmRender::HRenderContext m_RenderContext;
     dmGameSystem::PhysicsContext m_PhysicsContext;
+    dmGameSystem::TextureContext m_TextureContext;
     dmGameSystem::ParticleFXContext m_ParticleFXContext;
     dmGameSystem::GuiContext m_GuiContext;
     dmHID::HContext m_HidContext;
@@ -328,7 +329,9 @@ void GamesysTest<T>::SetUp()
 
     m_SoundContext.m_MaxComponentCount = 32;
 
-    dmResource::Result r = dmGameSystem::RegisterResourceTypes(m_Factory, m_RenderContext, &m_GuiContext, m_InputContext, &m_PhysicsContext);
+    dmGameSystem::InitializeTextureContext(m_TextureContext, m_GraphicsContext);
+
+    dmResource::Result r = dmGameSystem::RegisterResourceTypes(m_Factory, m_RenderContext, &m_GuiContext, m_InputContext, &m_PhysicsContext, &m_TextureContext);
     assert(dmResource::RESULT_OK == r);
 
     dmResource::Get(m_Factory, "/input/valid.gamepadsc", (void**)&m_GamepadMapsDDF);
@@ -354,6 +357,7 @@ void GamesysTest<T>::TearDown()
     dmScript::Finalize(m_ScriptContext);
     dmScript::DeleteContext(m_ScriptContext);
     dmResource::DeleteFactory(m_Factory);
+    dmGameSystem::FinalizeTextureContext(m_TextureContext);
     dmGameObject::DeleteRegister(m_Register);
     dmSound::Finalize();
     dmInput::DeleteContext(m_InputContext);
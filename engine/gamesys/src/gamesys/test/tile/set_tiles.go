@@ -0,0 +1,12 @@
+components {
+  id: "tilegrid"
+  component: "/tile/valid.tilegrid"
+}
+components {
+  id: "collisionobject"
+  component: "/collision_object/valid_tilegrid.collisionobject"
+}
+components {
+  id: "script"
+  component: "/tile/set_tiles.script"
+}
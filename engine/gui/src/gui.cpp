@@ -250,6 +250,7 @@ namespace dmGui
         scene->m_Width = width;
         scene->m_Height = height;
         scene->m_ResChanged = 1;
+        scene->m_PickDirty = 1;
     }
 
     void GetPhysicalResolution(HScene scene, uint32_t& width, uint32_t& height)
@@ -274,6 +275,7 @@ namespace dmGui
         {
             Scene* scene = scenes[i];
             scene->m_ResChanged = 1;
+            scene->m_PickDirty = 1;
             if(scene->m_OnWindowResizeCallback)
             {
                 scene->m_OnWindowResizeCallback(scene, width, height);
@@ -322,6 +324,7 @@ namespace dmGui
     void SetSceneAdjustReference(HScene scene, AdjustReference adjust_reference)
     {
         scene->m_AdjustReference = adjust_reference;
+        scene->m_PickDirty = 1;
     }
 
     void SetDefaultNewSceneParams(NewSceneParams* params)
@@ -398,6 +401,7 @@ namespace dmGui
         scene->m_RenderHead = INVALID_INDEX;
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NextVersionNumber = 0;
+        scene->m_PickDirty = 1;
         scene->m_RenderOrder = 0;
         scene->m_Width = context->m_DefaultProjectWidth;
         scene->m_Height = context->m_DefaultProjectHeight;
@@ -809,6 +813,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        scene->m_PickDirty = 1;
         return RESULT_OK;
     }
 
@@ -907,6 +912,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 continue;
             set_node_callback(scene, GetNodeHandle(n), n->m_Node.m_NodeDescTable[index]);
             n->m_Node.m_DirtyLocal = 1;
+            scene->m_PickDirty = 1;
         }
         return RESULT_OK;
     }
@@ -974,7 +980,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         return Vector4(scale_x, scale_y, 1.0f, 1.0f);
     }
 
-    inline void CalculateNodeSize(InternalNode* in)
+    inline void CalculateNodeSize(HScene scene, InternalNode* in)
     {
         Node& n = in->m_Node;
         if(n.m_SizeMode == SIZE_MODE_MANUAL || n.m_NodeType == NODE_TYPE_SPINE ||
@@ -987,21 +993,27 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         const float* tc = GetNodeFlipbookAnimUVInternal(in);
         TextureSetAnimDesc* anim_desc = &n.m_TextureSetAnimDesc;
 
-        float w,h;
+        float w,h,size_x,size_y;
         if(tc[0] != tc[2] && tc[3] != tc[5])
         {
             // uv-rotated
             w = tc[2]-tc[0];
             h = tc[1]-tc[5];
-            n.m_Properties[PROPERTY_SIZE][0] = h * (float)anim_desc->m_State.m_OriginalTextureHeight;
-            n.m_Properties[PROPERTY_SIZE][1] = w * (float)anim_desc->m_State.m_OriginalTextureWidth;
+            size_x = h * (float)anim_desc->m_State.m_OriginalTextureHeight;
+            size_y = w * (float)anim_desc->m_State.m_OriginalTextureWidth;
         }
         else
         {
             w = tc[4]-tc[0];
             h = tc[3]-tc[1];
-            n.m_Properties[PROPERTY_SIZE][0] = w * (float)anim_desc->m_State.m_OriginalTextureWidth;
-            n.m_Properties[PROPERTY_SIZE][1] = h * (float)anim_desc->m_State.m_OriginalTextureHeight;
+            size_x = w * (float)anim_desc->m_State.m_OriginalTextureWidth;
+            size_y = h * (float)anim_desc->m_State.m_OriginalTextureHeight;
+        }
+        if (n.m_Properties[PROPERTY_SIZE][0] != size_x || n.m_Properties[PROPERTY_SIZE][1] != size_y)
+        {
+            n.m_Properties[PROPERTY_SIZE][0] = size_x;
+            n.m_Properties[PROPERTY_SIZE][1] = size_y;
+            scene->m_PickDirty = 1;
         }
     }
 
@@ -1445,7 +1457,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             uint16_t index = entry.m_Node & 0xffff;
             InternalNode* n = &scene->m_Nodes[index];
             float opacity = 1.0f;
-            CalculateNodeSize(n);
+            CalculateNodeSize(scene, n);
             CalculateNodeTransformAndAlphaCached(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform, opacity);
             c->m_RenderTransforms.Push(transform);
             c->m_RenderOpacities.Push(opacity);
@@ -1557,6 +1569,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
                 // Flag local transform as dirty for the node
                 scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+                scene->m_PickDirty = 1;
 
                 // Animation complete, see above
                 if (t >= 1.0f)
@@ -2196,6 +2209,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         node->m_Node.m_LineBreak = 0;
         node->m_Node.m_Enabled = 1;
         node->m_Node.m_DirtyLocal = 1;
+        scene->m_PickDirty = 1;
         node->m_Node.m_InheritAlpha = 0;
         node->m_Node.m_ClippingMode = CLIPPING_MODE_NONE;
         node->m_Node.m_ClippingVisible = true;
@@ -2291,6 +2305,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
     static void AddToNodeList(HScene scene, InternalNode* n, InternalNode* parent_n, InternalNode* prev_n)
     {
+        scene->m_PickDirty = 1;
         uint16_t* head = &scene->m_RenderHead, * tail = &scene->m_RenderTail;
         uint16_t parent_index = INVALID_INDEX;
         if (parent_n != 0x0)
@@ -2335,6 +2350,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
     static void RemoveFromNodeList(HScene scene, InternalNode* n)
     {
+        scene->m_PickDirty = 1;
         // Remove from list
         if (n->m_PrevIndex != INVALID_INDEX)
             scene->m_Nodes[n->m_PrevIndex].m_NextIndex = n->m_NextIndex;
@@ -2462,6 +2478,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NodePool.Clear();
         scene->m_Animations.SetSize(0);
+        scene->m_PickDirty = 1;
     }
 
     static Vector4 ApplyAdjustOnReferenceScale(const Vector4& reference_scale, uint32_t adjust_mode)
@@ -2575,6 +2592,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (n->m_HasResetPoint) {
                 memcpy(n->m_Properties, n->m_ResetPointProperties, sizeof(n->m_Properties));
                 n->m_DirtyLocal = 1;
+                scene->m_PickDirty = 1;
                 n->m_State = n->m_ResetPointState;
             }
         }
@@ -2615,6 +2633,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[PROPERTY_POSITION] = Vector4(position);
         n->m_Node.m_DirtyLocal = 1;
+        scene->m_PickDirty = 1;
     }
 
     bool HasPropertyHash(HScene scene, HNode node, dmhash_t property)
@@ -2653,6 +2672,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Properties[property] = value;
         n->m_Node.m_DirtyLocal = 1;
+        scene->m_PickDirty = 1;
     }
 
     void SetNodeResetPoint(HScene scene, HNode node)
@@ -2748,6 +2768,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             {
                 n->m_Node.m_Properties[PROPERTY_SIZE][0] = texture_info->m_OriginalWidth;
                 n->m_Node.m_Properties[PROPERTY_SIZE][1] = texture_info->m_OriginalHeight;
+                scene->m_PickDirty = 1;
             }
             return RESULT_OK;
         } else if (DynamicTexture* texture = scene->m_DynamicTextures.Get(texture_id)) {
@@ -2758,6 +2779,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             {
                 n->m_Node.m_Properties[PROPERTY_SIZE][0] = texture->m_Width;
                 n->m_Node.m_Properties[PROPERTY_SIZE][1] = texture->m_Height;
+                scene->m_PickDirty = 1;
             }
             return RESULT_OK;
         }
@@ -3136,6 +3158,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            scene->m_PickDirty = 1;
             return RESULT_OK;
         }
         else
@@ -3583,6 +3606,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Pivot = (uint32_t) pivot;
+        scene->m_PickDirty = 1;
     }
 
     bool GetNodeIsBone(HScene scene, HNode node)
@@ -3591,6 +3615,12 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         return n->m_Node.m_IsBone;
     }
 
+    uint16_t GetNodeIndex(HScene scene, HNode node)
+    {
+        InternalNode* n = GetNode(scene, node);
+        return n->m_Index;
+    }
+
     void SetNodeIsBone(HScene scene, HNode node, bool is_bone)
     {
         InternalNode* n = GetNode(scene, node);
@@ -3607,6 +3637,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_SizeMode = (uint32_t) size_mode;
+        scene->m_PickDirty = 1;
         if((n->m_Node.m_SizeMode != SIZE_MODE_MANUAL) && (n->m_Node.m_NodeType != NODE_TYPE_SPINE) && (n->m_Node.m_NodeType != NODE_TYPE_PARTICLEFX))
         {
             if (TextureInfo* texture_info = scene->m_Textures.Get(n->m_Node.m_TextureHash))
@@ -3978,7 +4009,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             CancelAnimationComponent(scene, node, &n->m_Node.m_FlipbookAnimPosition);
         else
             AnimateTextureSetAnim(scene, node, offset, playback_rate, anim_complete_callback, callback_userdata1, callback_userdata2);
-        CalculateNodeSize(n);
+        CalculateNodeSize(scene, n);
         return RESULT_OK;
     }
 
@@ -4001,23 +4032,28 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         flip_vertical = n->m_Node.m_TextureSetAnimDesc.m_FlipVertical;
     }
 
-    bool PickNode(HScene scene, HNode node, float x, float y)
+    static Vector4 GetPickPosition(HScene scene, float x, float y)
     {
         Vector4 scale((float) scene->m_Context->m_PhysicalWidth / (float) scene->m_Context->m_DefaultProjectWidth,
                 (float) scene->m_Context->m_PhysicalHeight / (float) scene->m_Context->m_DefaultProjectHeight, 1, 1);
-        Matrix4 transform;
-        InternalNode* n = GetNode(scene, node);
-        CalculateNodeTransform(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+        return Vector4(x * scale.getX(), y * scale.getY(), 0.0f, 1.0f);
+    }
+
+    static Matrix4 CalculatePickTransform(Matrix4 boundary_transform)
+    {
         // DEF-3066 set Z scale to 1.0 to get a sound inverse node transform for picking
-        transform.setElem(2, 2, 1.0f);
-        transform = inverse(transform);
-        Vector4 screen_pos(x * scale.getX(), y * scale.getY(), 0.0f, 1.0f);
-        Vector4 node_pos = transform * screen_pos;
+        boundary_transform.setElem(2, 2, 1.0f);
+        return inverse(boundary_transform);
+    }
+
+    static bool PickBoundary(const Matrix4& pick_transform, const Vector4& screen_pos)
+    {
+        Vector4 node_pos = pick_transform * screen_pos;
         const float EPSILON = 0.0001f;
         // check if we need to project the local position to the node plane
         if (dmMath::Abs(node_pos.getZ()) > EPSILON)
         {
-            Vector4 ray_dir = transform.getCol2();
+            Vector4 ray_dir = pick_transform.getCol2();
             // falsify if node is almost orthogonal to the screen plane, impossible to pick
             if (dmMath::Abs(ray_dir.getZ()) < 0.0001f)
             {
@@ -4031,6 +4067,218 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 && node_pos.getY() <= 1.0f;
     }
 
+    bool PickNode(HScene scene, HNode node, float x, float y)
+    {
+        Matrix4 transform;
+        InternalNode* n = GetNode(scene, node);
+        CalculateNodeTransform(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform);
+        return PickBoundary(CalculatePickTransform(transform), GetPickPosition(scene, x, y));
+    }
+
+    // Number of pick grid cells along each screen axis
+    static const uint32_t PICK_GRID_SIZE = 16;
+
+    static void UpdatePickBounds(InternalNode* n, const Matrix4* parent_world, PickBounds& bounds)
+    {
+        const Node& node = n->m_Node;
+        Matrix4 boundary_transform = node.m_LocalTransform;
+        CalculateNodeExtents(node, CalculateNodeTransformFlags(CALCULATE_NODE_BOUNDARY | CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), boundary_transform);
+        if (parent_world)
+        {
+            boundary_transform = *parent_world * boundary_transform;
+        }
+
+        bounds.m_InverseBoundary = CalculatePickTransform(boundary_transform);
+        bounds.m_Node = GetNodeHandle(n);
+
+        // Picking projects along the screen z-axis, so the screen-space bounds of the unit quad are its projected corners
+        Vector4 corners[4] = {
+            boundary_transform.getCol3(),
+            boundary_transform.getCol3() + boundary_transform.getCol0(),
+            boundary_transform.getCol3() + boundary_transform.getCol1(),
+            boundary_transform.getCol3() + boundary_transform.getCol0() + boundary_transform.getCol1()
+        };
+        bounds.m_Min[0] = bounds.m_Max[0] = corners[0].getX();
+        bounds.m_Min[1] = bounds.m_Max[1] = corners[0].getY();
+        for (uint32_t i = 1; i < 4; ++i)
+        {
+            bounds.m_Min[0] = dmMath::Min(bounds.m_Min[0], (float) corners[i].getX());
+            bounds.m_Min[1] = dmMath::Min(bounds.m_Min[1], (float) corners[i].getY());
+            bounds.m_Max[0] = dmMath::Max(bounds.m_Max[0], (float) corners[i].getX());
+            bounds.m_Max[1] = dmMath::Max(bounds.m_Max[1], (float) corners[i].getY());
+        }
+    }
+
+    // Collects the enabled nodes in hierarchy order and refreshes their bounds
+    static void CollectPickNodes(HScene scene, PickGrid& grid, uint16_t start_index, const Matrix4* parent_world, uint16_t& order)
+    {
+        uint16_t index = start_index;
+        while (index != INVALID_INDEX)
+        {
+            InternalNode* n = &scene->m_Nodes[index];
+            index = n->m_NextIndex;
+            if (!n->m_Node.m_Enabled || n->m_Deleted)
+            {
+                continue;
+            }
+
+            const Node& node = n->m_Node;
+            if (node.m_DirtyLocal || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED))
+            {
+                UpdateLocalTransform(scene, n);
+            }
+            Matrix4 world = node.m_LocalTransform;
+            if (parent_world)
+            {
+                world = *parent_world * world;
+            }
+
+            PickBounds& bounds = grid.m_Bounds[n->m_Index];
+            UpdatePickBounds(n, parent_world, bounds);
+            bounds.m_Order = ((uint32_t) GetLayerIndex(scene, n) << 16) | order++;
+
+            if (grid.m_Nodes.Full())
+            {
+                grid.m_Nodes.OffsetCapacity(dmMath::Max(16U, grid.m_Nodes.Capacity()));
+            }
+            grid.m_Nodes.Push(n->m_Index);
+
+            CollectPickNodes(scene, grid, n->m_ChildHead, &world, order);
+        }
+    }
+
+    struct PickOrderPred
+    {
+        const PickBounds* m_Bounds;
+        PickOrderPred(const PickBounds* bounds) : m_Bounds(bounds) {}
+
+        bool operator ()(uint16_t a, uint16_t b) const
+        {
+            return m_Bounds[a].m_Order < m_Bounds[b].m_Order;
+        }
+    };
+
+    static inline uint32_t GetPickCell(float v, float cell_size)
+    {
+        float cell = v / cell_size;
+        // Also rejects NaN, e.g. for a zero sized screen
+        if (!(cell > 0.0f))
+        {
+            return 0;
+        }
+        return cell < (float) (PICK_GRID_SIZE - 1) ? (uint32_t) cell : PICK_GRID_SIZE - 1;
+    }
+
+    static void UpdatePickGrid(HScene scene)
+    {
+        PickGrid& grid = scene->m_PickGrid;
+        float width = (float) scene->m_Context->m_PhysicalWidth;
+        float height = (float) scene->m_Context->m_PhysicalHeight;
+        const uint32_t cell_count = PICK_GRID_SIZE * PICK_GRID_SIZE;
+        if (!scene->m_PickDirty && grid.m_CellStart.Size() == cell_count + 1 && grid.m_Width == width && grid.m_Height == height)
+        {
+            return;
+        }
+
+        uint32_t node_count = scene->m_Nodes.Size();
+        if (grid.m_Bounds.Capacity() < node_count)
+        {
+            grid.m_Bounds.SetCapacity(node_count);
+        }
+        grid.m_Bounds.SetSize(node_count);
+
+        grid.m_Nodes.SetSize(0);
+        uint16_t order = 0;
+        CollectPickNodes(scene, grid, scene->m_RenderHead, 0x0, order);
+        std::sort(grid.m_Nodes.Begin(), grid.m_Nodes.End(), PickOrderPred(grid.m_Bounds.Begin()));
+        scene->m_PickDirty = 0;
+
+        grid.m_Width = width;
+        grid.m_Height = height;
+        float cell_width = width / PICK_GRID_SIZE;
+        float cell_height = height / PICK_GRID_SIZE;
+
+        if (grid.m_CellStart.Size() != cell_count + 1)
+        {
+            grid.m_CellStart.SetCapacity(cell_count + 1);
+            grid.m_CellStart.SetSize(cell_count + 1);
+        }
+        uint32_t* cell_start = grid.m_CellStart.Begin();
+        memset(cell_start, 0, grid.m_CellStart.Size() * sizeof(uint32_t));
+
+        // Count the nodes per cell and turn the counts into end offsets
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < grid.m_Nodes.Size(); ++i)
+        {
+            const PickBounds& bounds = grid.m_Bounds[grid.m_Nodes[i]];
+            uint32_t x0 = GetPickCell(bounds.m_Min[0], cell_width), x1 = GetPickCell(bounds.m_Max[0], cell_width);
+            uint32_t y0 = GetPickCell(bounds.m_Min[1], cell_height), y1 = GetPickCell(bounds.m_Max[1], cell_height);
+            for (uint32_t y = y0; y <= y1; ++y)
+            {
+                for (uint32_t x = x0; x <= x1; ++x)
+                {
+                    ++cell_start[y * PICK_GRID_SIZE + x];
+                }
+            }
+        }
+        for (uint32_t i = 0; i < cell_count; ++i)
+        {
+            total += cell_start[i];
+            cell_start[i] = total;
+        }
+        cell_start[cell_count] = total;
+
+        // Fill backwards so that each cell ends up in render order, with the offsets moved to the cell starts
+        if (grid.m_CellNodes.Capacity() < total)
+        {
+            grid.m_CellNodes.SetCapacity(total);
+        }
+        grid.m_CellNodes.SetSize(total);
+        for (uint32_t i = grid.m_Nodes.Size(); i > 0; --i)
+        {
+            uint16_t index = grid.m_Nodes[i - 1];
+            const PickBounds& bounds = grid.m_Bounds[index];
+            uint32_t x0 = GetPickCell(bounds.m_Min[0], cell_width), x1 = GetPickCell(bounds.m_Max[0], cell_width);
+            uint32_t y0 = GetPickCell(bounds.m_Min[1], cell_height), y1 = GetPickCell(bounds.m_Max[1], cell_height);
+            for (uint32_t y = y0; y <= y1; ++y)
+            {
+                for (uint32_t x = x0; x <= x1; ++x)
+                {
+                    grid.m_CellNodes[--cell_start[y * PICK_GRID_SIZE + x]] = index;
+                }
+            }
+        }
+    }
+
+    void PickNodes(HScene scene, float x, float y, dmArray<HNode>& out_nodes)
+    {
+        out_nodes.SetSize(0);
+        UpdatePickGrid(scene);
+
+        PickGrid& grid = scene->m_PickGrid;
+        Vector4 screen_pos = GetPickPosition(scene, x, y);
+        float px = screen_pos.getX();
+        float py = screen_pos.getY();
+        uint32_t cell = GetPickCell(py, grid.m_Height / PICK_GRID_SIZE) * PICK_GRID_SIZE + GetPickCell(px, grid.m_Width / PICK_GRID_SIZE);
+        uint32_t start = grid.m_CellStart[cell];
+        for (uint32_t i = grid.m_CellStart[cell + 1]; i > start; --i)
+        {
+            const PickBounds& bounds = grid.m_Bounds[grid.m_CellNodes[i - 1]];
+            if (px < bounds.m_Min[0] || px > bounds.m_Max[0] || py < bounds.m_Min[1] || py > bounds.m_Max[1])
+            {
+                continue;
+            }
+            if (PickBoundary(bounds.m_InverseBoundary, screen_pos))
+            {
+                if (out_nodes.Full())
+                {
+                    out_nodes.OffsetCapacity(16U);
+                }
+                out_nodes.Push(bounds.m_Node);
+            }
+        }
+    }
+
     bool IsNodeEnabled(HScene scene, HNode node)
     {
         InternalNode* n = GetNode(scene, node);
@@ -4041,11 +4289,13 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_DirtyLocal = 1;
+        scene->m_PickDirty = 1;
         uint16_t index = n->m_ChildHead;
         while (index != INVALID_INDEX)
         {
             InternalNode* n = &scene->m_Nodes[index];
             n->m_Node.m_DirtyLocal = 1;
+            scene->m_PickDirty = 1;
             if(n->m_ChildHead != INVALID_INDEX)
             {
                 SetDirtyLocalRecursive(scene, GetNodeHandle(n));
@@ -4058,6 +4308,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Enabled = enabled;
+        scene->m_PickDirty = 1;
         if(enabled)
         {
             SetDirtyLocalRecursive(scene, node);
@@ -4200,6 +4451,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
                 n->m_Node.m_Properties[dmGui::PROPERTY_POSITION] = Vector4(position, 1.0f);
                 n->m_Node.m_DirtyLocal = 1;
+                scene->m_PickDirty = 1;
             }
 
             RemoveFromNodeList(scene, n);
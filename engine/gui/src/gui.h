@@ -1072,6 +1072,15 @@ namespace dmGui
     bool GetNodeIsBone(HScene scene, HNode node);
     void SetNodeIsBone(HScene scene, HNode node, bool is_bone);
 
+    /**
+     * Get the index of a node. The index is less than the max node count of the
+     * scene and unique among its live nodes, but is reused once the node is deleted.
+     * @param scene scene
+     * @param node node
+     * @return node index
+     */
+    uint16_t GetNodeIndex(HScene scene, HNode node);
+
     void SetNodeAdjustMode(HScene scene, HNode node, AdjustMode adjust_mode);
 
     void SetNodeSizeMode(HScene scene, HNode node, SizeMode size_mode);
@@ -1138,6 +1147,18 @@ namespace dmGui
      */
     bool PickNode(HScene scene, HNode node, float x, float y);
 
+    /** picks all nodes at a screen-space position
+     * Finds the enabled nodes whose boundaries contain the supplied screen-space coordinates.
+     * The world-space bounds of the nodes are cached in a screen-space grid, and only recalculated for nodes that
+     * have changed since the last call. The nodes are ordered by layer and hierarchy, clipping is not taken into account.
+     *
+     * @param scene the scene to pick from
+     * @param x x-coordinate in predefined screen-space
+     * @param y y-coordinate in predefined screen-space
+     * @param out_nodes [out] the picked nodes, topmost first
+     */
+    void PickNodes(HScene scene, float x, float y, dmArray<HNode>& out_nodes);
+
     /** retrieves if a node is enabled or not
      * Only enabled nodes are animated and rendered.
      *
@@ -269,6 +269,30 @@ namespace dmGui
         HNode                   m_Node;
     };
 
+    /** Cached world-space bounds of an enabled node, used by PickNodes
+     */
+    struct PickBounds
+    {
+        Matrix4     m_InverseBoundary;  // Inverse boundary transform, see PickNode
+        float       m_Min[2];           // Screen-space bounding box
+        float       m_Max[2];
+        HNode       m_Node;
+        uint32_t    m_Order;            // Layer and hierarchy order, used to sort the nodes in render order
+    };
+
+    /** Uniform screen-space grid over the cached node bounds of a scene
+     * The bounds and cells are rebuilt when the scene is flagged with m_PickDirty or the physical resolution has changed.
+     */
+    struct PickGrid
+    {
+        dmArray<PickBounds> m_Bounds;       // Indexed by node index
+        dmArray<uint16_t>   m_Nodes;        // Enabled node indices, sorted in render order
+        dmArray<uint32_t>   m_CellStart;    // Offsets into m_CellNodes, one per cell plus one
+        dmArray<uint16_t>   m_CellNodes;
+        float               m_Width;        // Physical dimensions the cells were built for
+        float               m_Height;
+    };
+
     struct Scene
     {
         int                     m_InstanceReference;
@@ -302,6 +326,7 @@ namespace dmGui
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
+        uint16_t                m_PickDirty : 1; // Set when anything affecting the pick grid has changed
         uint32_t                m_Width;
         uint32_t                m_Height;
         dmScript::ScriptWorld*  m_ScriptWorld;
@@ -309,6 +334,7 @@ namespace dmGui
         FetchRigSceneDataCallback m_FetchRigSceneDataCallback;
         RigEventDataCallback    m_RigEventDataCallback;
         OnWindowResizeCallback   m_OnWindowResizeCallback;
+        PickGrid                m_PickGrid;
     };
 
     InternalNode* GetNode(HScene scene, HNode node);
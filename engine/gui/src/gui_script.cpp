@@ -583,6 +583,7 @@ namespace dmGui
 
         // Set deferred delete flag
         n->m_Deleted = 1;
+        GetScene(L)->m_PickDirty = 1;
 
         return 0;
     }
@@ -2828,6 +2829,55 @@ namespace dmGui
         return 1;
     }
 
+    /*# finds all nodes at a position
+     * Returns the enabled nodes whose bounding boxes contain the supplied coordinates,
+     * ordered from the topmost node to the bottommost one. This is considerably cheaper
+     * than calling [ref:gui.pick_node] for each node when many nodes can be picked,
+     * since the bounds of the nodes are cached between calls.
+     *
+     * The order takes layers and the node hierarchy into account, but not clipping.
+     *
+     * @name gui.pick_nodes
+     * @param x [type:number] x-coordinate (see <a href="#on_input">on_input</a> )
+     * @param y [type:number] y-coordinate (see <a href="#on_input">on_input</a> )
+     * @return nodes [type:table] the picked nodes, topmost first
+     * @examples
+     *
+     * ```lua
+     * function on_input(self, action_id, action)
+     *     if action_id == hash("touch") and action.pressed then
+     *         local nodes = gui.pick_nodes(action.x, action.y)
+     *         if #nodes > 0 then
+     *             print("pressed", gui.get_id(nodes[1]))
+     *         end
+     *     end
+     * end
+     * ```
+     */
+    static int LuaPickNodes(lua_State* L)
+    {
+        int top = lua_gettop(L);
+        (void) top;
+
+        lua_Number x = luaL_checknumber(L, 1);
+        lua_Number y = luaL_checknumber(L, 2);
+
+        Scene* scene = GuiScriptInstance_Check(L);
+
+        dmArray<HNode> nodes;
+        PickNodes(scene, (float) x, (float) y, nodes);
+
+        lua_createtable(L, nodes.Size(), 0);
+        for (uint32_t i = 0; i < nodes.Size(); ++i)
+        {
+            LuaPushNode(L, scene, nodes[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
     /*# returns if a node is enabled or not
      * Returns `true` if a node is enabled and `false` if it's not.
      * Disabled nodes are not rendered and animations acting on them are not evaluated.
@@ -3476,6 +3526,7 @@ namespace dmGui
                 v = *dmScript::CheckVector4(L, 2);\
             n->m_Node.m_Properties[property] = v;\
             n->m_Node.m_DirtyLocal = 1;\
+            GetScene(L)->m_PickDirty = 1;\
             return 0;\
         }\
 
@@ -3541,6 +3592,7 @@ namespace dmGui
         }
         n->m_Node.m_Properties[PROPERTY_ROTATION] = v;
         n->m_Node.m_DirtyLocal = 1;
+        GetScene(L)->m_PickDirty = 1;
         return 0;
     }
 
@@ -3587,6 +3639,7 @@ namespace dmGui
             v = *dmScript::CheckVector4(L, 2);
         n->m_Node.m_Properties[PROPERTY_SIZE] = v;
         n->m_Node.m_DirtyLocal = 1;
+        GetScene(L)->m_PickDirty = 1;
         return 0;
     }
 
@@ -4566,6 +4619,7 @@ namespace dmGui
         {"get_slice9",      LuaGetSlice9},
         {"set_slice9",      LuaSetSlice9},
         {"pick_node",       LuaPickNode},
+        {"pick_nodes",      LuaPickNodes},
         {"is_enabled",      LuaIsEnabled},
         {"set_enabled",     LuaSetEnabled},
         {"get_adjust_mode", LuaGetAdjustMode},
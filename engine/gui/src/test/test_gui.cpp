@@ -1413,6 +1413,27 @@ TEST_F(dmGuiTest, NewDeleteNode)
     }
 }
 
+TEST_F(dmGuiTest, NodeIndex)
+{
+    bool used[MAX_NODES] = {};
+    dmGui::HNode nodes[MAX_NODES];
+    for (uint32_t i = 0; i < MAX_NODES; ++i)
+    {
+        nodes[i] = dmGui::NewNode(m_Scene, Point3(0, 0, 0), Vector3(0, 0 ,0), dmGui::NODE_TYPE_BOX);
+        uint16_t index = dmGui::GetNodeIndex(m_Scene, nodes[i]);
+        ASSERT_LT(index, MAX_NODES);
+        ASSERT_FALSE(used[index]);
+        used[index] = true;
+    }
+
+    // The index of a deleted node is reused, but the handle is not
+    uint16_t index = dmGui::GetNodeIndex(m_Scene, nodes[0]);
+    dmGui::DeleteNode(m_Scene, nodes[0], true);
+    dmGui::HNode node = dmGui::NewNode(m_Scene, Point3(0, 0, 0), Vector3(0, 0 ,0), dmGui::NODE_TYPE_BOX);
+    ASSERT_EQ(index, dmGui::GetNodeIndex(m_Scene, node));
+    ASSERT_NE(nodes[0], node);
+}
+
 TEST_F(dmGuiTest, ClearNodes)
 {
     for (uint32_t i = 0; i < MAX_NODES; ++i)
@@ -3158,6 +3179,100 @@ TEST_F(dmGuiTest, PickingDisabledAdjust)
     ASSERT_TRUE(dmGui::PickNode(m_Scene, n1, tmin.getX()*ref_scale, tmax.getY()*ref_scale));
 }
 
+TEST_F(dmGuiTest, PickNodes)
+{
+    uint32_t physical_width = 640;
+    uint32_t physical_height = 320;
+    dmGui::SetPhysicalResolution(m_Context, physical_width, physical_height);
+    dmGui::SetSceneResolution(m_Scene, physical_width, physical_height);
+    dmGui::SetDefaultResolution(m_Context, physical_width, physical_height);
+
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(50, 50, 0), Vector3(100, 100, 0), dmGui::NODE_TYPE_BOX);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(75, 50, 0), Vector3(50, 50, 0), dmGui::NODE_TYPE_BOX);
+    dmGui::HNode n3 = dmGui::NewNode(m_Scene, Point3(300, 200, 0), Vector3(20, 20, 0), dmGui::NODE_TYPE_BOX);
+
+    // Topmost first
+    dmArray<dmGui::HNode> nodes;
+    dmGui::PickNodes(m_Scene, 60, 50, nodes);
+    ASSERT_EQ(2U, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+    ASSERT_EQ(n1, nodes[1]);
+
+    dmGui::PickNodes(m_Scene, 10, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+
+    dmGui::PickNodes(m_Scene, 200, 50, nodes);
+    ASSERT_EQ(0U, nodes.Size());
+
+    // The grid is only rebuilt when something has changed
+    ASSERT_FALSE(m_Scene->m_PickDirty);
+    dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+    ASSERT_FALSE(m_Scene->m_PickDirty);
+    dmGui::PickNodes(m_Scene, 60, 50, nodes);
+    ASSERT_EQ(2U, nodes.Size());
+
+    // Disabled nodes are not picked
+    dmGui::SetNodeEnabled(m_Scene, n2, false);
+    dmGui::PickNodes(m_Scene, 60, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    dmGui::SetNodeEnabled(m_Scene, n2, true);
+
+    // Moved nodes are picked at their new position
+    dmGui::SetNodePosition(m_Scene, n2, Point3(300, 200, 0));
+    ASSERT_TRUE(m_Scene->m_PickDirty);
+    dmGui::PickNodes(m_Scene, 60, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    dmGui::PickNodes(m_Scene, 300, 200, nodes);
+    ASSERT_EQ(2U, nodes.Size());
+    ASSERT_EQ(n3, nodes[0]);
+    ASSERT_EQ(n2, nodes[1]);
+
+    // Children follow their parents
+    ASSERT_EQ(dmGui::RESULT_OK, dmGui::SetNodeParent(m_Scene, n3, n1, false));
+    dmGui::PickNodes(m_Scene, 345, 250, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n3, nodes[0]);
+    dmGui::SetNodePosition(m_Scene, n1, Point3(60, 50, 0));
+    dmGui::PickNodes(m_Scene, 345, 250, nodes);
+    ASSERT_EQ(0U, nodes.Size());
+    dmGui::PickNodes(m_Scene, 355, 250, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n3, nodes[0]);
+
+    // Resized nodes
+    dmGui::SetNodeProperty(m_Scene, n1, dmGui::PROPERTY_SIZE, Vector4(200, 100, 0, 0));
+    dmGui::PickNodes(m_Scene, 150, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+
+    // Pivots move the node boundary
+    dmGui::SetNodePivot(m_Scene, n1, dmGui::PIVOT_W);
+    dmGui::PickNodes(m_Scene, 250, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+
+    // Render order changes
+    dmGui::SetNodePosition(m_Scene, n2, Point3(75, 50, 0));
+    dmGui::PickNodes(m_Scene, 70, 50, nodes);
+    ASSERT_EQ(2U, nodes.Size());
+    ASSERT_EQ(n2, nodes[0]);
+    dmGui::MoveNodeAbove(m_Scene, n1, n2);
+    dmGui::PickNodes(m_Scene, 70, 50, nodes);
+    ASSERT_EQ(2U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+    ASSERT_EQ(n2, nodes[1]);
+
+    // Deleted nodes
+    dmGui::DeleteNode(m_Scene, n2, true);
+    dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+    dmGui::PickNodes(m_Scene, 70, 50, nodes);
+    ASSERT_EQ(1U, nodes.Size());
+    ASSERT_EQ(n1, nodes[0]);
+}
+
 TEST_F(dmGuiTest, ScriptPicking)
 {
     uint32_t physical_width = 640;
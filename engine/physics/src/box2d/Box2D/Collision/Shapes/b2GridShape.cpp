@@ -7,7 +7,9 @@
 #include <Box2D/Collision/b2BroadPhase.h>
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
 #include <new>
+#include <algorithm>
 using namespace std;
 
 b2GridShape::b2GridShape(const b2HullSet* hullSet,
@@ -384,6 +386,13 @@ void b2GridShape::SetCellHull(b2Body* body, uint32 row, uint32 column, uint32 hu
 
     uint32 index = row * m_columnCount + column;
     b2Assert(index < m_rowCount * m_columnCount);
+    SetCellData(index, hull, flags);
+
+    body->SynchronizeSingle(this, index);
+}
+
+void b2GridShape::SetCellData(uint32 index, uint32 hull, b2GridShape::CellFlags flags)
+{
     b2GridShape::Cell* cell = &m_cells[index];
     cell->m_Index = hull;
     m_cellFlags[index] = flags;
@@ -394,6 +403,123 @@ void b2GridShape::SetCellHull(b2Body* body, uint32 row, uint32 column, uint32 hu
         if (h.m_Count == 0)
             cell->m_Index = B2GRIDSHAPE_EMPTY_CELL;
     }
+}
 
-    body->SynchronizeSingle(this, index);
+static bool CellUpdateLessThan(const b2GridShape::CellUpdate& a, const b2GridShape::CellUpdate& b)
+{
+    return a.m_Index < b.m_Index;
+}
+
+static bool IsCellUpdated(const b2GridShape::CellUpdate* updates, uint32 count, uint32 index)
+{
+    uint32 low = 0;
+    uint32 high = count;
+    while (low < high)
+    {
+        uint32 mid = (low + high) / 2;
+        if (updates[mid].m_Index < index)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low < count && updates[low].m_Index == index;
+}
+
+void b2GridShape::SetCellHulls(b2Fixture* fixture, b2GridShape::CellUpdate* updates, uint32 count)
+{
+    assert(m_type == b2Shape::e_grid);
+    b2Assert(fixture->GetShape() == this);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Apply in the given order so that the last update of a cell wins.
+    // Only the updates that change a cell are kept, e.g. when a tile map is
+    // set up most of its cells already have the same hull.
+    uint32 cellCount = m_rowCount * m_columnCount;
+    uint32 changedCount = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const CellUpdate& update = updates[i];
+        b2Assert(update.m_Index < cellCount);
+        uint32 prevHull = m_cells[update.m_Index].m_Index;
+        CellFlags prevFlags = m_cellFlags[update.m_Index];
+        b2Filter& filter = fixture->m_filters[update.m_Index * m_filterPerChild];
+        bool filterChanged = filter.categoryBits != update.m_Filter.categoryBits
+                          || filter.maskBits != update.m_Filter.maskBits
+                          || filter.groupIndex != update.m_Filter.groupIndex;
+
+        SetCellData(update.m_Index, update.m_Hull, update.m_Flags);
+        filter = update.m_Filter;
+
+        if (filterChanged
+            || m_cells[update.m_Index].m_Index != prevHull
+            || m_cellFlags[update.m_Index].m_FlipHorizontal != prevFlags.m_FlipHorizontal
+            || m_cellFlags[update.m_Index].m_FlipVertical != prevFlags.m_FlipVertical)
+        {
+            updates[changedCount++] = update;
+        }
+    }
+
+    count = changedCount;
+    if (count == 0)
+    {
+        return;
+    }
+
+    std::sort(updates, updates + count, CellUpdateLessThan);
+
+    b2Body* body = fixture->GetBody();
+
+    // Flag the contacts of the touched cells only. The rest of the body's
+    // contacts are unaffected by the update.
+    for (b2ContactEdge* edge = body->GetContactList(); edge; edge = edge->next)
+    {
+        b2Contact* contact = edge->contact;
+        int32 childIndex;
+        if (contact->GetFixtureA() == fixture)
+            childIndex = contact->GetChildIndexA();
+        else if (contact->GetFixtureB() == fixture)
+            childIndex = contact->GetChildIndexB();
+        else
+            continue;
+
+        if (IsCellUpdated(updates, count, childIndex))
+        {
+            contact->FlagForFiltering();
+        }
+    }
+
+    // Proxies only exist for active bodies, see b2Body::SynchronizeSingle
+    if (!body->IsActive())
+    {
+        return;
+    }
+
+    b2Transform xf1;
+    xf1.q.Set(body->m_sweep.a0);
+    xf1.p = body->m_sweep.c0 - b2Mul(xf1.q, body->m_sweep.localCenter);
+
+    b2BroadPhase* broadPhase = &body->GetWorld()->m_contactManager.m_broadPhase;
+    uint32 prevIndex = B2GRIDSHAPE_EMPTY_CELL;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 index = updates[i].m_Index;
+        if (index == prevIndex)
+        {
+            continue;
+        }
+        prevIndex = index;
+
+        fixture->SynchronizeSingle(broadPhase, index, xf1, body->m_xf);
+        // The proxy is not moved when the cell bounds are unchanged, e.g. when
+        // only the hull or the filter changed. Touch it so that pairs that were
+        // previously filtered out can be created.
+        if (m_cells[index].m_Index != B2GRIDSHAPE_EMPTY_CELL)
+        {
+            broadPhase->TouchProxy(fixture->m_proxies[index].proxyId);
+        }
+    }
 }
@@ -4,6 +4,7 @@
 #include <Box2D/Common/b2Math.h>
 #include <Box2D/Collision/Shapes/b2Shape.h>
 #include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
 #include <string.h>
 
 struct b2HullSet
@@ -72,6 +73,13 @@ public:
         uint16 m_FlipVertical : 1;
         uint16 m_Padding : 14;
     };
+    struct CellUpdate
+    {
+        uint32    m_Index;
+        uint32    m_Hull;
+        CellFlags m_Flags;
+        b2Filter  m_Filter;
+    };
 
     b2GridShape(const b2HullSet* hullSet,
                 const b2Vec2 position,
@@ -100,6 +108,12 @@ public:
 
     void SetCellHull(b2Body* body, uint32 row, uint32 column, uint32 hull, CellFlags flags);
 
+    /// Set hull, flags and filter for a batch of cells. Only the proxies of the
+    /// changed cells are synchronized and only contacts involving those cells are
+    /// flagged for filtering. If a cell occurs more than once the last update wins.
+    /// NOTE: The updates are compacted and sorted in place by cell index.
+    void SetCellHulls(b2Fixture* fixture, CellUpdate* updates, uint32 count);
+
     void ClearCellData();
 
     uint32 CalculateCellMask(b2Fixture* fixture, uint32 row, uint32 column);
@@ -116,6 +130,7 @@ public:
     uint8    m_flags:7;
 
 private:
+    void SetCellData(uint32 index, uint32 hull, CellFlags flags);
     uint32 GetCellVertices(uint32 index, b2Vec2* vertices) const;
     b2Vec2 GetGhostPoint(uint32 index, b2Vec2 v0, b2Vec2 v1, bool fwdDirection) const;
 };
@@ -145,6 +145,8 @@ protected:
 	friend class b2Body;
 	friend class b2Fixture;
 
+    friend class b2GridShape;
+
 	// Flags stored in m_flags
 	enum
 	{
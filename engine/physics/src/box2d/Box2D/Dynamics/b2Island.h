@@ -36,6 +36,15 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+
+	/// Defold modification
+	/// Island over bodies, contacts and joints gathered up front by b2World::SolveParallel.
+	/// The state arrays hold stateCount entries and are indexed by b2Body::m_islandIndex.
+	/// Static bodies may be part of other islands solved at the same time, so they are
+	/// never written to. Contacts are not reported and bodies are not put to sleep,
+	/// see m_canSleep.
+	b2Island(b2Body** bodies, int32 bodyCount, b2Contact** contacts, int32 contactCount,
+			b2Joint** joints, int32 jointCount, int32 stateCount, b2StackAllocator* allocator);
 	~b2Island();
 
 	void Clear()
@@ -88,6 +97,11 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// Defold modification
+	bool m_sharedStatics;
+	// Set by Solve() when m_sharedStatics is true and the island should go to sleep
+	bool m_canSleep;
 };
 
 #endif
@@ -62,10 +62,17 @@ b2World::b2World(const b2Vec2& gravity)
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
+
+	m_parallelFor = NULL;
+	m_parallelForUserData = NULL;
+	m_taskAllocators = NULL;
+	m_taskCount = 0;
 }
 
 b2World::~b2World()
 {
+	SetParallelFor(NULL, NULL, 0);
+
 	// Some shapes allocate using b2Alloc.
 	b2Body* b = m_bodyList;
 	while (b)
@@ -105,6 +112,35 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetParallelFor(b2ParallelFor parallelFor, void* userData, int32 taskCount)
+{
+	b2Assert(IsLocked() == false);
+
+	for (int32 i = 0; i < m_taskCount; ++i)
+	{
+		m_taskAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_taskAllocators);
+	m_taskAllocators = NULL;
+	m_taskCount = 0;
+
+	if (parallelFor == NULL || taskCount <= 0)
+	{
+		m_parallelFor = NULL;
+		m_parallelForUserData = NULL;
+		return;
+	}
+
+	m_parallelFor = parallelFor;
+	m_parallelForUserData = userData;
+	m_taskAllocators = (b2StackAllocator*)b2Alloc(taskCount * sizeof(b2StackAllocator));
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		new (m_taskAllocators + i) b2StackAllocator();
+	}
+	m_taskCount = taskCount;
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -383,6 +419,105 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+// Defold modification
+// Add the seed and all bodies, contacts and joints connected to it to the island.
+void b2World::BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize)
+{
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	// Perform a depth first search (DFS) on the constraint graph.
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsActive() == true);
+		island->Add(b);
+
+		// Make sure the body is awake.
+		b->SetAwake(true);
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* contact = ce->contact;
+
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
+			{
+				continue;
+			}
+
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
+			{
+				continue;
+			}
+
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
+			{
+				continue;
+			}
+
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
+
+			b2Body* other = ce->other;
+
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
+
+			b2Body* other = je->other;
+
+			// Don't simulate joints connected to inactive bodies.
+			if (other->IsActive() == false)
+			{
+				continue;
+			}
+
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
+
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -390,6 +525,14 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// Defold modification
+	if (m_parallelFor != NULL)
+	{
+		SolveParallel(step);
+		SynchronizeSolvedBodies();
+		return;
+	}
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
@@ -434,144 +577,416 @@ void b2World::Solve(const b2TimeStep& step)
 
 		// Reset island and stack.
 		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
+		BuildIsland(&island, seed, stack, stackSize);
 
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+		b2Profile profile;
+		island.Solve(&profile, step, m_gravity, m_allowSleep);
+		m_profile.solveInit += profile.solveInit;
+		m_profile.solveVelocity += profile.solveVelocity;
+		m_profile.solvePosition += profile.solvePosition;
+
+		// Post solve cleanup.
+		for (int32 i = 0; i < island.m_bodyCount; ++i)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsActive() == true);
-			island.Add(b);
+			// Allow static bodies to participate in other islands.
+			b2Body* b = island.m_bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->m_flags &= ~b2Body::e_islandFlag;
+			}
+		}
+	}
 
-			// Make sure the body is awake.
-			b->SetAwake(true);
+	m_stackAllocator.Free(stack);
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+	SynchronizeSolvedBodies();
+}
+
+// Defold modification: split out of Solve()
+void b2World::SynchronizeSolvedBodies()
+{
+	{
+		b2Timer timer;
+		// Synchronize fixtures, check for out of range bodies.
+		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		{
+			// If a body was not in an island then it did not move.
+			if ((b->m_flags & b2Body::e_islandFlag) == 0)
 			{
 				continue;
 			}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			if (b->GetType() == b2_staticBody)
 			{
-				b2Contact* contact = ce->contact;
+				continue;
+			}
 
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
+			// Update fixtures (for broad-phase).
+			b->SynchronizeFixtures();
+		}
 
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
+		// Look for new contacts.
+		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
+	}
+}
 
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
+// Defold modification
+// Parallel island solving. All awake islands are gathered first, in the same order as Solve()
+// finds them. They are then solved in parallel and finally their contacts are reported, and
+// the islands put to sleep, on the calling thread and in the same order. Each island is solved
+// exactly as in Solve(), so the result doesn't depend on how the islands are split into tasks.
 
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
+// Below this many bodies in awake islands, waking the worker threads costs more than it saves
+static const int32 b2_minParallelBodyCount = 64;
 
-				b2Body* other = ce->other;
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	int32 stateCount;
+	bool canSleep;
+};
 
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+struct b2SolveParallelContext
+{
+	b2TimeStep step;
+	b2Vec2 gravity;
+	bool allowSleep;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2IslandRange* islands;
+	int32* taskStarts;
+	b2StackAllocator* allocators;
+	b2Profile* profiles;
+};
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+static void b2SolveIslandsTask(void* _context, int32 index)
+{
+	b2SolveParallelContext* context = (b2SolveParallelContext*)_context;
+	b2Profile* taskProfile = context->profiles + index;
+	taskProfile->solveInit = 0.0f;
+	taskProfile->solveVelocity = 0.0f;
+	taskProfile->solvePosition = 0.0f;
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
-			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
+	for (int32 i = context->taskStarts[index]; i < context->taskStarts[index + 1]; ++i)
+	{
+		b2IslandRange* range = context->islands + i;
+		b2Island island(context->bodies + range->bodyStart, range->bodyCount,
+						context->contacts + range->contactStart, range->contactCount,
+						context->joints + range->jointStart, range->jointCount,
+						range->stateCount, context->allocators + index);
 
-				b2Body* other = je->other;
+		b2Profile profile;
+		island.Solve(&profile, context->step, context->gravity, context->allowSleep);
+		taskProfile->solveInit += profile.solveInit;
+		taskProfile->solveVelocity += profile.solveVelocity;
+		taskProfile->solvePosition += profile.solvePosition;
 
-				// Don't simulate joints connected to inactive bodies.
-				if (other->IsActive() == false)
-				{
-					continue;
-				}
+		range->canSleep = island.m_canSleep;
+	}
+}
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	// Clear all the island flags.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+	// A static body can be part of several islands, but only once per contact or joint.
+	b2Island gathered(m_bodyCount + m_contactManager.m_contactCount + m_jointCount,
+					  m_contactManager.m_contactCount,
+					  m_jointCount,
+					  &m_stackAllocator,
+					  NULL);
+	b2IslandRange* islands = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	int32 islandCount = 0;
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+	// Gather all awake islands.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
 
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandRange* range = islands + islandCount++;
+		range->bodyStart = gathered.m_bodyCount;
+		range->contactStart = gathered.m_contactCount;
+		range->jointStart = gathered.m_jointCount;
+
+		BuildIsland(&gathered, seed, stack, stackSize);
+
+		range->bodyCount = gathered.m_bodyCount - range->bodyStart;
+		range->contactCount = gathered.m_contactCount - range->contactStart;
+		range->jointCount = gathered.m_jointCount - range->jointStart;
+		range->canSleep = false;
+
+		for (int32 i = range->bodyStart; i < gathered.m_bodyCount; ++i)
 		{
 			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
+			b2Body* b = gathered.m_bodies[i];
 			if (b->GetType() == b2_staticBody)
 			{
 				b->m_flags &= ~b2Body::e_islandFlag;
+				b->m_islandIndex = -1;
+				// Done by b2Island::Solve for bodies that aren't shared
+				b->m_sweep.c0 = b->m_sweep.c;
+				b->m_sweep.a0 = b->m_sweep.a;
 			}
 		}
 	}
-
 	m_stackAllocator.Free(stack);
 
+	// A static body has one state index in all the islands it is part of, since they are
+	// solved at the same time. Each static body gets the lowest index that no other static
+	// body in any of its islands has, so an island only needs as many static states as it
+	// has static bodies around it. The other bodies are indexed after them.
+	int32 staticCount = 0;
+	for (int32 i = 0; i < gathered.m_bodyCount; ++i)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2Body* b = gathered.m_bodies[i];
+		if (b->GetType() == b2_staticBody && b->m_islandIndex == -1)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			b->m_islandIndex = staticCount++;
+		}
+	}
+
+	if (staticCount > 0)
+	{
+		// The islands of each static body, in the same order as the static bodies
+		int32* staticIslandStarts = (int32*)m_stackAllocator.Allocate((staticCount + 1) * sizeof(int32));
+		int32* staticIslands = (int32*)m_stackAllocator.Allocate(gathered.m_bodyCount * sizeof(int32));
+		b2Body** statics = (b2Body**)m_stackAllocator.Allocate(staticCount * sizeof(b2Body*));
+		int32* slots = (int32*)m_stackAllocator.Allocate(staticCount * sizeof(int32));
+		int32* slotMarks = (int32*)m_stackAllocator.Allocate(staticCount * sizeof(int32));
+
+		memset(staticIslandStarts, 0, (staticCount + 1) * sizeof(int32));
+		for (int32 i = 0; i < gathered.m_bodyCount; ++i)
+		{
+			b2Body* b = gathered.m_bodies[i];
+			if (b->GetType() == b2_staticBody)
 			{
-				continue;
+				statics[b->m_islandIndex] = b;
+				++staticIslandStarts[b->m_islandIndex + 1];
+			}
+		}
+		for (int32 i = 0; i < staticCount; ++i)
+		{
+			staticIslandStarts[i + 1] += staticIslandStarts[i];
+			// Fill cursor until the slots are assigned
+			slots[i] = staticIslandStarts[i];
+		}
+		for (int32 i = 0; i < islandCount; ++i)
+		{
+			b2IslandRange* range = islands + i;
+			for (int32 j = range->bodyStart; j < range->bodyStart + range->bodyCount; ++j)
+			{
+				b2Body* b = gathered.m_bodies[j];
+				if (b->GetType() == b2_staticBody)
+				{
+					staticIslands[slots[b->m_islandIndex]++] = i;
+				}
 			}
+		}
+		for (int32 i = 0; i < staticCount; ++i)
+		{
+			slots[i] = -1;
+			slotMarks[i] = -1;
+		}
+
+		for (int32 i = 0; i < staticCount; ++i)
+		{
+			for (int32 k = staticIslandStarts[i]; k < staticIslandStarts[i + 1]; ++k)
+			{
+				b2IslandRange* range = islands + staticIslands[k];
+				for (int32 j = range->bodyStart; j < range->bodyStart + range->bodyCount; ++j)
+				{
+					b2Body* b = gathered.m_bodies[j];
+					if (b->GetType() == b2_staticBody && slots[b->m_islandIndex] != -1)
+					{
+						slotMarks[slots[b->m_islandIndex]] = i;
+					}
+				}
+			}
+			int32 slot = 0;
+			while (slotMarks[slot] == i)
+			{
+				++slot;
+			}
+			slots[i] = slot;
+		}
 
+		for (int32 i = 0; i < staticCount; ++i)
+		{
+			statics[i]->m_islandIndex = slots[i];
+		}
+
+		m_stackAllocator.Free(slotMarks);
+		m_stackAllocator.Free(slots);
+		m_stackAllocator.Free(statics);
+		m_stackAllocator.Free(staticIslands);
+		m_stackAllocator.Free(staticIslandStarts);
+	}
+
+	int32 totalWeight = 0;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		b2IslandRange* range = islands + i;
+		int32 index = 0;
+		for (int32 j = range->bodyStart; j < range->bodyStart + range->bodyCount; ++j)
+		{
+			b2Body* b = gathered.m_bodies[j];
 			if (b->GetType() == b2_staticBody)
 			{
-				continue;
+				index = b2Max(index, b->m_islandIndex + 1);
 			}
+		}
+		for (int32 j = range->bodyStart; j < range->bodyStart + range->bodyCount; ++j)
+		{
+			b2Body* b = gathered.m_bodies[j];
+			if (b->GetType() != b2_staticBody)
+			{
+				b->m_islandIndex = index++;
+			}
+		}
+		range->stateCount = index;
+		totalWeight += range->bodyCount + range->contactCount + range->jointCount;
+	}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+	// Split the islands into tasks with about the same amount of work.
+	int32 taskCount = b2Min(m_taskCount, islandCount);
+	if (gathered.m_bodyCount < b2_minParallelBodyCount)
+	{
+		taskCount = b2Min(1, islandCount);
+	}
+	int32* taskStarts = (int32*)m_stackAllocator.Allocate((taskCount + 1) * sizeof(int32));
+	b2Profile* profiles = (b2Profile*)m_stackAllocator.Allocate(b2Max(taskCount, 1) * sizeof(b2Profile));
+	int32 task = 0;
+	int32 weight = 0;
+	taskStarts[0] = 0;
+	for (int32 i = 0; i < islandCount && task + 1 < taskCount; ++i)
+	{
+		b2IslandRange* range = islands + i;
+		weight += range->bodyCount + range->contactCount + range->jointCount;
+		if ((float32)weight * taskCount >= (float32)totalWeight * (task + 1))
+		{
+			taskStarts[++task] = i + 1;
 		}
+	}
+	while (task < taskCount)
+	{
+		taskStarts[++task] = islandCount;
+	}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+	b2SolveParallelContext context;
+	context.step = step;
+	context.gravity = m_gravity;
+	context.allowSleep = m_allowSleep;
+	context.bodies = gathered.m_bodies;
+	context.contacts = gathered.m_contacts;
+	context.joints = gathered.m_joints;
+	context.islands = islands;
+	context.taskStarts = taskStarts;
+	context.allocators = m_taskAllocators;
+	context.profiles = profiles;
+
+	if (taskCount == 1)
+	{
+		b2SolveIslandsTask(&context, 0);
+	}
+	else if (taskCount > 1)
+	{
+		m_parallelFor(b2SolveIslandsTask, &context, taskCount, m_parallelForUserData);
+	}
+
+	for (int32 i = 0; i < taskCount; ++i)
+	{
+		m_profile.solveInit += profiles[i].solveInit;
+		m_profile.solveVelocity += profiles[i].solveVelocity;
+		m_profile.solvePosition += profiles[i].solvePosition;
+	}
+
+	// Report contacts and put islands to sleep, as b2Island::Solve does for islands that
+	// don't share static bodies.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		b2IslandRange* range = islands + i;
+		b2Body** bodies = gathered.m_bodies + range->bodyStart;
+
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			if (bodies[j]->GetType() == b2_staticBody)
+			{
+				bodies[j]->SynchronizeTransform();
+			}
+		}
+
+		if (listener != NULL)
+		{
+			b2Contact** contacts = gathered.m_contacts + range->contactStart;
+			for (int32 j = 0; j < range->contactCount; ++j)
+			{
+				// b2ContactSolver::StoreImpulses has stored the impulses in the manifold
+				b2Contact* c = contacts[j];
+				const b2Manifold* manifold = c->GetManifold();
+				b2ContactImpulse impulse;
+				impulse.count = manifold->pointCount;
+				for (int32 k = 0; k < manifold->pointCount; ++k)
+				{
+					impulse.normalImpulses[k] = manifold->points[k].normalImpulse;
+					impulse.tangentImpulses[k] = manifold->points[k].tangentImpulse;
+				}
+				listener->PostSolve(c, &impulse);
+			}
+		}
+
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			if (range->canSleep)
+			{
+				bodies[j]->SetAwake(false);
+			}
+			else if (bodies[j]->GetType() == b2_staticBody)
+			{
+				// Solve() wakes static bodies again when building a later island
+				bodies[j]->SetAwake(true);
+			}
+		}
 	}
+
+	m_stackAllocator.Free(profiles);
+	m_stackAllocator.Free(taskStarts);
+	m_stackAllocator.Free(islands);
 }
 
 // Find TOI contacts and solve them.
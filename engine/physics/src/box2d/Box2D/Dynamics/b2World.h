@@ -34,6 +34,16 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2Island;
+
+/// Defold modification
+/// A task run by b2ParallelFor.
+typedef void (*b2ParallelForTask)(void* context, int32 index);
+
+/// Defold modification
+/// Runs task(context, i) for every i in [0, count) and returns when all of them have
+/// finished. The calls may run on other threads, and in parallel.
+typedef void (*b2ParallelFor)(b2ParallelForTask task, void* context, int32 count, void* userData);
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -204,6 +214,12 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// Defold modification
+	/// Solve islands in parallel. The islands are split into at most taskCount tasks,
+	/// which are run with parallelFor. The result does not depend on the number of tasks.
+	/// Pass NULL to solve all islands on the calling thread, which is the default.
+	void SetParallelFor(b2ParallelFor parallelFor, void* userData, int32 taskCount);
+
 private:
 
 	// m_flags
@@ -219,9 +235,16 @@ private:
 	friend class b2ContactManager;
 	friend class b2Controller;
 
+    friend class b2GridShape;
+
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	// Defold modification
+	void BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize);
+	void SolveParallel(const b2TimeStep& step);
+	void SynchronizeSolvedBodies();
+
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 	void DrawPolygon(const b2Transform& xf, const b2PolygonShape& poly, const b2Color& color);
@@ -257,6 +280,13 @@ private:
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	// Defold modification
+	b2ParallelFor m_parallelFor;
+	void* m_parallelForUserData;
+	// One allocator per task, since b2StackAllocator is not thread safe
+	b2StackAllocator* m_taskAllocators;
+	int32 m_taskCount;
 };
 
 inline b2Body* b2World::GetBodyList()
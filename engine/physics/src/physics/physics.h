@@ -110,6 +110,22 @@ namespace dmPhysics
         uint16_t m_Padding : 14;
     };
 
+    /**
+     * Cell update, see SetGridShapeHulls
+     */
+    struct GridShapeCell
+    {
+        uint32_t  m_Row;
+        uint32_t  m_Column;
+        /// Hull index. Use GRIDSHAPE_EMPTY_CELL to clear the cell.
+        uint32_t  m_Hull;
+        HullFlags m_Flags;
+        /// Collision group of the cell
+        uint16_t  m_Group;
+        /// Collision mask of the cell
+        uint16_t  m_Mask;
+    };
+
     /**
      * Callback used to propagate the world transform of an external object into the physics simulation.
      *
@@ -239,6 +255,9 @@ namespace dmPhysics
         uint32_t m_RayCastLimit3D;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
+        /// Number of threads, including the calling one, used to solve the islands of 2D worlds.
+        /// 0 or 1 solves them on the calling thread.
+        uint32_t m_SolverThreadCount;
         /// If true, the collision objects will retrieve the position of its game object
         uint8_t m_AllowDynamicTransforms:1;
         uint8_t :7;
@@ -364,6 +383,12 @@ namespace dmPhysics
         TriggerExitedCallback   m_TriggerExitedCallback;
         /// Trigger exited callback
         void*                   m_TriggerExitedUserData;
+        /// Collision objects (HCollisionObject2D or HCollisionObject3D) whose game world transforms have changed since the last step
+        void**                  m_DirtyCollisionObjects;
+        /// Number of dirty collision objects
+        uint32_t                m_DirtyCollisionObjectCount;
+        /// Only retrieve the game world transforms of the dirty collision objects, instead of all kinematic ones
+        uint32_t                m_SyncDirtyOnly : 1;
     };
 
     /**
@@ -510,6 +535,19 @@ namespace dmPhysics
      */
     void SetGridShapeHull(HCollisionObject2D collision_object, uint32_t shape_index, uint32_t row, uint32_t column, uint32_t hull, HullFlags flags);
 
+    /**
+     * Set hull and collision filter for a batch of cells in a grid-shape.
+     * Only the broadphase proxies and contacts of the given cells are refreshed,
+     * which makes this considerably cheaper than calling SetGridShapeHull and
+     * SetCollisionObjectFilter per cell when many cells change at once.
+     * If a cell occurs more than once, the last entry wins.
+     * @param collision_object collision object
+     * @param shape_index index of the collision shape
+     * @param cells cells to update
+     * @param cell_count number of cells
+     */
+    void SetGridShapeHulls(HCollisionObject2D collision_object, uint32_t shape_index, const GridShapeCell* cells, uint32_t cell_count);
+
     /**
      * Enable or disable a grid shape (layer)
      * @param shape_index index of the collision shape
@@ -1114,6 +1152,105 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray.
+     * Large batches are split over worker threads, the world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests. m_ReturnAllResults and m_UserData are ignored
+     * @param count Number of requests
+     * @param responses Array of count responses. responses[i] is the closest hit of requests[i], m_Hit is 0 if the ray missed or had 0 length
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
+    /**
+     * Perform a batch of synchronous ray casts, reporting the closest hit of each ray.
+     * Large batches are split over worker threads, the world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests. m_ReturnAllResults and m_UserData are ignored
+     * @param count Number of requests
+     * @param responses Array of count responses. responses[i] is the closest hit of requests[i], m_Hit is 0 if the ray missed or had 0 length
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses);
+
+    /**
+     * Shape of an overlap query
+     */
+    enum OverlapShape
+    {
+        OVERLAP_SHAPE_BOX       = 0,
+        OVERLAP_SHAPE_SPHERE    = 1,
+    };
+
+    /**
+     * Container of data for overlap queries.
+     */
+    struct OverlapRequest
+    {
+        OverlapRequest();
+
+        /// Center of the query shape
+        Vectormath::Aos::Point3 m_Position;
+        /// Half extents of the box, used by OVERLAP_SHAPE_BOX. The box is axis aligned
+        Vectormath::Aos::Vector3 m_HalfExtents;
+        /// Radius of the sphere, a circle in 2D, used by OVERLAP_SHAPE_SPHERE
+        float m_Radius;
+        /// All collision objects with this user data will be ignored in the query
+        void* m_IgnoredUserData;
+        /// Bit field to filter out collision objects of the corresponding groups
+        uint16_t m_Mask;
+        /// Shape of the query, see OverlapShape
+        uint8_t m_Shape;
+    };
+
+    /**
+     * Collision object overlapping the shape of an overlap query.
+     */
+    struct OverlapHit
+    {
+        /// User specified data for the overlapping object
+        void* m_CollisionObjectUserData;
+        /// Group of the overlapping object
+        uint16_t m_CollisionObjectGroup;
+    };
+
+    /**
+     * Range of the hits of an overlap query, in the hit array of the batch.
+     */
+    struct OverlapResponse
+    {
+        /// Index of the first hit
+        uint32_t m_HitOffset;
+        /// Number of hits, each overlapping object is reported once
+        uint32_t m_HitCount;
+    };
+
+    /**
+     * Perform a batch of synchronous overlap queries. Trigger objects are not reported.
+     * Large batches are split over worker threads, the world must not be modified during the call.
+     * @note Objects are tested against their bounding boxes in 3D
+     *
+     * @param world Physics world in which to perform the queries
+     * @param requests Array of requests
+     * @param count Number of requests
+     * @param responses Array of count responses, the hits of requests[i] are found through responses[i]
+     * @param hits Array receiving the hits of all queries, in request order. The array may grow during the call
+     */
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits);
+
+    /**
+     * Perform a batch of synchronous overlap queries. Trigger objects are not reported.
+     * Large batches are split over worker threads, the world must not be modified during the call.
+     *
+     * @param world Physics world in which to perform the queries
+     * @param requests Array of requests, the z-component of positions and extents is ignored
+     * @param count Number of requests
+     * @param responses Array of count responses, the hits of requests[i] are found through responses[i]
+     * @param hits Array receiving the hits of all queries, in request order. The array may grow during the call
+     */
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits);
+
     /**
      * Set the gravity for a 2D physics world.
      *
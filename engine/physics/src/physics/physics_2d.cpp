@@ -38,6 +38,8 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_SolverPool(0)
+    , m_QueryPool(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -216,6 +218,11 @@ namespace dmPhysics
         context->m_RayCastLimit = params.m_RayCastLimit2D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
+        if (params.m_SolverThreadCount > 1)
+        {
+            // The stepping thread solves islands too
+            context->m_SolverPool = dmThreadPool::New(params.m_SolverThreadCount - 1, "physics_solver");
+        }
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
         {
@@ -236,6 +243,10 @@ namespace dmPhysics
         }
         if (context->m_Socket != 0)
             dmMessage::DeleteSocket(context->m_Socket);
+        if (context->m_SolverPool != 0)
+            dmThreadPool::Delete(context->m_SolverPool);
+        if (context->m_QueryPool != 0)
+            dmThreadPool::Delete(context->m_QueryPool);
         delete context;
     }
 
@@ -244,6 +255,26 @@ namespace dmPhysics
         return context->m_Socket;
     }
 
+    struct SolverJobContext
+    {
+        b2ParallelForTask   m_Task;
+        void*               m_Context;
+    };
+
+    static void SolverJob(void* _ctx, uint32_t index)
+    {
+        SolverJobContext* ctx = (SolverJobContext*)_ctx;
+        ctx->m_Task(ctx->m_Context, (int32)index);
+    }
+
+    static void SolverParallelFor(b2ParallelForTask task, void* context, int32 count, void* user_data)
+    {
+        SolverJobContext ctx;
+        ctx.m_Task = task;
+        ctx.m_Context = context;
+        dmThreadPool::Run((dmThreadPool::HThreadPool)user_data, SolverJob, &ctx, (uint32_t)count);
+    }
+
     HWorld2D NewWorld2D(HContext2D context, const NewWorldParams& params)
     {
         if (context->m_Worlds.Full())
@@ -255,6 +286,10 @@ namespace dmPhysics
         world->m_World.SetDebugDraw(&world->m_DebugDraw);
         world->m_World.SetContactListener(&world->m_ContactListener);
         world->m_World.SetContinuousPhysics(false);
+        if (context->m_SolverPool != 0)
+        {
+            world->m_World.SetParallelFor(SolverParallelFor, context->m_SolverPool, dmThreadPool::GetThreadCount(context->m_SolverPool) + 1);
+        }
         context->m_Worlds.Push(world);
         return world;
     }
@@ -379,6 +414,47 @@ namespace dmPhysics
         }
     }
 
+    static void UpdateKinematicBody2D(HWorld2D world, b2Body* body, float scale, float pos_epsilon, float rot_epsilon)
+    {
+        bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+
+        // translate & rotation
+        if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+        {
+            Vectormath::Aos::Point3 old_position = GetWorldPosition2D(world->m_Context, body);
+            dmTransform::Transform world_transform;
+            (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
+            Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+            // Ignore z-component
+            position.setZ(0.0f);
+            Vectormath::Aos::Quat rotation = world_transform.GetRotation();
+            float dp = distSqr(old_position, position);
+            float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
+            float old_angle = body->GetAngle();
+            float da = old_angle - angle;
+
+            if (dp > pos_epsilon || fabsf(da) > rot_epsilon)
+            {
+                b2Vec2 b2_position;
+                ToB2(position, b2_position, scale);
+                body->SetTransform(b2_position, angle);
+                if (body->IsSleepingAllowed())
+                {
+                    body->SetSleepingAllowed(false);
+                    if (world->m_MovedBodies.Full())
+                        world->m_MovedBodies.OffsetCapacity(dmMath::Max(world->m_MovedBodies.Capacity(), 32U));
+                    world->m_MovedBodies.Push(body);
+                }
+            }
+        }
+
+        // Scaling
+        if(retrieve_gameworld_transform)
+        {
+            UpdateScale(world, body);
+        }
+    }
+
     void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
@@ -392,42 +468,27 @@ namespace dmPhysics
         if (world->m_GetWorldTransformCallback)
         {
             DM_PROFILE(Physics, "UpdateKinematic");
-            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+            // Bodies moved in the last step are allowed to sleep again, unless they are moved in this step as well
+            uint32_t moved_count = world->m_MovedBodies.Size();
+            for (uint32_t i = 0; i < moved_count; ++i)
             {
-                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+                world->m_MovedBodies[i]->SetSleepingAllowed(true);
+            }
+            world->m_MovedBodies.SetSize(0);
 
-                // translate & rotation
-                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+            if (step_context.m_SyncDirtyOnly)
+            {
+                uint32_t dirty_count = step_context.m_DirtyCollisionObjectCount;
+                for (uint32_t i = 0; i < dirty_count; ++i)
                 {
-                    Vectormath::Aos::Point3 old_position = GetWorldPosition2D(context, body);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    // Ignore z-component
-                    position.setZ(0.0f);
-                    Vectormath::Aos::Quat rotation = world_transform.GetRotation();
-                    float dp = distSqr(old_position, position);
-                    float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
-                    float old_angle = body->GetAngle();
-                    float da = old_angle - angle;
-
-                    if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
-                    {
-                        b2Vec2 b2_position;
-                        ToB2(position, b2_position, scale);
-                        body->SetTransform(b2_position, angle);
-                        body->SetSleepingAllowed(false);
-                    }
-                    else
-                    {
-                        body->SetSleepingAllowed(true);
-                    }
+                    UpdateKinematicBody2D(world, (b2Body*)step_context.m_DirtyCollisionObjects[i], scale, POS_EPSILON, ROT_EPSILON);
                 }
-
-                // Scaling
-                if(retrieve_gameworld_transform)
+            }
+            else
+            {
+                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
                 {
-                    UpdateScale(world, body);
+                    UpdateKinematicBody2D(world, body, scale, POS_EPSILON, ROT_EPSILON);
                 }
             }
         }
@@ -652,6 +713,37 @@ namespace dmPhysics
         grid_shape->SetCellHull(body, row, column, hull, f);
     }
 
+    void SetGridShapeHulls(HCollisionObject2D collision_object, uint32_t shape_index, const GridShapeCell* cells, uint32_t cell_count)
+    {
+        if (cell_count == 0)
+        {
+            return;
+        }
+
+        b2Body* body = (b2Body*) collision_object;
+        b2Fixture* fixture = GetFixture(body, shape_index);
+        assert(fixture->GetShape()->GetType() == b2Shape::e_grid);
+        b2GridShape* grid_shape = (b2GridShape*) fixture->GetShape();
+
+        dmArray<b2GridShape::CellUpdate> updates;
+        updates.SetCapacity(cell_count);
+        updates.SetSize(cell_count);
+        for (uint32_t i = 0; i < cell_count; ++i)
+        {
+            const GridShapeCell& cell = cells[i];
+            assert(cell.m_Row < grid_shape->m_rowCount && cell.m_Column < grid_shape->m_columnCount);
+            b2GridShape::CellUpdate& update = updates[i];
+            update.m_Index = cell.m_Row * grid_shape->m_columnCount + cell.m_Column;
+            update.m_Hull = cell.m_Hull;
+            update.m_Flags.m_FlipHorizontal = cell.m_Flags.m_FlipHorizontal;
+            update.m_Flags.m_FlipVertical = cell.m_Flags.m_FlipVertical;
+            update.m_Filter = fixture->GetFilterData(update.m_Index);
+            update.m_Filter.categoryBits = cell.m_Group;
+            update.m_Filter.maskBits = cell.m_Mask;
+        }
+        grid_shape->SetCellHulls(fixture, updates.Begin(), cell_count);
+    }
+
     void SetGridShapeEnable(HCollisionObject2D collision_object, uint32_t shape_index, uint32_t enable)
     {
         b2Body* body = (b2Body*) collision_object;
@@ -947,6 +1039,18 @@ namespace dmPhysics
 
         OverlapCacheRemove(&world->m_TriggerOverlaps, collision_object);
         b2Body* body = (b2Body*)collision_object;
+        if (!body->IsSleepingAllowed())
+        {
+            uint32_t moved_count = world->m_MovedBodies.Size();
+            for (uint32_t i = 0; i < moved_count; ++i)
+            {
+                if (world->m_MovedBodies[i] == body)
+                {
+                    world->m_MovedBodies.EraseSwap(i);
+                    break;
+                }
+            }
+        }
         b2Fixture* fixture = body->GetFixtureList();
         while (fixture)
         {
@@ -1188,6 +1292,178 @@ namespace dmPhysics
         }
     }
 
+    struct RayCastBatchContext2D
+    {
+        HWorld2D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    static void RayCastBatchJob2D(void* _ctx, uint32_t job_index, uint32_t begin, uint32_t end)
+    {
+        RayCastBatchContext2D* ctx = (RayCastBatchContext2D*)_ctx;
+        HWorld2D world = ctx->m_World;
+        float scale = world->m_Context->m_Scale;
+        ProcessRayCastResultCallback2D query;
+        query.m_Context = world->m_Context;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = ctx->m_Requests[i];
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            query.m_Request = &request;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_CollisionMask = request.m_Mask;
+            query.m_Response.m_Hit = 0;
+            if (b2DistanceSquared(from, to) > 0.0f)
+            {
+                world->m_World.RayCast(&query, from, to);
+            }
+            ctx->m_Responses[i] = query.m_Response;
+        }
+    }
+
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+
+        RayCastBatchContext2D ctx;
+        ctx.m_World = world;
+        ctx.m_Requests = requests;
+        ctx.m_Responses = responses;
+        RunQueryBatch(&world->m_Context->m_QueryPool, RayCastBatchJob2D, &ctx, count);
+    }
+
+    // Tests the fixtures found in the broad phase against the query shape
+    struct OverlapQuery2D
+    {
+        bool QueryCallback(int32 proxy_id)
+        {
+            b2FixtureProxy* proxy = (b2FixtureProxy*)m_BroadPhase->GetUserData(proxy_id);
+            b2Fixture* fixture = proxy->fixture;
+            // Never report triggers
+            if (fixture->IsSensor())
+                return true;
+            b2Body* body = fixture->GetBody();
+            void* user_data = body->GetUserData();
+            if (user_data == m_IgnoredUserData)
+                return true;
+            uint16_t group = fixture->GetFilterData(proxy->childIndex).categoryBits;
+            if (!(group & m_Mask))
+                return true;
+
+            const b2Shape* shape = fixture->GetShape();
+            bool overlap;
+            if (shape->GetType() == b2Shape::e_grid)
+            {
+                // Grid cells have no shape of their own, build the polygon of the cell
+                const b2GridShape* grid_shape = (const b2GridShape*)shape;
+                if (grid_shape->m_cells[proxy->childIndex].m_Index == B2GRIDSHAPE_EMPTY_CELL)
+                    return true;
+                b2PolygonShape cell_shape;
+                grid_shape->GetPolygonShapeForCell(proxy->childIndex, cell_shape);
+                overlap = b2TestOverlap(m_Shape, 0, &cell_shape, 0, m_Transform, body->GetTransform());
+            }
+            else
+            {
+                overlap = b2TestOverlap(m_Shape, 0, shape, proxy->childIndex, m_Transform, body->GetTransform());
+            }
+            if (!overlap)
+                return true;
+
+            // Report each object once, even if several of its fixtures overlap
+            for (uint32_t i = m_FirstHit; i < m_Hits->Size(); ++i)
+            {
+                if ((*m_Hits)[i].m_CollisionObjectUserData == user_data)
+                    return true;
+            }
+            if (m_Hits->Full())
+                m_Hits->OffsetCapacity(dmMath::Max(m_Hits->Capacity(), 32U));
+            OverlapHit hit;
+            hit.m_CollisionObjectUserData = user_data;
+            hit.m_CollisionObjectGroup = group;
+            m_Hits->Push(hit);
+            return true;
+        }
+
+        const b2BroadPhase*     m_BroadPhase;
+        const b2Shape*          m_Shape;
+        b2Transform             m_Transform;
+        dmArray<OverlapHit>*    m_Hits;
+        void*                   m_IgnoredUserData;
+        uint32_t                m_FirstHit;
+        uint16_t                m_Mask;
+    };
+
+    struct OverlapBatchContext2D
+    {
+        HWorld2D                m_World;
+        const OverlapRequest*   m_Requests;
+        OverlapResponse*        m_Responses;
+        dmArray<OverlapHit>     m_JobHits[MAX_QUERY_JOB_COUNT];
+    };
+
+    static void OverlapBatchJob2D(void* _ctx, uint32_t job_index, uint32_t begin, uint32_t end)
+    {
+        OverlapBatchContext2D* ctx = (OverlapBatchContext2D*)_ctx;
+        HWorld2D world = ctx->m_World;
+        float scale = world->m_Context->m_Scale;
+
+        OverlapQuery2D query;
+        query.m_BroadPhase = &world->m_World.GetContactManager().m_broadPhase;
+        query.m_Hits = &ctx->m_JobHits[job_index];
+        query.m_Transform.SetIdentity();
+
+        b2PolygonShape box_shape;
+        b2CircleShape circle_shape;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const OverlapRequest& request = ctx->m_Requests[i];
+            b2Vec2 position;
+            ToB2(request.m_Position, position, scale);
+            b2AABB aabb;
+            if (request.m_Shape == OVERLAP_SHAPE_SPHERE)
+            {
+                circle_shape.m_radius = request.m_Radius * scale;
+                query.m_Shape = &circle_shape;
+                b2Vec2 r(circle_shape.m_radius, circle_shape.m_radius);
+                aabb.lowerBound = position - r;
+                aabb.upperBound = position + r;
+            }
+            else
+            {
+                b2Vec2 half_extents;
+                ToB2(request.m_HalfExtents, half_extents, scale);
+                box_shape.SetAsBox(half_extents.x, half_extents.y);
+                query.m_Shape = &box_shape;
+                aabb.lowerBound = position - half_extents;
+                aabb.upperBound = position + half_extents;
+            }
+            query.m_Transform.p = position;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_Mask = request.m_Mask;
+            query.m_FirstHit = query.m_Hits->Size();
+            query.m_BroadPhase->Query(&query, aabb);
+
+            ctx->m_Responses[i].m_HitOffset = query.m_FirstHit;
+            ctx->m_Responses[i].m_HitCount = query.m_Hits->Size() - query.m_FirstHit;
+        }
+    }
+
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits)
+    {
+        DM_PROFILE(Physics, "OverlapBatch");
+
+        OverlapBatchContext2D ctx;
+        ctx.m_World = world;
+        ctx.m_Requests = requests;
+        ctx.m_Responses = responses;
+        uint32_t job_count = RunQueryBatch(&world->m_Context->m_QueryPool, OverlapBatchJob2D, &ctx, count);
+        MergeOverlapHits(ctx.m_JobHits, job_count, responses, count, hits);
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
         b2Vec2 gravity_b;
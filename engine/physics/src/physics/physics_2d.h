@@ -15,6 +15,7 @@
 
 #include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/thread_pool.h>
 
 #include "physics.h"
 #include "physics_private.h"
@@ -49,6 +50,8 @@ namespace dmPhysics
         ContactListener             m_ContactListener;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
         SetWorldTransformCallback   m_SetWorldTransformCallback;
+        // Bodies that were kept awake by a transform sync in the last step
+        dmArray<b2Body*>            m_MovedBodies;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -67,6 +70,10 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        // Solves the islands of all worlds in parallel, 0 if they are solved on the calling thread
+        dmThreadPool::HThreadPool   m_SolverPool;
+        // Runs the query batches of all worlds, created by the first large batch, see RunQueryBatch
+        dmThreadPool::HThreadPool   m_QueryPool;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
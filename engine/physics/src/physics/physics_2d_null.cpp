@@ -94,6 +94,10 @@ namespace dmPhysics
     {
     }
 
+    void SetGridShapeHulls(HCollisionObject2D collision_object, uint32_t shape_index, const GridShapeCell* cells, uint32_t cell_count)
+    {
+    }
+
     void SetGridShapeEnable(HCollisionObject2D collision_object, uint32_t shape_index, uint32_t enable)
     {
     }
@@ -226,6 +230,23 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_Hit = 0;
+        }
+    }
+
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_HitOffset = 0;
+            responses[i].m_HitCount = 0;
+        }
+    }
+
     void SetGravity2D(HWorld2D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
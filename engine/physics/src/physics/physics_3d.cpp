@@ -120,6 +120,7 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_QueryPool(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -304,6 +305,8 @@ namespace dmPhysics
         }
         if (context->m_Socket != 0)
             dmMessage::DeleteSocket(context->m_Socket);
+        if (context->m_QueryPool != 0)
+            dmThreadPool::Delete(context->m_QueryPool);
         delete context;
     }
 
@@ -355,6 +358,52 @@ namespace dmPhysics
 
     static void UpdateOverlapCache(OverlapCache* cache, HContext3D context, btDispatcher* dispatcher, const StepWorldContext& step_context);
 
+    static void UpdateKinematicObject3D(HWorld3D world, btCollisionObject* collision_object, float scale, float pos_epsilon, float rot_epsilon)
+    {
+        HContext3D context = world->m_Context;
+        bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && !collision_object->isStaticObject();
+
+        if (collision_object->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || collision_object->isKinematicObject() || retrieve_gameworld_transform)
+        {
+            Point3 old_position = GetWorldPosition(context, collision_object);
+            Quat old_rotation = GetWorldRotation(context, collision_object);
+            dmTransform::Transform world_transform;
+            (*world->m_GetWorldTransform)(collision_object->getUserPointer(), world_transform);
+            Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+            Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat(world_transform.GetRotation());
+            float dp = distSqr(old_position, position);
+            float dr = norm(rotation - old_rotation);
+            if (dp > pos_epsilon || dr > rot_epsilon)
+            {
+                btVector3 bt_pos;
+                ToBt(position, bt_pos, scale);
+                btTransform world_t(btQuaternion(rotation.getX(), rotation.getY(), rotation.getZ(), rotation.getW()), bt_pos);
+                collision_object->setWorldTransform(world_t);
+                collision_object->activate(true);
+            }
+        }
+
+        // Scaling
+        if (retrieve_gameworld_transform)
+        {
+            dmTransform::Transform world_transform;
+            world->m_GetWorldTransform(collision_object->getUserPointer(), world_transform);
+
+            // The compound shape scale always defaults to 1
+            btCollisionShape* shape = collision_object->getCollisionShape();
+
+            float object_scale = world_transform.GetUniformScale();
+            float shape_scale = shape->getLocalScaling().getX();
+
+            if (object_scale != shape_scale)
+            {
+                shape->setLocalScaling(btVector3(object_scale,object_scale,object_scale));
+                if (!collision_object->isActive())
+                    collision_object->activate(true);
+            }
+        }
+    }
+
     void StepWorld3D(HWorld3D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
@@ -368,52 +417,21 @@ namespace dmPhysics
         if (world->m_GetWorldTransform != 0x0)
         {
             DM_PROFILE(Physics, "UpdateTriggers");
-            int collision_object_count = world->m_DynamicsWorld->getNumCollisionObjects();
-            btCollisionObjectArray& collision_objects = world->m_DynamicsWorld->getCollisionObjectArray();
-            for (int i = 0; i < collision_object_count; ++i)
+            if (step_context.m_SyncDirtyOnly)
             {
-                btCollisionObject* collision_object = collision_objects[i];
-
-                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && !collision_object->isStaticObject();
-
-                if (collision_object->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || collision_object->isKinematicObject() || retrieve_gameworld_transform)
+                uint32_t dirty_count = step_context.m_DirtyCollisionObjectCount;
+                for (uint32_t i = 0; i < dirty_count; ++i)
                 {
-                    Point3 old_position = GetWorldPosition(context, collision_object);
-                    Quat old_rotation = GetWorldRotation(context, collision_object);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransform)(collision_object->getUserPointer(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat(world_transform.GetRotation());
-                    float dp = distSqr(old_position, position);
-                    float dr = norm(rotation - old_rotation);
-                    if (dp > POS_EPSILON || dr > ROT_EPSILON)
-                    {
-                        btVector3 bt_pos;
-                        ToBt(position, bt_pos, scale);
-                        btTransform world_t(btQuaternion(rotation.getX(), rotation.getY(), rotation.getZ(), rotation.getW()), bt_pos);
-                        collision_object->setWorldTransform(world_t);
-                        collision_object->activate(true);
-                    }
+                    UpdateKinematicObject3D(world, GetCollisionObject(step_context.m_DirtyCollisionObjects[i]), scale, POS_EPSILON, ROT_EPSILON);
                 }
-
-                // Scaling
-                if (retrieve_gameworld_transform)
+            }
+            else
+            {
+                int collision_object_count = world->m_DynamicsWorld->getNumCollisionObjects();
+                btCollisionObjectArray& collision_objects = world->m_DynamicsWorld->getCollisionObjectArray();
+                for (int i = 0; i < collision_object_count; ++i)
                 {
-                    dmTransform::Transform world_transform;
-                    world->m_GetWorldTransform(collision_object->getUserPointer(), world_transform);
-
-                    // The compound shape scale always defaults to 1
-                    btCollisionShape* shape = collision_object->getCollisionShape();
-
-                    float object_scale = world_transform.GetUniformScale();
-                    float shape_scale = shape->getLocalScaling().getX();
-
-                    if (object_scale != shape_scale)
-                    {
-                        shape->setLocalScaling(btVector3(object_scale,object_scale,object_scale));
-                        if (!collision_object->isActive())
-                            collision_object->activate(true);
-                    }
+                    UpdateKinematicObject3D(world, collision_objects[i], scale, POS_EPSILON, ROT_EPSILON);
                 }
             }
         }
@@ -1156,6 +1174,160 @@ namespace dmPhysics
         }
     }
 
+    struct RayCastBatchContext3D
+    {
+        HWorld3D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    static void RayCastBatchJob3D(void* _ctx, uint32_t job_index, uint32_t begin, uint32_t end)
+    {
+        RayCastBatchContext3D* ctx = (RayCastBatchContext3D*)_ctx;
+        HWorld3D world = ctx->m_World;
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = ctx->m_Requests[i];
+            RayCastResponse& response = ctx->m_Responses[i];
+            response.m_Hit = 0;
+            if (Vectormath::Aos::lengthSqr(request.m_To - request.m_From) <= 0.0f)
+                continue;
+
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+            if (result_callback.hasHit())
+            {
+                ResponseFromRayCastResult(response, inv_scale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_collisionObject);
+            }
+        }
+    }
+
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        DM_PROFILE(Physics, "RayCastBatch");
+
+        RayCastBatchContext3D ctx;
+        ctx.m_World = world;
+        ctx.m_Requests = requests;
+        ctx.m_Responses = responses;
+        RunQueryBatch(&world->m_Context->m_QueryPool, RayCastBatchJob3D, &ctx, count);
+    }
+
+    // Tests the objects found in the broad phase against the query shape, using their bounding boxes
+    struct OverlapQuery3D : public btBroadphaseAabbCallback
+    {
+        virtual bool process(const btBroadphaseProxy* proxy)
+        {
+            const btCollisionObject* collision_object = (const btCollisionObject*)proxy->m_clientObject;
+            // Never report triggers
+            if (!collision_object->hasContactResponse())
+                return true;
+            void* user_data = collision_object->getUserPointer();
+            if (user_data == m_IgnoredUserData)
+                return true;
+            uint16_t group = proxy->m_collisionFilterGroup;
+            if (!(group & m_Mask))
+                return true;
+
+            btVector3 object_min;
+            btVector3 object_max;
+            collision_object->getCollisionShape()->getAabb(collision_object->getWorldTransform(), object_min, object_max);
+            if (m_Sphere)
+            {
+                btVector3 closest = m_Position;
+                closest.setMax(object_min);
+                closest.setMin(object_max);
+                if (closest.distance2(m_Position) > m_Radius * m_Radius)
+                    return true;
+            }
+            else if (!TestAabbAgainstAabb2(m_Min, m_Max, object_min, object_max))
+            {
+                return true;
+            }
+
+            // Compound objects have a single broad phase proxy, so each object is only found once
+            if (m_Hits->Full())
+                m_Hits->OffsetCapacity(dmMath::Max(m_Hits->Capacity(), 32U));
+            OverlapHit hit;
+            hit.m_CollisionObjectUserData = user_data;
+            hit.m_CollisionObjectGroup = group;
+            m_Hits->Push(hit);
+            return true;
+        }
+
+        btVector3               m_Position;
+        btVector3               m_Min;
+        btVector3               m_Max;
+        btScalar                m_Radius;
+        dmArray<OverlapHit>*    m_Hits;
+        void*                   m_IgnoredUserData;
+        uint16_t                m_Mask;
+        uint16_t                m_Sphere : 1;
+    };
+
+    struct OverlapBatchContext3D
+    {
+        HWorld3D                m_World;
+        const OverlapRequest*   m_Requests;
+        OverlapResponse*        m_Responses;
+        dmArray<OverlapHit>     m_JobHits[MAX_QUERY_JOB_COUNT];
+    };
+
+    static void OverlapBatchJob3D(void* _ctx, uint32_t job_index, uint32_t begin, uint32_t end)
+    {
+        OverlapBatchContext3D* ctx = (OverlapBatchContext3D*)_ctx;
+        HWorld3D world = ctx->m_World;
+        float scale = world->m_Context->m_Scale;
+        btBroadphaseInterface* broadphase = world->m_DynamicsWorld->getBroadphase();
+
+        OverlapQuery3D query;
+        query.m_Hits = &ctx->m_JobHits[job_index];
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const OverlapRequest& request = ctx->m_Requests[i];
+            ToBt(request.m_Position, query.m_Position, scale);
+            btVector3 half_extents;
+            if (request.m_Shape == OVERLAP_SHAPE_SPHERE)
+            {
+                query.m_Radius = request.m_Radius * scale;
+                query.m_Sphere = 1;
+                half_extents.setValue(query.m_Radius, query.m_Radius, query.m_Radius);
+            }
+            else
+            {
+                ToBt(request.m_HalfExtents, half_extents, scale);
+                query.m_Sphere = 0;
+            }
+            query.m_Min = query.m_Position - half_extents;
+            query.m_Max = query.m_Position + half_extents;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_Mask = request.m_Mask;
+
+            uint32_t first_hit = query.m_Hits->Size();
+            broadphase->aabbTest(query.m_Min, query.m_Max, query);
+            ctx->m_Responses[i].m_HitOffset = first_hit;
+            ctx->m_Responses[i].m_HitCount = query.m_Hits->Size() - first_hit;
+        }
+    }
+
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits)
+    {
+        DM_PROFILE(Physics, "OverlapBatch");
+
+        OverlapBatchContext3D ctx;
+        ctx.m_World = world;
+        ctx.m_Requests = requests;
+        ctx.m_Responses = responses;
+        uint32_t job_count = RunQueryBatch(&world->m_Context->m_QueryPool, OverlapBatchJob3D, &ctx, count);
+        MergeOverlapHits(ctx.m_JobHits, job_count, responses, count, hits);
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
         HContext3D context = world->m_Context;
@@ -14,6 +14,7 @@
 #define PHYSICS_3D_H
 
 #include <dlib/array.h>
+#include <dlib/thread_pool.h>
 
 #include "physics.h"
 #include "physics_private.h"
@@ -55,6 +56,8 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        // Runs the query batches of all worlds, created by the first large batch, see RunQueryBatch
+        dmThreadPool::HThreadPool   m_QueryPool;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
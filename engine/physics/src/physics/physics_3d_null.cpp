@@ -194,6 +194,23 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, uint32_t count, RayCastResponse* responses)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_Hit = 0;
+        }
+    }
+
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, OverlapResponse* responses, dmArray<OverlapHit>& hits)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            responses[i].m_HitOffset = 0;
+            responses[i].m_HitCount = 0;
+        }
+    }
+
     void SetGravity3D(HWorld3D world, const Vectormath::Aos::Vector3& gravity)
     {
     }
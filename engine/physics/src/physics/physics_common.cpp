@@ -15,6 +15,9 @@
 
 #include <string.h>
 
+#include <dlib/math.h>
+#include <dlib/thread_pool.h>
+
 namespace dmPhysics
 {
     using namespace Vectormath::Aos;
@@ -30,6 +33,7 @@ namespace dmPhysics
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
     , m_TriggerOverlapCapacity(0)
+    , m_SolverThreadCount(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -89,6 +93,17 @@ namespace dmPhysics
 
     }
 
+    OverlapRequest::OverlapRequest()
+    : m_Position(0.0f, 0.0f, 0.0f)
+    , m_HalfExtents(0.0f, 0.0f, 0.0f)
+    , m_Radius(0.0f)
+    , m_IgnoredUserData((void*)~0) // unlikely user data to ignore
+    , m_Mask(~0)
+    , m_Shape(OVERLAP_SHAPE_BOX)
+    {
+
+    }
+
     DebugCallbacks::DebugCallbacks()
     : m_DrawLines(0x0)
     , m_DrawTriangles(0x0)
@@ -117,4 +132,87 @@ namespace dmPhysics
         memset(this, 0, sizeof(*this));
     }
 
+    // Batches with fewer queries than this run on the calling thread, since
+    // waking the workers costs more than it saves.
+    static const uint32_t MIN_PARALLEL_QUERY_COUNT = 64;
+
+    struct QueryBatchContext
+    {
+        QueryJobFunction    m_Function;
+        void*               m_Context;
+        uint32_t            m_Count;
+        uint32_t            m_JobCount;
+    };
+
+    static void QueryBatchJob(void* _ctx, uint32_t job_index)
+    {
+        QueryBatchContext* ctx = (QueryBatchContext*)_ctx;
+        uint32_t begin = GetQueryJobBegin(ctx->m_Count, ctx->m_JobCount, job_index);
+        uint32_t end = GetQueryJobBegin(ctx->m_Count, ctx->m_JobCount, job_index + 1);
+        ctx->m_Function(ctx->m_Context, job_index, begin, end);
+    }
+
+    uint32_t GetQueryJobBegin(uint32_t count, uint32_t job_count, uint32_t job_index)
+    {
+        return (uint32_t)(((uint64_t)count * job_index) / job_count);
+    }
+
+    uint32_t RunQueryBatch(dmThreadPool::HThreadPool* pool_slot, QueryJobFunction function, void* context, uint32_t count)
+    {
+        dmThreadPool::HThreadPool pool = 0;
+        uint32_t job_count = 1;
+        if (count >= MIN_PARALLEL_QUERY_COUNT)
+        {
+            if (*pool_slot == 0)
+            {
+                // The querying thread runs a job too
+                *pool_slot = dmThreadPool::New(MAX_QUERY_JOB_COUNT - 1, "physics_query");
+            }
+            pool = *pool_slot;
+            if (pool)
+            {
+                job_count = dmMath::Min(dmThreadPool::GetThreadCount(pool) + 1, dmMath::Min(count / (MIN_PARALLEL_QUERY_COUNT / 2), MAX_QUERY_JOB_COUNT));
+            }
+        }
+
+        if (job_count <= 1)
+        {
+            function(context, 0, 0, count);
+            return 1;
+        }
+
+        QueryBatchContext ctx;
+        ctx.m_Function = function;
+        ctx.m_Context = context;
+        ctx.m_Count = count;
+        ctx.m_JobCount = job_count;
+        dmThreadPool::Run(pool, QueryBatchJob, &ctx, job_count);
+        return job_count;
+    }
+
+    void MergeOverlapHits(dmArray<OverlapHit>* job_hits, uint32_t job_count, OverlapResponse* responses, uint32_t count, dmArray<OverlapHit>& hits)
+    {
+        uint32_t total = hits.Size();
+        for (uint32_t job = 0; job < job_count; ++job)
+        {
+            total += job_hits[job].Size();
+        }
+        if (hits.Capacity() < total)
+        {
+            hits.OffsetCapacity(total - hits.Capacity());
+        }
+
+        for (uint32_t job = 0; job < job_count; ++job)
+        {
+            uint32_t offset = hits.Size();
+            uint32_t begin = GetQueryJobBegin(count, job_count, job);
+            uint32_t end = GetQueryJobBegin(count, job_count, job + 1);
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                responses[i].m_HitOffset += offset;
+            }
+            hits.PushArray(job_hits[job].Begin(), job_hits[job].Size());
+        }
+    }
+
 }
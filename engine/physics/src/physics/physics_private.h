@@ -13,7 +13,9 @@
 #ifndef PHYSICS_PRIVATE_H
 #define PHYSICS_PRIVATE_H
 
+#include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/thread_pool.h>
 
 namespace dmPhysics
 {
@@ -123,6 +125,36 @@ namespace dmPhysics
      * if it is the last known occurrence of overlap.
      */
     void OverlapCachePrune(OverlapCache* cache, const OverlapCachePruneData& data);
+
+    /**
+     * Max number of jobs a query batch is split into.
+     */
+    const uint32_t MAX_QUERY_JOB_COUNT = 8;
+
+    /**
+     * Runs the queries [begin, end) of a batch.
+     * The job index is unique among the jobs of the batch, and less than MAX_QUERY_JOB_COUNT.
+     */
+    typedef void (*QueryJobFunction)(void* context, uint32_t job_index, uint32_t begin, uint32_t end);
+
+    /**
+     * Runs all queries of a batch, split over the query pool of the context when the batch is large enough.
+     * Returns when all queries are done.
+     * @param pool_slot Query pool of the context, created by the first batch that is large enough to be split
+     * @return Number of jobs the batch was split into, see GetQueryJobBegin
+     */
+    uint32_t RunQueryBatch(dmThreadPool::HThreadPool* pool_slot, QueryJobFunction function, void* context, uint32_t count);
+
+    /**
+     * First query of a job, as split by RunQueryBatch.
+     */
+    uint32_t GetQueryJobBegin(uint32_t count, uint32_t job_count, uint32_t job_index);
+
+    /**
+     * Concatenates the hits found by each job of an overlap batch, in request order.
+     * The hit offsets in the responses are relative to the hits of their job on entry, and to hits on return.
+     */
+    void MergeOverlapHits(dmArray<OverlapHit>* job_hits, uint32_t job_count, OverlapResponse* responses, uint32_t count, dmArray<OverlapHit>& hits);
 }
 
 #endif // PHYSICS_PRIVATE_H
@@ -125,6 +125,8 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
+, m_OverlapBatchFunc(dmPhysics::OverlapBatch3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
@@ -182,6 +184,8 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
+, m_OverlapBatchFunc(dmPhysics::OverlapBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
@@ -1226,6 +1230,205 @@ TYPED_TEST(PhysicsTest, SynchronousRayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, BatchRayCasting)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+
+    dmPhysics::CollisionObjectData data_a;
+    data_a.m_Group = 2;
+    data_a.m_Mass = 0.0f;
+    data_a.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data_a.m_UserData = &vo_a;
+    typename TypeParam::CollisionObjectType box_co_a = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data_a, &shape, 1u);
+
+    dmPhysics::CollisionObjectData data_b;
+    data_b.m_Group = 1;
+    data_b.m_Mass = 0.0f;
+    data_b.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data_b.m_UserData = &vo_b;
+    typename TypeParam::CollisionObjectType box_co_b = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data_b, &shape, 1u);
+
+    // Large enough to be split over worker threads
+    const uint32_t count = 256;
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(count);
+    requests.SetSize(count);
+    dmArray<dmPhysics::RayCastResponse> responses;
+    responses.SetCapacity(count);
+    responses.SetSize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmPhysics::RayCastRequest& request = requests[i];
+        request.m_Mask = 1;
+        switch (i % 4)
+        {
+        case 0: // Hits b, since a has the wrong group
+            request.m_From = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+            request.m_To = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+            break;
+        case 1: // A miss
+            request.m_From = Vectormath::Aos::Point3(-1.0f, 2.0f, 0.0f);
+            request.m_To = Vectormath::Aos::Point3(5.0f, 2.0f, 0.0f);
+            break;
+        case 2: // Hits b from the other side
+            request.m_From = Vectormath::Aos::Point3(5.0f, 0.0f, 0.0f);
+            request.m_To = Vectormath::Aos::Point3(-1.0f, 0.0f, 0.0f);
+            break;
+        case 3: // Zero length
+            request.m_From = Vectormath::Aos::Point3(2.5f, 0.0f, 0.0f);
+            request.m_To = Vectormath::Aos::Point3(2.5f, 0.0f, 0.0f);
+            break;
+        }
+    }
+
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests.Begin(), count, responses.Begin());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const dmPhysics::RayCastResponse& response = responses[i];
+        switch (i % 4)
+        {
+        case 0:
+            ASSERT_TRUE(response.m_Hit);
+            ASSERT_EQ((void*)&vo_b, response.m_CollisionObjectUserData);
+            ASSERT_NEAR(0.5f, response.m_Fraction, 0.0001f);
+            ASSERT_NEAR(2.0f, response.m_Position.getX(), 0.0001f);
+            break;
+        case 2:
+            ASSERT_TRUE(response.m_Hit);
+            ASSERT_EQ((void*)&vo_b, response.m_CollisionObjectUserData);
+            ASSERT_NEAR(3.0f, response.m_Position.getX(), 0.0001f);
+            break;
+        default:
+            ASSERT_FALSE(response.m_Hit);
+            break;
+        }
+    }
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_a);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co_b);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+static bool HasOverlapHit(const dmArray<dmPhysics::OverlapHit>& hits, const dmPhysics::OverlapResponse& response, void* user_data)
+{
+    for (uint32_t i = response.m_HitOffset; i < response.m_HitOffset + response.m_HitCount; ++i)
+    {
+        if (hits[i].m_CollisionObjectUserData == user_data)
+            return true;
+    }
+    return false;
+}
+
+TYPED_TEST(PhysicsTest, BatchOverlap)
+{
+    float box_half_ext = 0.5f;
+
+    VisualObject vo_a;
+    vo_a.m_Position.setX(1.0f);
+
+    VisualObject vo_b;
+    vo_b.m_Position.setX(2.5f);
+
+    VisualObject vo_c;
+    vo_c.m_Position.setX(4.0f);
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+
+    VisualObject* vos[] = {&vo_a, &vo_b, &vo_c};
+    uint16_t groups[] = {1, 1, 2};
+    typename TypeParam::CollisionObjectType cos[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        dmPhysics::CollisionObjectData data;
+        data.m_Group = groups[i];
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+        data.m_UserData = vos[i];
+        cos[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    // Large enough to be split over worker threads
+    const uint32_t count = 200;
+    dmArray<dmPhysics::OverlapRequest> requests;
+    requests.SetCapacity(count);
+    requests.SetSize(count);
+    dmArray<dmPhysics::OverlapResponse> responses;
+    responses.SetCapacity(count);
+    responses.SetSize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmPhysics::OverlapRequest& request = requests[i];
+        request.m_Mask = 3;
+        switch (i % 4)
+        {
+        case 0: // Spans a and b
+            request.m_Shape = dmPhysics::OVERLAP_SHAPE_BOX;
+            request.m_Position = Vectormath::Aos::Point3(1.75f, 0.0f, 0.0f);
+            request.m_HalfExtents = Vectormath::Aos::Vector3(1.0f, 0.25f, 0.25f);
+            break;
+        case 1: // Inside c
+            request.m_Shape = dmPhysics::OVERLAP_SHAPE_SPHERE;
+            request.m_Position = Vectormath::Aos::Point3(4.0f, 0.0f, 0.0f);
+            request.m_Radius = 0.1f;
+            break;
+        case 2: // Inside c, but filtered out
+            request.m_Shape = dmPhysics::OVERLAP_SHAPE_SPHERE;
+            request.m_Position = Vectormath::Aos::Point3(4.0f, 0.0f, 0.0f);
+            request.m_Radius = 0.1f;
+            request.m_Mask = 1;
+            break;
+        case 3: // Between b and c
+            request.m_Shape = dmPhysics::OVERLAP_SHAPE_SPHERE;
+            request.m_Position = Vectormath::Aos::Point3(3.25f, 0.0f, 0.0f);
+            request.m_Radius = 0.2f;
+            break;
+        }
+    }
+
+    dmArray<dmPhysics::OverlapHit> hits;
+    (*TestFixture::m_Test.m_OverlapBatchFunc)(TestFixture::m_World, requests.Begin(), count, responses.Begin(), hits);
+
+    uint32_t hit_count = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const dmPhysics::OverlapResponse& response = responses[i];
+        ASSERT_EQ(hit_count, response.m_HitOffset);
+        hit_count += response.m_HitCount;
+        switch (i % 4)
+        {
+        case 0:
+            ASSERT_EQ(2u, response.m_HitCount);
+            ASSERT_TRUE(HasOverlapHit(hits, response, &vo_a));
+            ASSERT_TRUE(HasOverlapHit(hits, response, &vo_b));
+            break;
+        case 1:
+            ASSERT_EQ(1u, response.m_HitCount);
+            ASSERT_TRUE(HasOverlapHit(hits, response, &vo_c));
+            ASSERT_EQ(2u, hits[response.m_HitOffset].m_CollisionObjectGroup);
+            break;
+        default:
+            ASSERT_EQ(0u, response.m_HitCount);
+            break;
+        }
+    }
+    ASSERT_EQ(hit_count, hits.Size());
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, cos[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 enum Groups
 {
     GROUP_A = 1 << 0,
@@ -120,6 +120,8 @@ struct Funcs
     typedef float (*GetMassFunc)(typename T::CollisionObjectType collision_object);
     typedef void (*RequestRayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request);
     typedef void (*RayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    typedef void (*RayCastBatchFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest* requests, uint32_t count, dmPhysics::RayCastResponse* responses);
+    typedef void (*OverlapBatchFunc)(typename T::WorldType world, const dmPhysics::OverlapRequest* requests, uint32_t count, dmPhysics::OverlapResponse* responses, dmArray<dmPhysics::OverlapHit>& hits);
     typedef void (*SetDebugCallbacks)(typename T::ContextType context, const dmPhysics::DebugCallbacks& callbacks);
     typedef void (*ReplaceShapeFunc)(typename T::ContextType context, typename T::CollisionShapeType old_shape, typename T::CollisionShapeType new_shape);
     typedef void (*SetGravityFunc)(typename T::WorldType world, const Vectormath::Aos::Vector3& gravity);
@@ -174,6 +176,8 @@ struct Test3D
     Funcs<Test3D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test3D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test3D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test3D>::RayCastBatchFunc                 m_RayCastBatchFunc;
+    Funcs<Test3D>::OverlapBatchFunc                 m_OverlapBatchFunc;
     Funcs<Test3D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test3D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test3D>::SetGravityFunc                   m_SetGravityFunc;
@@ -231,6 +235,8 @@ struct Test2D
     Funcs<Test2D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test2D>::RequestRayCastFunc               m_RequestRayCastFunc;
     Funcs<Test2D>::RayCastFunc                      m_RayCastFunc;
+    Funcs<Test2D>::RayCastBatchFunc                 m_RayCastBatchFunc;
+    Funcs<Test2D>::OverlapBatchFunc                 m_OverlapBatchFunc;
     Funcs<Test2D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test2D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
     Funcs<Test2D>::SetGravityFunc                   m_SetGravityFunc;
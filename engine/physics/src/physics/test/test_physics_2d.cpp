@@ -1423,6 +1423,98 @@ TYPED_TEST(PhysicsTest, ClearGridShapeHull)
     dmPhysics::DeleteHullSet2D(hull_set);
 }
 
+TYPED_TEST(PhysicsTest, SetGridShapeHulls)
+{
+    /*
+     * Batched version of ClearGridShapeHull
+     */
+    int32_t rows = 2;
+    int32_t columns = 2;
+    int32_t cell_width = 16;
+    int32_t cell_height = 16;
+
+    VisualObject vo_a;
+    vo_a.m_Position = Point3(0, 0, 0);
+    dmPhysics::CollisionObjectData data;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_a;
+    data.m_Group = 0xffff;
+    data.m_Mask = 0xffff;
+
+    const float hull_vertices[] = {  // 1x1 around origo
+                                    -0.5f, -0.5f,
+                                     0.5f, -0.5f,
+                                     0.5f,  0.5f,
+                                    -0.5f,  0.5f };
+
+    const dmPhysics::HullDesc hulls[] = { {0, 4} };
+    dmPhysics::HHullSet2D hull_set = dmPhysics::NewHullSet2D(TestFixture::m_Context, hull_vertices, 4, hulls, 1);
+    dmPhysics::HCollisionShape2D grid_shape = dmPhysics::NewGridShape2D(TestFixture::m_Context, hull_set, Point3(0,0,0), cell_width, cell_height, rows, columns);
+    typename TypeParam::CollisionObjectType grid_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &grid_shape, 1u);
+
+    // An "L" of set hulls, the upper right corner is first set and then cleared in the same batch
+    dmPhysics::GridShapeCell cells[] = {
+        {0, 0, 0, EMPTY_FLAGS, 0xffff, 0xffff},
+        {1, 1, 0, EMPTY_FLAGS, 0xffff, 0xffff},
+        {0, 1, 0, EMPTY_FLAGS, 0xffff, 0xffff},
+        {1, 0, 0, EMPTY_FLAGS, 0xffff, 0xffff},
+        {1, 1, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS, 0, 0},
+    };
+    dmPhysics::SetGridShapeHulls(grid_co, 0, cells, sizeof(cells) / sizeof(cells[0]));
+
+    VisualObject vo_b;
+    // the sphere is centered in the upper right quadrant, which is cleared
+    vo_b.m_Position = Point3(8.0f, 8.0f, 0.0f);
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_Mass = 0.0f;
+    data.m_UserData = &vo_b;
+    data.m_Group = 0xffff;
+    data.m_Mask = 0xffff;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewSphereShapeFunc)(TestFixture::m_Context, 8.0f);
+    typename TypeParam::CollisionObjectType dynamic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    // See ClearGridShapeHull for why this is 2
+    ASSERT_EQ(2, TestFixture::m_CollisionCount);
+    ASSERT_EQ(2, TestFixture::m_ContactPointCount);
+
+    // Clear the "top" of the "L" and mask out the lower right cell
+    dmPhysics::GridShapeCell cells_cleared[] = {
+        {1, 0, dmPhysics::GRIDSHAPE_EMPTY_CELL, EMPTY_FLAGS, 0, 0},
+        {0, 1, 0, EMPTY_FLAGS, 0xffff, 0},
+    };
+    dmPhysics::SetGridShapeHulls(grid_co, 0, cells_cleared, sizeof(cells_cleared) / sizeof(cells_cleared[0]));
+
+    TestFixture::m_CollisionCount = 0;
+    TestFixture::m_ContactPointCount = 0;
+
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+
+    ASSERT_EQ(0, TestFixture::m_CollisionCount);
+    ASSERT_EQ(0, TestFixture::m_ContactPointCount);
+
+    // Unmask the lower right cell, the filtered out pair must be recreated
+    dmPhysics::GridShapeCell cells_unmasked[] = {
+        {0, 1, 0, EMPTY_FLAGS, 0xffff, 0xffff},
+    };
+    dmPhysics::SetGridShapeHulls(grid_co, 0, cells_unmasked, sizeof(cells_unmasked) / sizeof(cells_unmasked[0]));
+
+    // New pairs are found at the end of the step, the contact is reported in the next one
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+    ASSERT_EQ(0, TestFixture::m_CollisionCount);
+    (*TestFixture::m_Test.m_StepWorldFunc)(TestFixture::m_World, TestFixture::m_StepWorldContext);
+
+    ASSERT_EQ(1, TestFixture::m_CollisionCount);
+    ASSERT_EQ(1, TestFixture::m_ContactPointCount);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, grid_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, dynamic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(grid_shape);
+    dmPhysics::DeleteHullSet2D(hull_set);
+}
+
 // Test that a grid shape hull cell set to an empty hull is treated as a cleared cell
 TYPED_TEST(PhysicsTest, GridShapeEmptyHull)
 {
@@ -1607,6 +1699,134 @@ TYPED_TEST(PhysicsTest, SetGridShapeEnable)
     dmPhysics::DeleteHullSet2D(hull_set);
 }
 
+// Solver scene: stacks of boxes resting on a shared static ground, so that every
+// stack is an island of its own. Each stack also leans on a static post of its own.
+struct SolverScene
+{
+    static const uint32_t STACK_COUNT = 64;
+    static const uint32_t STACK_HEIGHT = 12;
+
+    SolverScene(uint32_t solver_thread_count)
+    {
+        dmPhysics::NewContextParams context_params;
+        context_params.m_Scale = PHYSICS_SCALE;
+        context_params.m_SolverThreadCount = solver_thread_count;
+        m_Context = dmPhysics::NewContext2D(context_params);
+        dmPhysics::NewWorldParams world_params;
+        world_params.m_GetWorldTransformCallback = GetWorldTransform;
+        world_params.m_SetWorldTransformCallback = SetWorldTransform;
+        world_params.m_WorldMin = Point3(-1000.0f, -100.0f, -100.0f);
+        world_params.m_WorldMax = Point3(1000.0f, 1000.0f, 100.0f);
+        m_World = dmPhysics::NewWorld2D(m_Context, world_params);
+
+        m_VisualObjects.resize(1 + STACK_COUNT * STACK_HEIGHT + STACK_COUNT);
+
+        float width = STACK_COUNT * 4.0f;
+        m_GroundShape = dmPhysics::NewBoxShape2D(m_Context, Vector3(width * 0.5f, 1.0f, 0.0f));
+        m_BoxShape = dmPhysics::NewBoxShape2D(m_Context, Vector3(0.5f, 0.5f, 0.0f));
+        m_PostShape = dmPhysics::NewBoxShape2D(m_Context, Vector3(0.1f, 2.0f, 0.0f));
+
+        dmPhysics::CollisionObjectData data;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+        data.m_Mass = 0.0f;
+        data.m_UserData = &m_VisualObjects[0];
+        m_VisualObjects[0].m_Position = Point3(0.0f, -1.0f, 0.0f);
+        m_Objects.push_back(dmPhysics::NewCollisionObject2D(m_World, data, &m_GroundShape, 1u));
+
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_DYNAMIC;
+        data.m_Mass = 1.0f;
+        for (uint32_t i = 0; i < STACK_COUNT; ++i)
+        {
+            for (uint32_t j = 0; j < STACK_HEIGHT; ++j)
+            {
+                VisualObject* vo = &m_VisualObjects[1 + i * STACK_HEIGHT + j];
+                // Slightly offset, so that the stacks don't come to rest at once
+                vo->m_Position = Point3(-width * 0.5f + 2.0f + i * 4.0f + 0.05f * (j % 3), 0.5f + j * 1.05f, 0.0f);
+                data.m_UserData = vo;
+                m_Objects.push_back(dmPhysics::NewCollisionObject2D(m_World, data, &m_BoxShape, 1u));
+            }
+        }
+
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+        data.m_Mass = 0.0f;
+        for (uint32_t i = 0; i < STACK_COUNT; ++i)
+        {
+            VisualObject* vo = &m_VisualObjects[1 + STACK_COUNT * STACK_HEIGHT + i];
+            vo->m_Position = Point3(-width * 0.5f + 2.0f + i * 4.0f + 0.7f, 2.0f, 0.0f);
+            data.m_UserData = vo;
+            m_Objects.push_back(dmPhysics::NewCollisionObject2D(m_World, data, &m_PostShape, 1u));
+        }
+    }
+
+    ~SolverScene()
+    {
+        for (uint32_t i = 0; i < m_Objects.size(); ++i)
+        {
+            dmPhysics::DeleteCollisionObject2D(m_World, m_Objects[i]);
+        }
+        dmPhysics::DeleteCollisionShape2D(m_PostShape);
+        dmPhysics::DeleteCollisionShape2D(m_BoxShape);
+        dmPhysics::DeleteCollisionShape2D(m_GroundShape);
+        dmPhysics::DeleteWorld2D(m_Context, m_World);
+        dmPhysics::DeleteContext2D(m_Context);
+    }
+
+    void Step(uint32_t step_count)
+    {
+        dmPhysics::StepWorldContext step_context;
+        step_context.m_DT = 1.0f / 60.0f;
+        for (uint32_t i = 0; i < step_count; ++i)
+        {
+            dmPhysics::StepWorld2D(m_World, step_context);
+        }
+    }
+
+    dmPhysics::HContext2D                   m_Context;
+    dmPhysics::HWorld2D                     m_World;
+    dmPhysics::HCollisionShape2D            m_GroundShape;
+    dmPhysics::HCollisionShape2D            m_BoxShape;
+    dmPhysics::HCollisionShape2D            m_PostShape;
+    std::vector<dmPhysics::HCollisionObject2D> m_Objects;
+    std::vector<VisualObject>               m_VisualObjects;
+};
+
+TEST(PhysicsSolver, ParallelIslands)
+{
+    const uint32_t step_count = 180;
+
+    SolverScene serial(1);
+    serial.Step(step_count);
+
+    uint32_t thread_counts[] = {2, 4, 8};
+    for (uint32_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); ++t)
+    {
+        SolverScene parallel(thread_counts[t]);
+        parallel.Step(step_count);
+
+        // The islands are solved exactly as on a single thread
+        for (uint32_t i = 0; i < serial.m_VisualObjects.size(); ++i)
+        {
+            const VisualObject& a = serial.m_VisualObjects[i];
+            const VisualObject& b = parallel.m_VisualObjects[i];
+            ASSERT_EQ(a.m_Position.getX(), b.m_Position.getX());
+            ASSERT_EQ(a.m_Position.getY(), b.m_Position.getY());
+            ASSERT_EQ(a.m_Rotation.getZ(), b.m_Rotation.getZ());
+            ASSERT_EQ(a.m_Rotation.getW(), b.m_Rotation.getW());
+        }
+        for (uint32_t i = 1; i < serial.m_Objects.size(); ++i)
+        {
+            ASSERT_EQ(dmPhysics::IsSleeping2D(serial.m_Objects[i]), dmPhysics::IsSleeping2D(parallel.m_Objects[i]));
+        }
+    }
+
+    // The stacks are still standing
+    for (uint32_t i = 0; i < SolverScene::STACK_COUNT; ++i)
+    {
+        const VisualObject& top = serial.m_VisualObjects[i * SolverScene::STACK_HEIGHT + SolverScene::STACK_HEIGHT];
+        ASSERT_GT(top.m_Position.getY(), SolverScene::STACK_HEIGHT - 1.0f);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -22,9 +22,19 @@
 #include <vpx/vpx_encoder.h>
 #include <vpx/vp8cx.h>
 #include <dlib/log.h>
+#include <dlib/thread.h>
+#include <dlib/mutex.h>
+#include <dlib/condition_variable.h>
 
 namespace dmRecord
 {
+    /*
+     * The frames passed to RecordFrame are copied into a bounded queue and converted
+     * and encoded on a worker thread. If the worker falls behind and the queue is full
+     * the frame is dropped and counted instead of stalling the caller.
+     * Frames are time stamped with their index in the recording so the video keeps
+     * real time pace when frames are dropped.
+     */
     struct Recorder
     {
         Recorder(const NewParams* params)
@@ -34,6 +44,7 @@ namespace dmRecord
             m_Height = params->m_Height;
             m_Fps = params->m_Fps;
             m_Filename = strdup(params->m_Filename);
+            m_Result = RESULT_OK;
         }
 
         ~Recorder()
@@ -52,7 +63,21 @@ namespace dmRecord
         FILE*               m_File;
         vpx_codec_ctx_t     m_Codec;
         vpx_image_t         m_VpxImage;
-        uint32_t            m_FrameCount;
+        uint32_t            m_FrameCount;       // Number of encoded frames, written to the file header
+
+        // Frame queue, guarded by m_Mutex
+        dmThread::Thread                    m_Thread;
+        dmMutex::HMutex                     m_Mutex;
+        dmConditionVariable::HConditionVariable m_Condition;
+        uint8_t*                            m_QueueBuffer;
+        uint64_t*                           m_QueuePts;
+        uint32_t                            m_QueueSize;
+        uint32_t                            m_QueueHead;
+        uint32_t                            m_QueueCount;
+        uint64_t                            m_FrameIndex;       // Index of the next frame passed to RecordFrame
+        uint32_t                            m_DroppedFrames;
+        Result                              m_Result;           // First error from the worker thread
+        uint32_t                            m_Running : 1;
     };
 
     static void MemPutLE16(char *mem, unsigned int val)
@@ -109,6 +134,133 @@ namespace dmRecord
         return fwrite(header, 1, sizeof(header), recorder->m_File) == sizeof(header);
     }
 
+    /*
+     * BGRA to YV12 with flipped y
+     * The conversion uses 8-bit fixed point weights so that the inner loops only do integer
+     * arithmetic on independent pixels and can be vectorized by the compiler. The result is
+     * identical to the previous floating point version since all sums are rounded down.
+     * Links:
+     * http://groups.google.com/a/chromium.org/group/chromium-reviews/browse_thread/thread/720aafe35a78942a?pli=1
+     */
+    static void RGBAToYV12FlipY(const uint8_t* __restrict rgba, uint32_t width, uint32_t height, uint8_t* __restrict y_plane, uint8_t* __restrict u_plane, uint8_t* __restrict v_plane)
+    {
+        for (uint32_t iy = 0; iy < height; ++iy)
+        {
+            const uint8_t* src = rgba + iy * width * 4;
+            uint8_t* y_plane_row = y_plane + (height - 1 - iy) * width;
+            for (uint32_t ix = 0; ix < width; ++ix)
+            {
+                int32_t B = src[ix*4+0];
+                int32_t G = src[ix*4+1];
+                int32_t R = src[ix*4+2];
+                y_plane_row[ix] = (uint8_t) (((R*66 + G*129 + B*25 + 128) >> 8) + 16);
+            }
+        }
+
+        uint32_t half_height = height >> 1;
+        uint32_t half_width = width >> 1;
+
+        for (uint32_t iy = 0; iy < half_height; iy++)
+        {
+            // Chroma is sampled from the top left pixel of each 2x2 block
+            const uint8_t* src = rgba + (iy*2) * width * 4;
+            uint8_t* v_plane_row = v_plane + (half_height - 1 - iy) * half_width;
+            uint8_t* u_plane_row = u_plane + (half_height - 1 - iy) * half_width;
+
+            for (uint32_t ix = 0; ix < half_width; ix++)
+            {
+                int32_t B = src[ix*8+0];
+                int32_t G = src[ix*8+1];
+                int32_t R = src[ix*8+2];
+
+                // The sums are offset by 128 << 8 to be positive before the shift
+                u_plane_row[ix] = (uint8_t) ((R*-38 + G*-74 + B*112 + 128 + (128 << 8)) >> 8);
+                v_plane_row[ix] = (uint8_t) ((R*112 + G*-94 + B*-18 + 128 + (128 << 8)) >> 8);
+            }
+        }
+    }
+
+    static Result EncodeFrame(HRecorder recorder, const uint8_t* frame, uint64_t pts)
+    {
+        vpx_codec_iter_t iter = NULL;
+        const vpx_codec_cx_pkt_t *pkt;
+        vpx_codec_err_t res;
+        int flags = 0;
+
+        RGBAToYV12FlipY(frame, recorder->m_Width, recorder->m_Height, recorder->m_VpxImage.planes[0], recorder->m_VpxImage.planes[1], recorder->m_VpxImage.planes[2]);
+        res = vpx_codec_encode(&recorder->m_Codec, &recorder->m_VpxImage, pts, 1, flags, VPX_DL_REALTIME);
+        if (res)
+        {
+            dmLogError("Failed to encode frame (%s)", vpx_codec_err_to_string(res))
+            return RESULT_UNKNOWN_ERROR;
+        }
+
+        while ((pkt = vpx_codec_get_cx_data(&recorder->m_Codec, &iter)))
+        {
+            switch (pkt->kind)
+            {
+            case VPX_CODEC_CX_FRAME_PKT:
+                if (!WriteIvfFrameHeader(recorder, pkt))
+                {
+                    return RESULT_IO_ERROR;
+                }
+
+                if (fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
+                        recorder->m_File) != pkt->data.frame.sz)
+                {
+                    return RESULT_IO_ERROR;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        recorder->m_FrameCount++;
+
+        return RESULT_OK;
+    }
+
+    static uint32_t GetFrameSize(HRecorder recorder)
+    {
+        return recorder->m_Width * recorder->m_Height * 4;
+    }
+
+    static void EncodeThread(void* arg)
+    {
+        HRecorder recorder = (HRecorder) arg;
+        uint32_t frame_size = GetFrameSize(recorder);
+
+        dmMutex::Lock(recorder->m_Mutex);
+        while (true)
+        {
+            while (recorder->m_QueueCount == 0 && recorder->m_Running)
+            {
+                dmConditionVariable::Wait(recorder->m_Condition, recorder->m_Mutex);
+            }
+            if (recorder->m_QueueCount == 0)
+            {
+                break;
+            }
+
+            // The slot at the head is not touched by RecordFrame until it has been released
+            uint32_t slot = recorder->m_QueueHead;
+            uint64_t pts = recorder->m_QueuePts[slot];
+            bool failed = recorder->m_Result != RESULT_OK;
+            dmMutex::Unlock(recorder->m_Mutex);
+
+            Result r = failed ? RESULT_OK : EncodeFrame(recorder, recorder->m_QueueBuffer + slot * frame_size, pts);
+
+            dmMutex::Lock(recorder->m_Mutex);
+            if (r != RESULT_OK)
+            {
+                recorder->m_Result = r;
+            }
+            recorder->m_QueueHead = (slot + 1) % recorder->m_QueueSize;
+            recorder->m_QueueCount--;
+        }
+        dmMutex::Unlock(recorder->m_Mutex);
+    }
+
     Result New(const NewParams* params, HRecorder* recorder)
     {
         *recorder = 0;
@@ -178,68 +330,34 @@ namespace dmRecord
         r->m_Codec = codec;
         r->m_VpxImage = vpx_image;
         r->m_File = f;
+
+        r->m_QueueSize = params->m_QueueSize > 0 ? params->m_QueueSize : 1;
+        r->m_QueueBuffer = (uint8_t*) malloc((size_t) r->m_QueueSize * GetFrameSize(r));
+        r->m_QueuePts = (uint64_t*) malloc(r->m_QueueSize * sizeof(uint64_t));
+        r->m_Mutex = dmMutex::New();
+        r->m_Condition = dmConditionVariable::New();
+        r->m_Running = 1;
+        r->m_Thread = dmThread::New(EncodeThread, 0x80000, r, "record");
+
         *recorder = r;
         return RESULT_OK;
     }
 
-    /*
-     * TODO: This code needs to be optimized.
-     * RGBA to YV12 with flipped y
-     * Links:
-     * http://groups.google.com/a/chromium.org/group/chromium-reviews/browse_thread/thread/720aafe35a78942a?pli=1
-     */
-    static void RGBAToYV12FlipY(const uint8_t *rgba, uint32_t width, uint32_t height, void *y_plane, void *u_plane, void *v_plane)
+    Result Delete(HRecorder recorder)
     {
-        for (uint32_t iy = 0; iy < height; ++iy)
-        {
-            char* y_plane_row = (char*) y_plane;
-            y_plane_row += (height - 1 - iy) * width;
-            for (uint32_t ix = 0; ix < width; ++ix)
-            {
-                int i = (iy * width + ix) * 4;
-                uint8_t B = rgba[i+0];
-                uint8_t G = rgba[i+1];
-                uint8_t R = rgba[i+2];
-                float y = (float)( R*66 + G*129 + B*25 + 128 ) / 256 + 16;
-                *y_plane_row = (char) y;
-                ++y_plane_row;
-            }
-        }
-
-        uint32_t half_height = height >> 1;
-        uint32_t half_width = width >> 1;
+        // Let the worker encode the queued frames before it exits
+        dmMutex::Lock(recorder->m_Mutex);
+        recorder->m_Running = 0;
+        dmConditionVariable::Signal(recorder->m_Condition);
+        dmMutex::Unlock(recorder->m_Mutex);
+        dmThread::Join(recorder->m_Thread);
 
-        for (uint32_t iy = 0; iy < half_height; iy++)
-        {
-            uint32_t base_src = (iy*2) * width * 4;
-
-            uint8_t *v_plane_row = (uint8_t*)v_plane;
-            uint8_t *u_plane_row = (uint8_t*)u_plane;
-            v_plane_row += (half_height - 1 - iy) * half_width;
-            u_plane_row += (half_height - 1 - iy) * half_width;
-
-            for (uint32_t xPixel = 0; xPixel < half_width; xPixel++ )
-            {
-                uint8_t B = rgba[base_src+0];
-                uint8_t G = rgba[base_src+1];
-                uint8_t R = rgba[base_src+2];
+        dmConditionVariable::Delete(recorder->m_Condition);
+        dmMutex::Delete(recorder->m_Mutex);
+        free(recorder->m_QueueBuffer);
+        free(recorder->m_QueuePts);
 
-                float u = (float)( R*-38 + G*-74 + B*112 + 128 ) / 256 + 128;
-                float v = (float)( R*112 + G*-94 + B*-18 + 128 ) / 256 + 128;
-
-                *v_plane_row = (uint8_t) v;
-                *u_plane_row = (uint8_t) u;
-                ++u_plane_row;
-                ++v_plane_row;
-
-                base_src += 8;
-            }
-        }
-    }
-
-    Result Delete(HRecorder recorder)
-    {
-        Result result = RESULT_OK;
+        Result result = recorder->m_Result;
 
         fseek(recorder->m_File, 0, SEEK_SET);
         if (!WriteIvfFileHeader(recorder))
@@ -257,41 +375,44 @@ namespace dmRecord
     Result RecordFrame(HRecorder recorder, const void* frame_buffer,
             uint32_t frame_buffer_size, BufferFormat format)
     {
-        vpx_codec_iter_t iter = NULL;
-        const vpx_codec_cx_pkt_t *pkt;
-        vpx_codec_err_t res;
-        int flags = 0;
-
-        RGBAToYV12FlipY((const uint8_t*) frame_buffer, recorder->m_Width, recorder->m_Height, recorder->m_VpxImage.planes[0], recorder->m_VpxImage.planes[1], recorder->m_VpxImage.planes[2]);
-        res = vpx_codec_encode(&recorder->m_Codec, &recorder->m_VpxImage, recorder->m_FrameCount, 1, flags, VPX_DL_REALTIME);
-        if (res)
+        uint32_t frame_size = GetFrameSize(recorder);
+        if (frame_buffer_size < frame_size)
         {
-            dmLogError("Failed to encode frame (%s)", vpx_codec_err_to_string(res))
-            return RESULT_UNKNOWN_ERROR;
+            return RESULT_INVAL_ERROR;
         }
 
-        while ((pkt = vpx_codec_get_cx_data(&recorder->m_Codec, &iter)))
+        dmMutex::Lock(recorder->m_Mutex);
+        Result result = recorder->m_Result;
+        uint64_t pts = recorder->m_FrameIndex++;
+        if (result != RESULT_OK || recorder->m_QueueCount == recorder->m_QueueSize)
         {
-            switch (pkt->kind)
+            if (result == RESULT_OK)
             {
-            case VPX_CODEC_CX_FRAME_PKT:
-                if (!WriteIvfFrameHeader(recorder, pkt))
-                {
-                    return RESULT_IO_ERROR;
-                }
-
-                if (fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
-                        recorder->m_File) != pkt->data.frame.sz)
-                {
-                    return RESULT_IO_ERROR;
-                }
-                break;
-            default:
-                break;
+                recorder->m_DroppedFrames++;
             }
+            dmMutex::Unlock(recorder->m_Mutex);
+            return result;
         }
-        recorder->m_FrameCount++;
+        uint32_t slot = (recorder->m_QueueHead + recorder->m_QueueCount) % recorder->m_QueueSize;
+        dmMutex::Unlock(recorder->m_Mutex);
+
+        // The worker only reads queued slots, so the copy can be done without holding the lock
+        memcpy(recorder->m_QueueBuffer + slot * frame_size, frame_buffer, frame_size);
+
+        dmMutex::Lock(recorder->m_Mutex);
+        recorder->m_QueuePts[slot] = pts;
+        recorder->m_QueueCount++;
+        dmConditionVariable::Signal(recorder->m_Condition);
+        dmMutex::Unlock(recorder->m_Mutex);
 
         return RESULT_OK;
     }
+
+    uint32_t GetDroppedFrameCount(HRecorder recorder)
+    {
+        dmMutex::Lock(recorder->m_Mutex);
+        uint32_t dropped = recorder->m_DroppedFrames;
+        dmMutex::Unlock(recorder->m_Mutex);
+        return dropped;
+    }
 }
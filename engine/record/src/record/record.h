@@ -58,11 +58,29 @@ namespace dmRecord
         VideoCodec      m_VideoCodec;
         const char*     m_Filename;
         uint32_t        m_Fps;
+        /// Max number of frames waiting to be encoded. Frames recorded when the queue is full are dropped
+        uint32_t        m_QueueSize;
     };
 
     Result New(const NewParams* params, HRecorder* recorder);
+
+    /**
+     * Delete the recorder. Encodes the frames still in the queue and finalizes the file.
+     */
     Result Delete(HRecorder recorder);
+
+    /**
+     * Queue a frame for encoding. The frame is copied and encoded on a worker thread.
+     * If the encoder falls behind and the queue is full the frame is dropped and RESULT_OK is returned,
+     * see GetDroppedFrameCount.
+     * Errors from encoding previous frames are returned by subsequent calls.
+     */
     Result RecordFrame(HRecorder recorder, const void* frame_buffer, uint32_t frame_buffer_size, BufferFormat format);
+
+    /**
+     * Get the number of frames dropped since the recorder was created because the queue was full
+     */
+    uint32_t GetDroppedFrameCount(HRecorder recorder);
 }
 
 #endif
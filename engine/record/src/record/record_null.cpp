@@ -34,5 +34,10 @@ namespace dmRecord
     {
         return RESULT_RECORD_NOT_SUPPORTED;
     }
+
+    uint32_t GetDroppedFrameCount(HRecorder recorder)
+    {
+        return 0;
+    }
 }
 
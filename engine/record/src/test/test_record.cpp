@@ -12,6 +12,8 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include <string>
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
@@ -119,6 +121,45 @@ TEST(dmRecord, Simple)
     ASSERT_EQ(dmRecord::RESULT_OK, r);
 }
 
+TEST(dmRecord, DroppedFrames)
+{
+    dmRecord::NewParams params;
+    params.m_Width = 1280;
+    params.m_Height = 720;
+    params.m_Filename = "tmp/dropped.ivf";
+    params.m_QueueSize = 1;
+    dmRecord::HRecorder recorder = 0;
+    dmRecord::Result r = dmRecord::New(&params, &recorder);
+    ASSERT_EQ(dmRecord::RESULT_OK, r);
+
+    const uint32_t frame_count = 64;
+    uint32_t buffer_size_bytes = params.m_Width * params.m_Height * sizeof(uint32_t);
+    uint8_t* buffer = new uint8_t[buffer_size_bytes];
+    memset(buffer, 0x80, buffer_size_bytes);
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        r = dmRecord::RecordFrame(recorder, buffer, buffer_size_bytes, dmRecord::BUFFER_FORMAT_BGRA);
+        ASSERT_EQ(dmRecord::RESULT_OK, r);
+    }
+    delete[] buffer;
+
+    // The first frame always fits in the queue, the rest depend on the encoder speed
+    uint32_t dropped = dmRecord::GetDroppedFrameCount(recorder);
+    ASSERT_LT(dropped, frame_count);
+
+    r = dmRecord::Delete(recorder);
+    ASSERT_EQ(dmRecord::RESULT_OK, r);
+
+    // All frames that were not dropped are written to the file
+    uint8_t header[32];
+    FILE* f = fopen(params.m_Filename, "rb");
+    ASSERT_NE((FILE*) 0, f);
+    ASSERT_EQ(sizeof(header), fread(header, 1, sizeof(header), f));
+    fclose(f);
+    uint32_t length = header[24] | (header[25] << 8) | (header[26] << 16) | (header[27] << 24);
+    ASSERT_EQ(frame_count - dropped, length);
+}
+
 int main(int argc, char **argv)
 {
 #if !defined(DM_NO_SYSTEM_FUNCTION)
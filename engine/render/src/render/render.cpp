@@ -96,6 +96,7 @@ namespace dmRender
     RenderScriptContext::RenderScriptContext()
     : m_LuaState(0)
     , m_CommandBufferSize(0)
+    , m_CommandListId(0)
     {
 
     }
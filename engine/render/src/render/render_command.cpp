@@ -52,7 +52,9 @@ namespace dmRender
         m_Operands[3] = op3;
     }
 
-    void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count)
+    // Commands in a retained list are executed every frame the list is drawn, so
+    // any data they point to is owned by the list and must not be freed here.
+    static void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count, bool retained)
     {
         dmGraphics::HContext context = dmRender::GetGraphicsContext(render_context);
 
@@ -108,14 +110,16 @@ namespace dmRender
                 {
                     Vectormath::Aos::Matrix4* matrix = (Vectormath::Aos::Matrix4*)c->m_Operands[0];
                     dmRender::SetViewMatrix(render_context, *matrix);
-                    delete matrix;
+                    if (!retained)
+                        delete matrix;
                     break;
                 }
                 case COMMAND_TYPE_SET_PROJECTION:
                 {
                     Vectormath::Aos::Matrix4* matrix = (Vectormath::Aos::Matrix4*)c->m_Operands[0];
                     dmRender::SetProjectionMatrix(render_context, *matrix);
-                    delete matrix;
+                    if (!retained)
+                        delete matrix;
                     break;
                 }
                 case COMMAND_TYPE_SET_BLEND_FUNC:
@@ -188,6 +192,11 @@ namespace dmRender
                     render_context->m_Material = 0;
                     break;
                 }
+                case COMMAND_TYPE_DRAW_LIST:
+                {
+                    ParseCommands(render_context, (Command*)c->m_Operands[0], c->m_Operands[1], true);
+                    break;
+                }
                 default:
                 {
                     dmLogError("No such render command (%d).", c->m_Type);
@@ -196,4 +205,8 @@ namespace dmRender
         }
     }
 
+    void ParseCommands(dmRender::HRenderContext render_context, Command* commands, uint32_t command_count)
+    {
+        ParseCommands(render_context, commands, command_count, false);
+    }
 }
@@ -44,6 +44,7 @@ namespace dmRender
         COMMAND_TYPE_DRAW_DEBUG2D,
         COMMAND_TYPE_ENABLE_MATERIAL,
         COMMAND_TYPE_DISABLE_MATERIAL,
+        COMMAND_TYPE_DRAW_LIST,
         COMMAND_TYPE_MAX
     };
 
@@ -173,6 +173,8 @@ namespace dmRender
 
         lua_State*                  m_LuaState;
         uint32_t                    m_CommandBufferSize;
+        // Id of the latest recorded command list, see CommandList::m_Id
+        uint32_t                    m_CommandListId;
     };
 
     struct RenderListDispatch
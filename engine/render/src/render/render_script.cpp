@@ -17,6 +17,7 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/math.h>
 #include <dlib/hash.h>
 #include <dlib/message.h>
 #include <dlib/profile.h>
@@ -50,6 +51,7 @@ namespace dmRender
     #define RENDER_SCRIPT "RenderScript"
 
     #define RENDER_SCRIPT_CONSTANTBUFFER "RenderScriptConstantBuffer"
+    #define RENDER_SCRIPT_COMMANDLIST "RenderScriptCommandList"
 
     #define RENDER_SCRIPT_LIB_NAME "render"
     #define RENDER_SCRIPT_FORMAT_NAME "format"
@@ -63,6 +65,7 @@ namespace dmRender
     static uint32_t RENDER_SCRIPT_TYPE_HASH = 0;
     static uint32_t RENDER_SCRIPT_INSTANCE_TYPE_HASH = 0;
     static uint32_t RENDER_SCRIPT_CONSTANTBUFFER_TYPE_HASH = 0;
+    static uint32_t RENDER_SCRIPT_COMMANDLIST_TYPE_HASH = 0;
 
     const char* RENDER_SCRIPT_FUNCTION_NAMES[MAX_RENDER_SCRIPT_FUNCTION_COUNT] =
     {
@@ -325,6 +328,18 @@ namespace dmRender
 
     bool InsertCommand(RenderScriptInstance* i, const Command& command)
     {
+        if (i->m_RecordingList)
+        {
+            // Recorded lists grow on demand but are capped to the frame command buffer size
+            dmArray<Command>& commands = i->m_RecordingList->m_Commands;
+            if (commands.Size() == i->m_CommandBuffer.Capacity())
+                return false;
+            if (commands.Full())
+                commands.OffsetCapacity(dmMath::Min(64u, i->m_CommandBuffer.Capacity() - commands.Size()));
+            commands.Push(command);
+            return true;
+        }
+
         if (i->m_CommandBuffer.Full())
             return false;
         else
@@ -332,6 +347,67 @@ namespace dmRender
         return true;
     }
 
+    static void DeleteCommandList(lua_State* L, CommandList* list)
+    {
+        for (uint32_t i = 0; i < list->m_Commands.Size(); ++i)
+        {
+            Command& c = list->m_Commands[i];
+            if (c.m_Type == COMMAND_TYPE_SET_VIEW || c.m_Type == COMMAND_TYPE_SET_PROJECTION)
+                delete (Vectormath::Aos::Matrix4*)c.m_Operands[0];
+        }
+        for (uint32_t i = 0; i < list->m_ConstantBufferReferences.Size(); ++i)
+        {
+            dmScript::Unref(L, LUA_REGISTRYINDEX, list->m_ConstantBufferReferences[i]);
+        }
+        delete list;
+    }
+
+    // Frees lists deleted from the script, once no pending command can refer to them
+    static void FlushDeletedCommandLists(RenderScriptInstance* i)
+    {
+        lua_State* L = i->m_RenderContext->m_RenderScriptContext.m_LuaState;
+        uint32_t count = 0;
+        for (uint32_t j = 0; j < i->m_CommandListCount; ++j)
+        {
+            CommandList* list = i->m_CommandLists[j];
+            if (list->m_Deleted)
+                DeleteCommandList(L, list);
+            else
+                i->m_CommandLists[count++] = list;
+        }
+        i->m_CommandListCount = count;
+    }
+
+    static CommandList* CheckCommandList(lua_State* L, RenderScriptInstance* i, int index)
+    {
+        uint32_t* id = (uint32_t*)dmScript::CheckUserType(L, index, RENDER_SCRIPT_COMMANDLIST_TYPE_HASH, "Expected a command list (acquired from render.end_list)");
+        for (uint32_t j = 0; j < i->m_CommandListCount; ++j)
+        {
+            CommandList* list = i->m_CommandLists[j];
+            if (list->m_Id == *id && !list->m_Deleted)
+                return list;
+        }
+        luaL_error(L, "The command list has been deleted.");
+        return 0;
+    }
+
+    static int RenderScriptCommandList_tostring(lua_State* L)
+    {
+        lua_pushfstring(L, "CommandList: %d", *(uint32_t*)lua_touserdata(L, 1));
+        return 1;
+    }
+
+    static const luaL_reg RenderScriptCommandList_methods[] =
+    {
+        {0,0}
+    };
+
+    static const luaL_reg RenderScriptCommandList_meta[] =
+    {
+        {"__tostring",  RenderScriptCommandList_tostring},
+        {0, 0}
+    };
+
     /*#
      * @name render.STATE_DEPTH_TEST
      * @variable
@@ -860,6 +936,9 @@ namespace dmRender
             lua_pop(L, 2);
         }
 
+        if (render_target && i->m_RecordingList)
+            return luaL_error(L, "%s.set_render_target can not be recorded in a command list.", RENDER_SCRIPT_LIB_NAME);
+
         if (InsertCommand(i, Command(COMMAND_TYPE_SET_RENDER_TARGET, (uintptr_t)render_target, transient_buffer_types)))
             return 0;
         else
@@ -903,6 +982,8 @@ namespace dmRender
         }
         if (render_target == 0x0)
             return luaL_error(L, "Invalid render target (nil) supplied to %s.enable_render_target.", RENDER_SCRIPT_LIB_NAME);
+        if (i->m_RecordingList)
+            return luaL_error(L, "%s.enable_render_target can not be recorded in a command list.", RENDER_SCRIPT_LIB_NAME);
 
         if (InsertCommand(i, Command(COMMAND_TYPE_SET_RENDER_TARGET, (uintptr_t)render_target, 0)))
             return 0;
@@ -1026,6 +1107,8 @@ namespace dmRender
     {
         RenderScriptInstance* i = RenderScriptInstance_Check(L);
         dmGraphics::HRenderTarget render_target = 0x0;
+        if (i->m_RecordingList)
+            return luaL_error(L, "%s.enable_texture can not be recorded in a command list.", RENDER_SCRIPT_LIB_NAME);
 
         uint32_t unit = luaL_checknumber(L, 1);
         if (lua_islightuserdata(L, 2))
@@ -1321,12 +1404,145 @@ namespace dmRender
             constant_buffer = *tmp;
         }
 
-        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uintptr_t)predicate, (uintptr_t) constant_buffer)))
+        if (!InsertCommand(i, Command(COMMAND_TYPE_DRAW, (uintptr_t)predicate, (uintptr_t) constant_buffer)))
+            return luaL_error(L, "Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
+
+        if (constant_buffer && i->m_RecordingList)
+        {
+            // Keep the constant buffer alive for as long as the list may be drawn
+            dmArray<int>& refs = i->m_RecordingList->m_ConstantBufferReferences;
+            if (refs.Full())
+                refs.OffsetCapacity(8);
+            lua_pushvalue(L, 2);
+            refs.Push(dmScript::Ref(L, LUA_REGISTRYINDEX));
+        }
+        return 0;
+    }
+
+    /*# starts recording a command list
+     * Starts recording a list of render commands. Until [ref:render.end_list] is called,
+     * render functions that issue commands (such as [ref:render.enable_state],
+     * [ref:render.clear], [ref:render.set_view] and [ref:render.draw]) are stored in the
+     * list instead of being executed this frame.
+     *
+     * A recorded list is drawn with [ref:render.draw_list], which executes all its commands
+     * without calling back into Lua. Constant buffers used with [ref:render.draw] while
+     * recording are referenced, not copied, so values set on them later are used the next
+     * time the list is drawn. Everything else, such as matrices passed to
+     * [ref:render.set_view], is captured when recorded.
+     *
+     * Render targets, textures and materials can be deleted or reloaded before the list is
+     * drawn, so [ref:render.set_render_target] with a render target, [ref:render.enable_texture]
+     * and [ref:render.enable_material] raise an error while recording. Call them before
+     * [ref:render.draw_list] instead.
+     *
+     * A list must be started and ended within the same script function.
+     *
+     * @name render.begin_list
+     * @examples
+     *
+     * Record the tile pass once and replay it every frame:
+     *
+     * ```lua
+     * function init(self)
+     *     self.tile_pred = render.predicate({"tile"})
+     *     self.constants = render.constant_buffer()
+     *     render.begin_list()
+     *     render.set_depth_mask(false)
+     *     render.disable_state(render.STATE_DEPTH_TEST)
+     *     render.enable_state(render.STATE_BLEND)
+     *     render.set_blend_func(render.BLEND_SRC_ALPHA, render.BLEND_ONE_MINUS_SRC_ALPHA)
+     *     render.draw(self.tile_pred, self.constants)
+     *     self.tile_list = render.end_list()
+     * end
+     *
+     * function update(self, dt)
+     *     self.constants.tint = vmath.vector4(1, 1, 1, 1)
+     *     render.set_view(self.view)
+     *     render.set_projection(self.projection)
+     *     render.draw_list(self.tile_list)
+     * end
+     * ```
+     */
+    int RenderScript_BeginList(lua_State* L)
+    {
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        if (i->m_RecordingList)
+            return luaL_error(L, "A command list is already being recorded.");
+        if (i->m_CommandListCount == MAX_COMMAND_LIST_COUNT)
+            return luaL_error(L, "Could not create more command lists since the buffer is full (%d).", MAX_COMMAND_LIST_COUNT);
+        i->m_RecordingList = new CommandList();
+        i->m_RecordingList->m_Id = ++i->m_RenderContext->m_RenderScriptContext.m_CommandListId;
+        i->m_RecordingList->m_Deleted = 0;
+        return 0;
+    }
+
+    /*# stops recording a command list
+     * Stops recording the command list started with [ref:render.begin_list]
+     * and returns it. The list stays valid until deleted with [ref:render.delete_list].
+     *
+     * @name render.end_list
+     * @return list [type:command_list] the recorded command list
+     */
+    int RenderScript_EndList(lua_State* L)
+    {
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        CommandList* list = i->m_RecordingList;
+        if (!list)
+            return luaL_error(L, "No command list is being recorded, call render.begin_list() first.");
+        i->m_RecordingList = 0;
+        i->m_CommandLists[i->m_CommandListCount++] = list;
+
+        uint32_t* id = (uint32_t*)lua_newuserdata(L, sizeof(uint32_t));
+        *id = list->m_Id;
+        luaL_getmetatable(L, RENDER_SCRIPT_COMMANDLIST);
+        lua_setmetatable(L, -2);
+        return 1;
+    }
+
+    /*# draws a recorded command list
+     * Executes all commands recorded in the list, in the order they were recorded.
+     * A list can not be drawn while another list is being recorded.
+     *
+     * @name render.draw_list
+     * @param list [type:command_list] command list to draw
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     render.draw_list(self.tile_list)
+     * end
+     * ```
+     */
+    int RenderScript_DrawList(lua_State* L)
+    {
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        CommandList* list = CheckCommandList(L, i, 1);
+        if (i->m_RecordingList)
+            return luaL_error(L, "Command lists can not be drawn while recording a command list.");
+        if (list->m_Commands.Empty())
+            return 0;
+        if (InsertCommand(i, Command(COMMAND_TYPE_DRAW_LIST, (uintptr_t)list->m_Commands.Begin(), list->m_Commands.Size())))
             return 0;
         else
             return luaL_error(L, "Command buffer is full (%d).", i->m_CommandBuffer.Capacity());
     }
 
+    /*# deletes a command list
+     * Deletes a command list recorded with [ref:render.begin_list] and [ref:render.end_list].
+     * If the list has already been drawn this frame, it is released once the frame has been rendered.
+     *
+     * @name render.delete_list
+     * @param list [type:command_list] command list to delete
+     */
+    int RenderScript_DeleteList(lua_State* L)
+    {
+        RenderScriptInstance* i = RenderScriptInstance_Check(L);
+        CommandList* list = CheckCommandList(L, i, 1);
+        list->m_Deleted = 1;
+        return 0;
+    }
+
     /*# draws all 3d debug graphics
      * Draws all 3d debug graphics such as lines drawn with "draw_line" messages and physics visualization.
      * @name render.draw_debug3d
@@ -2258,6 +2474,8 @@ namespace dmRender
         RenderScriptInstance* i = RenderScriptInstance_Check(L);
         if (!lua_isnil(L, 1))
         {
+            if (i->m_RecordingList)
+                return luaL_error(L, "%s.enable_material can not be recorded in a command list.", RENDER_SCRIPT_LIB_NAME);
             dmhash_t material_id = dmScript::CheckHashOrString(L, 1);
             dmRender::HMaterial* mat = i->m_Materials.Get(material_id);
             if (mat == 0x0)
@@ -2344,6 +2562,10 @@ namespace dmRender
         {"set_cull_face",                   RenderScript_SetCullFace},
         {"set_polygon_offset",              RenderScript_SetPolygonOffset},
         {"draw",                            RenderScript_Draw},
+        {"begin_list",                      RenderScript_BeginList},
+        {"end_list",                        RenderScript_EndList},
+        {"draw_list",                       RenderScript_DrawList},
+        {"delete_list",                     RenderScript_DeleteList},
         {"draw_debug3d",                    RenderScript_DrawDebug3d},
         {"draw_debug2d",                    RenderScript_DrawDebug2d},
         {"get_width",                       RenderScript_GetWidth},
@@ -2373,6 +2595,8 @@ namespace dmRender
 
         RENDER_SCRIPT_CONSTANTBUFFER_TYPE_HASH = dmScript::RegisterUserType(L, RENDER_SCRIPT_CONSTANTBUFFER, RenderScriptConstantBuffer_methods, RenderScriptConstantBuffer_meta);
 
+        RENDER_SCRIPT_COMMANDLIST_TYPE_HASH = dmScript::RegisterUserType(L, RENDER_SCRIPT_COMMANDLIST, RenderScriptCommandList_methods, RenderScriptCommandList_meta);
+
         luaL_register(L, RENDER_SCRIPT_LIB_NAME, Render_methods);
 
 #define REGISTER_STATE_CONSTANT(name)\
@@ -2703,6 +2927,9 @@ bail:
         for (uint32_t i = 0; i < render_script_instance->m_PredicateCount; ++i) {
             delete render_script_instance->m_Predicates[i];
         }
+        for (uint32_t i = 0; i < render_script_instance->m_CommandListCount; ++i) {
+            DeleteCommandList(L, render_script_instance->m_CommandLists[i]);
+        }
         render_script_instance->~RenderScriptInstance();
         ResetRenderScriptInstance(render_script_instance);
     }
@@ -2798,6 +3025,14 @@ bail:
                 }
             }
 
+            if (script_instance->m_RecordingList)
+            {
+                dmLogError("render.begin_list() was called without a matching render.end_list() in %s.", RENDER_SCRIPT_FUNCTION_NAMES[script_function]);
+                DeleteCommandList(L, script_instance->m_RecordingList);
+                script_instance->m_RecordingList = 0;
+                result = RENDER_SCRIPT_RESULT_FAILED;
+            }
+
             lua_pushnil(L);
             dmScript::SetInstance(L);
 
@@ -2891,6 +3126,7 @@ bail:
 
         if (instance->m_CommandBuffer.Size() > 0)
             ParseCommands(instance->m_RenderContext, &instance->m_CommandBuffer.Front(), instance->m_CommandBuffer.Size());
+        FlushDeletedCommandLists(instance);
         return result;
     }
 
@@ -42,16 +42,33 @@ namespace dmRender
         int             m_InstanceReference;
     };
 
+    /**
+     * Commands recorded between render.begin_list() and render.end_list().
+     * Constant buffers passed to render.draw() while recording stay referenced for the lifetime of the list.
+     * Scripts refer to the list by its id, which is never reused, so a stale handle can't reach another list.
+     */
+    struct CommandList
+    {
+        dmArray<Command>            m_Commands;
+        dmArray<int>                m_ConstantBufferReferences;
+        uint32_t                    m_Id;
+        uint32_t                    m_Deleted : 1;
+    };
+
     static const uint32_t MAX_PREDICATE_COUNT = 64;
+    static const uint32_t MAX_COMMAND_LIST_COUNT = 32;
     struct RenderScriptInstance
     {
         dmArray<Command>            m_CommandBuffer;
         dmHashTable64<HMaterial>    m_Materials;
         Predicate*                  m_Predicates[MAX_PREDICATE_COUNT];
+        CommandList*                m_CommandLists[MAX_COMMAND_LIST_COUNT];
+        CommandList*                m_RecordingList;
         RenderContext*              m_RenderContext;
         HRenderScript               m_RenderScript;
         dmScript::ScriptWorld*      m_ScriptWorld;
         uint32_t                    m_PredicateCount;
+        uint32_t                    m_CommandListCount;
         int                         m_InstanceReference;
         int                         m_RenderScriptDataReference;
         int                         m_ContextTableReference;
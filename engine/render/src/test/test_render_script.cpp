@@ -809,6 +809,203 @@ TEST_F(dmRenderScriptTest, TestLuaDraw_NoPredicate)
     dmRender::DeleteRenderScript(m_Context, render_script);
 }
 
+TEST_F(dmRenderScriptTest, TestLuaCommandList)
+{
+    const char* script =
+    "function init(self)\n"
+    "    self.test_pred = render.predicate({\"one\"})\n"
+    "    self.constants = render.constant_buffer()\n"
+    "    render.begin_list()\n"
+    "    render.set_viewport(1, 2, 3, 4)\n"
+    "    render.set_view(vmath.matrix4_translation(vmath.vector3(1, 2, 3)))\n"
+    "    render.draw(self.test_pred, self.constants)\n"
+    "    self.list = render.end_list()\n"
+    "    self.frame = 0\n"
+    "end\n"
+    "function update(self)\n"
+    "    self.frame = self.frame + 1\n"
+    "    self.constants.tint = vmath.vector4(self.frame, 0, 0, 0)\n"
+    "    render.draw_list(self.list)\n"
+    "    if self.frame == 2 then\n"
+    "        render.delete_list(self.list)\n"
+    "    end\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+
+    // Recorded commands are stored in the list, not in the frame command buffer
+    dmArray<dmRender::Command>& commands = render_script_instance->m_CommandBuffer;
+    ASSERT_EQ(0u, commands.Size());
+    ASSERT_EQ(1u, render_script_instance->m_CommandListCount);
+    ASSERT_EQ(3u, render_script_instance->m_CommandLists[0]->m_Commands.Size());
+    ASSERT_EQ(1u, render_script_instance->m_CommandLists[0]->m_ConstantBufferReferences.Size());
+
+    for (uint32_t frame = 0; frame < 2; ++frame)
+    {
+        m_Context->m_View = Matrix4::identity();
+        ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+        ASSERT_EQ(1u, commands.Size());
+
+        dmRender::Command* command = &commands[0];
+        ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW_LIST, command->m_Type);
+        ASSERT_EQ(3u, command->m_Operands[1]);
+        dmRender::Command* list_commands = (dmRender::Command*)command->m_Operands[0];
+        ASSERT_EQ(dmRender::COMMAND_TYPE_SET_VIEWPORT, list_commands[0].m_Type);
+        ASSERT_EQ(dmRender::COMMAND_TYPE_SET_VIEW, list_commands[1].m_Type);
+        ASSERT_EQ(dmRender::COMMAND_TYPE_DRAW, list_commands[2].m_Type);
+        ASSERT_NE((void*)0, (void*)list_commands[2].m_Operands[1]);
+
+        // The recorded view matrix is applied again every frame it is drawn
+        Vector3 translation = m_Context->m_View.getTranslation();
+        ASSERT_EQ(1.0f, translation.getX());
+        ASSERT_EQ(2.0f, translation.getY());
+        ASSERT_EQ(3.0f, translation.getZ());
+
+        // The replayed draw uses the constant as set in this frame
+        Vector4 tint;
+        ASSERT_TRUE(dmRender::GetNamedConstant((dmRender::HNamedConstantBuffer)list_commands[2].m_Operands[1], "tint", tint));
+        ASSERT_EQ((float)(frame + 1), tint.getX());
+    }
+
+    // The deleted list is released after the frame it was drawn in
+    ASSERT_EQ(0u, render_script_instance->m_CommandListCount);
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
+TEST_F(dmRenderScriptTest, TestLuaCommandList_Unbalanced)
+{
+    const char* script_no_end =
+    "function init(self)\n"
+    "    render.begin_list()\n"
+    "    render.set_viewport(1, 2, 3, 4)\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script_no_end));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::InitRenderScriptInstance(render_script_instance));
+    ASSERT_EQ((void*)0, (void*)render_script_instance->m_RecordingList);
+    ASSERT_EQ(0u, render_script_instance->m_CommandListCount);
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+
+    const char* script_no_begin =
+    "function init(self)\n"
+    "    render.end_list()\n"
+    "end\n";
+    render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script_no_begin));
+    render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::InitRenderScriptInstance(render_script_instance));
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+
+    const char* script_nested =
+    "function init(self)\n"
+    "    render.begin_list()\n"
+    "    local list = render.end_list()\n"
+    "    render.begin_list()\n"
+    "    render.draw_list(list)\n"
+    "end\n";
+    render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script_nested));
+    render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::InitRenderScriptInstance(render_script_instance));
+    ASSERT_EQ((void*)0, (void*)render_script_instance->m_RecordingList);
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
+TEST_F(dmRenderScriptTest, TestLuaCommandList_InvalidHandle)
+{
+    const char* script_deleted =
+    "function init(self)\n"
+    "    render.begin_list()\n"
+    "    self.list = render.end_list()\n"
+    "    render.delete_list(self.list)\n"
+    "end\n"
+    "function update(self)\n"
+    "    render.begin_list()\n"
+    "    local list = render.end_list()\n"
+    "    render.draw_list(self.list)\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script_deleted));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+    // The new list may be allocated where the deleted one was, the old handle must still be rejected
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ(0u, render_script_instance->m_CommandBuffer.Size());
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+
+    const char* script_not_a_list =
+    "function init(self)\n"
+    "    render.draw_list(render.constant_buffer())\n"
+    "end\n";
+    render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script_not_a_list));
+    render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::InitRenderScriptInstance(render_script_instance));
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
+TEST_F(dmRenderScriptTest, TestLuaCommandList_Resources)
+{
+    // Render targets, textures and materials may be gone when a list is drawn, so they can't be recorded
+    const char* script =
+    "function init(self)\n"
+    "    render.enable_material(\"test_material\")\n"
+    "    render.begin_list()\n"
+    "    render.set_render_target()\n"
+    "    render.disable_texture(0)\n"
+    "    render.disable_material()\n"
+    "    self.list = render.end_list()\n"
+    "end\n"
+    "function update(self)\n"
+    "    render.begin_list()\n"
+    "    render.enable_material(\"test_material\")\n"
+    "end\n";
+    dmRender::HRenderScript render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    dmRender::HRenderScriptInstance render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    dmRender::HMaterial material = dmRender::NewMaterial(m_Context, m_VertexProgram, m_FragmentProgram);
+    dmRender::AddRenderScriptInstanceMaterial(render_script_instance, "test_material", material);
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_OK, dmRender::InitRenderScriptInstance(render_script_instance));
+    ASSERT_EQ(1u, render_script_instance->m_CommandListCount);
+    ASSERT_EQ(3u, render_script_instance->m_CommandLists[0]->m_Commands.Size());
+
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ((void*)0, (void*)render_script_instance->m_RecordingList);
+    ASSERT_EQ(1u, render_script_instance->m_CommandListCount);
+
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+    dmRender::DeleteMaterial(m_Context, material);
+
+    script =
+    "function init(self)\n"
+    "    local params_color = {\n"
+    "        format = render.FORMAT_RGBA,\n"
+    "        width = 1,\n"
+    "        height = 1\n"
+    "    }\n"
+    "    self.rt = render.render_target(\"rt\", {[render.BUFFER_COLOR_BIT] = params_color})\n"
+    "    render.begin_list()\n"
+    "    render.enable_texture(0, self.rt, render.BUFFER_COLOR_BIT)\n"
+    "end\n"
+    "function update(self)\n"
+    "    render.begin_list()\n"
+    "    render.set_render_target(self.rt)\n"
+    "end\n";
+    render_script = dmRender::NewRenderScript(m_Context, LuaSourceFromString(script));
+    render_script_instance = dmRender::NewRenderScriptInstance(m_Context, render_script);
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::InitRenderScriptInstance(render_script_instance));
+    ASSERT_EQ(dmRender::RENDER_SCRIPT_RESULT_FAILED, dmRender::UpdateRenderScriptInstance(render_script_instance, 0.0f));
+    ASSERT_EQ(0u, render_script_instance->m_CommandListCount);
+    dmRender::DeleteRenderScriptInstance(render_script_instance);
+    dmRender::DeleteRenderScript(m_Context, render_script);
+}
+
 TEST_F(dmRenderScriptTest, TestLuaWindowSize)
 {
     const char* script =
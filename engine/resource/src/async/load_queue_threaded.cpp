@@ -21,10 +21,12 @@
 #include <dlib/mutex.h>
 #include <dlib/time.h>
 #include <dlib/condition_variable.h>
+#include <dlib/math.h>
 
 namespace dmLoadQueue
 {
-    // Implementation of dmLoadQueue with a thread that loads items in the order they are supplied,
+    // Implementation of dmLoadQueue with threads that start loading items in the order they are supplied.
+    // There is one thread per concurrent load the factory supports, see dmResource::GetMaxConcurrentLoads()
 
     // Default to small buffers since a lot of what is loaded are just small objects anyway.
     // That way we can have more in flight, but throttle when max pending data grows too large anyway
@@ -34,6 +36,7 @@ namespace dmLoadQueue
     // This sets the bandwidth of the loader.
     const uint64_t MAX_PENDING_DATA = 4 * 1024 * 1024;
     const uint32_t QUEUE_SLOTS      = 16;
+    const uint32_t MAX_LOAD_THREADS = 8;
 
     struct Request
     {
@@ -49,7 +52,10 @@ namespace dmLoadQueue
         dmResource::HFactory m_Factory;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_WakeupCond;
-        dmThread::Thread m_Thread;
+        // Preload functions are not required to be thread safe, so they are called one at a time
+        dmMutex::HMutex m_PreloadMutex;
+        dmThread::Thread m_Threads[MAX_LOAD_THREADS];
+        uint32_t m_ThreadCount;
         Request m_Request[QUEUE_SLOTS];
         uint32_t m_Front, m_Back, m_Loaded;
         uint64_t m_BytesWaiting;
@@ -57,9 +63,10 @@ namespace dmLoadQueue
 
         // Circular queue with indexing as follow (exclusive end)
         //
-        //          m_Back           m_Loaded   m_Front
-        // [N/A]   [loaded] [loaded] [to-load]  [N/A]
+        //          m_Back                      m_Loaded   m_Front
+        // [N/A]   [loaded] [loading] [loaded] [to-load]  [N/A]
         //
+        // Requests before m_Loaded are loaded or being loaded by one of the threads.
     };
 
     static Request* GetNextRequest(Queue* queue)
@@ -78,7 +85,7 @@ namespace dmLoadQueue
             return 0x0;
         }
 
-        return &queue->m_Request[queue->m_Loaded % QUEUE_SLOTS];
+        return &queue->m_Request[(queue->m_Loaded++) % QUEUE_SLOTS];
     }
 
     static void LoadThread(void* arg)
@@ -94,7 +101,6 @@ namespace dmLoadQueue
                 {
                     // Just finished one (from previous iteratino)
                     queue->m_BytesWaiting += current->m_Buffer.Capacity();
-                    queue->m_Loaded++;
                     current->m_Result = result;
                     current           = 0;
                 }
@@ -106,11 +112,12 @@ namespace dmLoadQueue
                 current = GetNextRequest(queue);
                 if (current == 0x0)
                 {
-                    // Nothing to do, reset any buffers of inactive requests that are not at default capacity
+                    // Nothing to do, reset any buffers of inactive requests that are not at default capacity.
+                    // Requests that still have a name might be loaded into by another thread.
                     for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
                     {
                         Request* r = &queue->m_Request[i];
-                        if (r->m_Buffer.Size() == 0)
+                        if (r->m_Name == 0x0 && r->m_Buffer.Size() == 0)
                         {
                             if (r->m_Buffer.Capacity() > DEFAULT_CAPACITY)
                             {
@@ -143,6 +150,7 @@ namespace dmLoadQueue
                     assert(current->m_Buffer.Size() == size);
                     if (current->m_PreloadInfo.m_Function)
                     {
+                        dmMutex::ScopedLock lk(queue->m_PreloadMutex);
                         dmResource::ResourcePreloadParams params;
                         params.m_Factory       = queue->m_Factory;
                         params.m_Context       = current->m_PreloadInfo.m_Context;
@@ -172,7 +180,12 @@ namespace dmLoadQueue
         q->m_BytesWaiting = 0;
         q->m_Mutex        = dmMutex::New();
         q->m_WakeupCond   = dmConditionVariable::New();
-        q->m_Thread       = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        q->m_PreloadMutex = dmMutex::New();
+        q->m_ThreadCount  = dmMath::Min(dmResource::GetMaxConcurrentLoads(factory), MAX_LOAD_THREADS);
+        for (uint32_t i = 0; i < q->m_ThreadCount; ++i)
+        {
+            q->m_Threads[i] = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        }
 
         return q;
     }
@@ -182,10 +195,14 @@ namespace dmLoadQueue
         {
             dmMutex::ScopedLock lk(queue->m_Mutex);
             queue->m_Shutdown = true;
-            // Wake up the worker so it can exit and allow us to join
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up the workers so they can exit and allow us to join
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        for (uint32_t i = 0; i < queue->m_ThreadCount; ++i)
+        {
+            dmThread::Join(queue->m_Threads[i]);
         }
-        dmThread::Join(queue->m_Thread);
+        dmMutex::Delete(queue->m_PreloadMutex);
         dmConditionVariable::Delete(queue->m_WakeupCond);
         dmMutex::Delete(queue->m_Mutex);
         delete queue;
@@ -204,11 +221,8 @@ namespace dmLoadQueue
         if ((queue->m_Front - queue->m_Back) == QUEUE_SLOTS)
             return 0;
 
-        if (queue->m_Loaded == queue->m_Front)
-        {
-            // The worker is sleeping waiting for request, wake it up
-            dmConditionVariable::Signal(queue->m_WakeupCond);
-        }
+        // Wake up a worker in case they are all sleeping waiting for requests
+        dmConditionVariable::Signal(queue->m_WakeupCond);
 
         Request* req         = &queue->m_Request[(queue->m_Front++) % QUEUE_SLOTS];
         req->m_Name          = name;
@@ -248,8 +262,8 @@ namespace dmLoadQueue
         // the buffer has a non-default capacity, we want to wake up the worker
         if (buffer_capacity != DEFAULT_CAPACITY || (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA))
         {
-            // Wake up thread, we can now fit a new request
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up threads, we can now fit new requests
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
         }
 
         // Clean up picked up requests
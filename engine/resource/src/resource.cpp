@@ -47,6 +47,7 @@
 #include <dlib/sys.h>
 #include <dlib/time.h>
 #include <dlib/mutex.h>
+#include <dlib/condition_variable.h>
 
 #include "resource.h"
 #include "resource_ddf.h"
@@ -76,12 +77,31 @@ const int DEFAULT_BUFFER_SIZE = 1024 * 1024;
 
 const char* MAX_RESOURCES_KEY = "resource.max_resources";
 
+// Max number of resources loaded over http at the same time. Each loader has its own
+// http client and keep-alive connection, see AcquireHttpLoader()
+const uint32_t MAX_HTTP_LOADERS = 4;
+
 struct ResourceReloadedCallbackPair
 {
     ResourceReloadedCallback    m_Callback;
     void*                       m_UserData;
 };
 
+struct HttpLoader
+{
+    dmHttpClient::HClient                        m_Client;
+    LoadBufferType*                              m_Buffer;
+
+    // HTTP related state
+    // Total number bytes loaded in current GET-request
+    int32_t                                      m_ContentLength;
+    uint32_t                                     m_TotalBytesStreamed;
+    // True if the content is transferred compressed, ie Content-Length is the compressed size
+    bool                                         m_ContentEncoded;
+    int                                          m_Status;
+    Result                                       m_FactoryResult;
+};
+
 struct SResourceFactory
 {
     // TODO: Arg... budget. Two hash-maps. Really necessary?
@@ -96,7 +116,7 @@ struct SResourceFactory
     uint32_t                                     m_ResourceTypesCount;
 
     // Guard for anything that touches anything that could be shared
-    // with GetRaw (used for async threaded loading). Liveupdate, HttpClient, m_Buffer
+    // with GetRaw (used for async threaded loading). Liveupdate, m_Buffer
     // m_BuiltinsManifest, m_Manifest
     dmMutex::HMutex                              m_LoadMutex;
 
@@ -108,18 +128,16 @@ struct SResourceFactory
     dmMessage::HSocket                           m_Socket;
 
     dmURI::Parts                                 m_UriParts;
-    dmHttpClient::HClient                        m_HttpClient;
     dmHttpCache::HCache                          m_HttpCache;
-    LoadBufferType*                              m_HttpBuffer;
 
-    dmArray<char>                                m_Buffer;
+    // Only valid when loading over http. The free list is guarded by m_HttpLoaderMutex
+    HttpLoader                                   m_HttpLoaders[MAX_HTTP_LOADERS];
+    uint32_t                                     m_HttpLoaderCount;
+    dmArray<HttpLoader*>                         m_FreeHttpLoaders;
+    dmMutex::HMutex                              m_HttpLoaderMutex;
+    dmConditionVariable::HConditionVariable      m_HttpLoaderCond;
 
-    // HTTP related state
-    // Total number bytes loaded in current GET-request
-    int32_t                                      m_HttpContentLength;
-    uint32_t                                     m_HttpTotalBytesStreamed;
-    int                                          m_HttpStatus;
-    Result                                       m_HttpFactoryResult;
+    dmArray<char>                                m_Buffer;
 
     // Manifest for builtin resources
     Manifest*                                   m_BuiltinsManifest;
@@ -198,45 +216,70 @@ void SetDefaultNewFactoryParams(struct NewFactoryParams* params)
 
 static void HttpHeader(dmHttpClient::HResponse response, void* user_data, int status_code, const char* key, const char* value)
 {
-    SResourceFactory* factory = (SResourceFactory*) user_data;
-    factory->m_HttpStatus = status_code;
+    HttpLoader* loader = (HttpLoader*) user_data;
+    loader->m_Status = status_code;
 
     if (dmStrCaseCmp(key, "Content-Length") == 0)
     {
-        factory->m_HttpContentLength = strtol(value, 0, 10);
-        if (factory->m_HttpContentLength < 0) {
-            dmLogError("Content-Length negative (%d)", factory->m_HttpContentLength);
+        loader->m_ContentLength = strtol(value, 0, 10);
+        if (loader->m_ContentLength < 0) {
+            dmLogError("Content-Length negative (%d)", loader->m_ContentLength);
         } else {
-            if (factory->m_HttpBuffer->Capacity() < (uint32_t)factory->m_HttpContentLength) {
-                factory->m_HttpBuffer->SetCapacity(factory->m_HttpContentLength);
+            if (loader->m_Buffer->Capacity() < (uint32_t)loader->m_ContentLength) {
+                loader->m_Buffer->SetCapacity(loader->m_ContentLength);
             }
-            factory->m_HttpBuffer->SetSize(0);
+            loader->m_Buffer->SetSize(0);
         }
     }
+    else if (dmStrCaseCmp(key, "Content-Encoding") == 0 && dmStrCaseCmp(value, "identity") != 0)
+    {
+        loader->m_ContentEncoded = true;
+    }
 }
 
 static void HttpContent(dmHttpClient::HResponse, void* user_data, int status_code, const void* content_data, uint32_t content_data_size)
 {
-    SResourceFactory* factory = (SResourceFactory*) user_data;
+    HttpLoader* loader = (HttpLoader*) user_data;
     (void) status_code;
 
     if (!content_data && content_data_size)
     {
-        factory->m_HttpBuffer->SetSize(0);
+        loader->m_Buffer->SetSize(0);
         return;
     }
 
     // We must set http-status here. For direct cached result HttpHeader is not called.
-    factory->m_HttpStatus = status_code;
+    loader->m_Status = status_code;
 
-    if (factory->m_HttpBuffer->Remaining() < content_data_size) {
-        uint32_t diff = content_data_size - factory->m_HttpBuffer->Remaining();
+    if (loader->m_Buffer->Remaining() < content_data_size) {
+        uint32_t diff = content_data_size - loader->m_Buffer->Remaining();
         // NOTE: Resizing the the array can be inefficient but sometimes we don't know the actual size, i.e. when "Content-Size" isn't set
-        factory->m_HttpBuffer->OffsetCapacity(diff + 1024 * 1024);
+        loader->m_Buffer->OffsetCapacity(diff + 1024 * 1024);
+    }
+
+    loader->m_Buffer->PushArray((const char*) content_data, content_data_size);
+    loader->m_TotalBytesStreamed += content_data_size;
+}
+
+// Blocks until a loader is available
+static HttpLoader* AcquireHttpLoader(HFactory factory)
+{
+    dmMutex::ScopedLock lk(factory->m_HttpLoaderMutex);
+    while (factory->m_FreeHttpLoaders.Empty())
+    {
+        dmConditionVariable::Wait(factory->m_HttpLoaderCond, factory->m_HttpLoaderMutex);
     }
+    HttpLoader* loader = factory->m_FreeHttpLoaders.Back();
+    factory->m_FreeHttpLoaders.Pop();
+    return loader;
+}
 
-    factory->m_HttpBuffer->PushArray((const char*) content_data, content_data_size);
-    factory->m_HttpTotalBytesStreamed += content_data_size;
+static void ReleaseHttpLoader(HFactory factory, HttpLoader* loader)
+{
+    dmMutex::ScopedLock lk(factory->m_HttpLoaderMutex);
+    loader->m_Buffer = 0;
+    factory->m_FreeHttpLoaders.Push(loader);
+    dmConditionVariable::Signal(factory->m_HttpLoaderCond);
 }
 
 Manifest* GetManifest(HFactory factory)
@@ -631,8 +674,7 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     dmDNS::HChannel dns_channel;
     dmDNS::NewChannel(&dns_channel);
 
-    factory->m_HttpBuffer = 0;
-    factory->m_HttpClient = 0;
+    factory->m_HttpLoaderCount = 0;
     factory->m_HttpCache = 0;
     if (strcmp(factory->m_UriParts.m_Scheme, "http") == 0 || strcmp(factory->m_UriParts.m_Scheme, "https") == 0)
     {
@@ -672,14 +714,38 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
             }
         }
 
-        dmHttpClient::NewParams http_params;
-        http_params.m_HttpHeader = &HttpHeader;
-        http_params.m_HttpContent = &HttpContent;
-        http_params.m_Userdata = factory;
-        http_params.m_HttpCache = factory->m_HttpCache;
-        http_params.m_DNSChannel = dns_channel;
-        factory->m_HttpClient = dmHttpClient::New(&http_params, factory->m_UriParts.m_Hostname, factory->m_UriParts.m_Port, strcmp(factory->m_UriParts.m_Scheme, "https") == 0);
-        if (!factory->m_HttpClient)
+        factory->m_FreeHttpLoaders.SetCapacity(MAX_HTTP_LOADERS);
+        for (uint32_t i = 0; i < MAX_HTTP_LOADERS; ++i)
+        {
+            // The loaders are used from different threads, so they can't share a DNS channel
+            dmDNS::HChannel loader_dns_channel = dns_channel;
+            if (i > 0)
+            {
+                dmDNS::NewChannel(&loader_dns_channel);
+            }
+
+            HttpLoader* loader = &factory->m_HttpLoaders[i];
+            dmHttpClient::NewParams http_params;
+            http_params.m_HttpHeader = &HttpHeader;
+            http_params.m_HttpContent = &HttpContent;
+            http_params.m_Userdata = loader;
+            http_params.m_HttpCache = factory->m_HttpCache;
+            http_params.m_DNSChannel = loader_dns_channel;
+            loader->m_Client = dmHttpClient::New(&http_params, factory->m_UriParts.m_Hostname, factory->m_UriParts.m_Port, strcmp(factory->m_UriParts.m_Scheme, "https") == 0);
+            if (!loader->m_Client)
+            {
+                if (i > 0)
+                {
+                    dmDNS::DeleteChannel(loader_dns_channel);
+                }
+                break;
+            }
+            dmHttpClient::SetOptionInt(loader->m_Client, dmHttpClient::OPTION_ACCEPT_ENCODING, 1);
+            factory->m_FreeHttpLoaders.Push(loader);
+            factory->m_HttpLoaderCount++;
+        }
+
+        if (factory->m_HttpLoaderCount == 0)
         {
             dmLogError("Invalid URI: %s", uri);
             dmMessage::DeleteSocket(socket);
@@ -687,6 +753,8 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
             delete factory;
             return 0;
         }
+        factory->m_HttpLoaderMutex = dmMutex::New();
+        factory->m_HttpLoaderCond = dmConditionVariable::New();
     }
     else if (strcmp(factory->m_UriParts.m_Scheme, "file") == 0)
     {
@@ -844,12 +912,21 @@ void DeleteFactory(HFactory factory)
     {
         dmMessage::DeleteSocket(factory->m_Socket);
     }
-    if (factory->m_HttpClient)
+    for (uint32_t i = 0; i < factory->m_HttpLoaderCount; ++i)
     {
-        dmDNS::HChannel dns_channel = dmHttpClient::GetDNSChannel(factory->m_HttpClient);
-        dmHttpClient::Delete(factory->m_HttpClient);
+        dmHttpClient::HClient client = factory->m_HttpLoaders[i].m_Client;
+        dmDNS::HChannel dns_channel = dmHttpClient::GetDNSChannel(client);
+        dmHttpClient::Delete(client);
         dmDNS::DeleteChannel(dns_channel);
     }
+    if (factory->m_HttpLoaderCond)
+    {
+        dmConditionVariable::Delete(factory->m_HttpLoaderCond);
+    }
+    if (factory->m_HttpLoaderMutex)
+    {
+        dmMutex::Delete(factory->m_HttpLoaderMutex);
+    }
     if (factory->m_HttpCache)
     {
         dmHttpCache::Close(factory->m_HttpCache);
@@ -1066,6 +1143,61 @@ static Result LoadFromManifest(const Manifest* manifest, const char* path, uint3
     return RESULT_IO_ERROR;
 }
 
+// Does not use any state guarded by m_LoadMutex, so it can be called from several threads at once
+static Result LoadOverHttp(HFactory factory, const char* factory_path, uint32_t* resource_size, LoadBufferType* buffer)
+{
+    *resource_size = 0;
+
+    char uri[RESOURCE_PATH_MAX*2];
+    dmURI::Encode(factory_path, uri, sizeof(uri));
+
+    HttpLoader* loader = AcquireHttpLoader(factory);
+    loader->m_Buffer = buffer;
+    loader->m_ContentLength = -1;
+    loader->m_TotalBytesStreamed = 0;
+    loader->m_ContentEncoded = false;
+    loader->m_FactoryResult = RESULT_OK;
+    loader->m_Status = -1;
+
+    dmHttpClient::Result http_result = dmHttpClient::Get(loader->m_Client, uri);
+
+    int status = loader->m_Status;
+    int32_t content_length = loader->m_ContentLength;
+    uint32_t total_bytes_streamed = loader->m_TotalBytesStreamed;
+    bool content_encoded = loader->m_ContentEncoded;
+    Result factory_result = loader->m_FactoryResult;
+    ReleaseHttpLoader(factory, loader);
+
+    if (http_result != dmHttpClient::RESULT_OK)
+    {
+        if (status == 404)
+        {
+            return RESULT_RESOURCE_NOT_FOUND;
+        }
+        else
+        {
+            // 304 (NOT MODIFIED) is OK. 304 is returned when the resource is loaded from cache, ie ETag or similar match
+            if (http_result == dmHttpClient::RESULT_NOT_200_OK && status != 304)
+            {
+                dmLogWarning("Unexpected http status code: %d", status);
+                return RESULT_IO_ERROR;
+            }
+        }
+    }
+
+    if (factory_result != RESULT_OK)
+        return factory_result;
+
+    // Only check content-length if status != 304 (NOT MODIFIED) and the content wasn't transferred compressed
+    if (status != 304 && !content_encoded && content_length != -1 && content_length != (int32_t)total_bytes_streamed)
+    {
+        dmLogError("Expected content length differs from actually streamed for resource %s (%d != %d)", factory_path, content_length, total_bytes_streamed);
+    }
+
+    *resource_size = total_bytes_streamed;
+    return RESULT_OK;
+}
+
 // Assumes m_LoadMutex is already held
 static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
 {
@@ -1081,48 +1213,9 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
     char factory_path[RESOURCE_PATH_MAX];
     GetCanonicalPathFromBase(factory->m_UriParts.m_Path, path, factory_path);
     // NOTE: No else if here. Fall through
-    if (factory->m_HttpClient)
+    if (factory->m_HttpLoaderCount > 0)
     {
-        // Load over HTTP
-        *resource_size = 0;
-        factory->m_HttpBuffer = buffer;
-        factory->m_HttpContentLength = -1;
-        factory->m_HttpTotalBytesStreamed = 0;
-        factory->m_HttpFactoryResult = RESULT_OK;
-        factory->m_HttpStatus = -1;
-
-        char uri[RESOURCE_PATH_MAX*2];
-        dmURI::Encode(factory_path, uri, sizeof(uri));
-
-        dmHttpClient::Result http_result = dmHttpClient::Get(factory->m_HttpClient, uri);
-        if (http_result != dmHttpClient::RESULT_OK)
-        {
-            if (factory->m_HttpStatus == 404)
-            {
-                return RESULT_RESOURCE_NOT_FOUND;
-            }
-            else
-            {
-                // 304 (NOT MODIFIED) is OK. 304 is returned when the resource is loaded from cache, ie ETag or similar match
-                if (http_result == dmHttpClient::RESULT_NOT_200_OK && factory->m_HttpStatus != 304)
-                {
-                    dmLogWarning("Unexpected http status code: %d", factory->m_HttpStatus);
-                    return RESULT_IO_ERROR;
-                }
-            }
-        }
-
-        if (factory->m_HttpFactoryResult != RESULT_OK)
-            return factory->m_HttpFactoryResult;
-
-        // Only check content-length if status != 304 (NOT MODIFIED)
-        if (factory->m_HttpStatus != 304 && factory->m_HttpContentLength != -1 && factory->m_HttpContentLength != (int32_t)factory->m_HttpTotalBytesStreamed)
-        {
-            dmLogError("Expected content length differs from actually streamed for resource %s (%d != %d)", factory_path, factory->m_HttpContentLength, factory->m_HttpTotalBytesStreamed);
-        }
-
-        *resource_size = factory->m_HttpTotalBytesStreamed;
-        return RESULT_OK;
+        return LoadOverHttp(factory, factory_path, resource_size, buffer);
     }
     else if (factory->m_Manifest)
     {
@@ -1163,9 +1256,33 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
 // Takes the lock.
 Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
 {
-    // Called from async queue so we wrap around a lock
-    dmMutex::ScopedLock lk(factory->m_LoadMutex);
-    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer);
+    if (factory->m_HttpLoaderCount == 0)
+    {
+        // Called from async queue so we wrap around a lock
+        dmMutex::ScopedLock lk(factory->m_LoadMutex);
+        return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer);
+    }
+
+    // Only the builtins lookup needs the lock when loading over http. The request itself is made
+    // without holding it, so that the load threads can have several requests in flight.
+    {
+        DM_PROFILE(Resource, "LoadResource");
+        dmMutex::ScopedLock lk(factory->m_LoadMutex);
+        if (factory->m_BuiltinsManifest && LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer) == RESULT_OK)
+        {
+            return RESULT_OK;
+        }
+    }
+
+    DM_PROFILE(Resource, "LoadResourceHttp");
+    char factory_path[RESOURCE_PATH_MAX];
+    GetCanonicalPathFromBase(factory->m_UriParts.m_Path, path, factory_path);
+    return LoadOverHttp(factory, factory_path, resource_size, buffer);
+}
+
+uint32_t GetMaxConcurrentLoads(HFactory factory)
+{
+    return factory->m_HttpLoaderCount > 0 ? factory->m_HttpLoaderCount : 1;
 }
 
 // Assumes m_LoadMutex is already held
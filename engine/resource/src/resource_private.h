@@ -56,6 +56,8 @@ namespace dmResource
     Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size);
     // load with own buffer
     Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer);
+    // max number of DoLoadResource calls that make progress at the same time, larger than one when loading over http
+    uint32_t GetMaxConcurrentLoads(HFactory factory);
 
     Result InsertResource(HFactory factory, const char* path, uint64_t canonical_path_hash, SResourceDescriptor* descriptor);
     uint32_t GetCanonicalPath(const char* relative_dir, char* buf);
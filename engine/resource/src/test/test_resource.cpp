@@ -14,15 +14,18 @@
 
 #include <dlib/socket.h>
 #include <dlib/http_client.h>
+#include <dlib/http_server.h>
 #include <dlib/hash.h>
 #include <dlib/dstrings.h>
 #include <dlib/time.h>
 #include <dlib/message.h>
 #include <dlib/thread.h>
+#include <dlib/mutex.h>
 #include <ddf/ddf.h>
 #include "resource_ddf.h"
 #include "../resource.h"
 #include "../resource_private.h"
+#include "../async/load_queue.h"
 #include "test/test_resource_ddf.h"
 
 #define JC_TEST_IMPLEMENTATION
@@ -936,6 +939,308 @@ TEST(dmResource, Builtins)
     dmResource::DeleteFactory(factory);
 }
 
+// A local http server that only answers requests while it is open. Requests that are in flight when
+// it is opened are answered in the same Update() pass, so the pass a request was served in tells how
+// many requests the client side had in flight at once.
+struct GatedHttpServer
+{
+    struct ServedRequest
+    {
+        char     m_Resource[64];
+        uint32_t m_Pass;
+    };
+
+    dmHttpServer::HServer      m_Server;
+    dmThread::Thread           m_Thread;
+    dmMutex::HMutex            m_Mutex;
+    std::vector<ServedRequest> m_Served;
+    uint32_t                   m_Pass;
+    uint16_t                   m_Port;
+    volatile bool              m_Open;
+    volatile bool              m_Quit;
+};
+
+static const uint32_t GATED_CONTENT_SIZE = 3000;
+
+static void GatedHttpContent(const char* resource, char* content)
+{
+    uint32_t length = strlen(resource);
+    for (uint32_t i = 0; i < GATED_CONTENT_SIZE; ++i)
+        content[i] = resource[i % length];
+}
+
+static void GatedHttpResponse(void* user_data, const dmHttpServer::Request* request)
+{
+    GatedHttpServer* server = (GatedHttpServer*) user_data;
+    {
+        dmMutex::ScopedLock lk(server->m_Mutex);
+        GatedHttpServer::ServedRequest served;
+        dmStrlCpy(served.m_Resource, request->m_Resource, sizeof(served.m_Resource));
+        served.m_Pass = server->m_Pass;
+        server->m_Served.push_back(served);
+    }
+
+    char content[GATED_CONTENT_SIZE];
+    GatedHttpContent(request->m_Resource, content);
+    dmHttpServer::Send(request, content, sizeof(content));
+}
+
+static void GatedHttpServerThread(void* arg)
+{
+    GatedHttpServer* server = (GatedHttpServer*) arg;
+    while (!server->m_Quit)
+    {
+        if (server->m_Open)
+        {
+            {
+                dmMutex::ScopedLock lk(server->m_Mutex);
+                server->m_Pass++;
+            }
+            dmHttpServer::Update(server->m_Server);
+        }
+        dmTime::Sleep(10 * 1000);
+    }
+}
+
+struct HttpLoad
+{
+    dmResource::HFactory       m_Factory;
+    char                       m_Path[32];
+    dmResource::LoadBufferType m_Buffer;
+    uint32_t                   m_Size;
+    dmResource::Result         m_Result;
+};
+
+static void HttpLoadThread(void* arg)
+{
+    HttpLoad* load = (HttpLoad*) arg;
+    load->m_Result = dmResource::DoLoadResource(load->m_Factory, load->m_Path, load->m_Path, &load->m_Size, &load->m_Buffer);
+}
+
+class HttpLoaderTest : public jc_test_base_class
+{
+protected:
+    virtual void SetUp()
+    {
+        m_HttpServer.m_Mutex = dmMutex::New();
+        m_HttpServer.m_Pass = 0;
+        m_HttpServer.m_Open = false;
+        m_HttpServer.m_Quit = false;
+
+        dmHttpServer::NewParams params;
+        params.m_Userdata = &m_HttpServer;
+        params.m_HttpResponse = GatedHttpResponse;
+        dmHttpServer::Result r = dmHttpServer::New(&params, 0, &m_HttpServer.m_Server);
+        ASSERT_EQ(dmHttpServer::RESULT_OK, r);
+
+        dmSocket::Address address;
+        dmHttpServer::GetName(m_HttpServer.m_Server, &address, &m_HttpServer.m_Port);
+        m_HttpServer.m_Thread = dmThread::New(&GatedHttpServerThread, 0x8000, &m_HttpServer, "http_server");
+    }
+
+    virtual void TearDown()
+    {
+        m_HttpServer.m_Quit = true;
+        dmThread::Join(m_HttpServer.m_Thread);
+        dmHttpServer::Delete(m_HttpServer.m_Server);
+        dmMutex::Delete(m_HttpServer.m_Mutex);
+    }
+
+    dmResource::HFactory NewHttpFactory(dmResource::NewFactoryParams* params)
+    {
+        char uri[64];
+        dmSnPrintf(uri, sizeof(uri), "http://127.0.0.1:%d", m_HttpServer.m_Port);
+        return dmResource::NewFactory(params, uri);
+    }
+
+    // Starts one thread per load, each making its own DoLoadResource call. The server is kept closed
+    // long enough for all of them to get their requests sent (but well below the socket timeout of
+    // the http client), then it is opened. The server is closed again once all loads have completed.
+    void LoadInParallel(dmResource::HFactory factory, HttpLoad* loads, uint32_t count)
+    {
+        {
+            dmMutex::ScopedLock lk(m_HttpServer.m_Mutex);
+            m_HttpServer.m_Served.clear();
+        }
+
+        dmThread::Thread threads[8];
+        assert(count <= sizeof(threads) / sizeof(threads[0]));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            loads[i].m_Factory = factory;
+            loads[i].m_Buffer.SetSize(0);
+            loads[i].m_Size = 0;
+            loads[i].m_Result = dmResource::RESULT_PENDING;
+            threads[i] = dmThread::New(&HttpLoadThread, 0x10000, &loads[i], "http_load");
+        }
+
+        dmTime::Sleep(100 * 1000);
+        m_HttpServer.m_Open = true;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmThread::Join(threads[i]);
+        }
+        m_HttpServer.m_Open = false;
+    }
+
+    GatedHttpServer m_HttpServer;
+};
+
+static void NameHttpLoads(HttpLoad* loads, uint32_t count, const char* prefix)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmSnPrintf(loads[i].m_Path, sizeof(loads[i].m_Path), "/%s%d.foo", prefix, i);
+    }
+}
+
+TEST_F(HttpLoaderTest, ParallelLoads)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = 16;
+    dmResource::HFactory factory = NewHttpFactory(&params);
+    ASSERT_NE((void*) 0, factory);
+    ASSERT_EQ(4U, dmResource::GetMaxConcurrentLoads(factory));
+
+    // The server accepts one new connection per pass, so the first loads open the keep-alive connections
+    HttpLoad loads[4];
+    NameHttpLoads(loads, 4, "warmup");
+    LoadInParallel(factory, loads, 4);
+
+    NameHttpLoads(loads, 4, "parallel");
+    LoadInParallel(factory, loads, 4);
+
+    char expected[GATED_CONTENT_SIZE];
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(dmResource::RESULT_OK, loads[i].m_Result);
+        ASSERT_EQ(GATED_CONTENT_SIZE, loads[i].m_Size);
+        ASSERT_EQ(GATED_CONTENT_SIZE, loads[i].m_Buffer.Size());
+        GatedHttpContent(loads[i].m_Path, expected);
+        ASSERT_EQ(0, memcmp(expected, loads[i].m_Buffer.Begin(), GATED_CONTENT_SIZE));
+    }
+
+    // All requests were waiting on the server when it opened, so they were answered in the same pass
+    ASSERT_EQ(4U, m_HttpServer.m_Served.size());
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        ASSERT_EQ(m_HttpServer.m_Served[0].m_Pass, m_HttpServer.m_Served[i].m_Pass);
+    }
+
+    dmResource::DeleteFactory(factory);
+}
+
+TEST_F(HttpLoaderTest, LoadsBlockWhenAllLoadersAreBusy)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = 16;
+    dmResource::HFactory factory = NewHttpFactory(&params);
+    ASSERT_NE((void*) 0, factory);
+
+    HttpLoad loads[5];
+    NameHttpLoads(loads, 4, "warmup");
+    LoadInParallel(factory, loads, 4);
+
+    // Only four of the five loads get a loader, the fifth waits in AcquireHttpLoader until one is released
+    NameHttpLoads(loads, 5, "busy");
+    LoadInParallel(factory, loads, 5);
+
+    char expected[GATED_CONTENT_SIZE];
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        ASSERT_EQ(dmResource::RESULT_OK, loads[i].m_Result);
+        ASSERT_EQ(GATED_CONTENT_SIZE, loads[i].m_Size);
+        GatedHttpContent(loads[i].m_Path, expected);
+        ASSERT_EQ(0, memcmp(expected, loads[i].m_Buffer.Begin(), GATED_CONTENT_SIZE));
+    }
+
+    ASSERT_EQ(5U, m_HttpServer.m_Served.size());
+    uint32_t first_pass = m_HttpServer.m_Served[0].m_Pass;
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        ASSERT_EQ(first_pass, m_HttpServer.m_Served[i].m_Pass);
+    }
+    ASSERT_LT(first_pass, m_HttpServer.m_Served[4].m_Pass);
+
+    dmResource::DeleteFactory(factory);
+}
+
+TEST_F(HttpLoaderTest, LoadQueueCompletesOutOfOrder)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = 16;
+    params.m_ArchiveIndex.m_Data    = (const void*) RESOURCES_ARCI;
+    params.m_ArchiveIndex.m_Size    = RESOURCES_ARCI_SIZE;
+    params.m_ArchiveData.m_Data     = (const void*) RESOURCES_ARCD;
+    params.m_ArchiveData.m_Size     = RESOURCES_ARCD_SIZE;
+    params.m_ArchiveManifest.m_Data = (const void*) RESOURCES_DMANIFEST;
+    params.m_ArchiveManifest.m_Size = RESOURCES_DMANIFEST_SIZE;
+    dmResource::HFactory factory = NewHttpFactory(&params);
+    ASSERT_NE((void*) 0, factory);
+
+    dmLoadQueue::HQueue queue = dmLoadQueue::CreateQueue(factory);
+
+    // The first request goes to the closed server, the ones after it are builtins and load right away
+    const char* paths[] = { "/http0.foo", "/archive_data/file1.adc", "/archive_data/file3.adc", "/archive_data/file2.adc" };
+    const char* content[] = { 0, "file1_datafile1_datafile1_data", "file3_data", "file2_datafile2_datafile2_data" };
+    const uint32_t count = sizeof(paths) / sizeof(paths[0]);
+
+    dmLoadQueue::PreloadInfo info;
+    memset(&info, 0, sizeof(info));
+    dmLoadQueue::HRequest requests[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        requests[i] = dmLoadQueue::BeginLoad(queue, paths[i], paths[i], &info);
+        ASSERT_NE((dmLoadQueue::HRequest) 0, requests[i]);
+    }
+
+    void* buf;
+    uint32_t size;
+    dmLoadQueue::LoadResult result;
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        dmLoadQueue::Result r;
+        for (uint32_t j = 0; j < 100; ++j)
+        {
+            r = dmLoadQueue::EndLoad(queue, requests[i], &buf, &size, &result);
+            if (r != dmLoadQueue::RESULT_PENDING)
+                break;
+            dmTime::Sleep(1000);
+        }
+        ASSERT_EQ(dmLoadQueue::RESULT_OK, r);
+        ASSERT_EQ(dmResource::RESULT_OK, result.m_LoadResult);
+        ASSERT_EQ(strlen(content[i]), size);
+        ASSERT_EQ(0, memcmp(content[i], buf, size));
+    }
+
+    // The later requests were picked up and completed while the first one is still waiting on the server
+    ASSERT_EQ(dmLoadQueue::RESULT_PENDING, dmLoadQueue::EndLoad(queue, requests[0], &buf, &size, &result));
+
+    m_HttpServer.m_Open = true;
+    dmLoadQueue::Result r;
+    for (uint32_t j = 0; j < 100; ++j)
+    {
+        r = dmLoadQueue::EndLoad(queue, requests[0], &buf, &size, &result);
+        if (r != dmLoadQueue::RESULT_PENDING)
+            break;
+        dmTime::Sleep(10 * 1000);
+    }
+    ASSERT_EQ(dmLoadQueue::RESULT_OK, r);
+    ASSERT_EQ(dmResource::RESULT_OK, result.m_LoadResult);
+    ASSERT_EQ(GATED_CONTENT_SIZE, size);
+    char expected[GATED_CONTENT_SIZE];
+    GatedHttpContent(paths[0], expected);
+    ASSERT_EQ(0, memcmp(expected, buf, size));
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmLoadQueue::FreeLoad(queue, requests[i]);
+    }
+    dmLoadQueue::DeleteQueue(queue);
+    dmResource::DeleteFactory(factory);
+}
+
 struct ReloadData {
     ReloadData(): m_Old(0), m_New(0) {}
     int m_Old;
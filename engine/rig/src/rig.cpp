@@ -13,7 +13,9 @@
 #include "rig.h"
 
 #include <dlib/log.h>
+#include <dlib/math.h>
 #include <dlib/profile.h>
+#include <dlib/thread_pool.h>
 
 namespace dmRig
 {
@@ -39,8 +41,17 @@ namespace dmRig
         }
 
         context->m_Instances.SetCapacity(params.m_MaxRigInstanceCount);
-        context->m_ScratchPoseTransformBuffer.SetCapacity(0);
-        context->m_ScratchPoseMatrixBuffer.SetCapacity(0);
+        context->m_PoseKeyCounter = 0;
+        context->m_UpdateIndex = 0;
+        context->m_OffscreenUpdateInterval = params.m_OffscreenUpdateInterval;
+        context->m_OffscreenPoseTimeout = params.m_OffscreenPoseTimeout;
+        for (uint32_t i = 0; i < MAX_VERTEX_DATA_JOB_COUNT; ++i)
+        {
+            context->m_VertexScratch[i].m_InfluencePoseKey = 0;
+            context->m_VertexScratch[i].m_InfluencePoseIdxToInfluence = 0x0;
+        }
+        // Created on the first batch large enough to be split into several jobs
+        context->m_VertexDataPool = 0;
 
         return dmRig::RESULT_OK;
     }
@@ -48,6 +59,9 @@ namespace dmRig
     void DeleteContext(HRigContext context)
     {
         if (context) {
+            if (context->m_VertexDataPool) {
+                dmThreadPool::Delete(context->m_VertexDataPool);
+            }
             delete context;
         }
     }
@@ -255,7 +269,7 @@ namespace dmRig
         }
     }
 
-    static float GetCursorDuration(RigPlayer* player, const dmRigDDF::RigAnimation* animation)
+    static float GetCursorDuration(const RigPlayer* player, const dmRigDDF::RigAnimation* animation)
     {
         if (!animation)
         {
@@ -511,18 +525,25 @@ namespace dmRig
         child_t.SetRotation( dmVMath::QuatFromAngle(2, childRotation) );
     }
 
-    static void ApplyAnimation(RigPlayer* player, dmArray<dmTransform::Transform>& pose, const dmArray<uint32_t>& track_idx_to_pose, dmArray<IKAnimation>& ik_animation, dmArray<MeshSlotPose>& mesh_slot_pose, bool update_draw_order, dmArray<int32_t>& draw_order, int& slot_changed, float blend_weight)
+    static void GetAnimationSample(const RigPlayer* player, const dmRigDDF::RigAnimation* animation, uint32_t& sample, uint32_t& rounded_sample, float& fraction)
     {
-        const dmRigDDF::RigAnimation* animation = player->m_Animation;
-        if (animation == 0x0)
-            return;
         float duration = GetCursorDuration(player, animation);
         float t = CursorToTime(player->m_Cursor, duration, player->m_Backwards, player->m_Playback == dmRig::PLAYBACK_ONCE_PINGPONG);
 
-        float fraction = t * animation->m_SampleRate;
-        uint32_t sample = (uint32_t)fraction;
-        uint32_t rounded_sample = (uint32_t)(fraction + 0.5f);
+        fraction = t * animation->m_SampleRate;
+        sample = (uint32_t)fraction;
+        rounded_sample = (uint32_t)(fraction + 0.5f);
         fraction -= sample;
+    }
+
+    static void ApplyAnimation(RigPlayer* player, dmArray<dmTransform::Transform>& pose, const dmArray<uint32_t>& track_idx_to_pose, dmArray<IKAnimation>& ik_animation, float blend_weight)
+    {
+        const dmRigDDF::RigAnimation* animation = player->m_Animation;
+        if (animation == 0x0)
+            return;
+        uint32_t sample, rounded_sample;
+        float fraction;
+        GetAnimationSample(player, animation, sample, rounded_sample, fraction);
         // Sample animation tracks
         uint32_t track_count = animation->m_Tracks.m_Count;
         for (uint32_t ti = 0; ti < track_count; ++ti)
@@ -566,8 +587,18 @@ namespace dmRig
                 }
             }
         }
+    }
+
+    static void ApplyMeshAnimation(RigPlayer* player, dmArray<MeshSlotPose>& mesh_slot_pose, bool update_draw_order, dmArray<int32_t>& draw_order, int& slot_changed, float blend_weight)
+    {
+        const dmRigDDF::RigAnimation* animation = player->m_Animation;
+        if (animation == 0x0)
+            return;
+        uint32_t sample, rounded_sample;
+        float fraction;
+        GetAnimationSample(player, animation, sample, rounded_sample, fraction);
 
-        track_count = animation->m_MeshTracks.m_Count;
+        uint32_t track_count = animation->m_MeshTracks.m_Count;
         for (uint32_t ti = 0; ti < track_count; ++ti) {
             const dmRigDDF::MeshAnimationTrack* track = &animation->m_MeshTracks[ti];
 
@@ -604,6 +635,15 @@ namespace dmRig
 
         const dmArray<RigInstance*>& instances = context->m_Instances.m_Objects;
         uint32_t n = instances.Size();
+
+        dmHashTable64<RigInstance*>& shared_poses = context->m_SharedPoses;
+        if (shared_poses.Capacity() < n) {
+            shared_poses.SetCapacity(n / 2 + 1, n);
+        }
+        if (shared_poses.Capacity() > 0) {
+            shared_poses.Clear();
+        }
+
         for (uint32_t i = 0; i < n; ++i)
         {
             RigInstance* instance = instances[i];
@@ -611,31 +651,238 @@ namespace dmRig
         }
     }
 
-    static void DoAnimate(HRigContext context, RigInstance* instance, float dt)
+    // The state that decides the sampled pose of an instance that is not blending.
+    struct SharedPoseKey
     {
-            // NOTE we previously checked for (!instance->m_Enabled || !instance->m_AddedToUpdate) here also
-            if (instance->m_Pose.Empty() || !instance->m_Enabled)
-                return;
+        const dmRigDDF::Skeleton*     m_Skeleton;
+        const dmArray<RigBone>*       m_BindPose;
+        const dmArray<uint32_t>*      m_TrackIdxToPose;
+        const dmRigDDF::RigAnimation* m_Animation;
+        float                         m_Cursor;
+        uint32_t                      m_Playback;
+        uint32_t                      m_Backwards;
+    };
+
+    static void GetSharedPoseKey(const RigInstance* instance, const RigPlayer* player, SharedPoseKey& key)
+    {
+        memset(&key, 0, sizeof(key));
+        key.m_Skeleton       = instance->m_Skeleton;
+        key.m_BindPose       = instance->m_BindPose;
+        key.m_TrackIdxToPose = instance->m_TrackIdxToPose;
+        key.m_Animation      = player->m_Animation;
+        key.m_Cursor         = player->m_Cursor;
+        key.m_Playback       = player->m_Playback;
+        key.m_Backwards      = player->m_Backwards;
+    }
 
-            const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
-            const dmArray<RigBone>& bind_pose = *instance->m_BindPose;
-            const dmArray<uint32_t>& track_idx_to_pose = *instance->m_TrackIdxToPose;
-            dmArray<dmTransform::Transform>& pose = instance->m_Pose;
-            // Reset pose
-            uint32_t bone_count = pose.Size();
-            for (uint32_t bi = 0; bi < bone_count; ++bi)
+    static bool CanSharePose(const RigInstance* instance, const RigPlayer* player)
+    {
+        if (instance->m_Blending || !player->m_Animation) {
+            return false;
+        }
+        // User IK targets make the pose unique to the instance
+        const dmArray<IKTarget>& ik_targets = instance->m_IKTargets;
+        for (uint32_t i = 0; i < ik_targets.Size(); ++i)
+        {
+            if (ik_targets[i].m_Mix != 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void ResetPose(RigInstance* instance)
+    {
+        dmArray<dmTransform::Transform>& pose = instance->m_Pose;
+        uint32_t bone_count = pose.Size();
+        for (uint32_t bi = 0; bi < bone_count; ++bi)
+        {
+            pose[bi].SetIdentity();
+        }
+
+        const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
+        dmArray<IKAnimation>& ik_animation = instance->m_IKAnimation;
+        uint32_t ik_animation_count = ik_animation.Size();
+        for (uint32_t ii = 0; ii < ik_animation_count; ++ii)
+        {
+            const dmRigDDF::IK* ik = &skeleton->m_Iks[ii];
+            ik_animation[ii].m_Mix = ik->m_Mix;
+            ik_animation[ii].m_Positive = ik->m_Positive;
+        }
+    }
+
+    // Combine the sampled pose with the bind pose and apply IK constraints
+    static void FinishPose(RigInstance* instance)
+    {
+        const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
+        const dmArray<RigBone>& bind_pose = *instance->m_BindPose;
+        dmArray<dmTransform::Transform>& pose = instance->m_Pose;
+        dmArray<IKAnimation>& ik_animation = instance->m_IKAnimation;
+        uint32_t bone_count = pose.Size();
+
+        for (uint32_t bi = 0; bi < bone_count; ++bi)
+        {
+            dmTransform::Transform& t = pose[bi];
+            // Normalize quaternions while we blend
+            if (instance->m_Blending)
             {
-                pose[bi].SetIdentity();
+                Quat rotation = t.GetRotation();
+                if (dot(rotation, rotation) > 0.001f)
+                    rotation = normalize(rotation);
+                t.SetRotation(rotation);
             }
-            // Reset IK animation
-            dmArray<IKAnimation>& ik_animation = instance->m_IKAnimation;
-            uint32_t ik_animation_count = ik_animation.Size();
-            for (uint32_t ii = 0; ii < ik_animation_count; ++ii)
+            const dmTransform::Transform& bind_t = bind_pose[bi].m_LocalToParent;
+            t.SetTranslation(bind_t.GetTranslation() + t.GetTranslation());
+            t.SetRotation(bind_t.GetRotation() * t.GetRotation());
+            t.SetScale(mulPerElem(bind_t.GetScale(), t.GetScale()));
+        }
+
+        if (skeleton->m_Iks.m_Count > 0) {
+            DM_PROFILE(Rig, "IK");
+            const uint32_t count = skeleton->m_Iks.m_Count;
+            dmArray<IKTarget>& ik_targets = instance->m_IKTargets;
+
+
+            for (uint32_t i = 0; i < count; ++i) {
+                const dmRigDDF::IK* ik = &skeleton->m_Iks[i];
+
+                // transform local space hiearchy for pose
+                dmTransform::Transform parent_t = GetPoseTransform(bind_pose, pose, pose[ik->m_Parent], ik->m_Parent);
+                dmTransform::Transform target_t = GetPoseTransform(bind_pose, pose, pose[ik->m_Target], ik->m_Target);
+                const uint32_t parent_parent_index = skeleton->m_Bones[ik->m_Parent].m_Parent;
+                dmTransform::Transform parent_parent_t;
+                if(parent_parent_index != INVALID_BONE_INDEX)
+                {
+                    parent_parent_t = dmTransform::Inv(GetPoseTransform(bind_pose, pose, pose[skeleton->m_Bones[ik->m_Parent].m_Parent], skeleton->m_Bones[ik->m_Parent].m_Parent));
+                    parent_t = dmTransform::Mul(parent_parent_t, parent_t);
+                    target_t = dmTransform::Mul(parent_parent_t, target_t);
+                }
+                Vector3 parent_position = parent_t.GetTranslation();
+                Vector3 target_position = target_t.GetTranslation();
+
+                if(ik_targets[i].m_Mix != 0.0f)
+                {
+                    // get custom target position either from go or vector position
+                    Vector3 user_target_position = target_position;
+                    if(ik_targets[i].m_Callback != 0)
+                    {
+                        user_target_position = ik_targets[i].m_Callback(&ik_targets[i]);
+                    } else {
+                        // instance have been removed, disable animation
+                        ik_targets[i].m_UserHash = 0;
+                        ik_targets[i].m_Mix = 0.0f;
+                    }
+
+                    const float target_mix = ik_targets[i].m_Mix;
+
+                    if (parent_parent_index != INVALID_BONE_INDEX) {
+                        user_target_position = dmTransform::Apply(parent_parent_t, user_target_position);
+                    }
+
+                    // blend default target pose and target pose
+                    target_position = target_mix == 1.0f ? user_target_position : dmTransform::lerp(target_mix, target_position, user_target_position);
+                }
+
+                if(ik->m_Child == ik->m_Parent)
+                    ApplyOneBoneIKConstraint(ik, bind_pose, pose, target_position, parent_position, ik_animation[i].m_Mix);
+                else
+                    ApplyTwoBoneIKConstraint(ik, bind_pose, pose, target_position, parent_position, ik_animation[i].m_Positive, ik_animation[i].m_Mix);
+            }
+        }
+    }
+
+    // Evaluate the pose of a non-blending instance, or copy it from an instance that
+    // was evaluated earlier in this update with the same animation state.
+    static void EvaluatePose(HRigContext context, RigInstance* instance, RigPlayer* player)
+    {
+        bool shareable = CanSharePose(instance, player);
+        dmhash_t hash = 0;
+        SharedPoseKey key;
+        if (shareable)
+        {
+            GetSharedPoseKey(instance, player, key);
+            hash = dmHashBuffer64(&key, sizeof(key));
+            RigInstance** source = context->m_SharedPoses.Get(hash);
+            if (source)
+            {
+                RigInstance* source_instance = *source;
+                SharedPoseKey source_key;
+                GetSharedPoseKey(source_instance, GetPlayer(source_instance), source_key);
+                if (memcmp(&key, &source_key, sizeof(key)) == 0)
+                {
+                    memcpy(instance->m_Pose.Begin(), source_instance->m_Pose.Begin(), instance->m_Pose.Size() * sizeof(dmTransform::Transform));
+                    instance->m_PoseKey = source_instance->m_PoseKey;
+                    return;
+                }
+                shareable = false;
+            }
+        }
+
+        ResetPose(instance);
+        ApplyAnimation(player, instance->m_Pose, *instance->m_TrackIdxToPose, instance->m_IKAnimation, 1.0f);
+        FinishPose(instance);
+        instance->m_PoseKey = ++context->m_PoseKeyCounter;
+
+        if (shareable && !context->m_SharedPoses.Full()) {
+            context->m_SharedPoses.Put(hash, instance);
+        }
+    }
+
+    static bool ShouldEvaluatePose(HRigContext context, const RigInstance* instance)
+    {
+        uint32_t interval = context->m_OffscreenUpdateInterval;
+        uint32_t timeout = context->m_OffscreenPoseTimeout;
+        if (interval <= 1 && timeout == 0) {
+            return true;
+        }
+
+        if (instance->m_Visible) {
+            return true;
+        }
+
+        uint32_t offscreen_updates = context->m_UpdateIndex - instance->m_VisibleUpdate;
+        if (timeout != 0 && offscreen_updates > timeout) {
+            return false;
+        }
+        // Spread the off-screen instances over the interval
+        return interval <= 1 || (context->m_UpdateIndex + instance->m_Index) % interval == 0;
+    }
+
+    // Evaluates the pose from the current state of the players, without advancing them.
+    // Used to bring a pose that was skipped while not visible up to date.
+    static void RefreshPose(HRigContext context, RigInstance* instance)
+    {
+        RigPlayer* player = GetPlayer(instance);
+        ResetPose(instance);
+        if (instance->m_Blending)
+        {
+            float fade_rate = instance->m_BlendTimer / instance->m_BlendDuration;
+            float alpha = 1.0f;
+            for (uint32_t pi = 0; pi < 2; ++pi)
             {
-                const dmRigDDF::IK* ik = &skeleton->m_Iks[ii];
-                ik_animation[ii].m_Mix = ik->m_Mix;
-                ik_animation[ii].m_Positive = ik->m_Positive;
+                RigPlayer* p = &instance->m_Players[pi];
+                ApplyAnimation(p, instance->m_Pose, *instance->m_TrackIdxToPose, instance->m_IKAnimation, alpha);
+                alpha = player == p ? 1.0f - fade_rate : fade_rate;
             }
+        }
+        else
+        {
+            ApplyAnimation(player, instance->m_Pose, *instance->m_TrackIdxToPose, instance->m_IKAnimation, 1.0f);
+        }
+        FinishPose(instance);
+        instance->m_PoseKey = ++context->m_PoseKeyCounter;
+        instance->m_PoseSkipped = 0;
+    }
+
+    static void DoAnimate(HRigContext context, RigInstance* instance, float dt)
+    {
+            // NOTE we previously checked for (!instance->m_Enabled || !instance->m_AddedToUpdate) here also
+            if (instance->m_Pose.Empty() || !instance->m_Enabled)
+                return;
+
+            // Players, events and mesh slots always advance, only the bone pose is throttled
+            bool evaluate_pose = ShouldEvaluatePose(context, instance);
+            instance->m_PoseSkipped = !evaluate_pose;
 
             UpdateBlend(instance, dt);
 
@@ -663,6 +910,10 @@ namespace dmRig
 
             if (instance->m_Blending)
             {
+                if (evaluate_pose) {
+                    ResetPose(instance);
+                }
+
                 float fade_rate = instance->m_BlendTimer / instance->m_BlendDuration;
                 // How much to blend the pose, 1 first time to overwrite the bind pose, either fade_rate or 1 - fade_rate second depending on which one is the current player
                 float alpha = 1.0f;
@@ -685,7 +936,10 @@ namespace dmRig
 
                     UpdatePlayer(instance, p, dt, blend_weight);
                     bool draw_order = player == p ? fade_rate >= 0.5f : fade_rate < 0.5f;
-                    ApplyAnimation(p, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, draw_order, context->m_ScratchDrawOrderDeltas, slot_changed, alpha);
+                    if (evaluate_pose) {
+                        ApplyAnimation(p, instance->m_Pose, *instance->m_TrackIdxToPose, instance->m_IKAnimation, alpha);
+                    }
+                    ApplyMeshAnimation(p, instance->m_MeshSlotPose, draw_order, context->m_ScratchDrawOrderDeltas, slot_changed, alpha);
                     if (player == p)
                     {
                         alpha = 1.0f - fade_rate;
@@ -695,87 +949,25 @@ namespace dmRig
                         alpha = fade_rate;
                     }
                 }
+
+                if (evaluate_pose) {
+                    FinishPose(instance);
+                    instance->m_PoseKey = ++context->m_PoseKeyCounter;
+                }
             }
             else
             {
                 UpdatePlayer(instance, player, dt, 1.0f);
-                ApplyAnimation(player, pose, track_idx_to_pose, ik_animation, instance->m_MeshSlotPose, true, context->m_ScratchDrawOrderDeltas, slot_changed, 1.0f);
+                ApplyMeshAnimation(player, instance->m_MeshSlotPose, true, context->m_ScratchDrawOrderDeltas, slot_changed, 1.0f);
+                if (evaluate_pose) {
+                    EvaluatePose(context, instance, player);
+                }
             }
 
             // Update draw order after animation
             if (slot_changed > 0) {
                 UpdateSlotDrawOrder(instance->m_DrawOrder, context->m_ScratchDrawOrderDeltas, slot_changed, context->m_ScratchDrawOrderUnchanged);
             }
-
-            for (uint32_t bi = 0; bi < bone_count; ++bi)
-            {
-                dmTransform::Transform& t = pose[bi];
-                // Normalize quaternions while we blend
-                if (instance->m_Blending)
-                {
-                    Quat rotation = t.GetRotation();
-                    if (dot(rotation, rotation) > 0.001f)
-                        rotation = normalize(rotation);
-                    t.SetRotation(rotation);
-                }
-                const dmTransform::Transform& bind_t = bind_pose[bi].m_LocalToParent;
-                t.SetTranslation(bind_t.GetTranslation() + t.GetTranslation());
-                t.SetRotation(bind_t.GetRotation() * t.GetRotation());
-                t.SetScale(mulPerElem(bind_t.GetScale(), t.GetScale()));
-            }
-
-            if (skeleton->m_Iks.m_Count > 0) {
-                DM_PROFILE(Rig, "IK");
-                const uint32_t count = skeleton->m_Iks.m_Count;
-                dmArray<IKTarget>& ik_targets = instance->m_IKTargets;
-
-
-                for (uint32_t i = 0; i < count; ++i) {
-                    const dmRigDDF::IK* ik = &skeleton->m_Iks[i];
-
-                    // transform local space hiearchy for pose
-                    dmTransform::Transform parent_t = GetPoseTransform(bind_pose, pose, pose[ik->m_Parent], ik->m_Parent);
-                    dmTransform::Transform target_t = GetPoseTransform(bind_pose, pose, pose[ik->m_Target], ik->m_Target);
-                    const uint32_t parent_parent_index = skeleton->m_Bones[ik->m_Parent].m_Parent;
-                    dmTransform::Transform parent_parent_t;
-                    if(parent_parent_index != INVALID_BONE_INDEX)
-                    {
-                        parent_parent_t = dmTransform::Inv(GetPoseTransform(bind_pose, pose, pose[skeleton->m_Bones[ik->m_Parent].m_Parent], skeleton->m_Bones[ik->m_Parent].m_Parent));
-                        parent_t = dmTransform::Mul(parent_parent_t, parent_t);
-                        target_t = dmTransform::Mul(parent_parent_t, target_t);
-                    }
-                    Vector3 parent_position = parent_t.GetTranslation();
-                    Vector3 target_position = target_t.GetTranslation();
-
-                    if(ik_targets[i].m_Mix != 0.0f)
-                    {
-                        // get custom target position either from go or vector position
-                        Vector3 user_target_position = target_position;
-                        if(ik_targets[i].m_Callback != 0)
-                        {
-                            user_target_position = ik_targets[i].m_Callback(&ik_targets[i]);
-                        } else {
-                            // instance have been removed, disable animation
-                            ik_targets[i].m_UserHash = 0;
-                            ik_targets[i].m_Mix = 0.0f;
-                        }
-
-                        const float target_mix = ik_targets[i].m_Mix;
-
-                        if (parent_parent_index != INVALID_BONE_INDEX) {
-                            user_target_position = dmTransform::Apply(parent_parent_t, user_target_position);
-                        }
-
-                        // blend default target pose and target pose
-                        target_position = target_mix == 1.0f ? user_target_position : dmTransform::lerp(target_mix, target_position, user_target_position);
-                    }
-
-                    if(ik->m_Child == ik->m_Parent)
-                        ApplyOneBoneIKConstraint(ik, bind_pose, pose, target_position, parent_position, ik_animation[i].m_Mix);
-                    else
-                        ApplyTwoBoneIKConstraint(ik, bind_pose, pose, target_position, parent_position, ik_animation[i].m_Positive, ik_animation[i].m_Mix);
-                }
-            }
     }
 
     static Result PostUpdate(HRigContext context)
@@ -798,7 +990,7 @@ namespace dmRig
     {
             // If pose is empty, there are no bones to update
             dmArray<dmTransform::Transform>& pose = instance->m_Pose;
-            if (pose.Empty())
+            if (pose.Empty() || instance->m_PoseSkipped)
                 return false;
 
             // Notify any listener that the pose has been recalculated
@@ -814,6 +1006,13 @@ namespace dmRig
     {
         DM_PROFILE(Rig, "Update");
 
+        // Poses change, and resources may have been reloaded since the influence matrices were built
+        for (uint32_t i = 0; i < MAX_VERTEX_DATA_JOB_COUNT; ++i)
+        {
+            context->m_VertexScratch[i].m_InfluencePoseKey = 0;
+        }
+
+        ++context->m_UpdateIndex;
         Animate(context, dt);
 
         return PostUpdate(context);
@@ -828,6 +1027,7 @@ namespace dmRig
 
     static dmRig::Result CreatePose(HRigContext context, HRigInstance instance)
     {
+        instance->m_PoseKey = 0;
         if(!instance->m_Skeleton)
             return dmRig::RESULT_OK;
 
@@ -1039,14 +1239,75 @@ namespace dmRig
         return vertex_count;
     }
 
-    static float* GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<Matrix4>& pose_matrices, float* out_buffer)
+    static inline void BlendSkinMatrices(const RigSkinMatrix* skin_matrices, uint32_t max_index, const uint32_t* bone_indices, const float* bone_weights, float* out)
+    {
+        // Unused influences have zero weight, but their index is clamped so it never reads out of bounds.
+        const float* m0 = skin_matrices[dmMath::Min(bone_indices[0], max_index)].m_Rows;
+        const float* m1 = skin_matrices[dmMath::Min(bone_indices[1], max_index)].m_Rows;
+        const float* m2 = skin_matrices[dmMath::Min(bone_indices[2], max_index)].m_Rows;
+        const float* m3 = skin_matrices[dmMath::Min(bone_indices[3], max_index)].m_Rows;
+        const float w0 = bone_weights[0];
+        const float w1 = bone_weights[1];
+        const float w2 = bone_weights[2];
+        const float w3 = bone_weights[3];
+        for (uint32_t i = 0; i < 12; ++i)
+        {
+            out[i] = m0[i] * w0 + m1[i] * w1 + m2[i] * w2 + m3[i] * w3;
+        }
+    }
+
+    static void ToSkinMatrix(const Matrix4& m, RigSkinMatrix& out)
+    {
+        for (uint32_t row = 0; row < 3; ++row)
+        {
+            out.m_Rows[row*4+0] = m.getElem(0, row);
+            out.m_Rows[row*4+1] = m.getElem(1, row);
+            out.m_Rows[row*4+2] = m.getElem(2, row);
+            out.m_Rows[row*4+3] = m.getElem(3, row);
+        }
+    }
+
+    // Combine the influence matrices with the model and normal matrix, so that each vertex only needs a
+    // single blended 3x4 matrix. The model translation is left out and added once per vertex, which keeps
+    // the result identical for weights that do not sum to one.
+    static void InfluenceToSkinMatrices(const Matrix4& model_matrix, const Matrix4& normal_matrix, const dmArray<Matrix4>& influence_matrices, bool normals, dmArray<RigSkinMatrix>& out_skin_matrices, dmArray<RigSkinMatrix>& out_normal_matrices)
+    {
+        uint32_t count = influence_matrices.Size();
+        if (out_skin_matrices.Capacity() < count) {
+            out_skin_matrices.OffsetCapacity(count - out_skin_matrices.Capacity());
+        }
+        out_skin_matrices.SetSize(count);
+
+        const Matrix4 model_linear(model_matrix.getUpper3x3(), Vector3(0.0f));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ToSkinMatrix(model_linear * influence_matrices[i], out_skin_matrices[i]);
+        }
+
+        if (!normals) {
+            return;
+        }
+
+        if (out_normal_matrices.Capacity() < count) {
+            out_normal_matrices.OffsetCapacity(count - out_normal_matrices.Capacity());
+        }
+        out_normal_matrices.SetSize(count);
+
+        const Matrix3 normal_linear = normal_matrix.getUpper3x3();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ToSkinMatrix(Matrix4(normal_linear * influence_matrices[i].getUpper3x3(), Vector3(0.0f)), out_normal_matrices[i]);
+        }
+    }
+
+    static float* GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<RigSkinMatrix>& skin_matrices, float* out_buffer)
     {
         const float* normals_in = mesh->m_Normals.m_Data;
         const uint32_t* normal_indices = mesh->m_NormalsIndices.m_Data;
         uint32_t index_count = mesh->m_PositionIndices.m_Count;
         Vector4 v;
 
-        if (!mesh->m_BoneIndices.m_Count || pose_matrices.Size() == 0)
+        if (!mesh->m_BoneIndices.m_Count || skin_matrices.Size() == 0)
         {
             for (uint32_t ii = 0; ii < index_count; ++ii)
             {
@@ -1054,7 +1315,7 @@ namespace dmRig
                 Vector3 normal_in(normals_in[ni*3+0], normals_in[ni*3+1], normals_in[ni*3+2]);
                 v = normal_matrix * normal_in;
                 if (lengthSqr(v) > 0.0f) {
-                    normalize(v);
+                    v = normalize(v);
                 }
                 *out_buffer++ = v[0];
                 *out_buffer++ = v[1];
@@ -1066,52 +1327,44 @@ namespace dmRig
         const uint32_t* indices = mesh->m_BoneIndices.m_Data;
         const float* weights = mesh->m_Weights.m_Data;
         const uint32_t* vertex_indices = mesh->m_PositionIndices.m_Data;
+        const RigSkinMatrix* matrices = &skin_matrices.Front();
+        const uint32_t max_index = skin_matrices.Size() - 1;
+        float m[12];
         for (uint32_t ii = 0; ii < index_count; ++ii)
         {
             const uint32_t ni = normal_indices[ii]*3;
-            const Vector3 normal_in(normals_in[ni+0], normals_in[ni+1], normals_in[ni+2]);
-            Vector4 normal_out(0.0f, 0.0f, 0.0f, 0.0f);
+            const float nx = normals_in[ni+0];
+            const float ny = normals_in[ni+1];
+            const float nz = normals_in[ni+2];
 
             const uint32_t bi_offset = vertex_indices[ii] << 2;
-            const uint32_t* bone_indices = &indices[bi_offset];
-            const float* bone_weights = &weights[bi_offset];
-
-            if (bone_weights[0])
-            {
-                normal_out += (pose_matrices[bone_indices[0]] * normal_in) * bone_weights[0];
-                if (bone_weights[1])
-                {
-                    normal_out += (pose_matrices[bone_indices[1]] * normal_in) * bone_weights[1];
-                    if (bone_weights[2])
-                    {
-                        normal_out += (pose_matrices[bone_indices[2]] * normal_in) * bone_weights[2];
-                        if (bone_weights[3])
-                        {
-                            normal_out += (pose_matrices[bone_indices[3]] * normal_in) * bone_weights[3];
-                        }
-                    }
-                }
-            }
-
-            v = normal_matrix * Vector3(normal_out.getX(), normal_out.getY(), normal_out.getZ());
-            if (lengthSqr(v) > 0.0f) {
-                normalize(v);
+            BlendSkinMatrices(matrices, max_index, &indices[bi_offset], &weights[bi_offset], m);
+
+            float x = m[0] * nx + m[1] * ny + m[2]  * nz;
+            float y = m[4] * nx + m[5] * ny + m[6]  * nz;
+            float z = m[8] * nx + m[9] * ny + m[10] * nz;
+            const float len_sq = x * x + y * y + z * z;
+            if (len_sq > 0.0f) {
+                const float inv_len = 1.0f / sqrtf(len_sq);
+                x *= inv_len;
+                y *= inv_len;
+                z *= inv_len;
             }
-            *out_buffer++ = v[0];
-            *out_buffer++ = v[1];
-            *out_buffer++ = v[2];
+            *out_buffer++ = x;
+            *out_buffer++ = y;
+            *out_buffer++ = z;
         }
 
         return out_buffer;
     }
 
-    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<Matrix4>& pose_matrices, float* out_buffer)
+    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<RigSkinMatrix>& skin_matrices, float* out_buffer)
     {
         const float *positions = mesh->m_Positions.m_Data;
         const size_t vertex_count = mesh->m_Positions.m_Count / 3;
         Point3 in_p;
         Vector4 v;
-        if(!mesh->m_BoneIndices.m_Count || pose_matrices.Size() == 0)
+        if(!mesh->m_BoneIndices.m_Count || skin_matrices.Size() == 0)
         {
             for (uint32_t i = 0; i < vertex_count; ++i)
             {
@@ -1128,40 +1381,25 @@ namespace dmRig
 
         const uint32_t* indices = mesh->m_BoneIndices.m_Data;
         const float* weights = mesh->m_Weights.m_Data;
+        const RigSkinMatrix* matrices = &skin_matrices.Front();
+        const uint32_t max_index = skin_matrices.Size() - 1;
+        const Vector3 translation = model_matrix.getTranslation();
+        const float tx = translation.getX();
+        const float ty = translation.getY();
+        const float tz = translation.getZ();
+        float m[12];
         for (uint32_t i = 0; i < vertex_count; ++i)
         {
-            Vector4 in_v;
-            in_v.setX(*positions++);
-            in_v.setY(*positions++);
-            in_v.setZ(*positions++);
-            in_v.setW(1.0f);
+            const float px = *positions++;
+            const float py = *positions++;
+            const float pz = *positions++;
 
-            Vector4 out_p(0.0f, 0.0f, 0.0f, 0.0f);
             const uint32_t bi_offset = i << 2;
-            const uint32_t* bone_indices = &indices[bi_offset];
-            const float* bone_weights = &weights[bi_offset];
+            BlendSkinMatrices(matrices, max_index, &indices[bi_offset], &weights[bi_offset], m);
 
-            if(bone_weights[0])
-            {
-                out_p += pose_matrices[bone_indices[0]] * in_v * bone_weights[0];
-                if(bone_weights[1])
-                {
-                    out_p += pose_matrices[bone_indices[1]] * in_v * bone_weights[1];
-                    if(bone_weights[2])
-                    {
-                        out_p += pose_matrices[bone_indices[2]] * in_v * bone_weights[2];
-                        if(bone_weights[3])
-                        {
-                            out_p += pose_matrices[bone_indices[3]] * in_v * bone_weights[3];
-                        }
-                    }
-                }
-            }
-
-            v = model_matrix * Point3(out_p.getX(), out_p.getY(), out_p.getZ());
-            *out_buffer++ = v[0];
-            *out_buffer++ = v[1];
-            *out_buffer++ = v[2];
+            *out_buffer++ = m[0] * px + m[1] * py + m[2]  * pz + m[3]  + tx;
+            *out_buffer++ = m[4] * px + m[5] * py + m[6]  * pz + m[7]  + ty;
+            *out_buffer++ = m[8] * px + m[9] * py + m[10] * pz + m[11] + tz;
         }
         return out_buffer;
     }
@@ -1313,7 +1551,33 @@ namespace dmRig
         return out_write_ptr;
     }
 
-    void* GenerateVertexData(dmRig::HRigContext context, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
+    void SetVisible(HRigContext context, HRigInstance instance, bool visible)
+    {
+        if (visible == (bool)instance->m_Visible) {
+            return;
+        }
+        instance->m_Visible = visible;
+        if (!visible)
+        {
+            // The pose of the latest update is up to date
+            instance->m_VisibleUpdate = context->m_UpdateIndex;
+            return;
+        }
+
+        // Catch up right away, so that neither the next draw nor the bone game objects use a stale pose
+        if (instance->m_PoseSkipped)
+        {
+            RefreshPose(context, instance);
+            DoPostUpdate(instance);
+        }
+    }
+
+    bool GetVisible(HRigInstance instance)
+    {
+        return instance->m_Visible;
+    }
+
+    static void* DoGenerateVertexData(RigVertexScratch* scratch, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
     {
         const dmRigDDF::MeshEntry* mesh_entry = instance->m_MeshEntry;
         if (!instance->m_MeshEntry || !instance->m_DoRender) {
@@ -1332,15 +1596,26 @@ namespace dmRig
             }
         }
 
-        dmArray<Matrix4>& pose_matrices      = context->m_ScratchPoseMatrixBuffer;
-        dmArray<Matrix4>& influence_matrices = context->m_ScratchInfluenceMatrixBuffer;
-        dmArray<Vector3>& positions          = context->m_ScratchPositionBuffer;
-        dmArray<Vector3>& normals            = context->m_ScratchNormalBuffer;
+        dmArray<Matrix4>& pose_matrices        = scratch->m_PoseMatrixBuffer;
+        dmArray<Matrix4>& influence_matrices   = scratch->m_InfluenceMatrixBuffer;
+        dmArray<RigSkinMatrix>& skin_matrices  = scratch->m_SkinMatrixBuffer;
+        dmArray<RigSkinMatrix>& normal_skin_matrices = scratch->m_NormalSkinMatrixBuffer;
+        dmArray<Vector3>& positions            = scratch->m_PositionBuffer;
+        dmArray<Vector3>& normals              = scratch->m_NormalBuffer;
 
         // If the rig has bones, update the pose to be local-to-model
         uint32_t bone_count = GetBoneCount(instance);
-        influence_matrices.SetSize(0);
-        if (bone_count && instance->m_PoseIdxToInfluence->Size() > 0) {
+        skin_matrices.SetSize(0);
+        normal_skin_matrices.SetSize(0);
+        bool has_influences = bone_count && instance->m_PoseIdxToInfluence->Size() > 0;
+
+        // Instances sharing a pose (e.g. playing the same animation in sync) reuse the influence matrices
+        bool cached_influences = has_influences && instance->m_PoseKey != 0
+                                && scratch->m_InfluencePoseKey == instance->m_PoseKey
+                                && scratch->m_InfluencePoseIdxToInfluence == instance->m_PoseIdxToInfluence
+                                && influence_matrices.Size() == instance->m_MaxBoneCount;
+        if (has_influences && !cached_influences) {
+            influence_matrices.SetSize(0);
 
             // Make sure pose scratch buffers have enough space
             if (pose_matrices.Capacity() < bone_count) {
@@ -1365,7 +1640,7 @@ namespace dmRig
             const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
             if (skeleton->m_LocalBoneScaling) {
 
-                dmArray<dmTransform::Transform>& pose_transforms = context->m_ScratchPoseTransformBuffer;
+                dmArray<dmTransform::Transform>& pose_transforms = scratch->m_PoseTransformBuffer;
                 if (pose_transforms.Capacity() < bone_count) {
                     pose_transforms.OffsetCapacity(bone_count - pose_transforms.Capacity());
                 }
@@ -1389,6 +1664,13 @@ namespace dmRig
 
             // Rearrange pose matrices to indices that the mesh vertices understand.
             PoseToInfluence(*instance->m_PoseIdxToInfluence, pose_matrices, influence_matrices);
+
+            scratch->m_InfluencePoseKey = instance->m_PoseKey;
+            scratch->m_InfluencePoseIdxToInfluence = instance->m_PoseIdxToInfluence;
+        }
+
+        if (has_influences) {
+            InfluenceToSkinMatrices(model_matrix, normal_matrix, influence_matrices, vertex_format == RIG_VERTEX_FORMAT_MODEL, skin_matrices, normal_skin_matrices);
         }
 
         // Loop that generates actual vertex data for current mesh entry.
@@ -1432,9 +1714,9 @@ namespace dmRig
                     // Fill scratch buffers for positions, and normals if applicable, using pose matrices.
                     float* positions_buffer = (float*)positions.Begin();
                     float* normals_buffer = (float*)normals.Begin();
-                    dmRig::GeneratePositionData(mesh_attachment, model_matrix, influence_matrices, positions_buffer);
+                    dmRig::GeneratePositionData(mesh_attachment, model_matrix, skin_matrices, positions_buffer);
                     if (vertex_format == RIG_VERTEX_FORMAT_MODEL && mesh_attachment->m_NormalsIndices.m_Count) {
-                        dmRig::GenerateNormalData(mesh_attachment, normal_matrix, influence_matrices, normals_buffer);
+                        dmRig::GenerateNormalData(mesh_attachment, normal_matrix, normal_skin_matrices, normals_buffer);
                     }
 
                     // NOTE: We expose two different vertex format that GenerateVertexData can output.
@@ -1455,6 +1737,16 @@ namespace dmRig
             }
         }
 
+        return vertex_data_out;
+    }
+
+    void* GenerateVertexData(dmRig::HRigContext context, dmRig::HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out)
+    {
+        if (instance->m_PoseSkipped) {
+            RefreshPose(context, instance);
+        }
+        vertex_data_out = DoGenerateVertexData(&context->m_VertexScratch[0], instance, model_matrix, normal_matrix, color, vertex_format, vertex_data_out);
+
         // DEF-3610
         // Using Wasm on Microsoft Edge this function returns NULL after a couple of runs.
         // There is no code path that could result in NULL, leading us to suspect it has
@@ -1474,6 +1766,102 @@ namespace dmRig
         return vertex_data_out;
     }
 
+    // Batches smaller than this are generated on the calling thread, since
+    // waking the workers costs more than it saves.
+    static const uint32_t MIN_PARALLEL_VERTEX_COUNT = 4096;
+
+    struct VertexDataJobContext
+    {
+        RigContext*               m_Context;
+        const RigVertexDataEntry* m_Entries;
+        const uint32_t*           m_VertexOffsets;
+        // First entry of each job, job_count+1 entries
+        uint32_t                  m_JobEntryStart[MAX_VERTEX_DATA_JOB_COUNT + 1];
+        uint8_t*                  m_VertexDataOut;
+        uint32_t                  m_VertexSize;
+        RigVertexFormat           m_VertexFormat;
+    };
+
+    static void GenerateVertexDataJob(void* _ctx, uint32_t job_index)
+    {
+        VertexDataJobContext* ctx = (VertexDataJobContext*)_ctx;
+        RigVertexScratch* scratch = &ctx->m_Context->m_VertexScratch[job_index];
+        for (uint32_t i = ctx->m_JobEntryStart[job_index]; i < ctx->m_JobEntryStart[job_index + 1]; ++i)
+        {
+            const RigVertexDataEntry& entry = ctx->m_Entries[i];
+            void* out = ctx->m_VertexDataOut + ctx->m_VertexOffsets[i] * ctx->m_VertexSize;
+            DoGenerateVertexData(scratch, entry.m_Instance, entry.m_ModelMatrix, entry.m_NormalMatrix, entry.m_Color, ctx->m_VertexFormat, out);
+        }
+    }
+
+    void* GenerateVertexData(dmRig::HRigContext context, const RigVertexDataEntry* entries, uint32_t entry_count, RigVertexFormat vertex_format, void* vertex_data_out)
+    {
+        DM_PROFILE(Rig, "GenerateVertexData");
+
+        // Each instance writes to its own range of the output, found up front from the vertex counts.
+        dmArray<uint32_t>& offsets = context->m_ScratchVertexOffsets;
+        if (offsets.Capacity() < entry_count + 1) {
+            offsets.OffsetCapacity(entry_count + 1 - offsets.Capacity());
+        }
+        offsets.SetSize(entry_count + 1);
+        uint32_t vertex_count = 0;
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            // Instances drawn while not visible need a pose that matches their cursor
+            if (entries[i].m_Instance->m_PoseSkipped) {
+                RefreshPose(context, entries[i].m_Instance);
+            }
+            offsets[i] = vertex_count;
+            vertex_count += GetVertexCount(entries[i].m_Instance);
+        }
+        offsets[entry_count] = vertex_count;
+
+        VertexDataJobContext ctx;
+        ctx.m_Context       = context;
+        ctx.m_Entries       = entries;
+        ctx.m_VertexOffsets = offsets.Begin();
+        ctx.m_VertexDataOut = (uint8_t*)vertex_data_out;
+        ctx.m_VertexSize    = vertex_format == RIG_VERTEX_FORMAT_MODEL ? sizeof(RigModelVertex) : sizeof(RigSpineModelVertex);
+        ctx.m_VertexFormat  = vertex_format;
+
+        dmThreadPool::HThreadPool pool = 0;
+        uint32_t job_count = 1;
+        if (entry_count > 1 && vertex_count >= MIN_PARALLEL_VERTEX_COUNT)
+        {
+            if (!context->m_VertexDataPool)
+            {
+                // The calling thread runs one of the jobs itself
+                context->m_VertexDataPool = dmThreadPool::New(MAX_VERTEX_DATA_JOB_COUNT - 1, "rig_vertex_data");
+            }
+            pool = context->m_VertexDataPool;
+            if (pool)
+            {
+                job_count = dmMath::Min(dmThreadPool::GetThreadCount(pool) + 1, dmMath::Min(entry_count, MAX_VERTEX_DATA_JOB_COUNT));
+            }
+        }
+
+        // Split the entries into jobs with roughly the same number of vertices
+        ctx.m_JobEntryStart[0] = 0;
+        uint32_t entry = 0;
+        for (uint32_t job = 1; job < job_count; ++job)
+        {
+            uint32_t target = (uint32_t)(((uint64_t)vertex_count * job) / job_count);
+            while (entry < entry_count && offsets[entry] < target) {
+                ++entry;
+            }
+            ctx.m_JobEntryStart[job] = entry;
+        }
+        ctx.m_JobEntryStart[job_count] = entry_count;
+
+        if (job_count == 1) {
+            GenerateVertexDataJob(&ctx, 0);
+        } else {
+            dmThreadPool::Run(pool, GenerateVertexDataJob, &ctx, job_count);
+        }
+
+        return ctx.m_VertexDataOut + vertex_count * ctx.m_VertexSize;
+    }
+
     static uint32_t FindIKIndex(HRigInstance instance, dmhash_t ik_constraint_id)
     {
         const dmRigDDF::Skeleton* skeleton = instance->m_Skeleton;
@@ -1616,6 +2004,8 @@ namespace dmRig
         instance->m_TrackIdxToPose     = params.m_TrackIdxToPose;
 
         instance->m_Enabled = 1;
+        instance->m_Visible = 1;
+        instance->m_VisibleUpdate = context->m_UpdateIndex;
 
         AllocateMeshSlotPose(params.m_MeshSet, instance->m_MeshSlotPose, instance->m_DrawOrder);
         SetMesh(instance, instance->m_MeshId);
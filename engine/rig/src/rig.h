@@ -17,8 +17,10 @@
 
 #include <dlib/object_pool.h>
 #include <dlib/hash.h>
+#include <dlib/hashtable.h>
 #include <dlib/vmath.h>
 #include <dlib/align.h>
+#include <dlib/thread_pool.h>
 #include <dlib/transform.h>
 
 #include <render/render.h>
@@ -202,18 +204,53 @@ namespace dmRig
         float nz;
     };
 
+    // Number of jobs GenerateVertexData may split a batch of instances into
+    static const uint32_t MAX_VERTEX_DATA_JOB_COUNT = 4;
+
+    // Bone influence matrix premultiplied with the model (or normal) matrix, three
+    // rows of a 3x4 row-major matrix. Plain floats so blending loops vectorize.
+    struct RigSkinMatrix
+    {
+        float m_Rows[12];
+    };
+
+    // Temporary scratch buffers used when generating vertex data for an instance.
+    // Each job generating vertex data uses its own set.
+    struct RigVertexScratch
+    {
+        // Used for store pose as transform and matrices
+        // (avoids modifying the real pose transform data during rendering).
+        dmArray<dmTransform::Transform> m_PoseTransformBuffer;
+        dmArray<Matrix4>                m_InfluenceMatrixBuffer;
+        dmArray<Matrix4>                m_PoseMatrixBuffer;
+        // Influence matrices combined with the model and normal matrix.
+        dmArray<RigSkinMatrix>          m_SkinMatrixBuffer;
+        dmArray<RigSkinMatrix>          m_NormalSkinMatrixBuffer;
+        // Used when transforming the vertex buffer, used to creating primitives from indices.
+        dmArray<Vector3>                m_PositionBuffer;
+        dmArray<Vector3>                m_NormalBuffer;
+        // Pose the influence matrices were last built from, so that instances sharing
+        // a pose can reuse them (see RigInstance::m_PoseKey).
+        uint64_t                        m_InfluencePoseKey;
+        const dmArray<uint32_t>*        m_InfluencePoseIdxToInfluence;
+    };
+
     struct RigContext
     {
         dmObjectPool<HRigInstance>      m_Instances;
-        // Temporary scratch buffers used for store pose as transform and matrices
-        // (avoids modifying the real pose transform data during rendering).
-        dmArray<dmTransform::Transform> m_ScratchPoseTransformBuffer;
-        dmArray<Matrix4>                m_ScratchInfluenceMatrixBuffer;
-        dmArray<Matrix4>                m_ScratchPoseMatrixBuffer;
-        // Temporary scratch buffers used when transforming the vertex buffer,
-        // used to creating primitives from indices.
-        dmArray<Vector3>                m_ScratchPositionBuffer;
-        dmArray<Vector3>                m_ScratchNormalBuffer;
+        RigVertexScratch                m_VertexScratch[MAX_VERTEX_DATA_JOB_COUNT];
+        // Vertex offset of each instance when generating vertex data for several instances.
+        dmArray<uint32_t>               m_ScratchVertexOffsets;
+        // Worker threads for generating vertex data of large batches, created by the first such batch.
+        dmThreadPool::HThreadPool       m_VertexDataPool;
+        // Instances that evaluated their pose during the current update, by sampling state.
+        // Other instances in the same state copy the pose instead of sampling it again.
+        dmHashTable64<RigInstance*>     m_SharedPoses;
+        uint64_t                        m_PoseKeyCounter;
+        // Incremented by each Update(), used to tell how long ago an instance was visible.
+        uint32_t                        m_UpdateIndex;
+        uint32_t                        m_OffscreenUpdateInterval;
+        uint32_t                        m_OffscreenPoseTimeout;
         // Temporary scratch buffers to handle draw order changes.
         dmArray<int32_t>                m_ScratchDrawOrderDeltas;
         dmArray<int32_t>                m_ScratchDrawOrderUnchanged;
@@ -222,6 +259,10 @@ namespace dmRig
     struct NewContextParams {
         HRigContext* m_Context;
         uint32_t     m_MaxRigInstanceCount;
+        /// Evaluate the pose of instances that are not visible only every n:th update. 0 or 1 evaluates every update.
+        uint32_t     m_OffscreenUpdateInterval;
+        /// Stop evaluating the pose of instances that have not been visible for this many updates. 0 never stops.
+        uint32_t     m_OffscreenPoseTimeout;
     };
 
     typedef void (*RigEventCallback)(RigEventType, void*, void*, void*);
@@ -248,6 +289,10 @@ namespace dmRig
         void*                         m_EventCBUserData2;
         /// Animated pose, every transform is local-to-model-space and describes the delta between bind pose and animation
         dmArray<dmTransform::Transform> m_Pose;
+        /// Identifies the current pose. Instances with the same key have identical poses, 0 if unknown.
+        uint64_t                      m_PoseKey;
+        /// Context update index when the instance was made invisible
+        uint32_t                      m_VisibleUpdate;
         /// Animated IK
         dmArray<IKAnimation>          m_IKAnimation;
         /// User IK constraint targets
@@ -269,6 +314,9 @@ namespace dmRig
         uint8_t                       m_Blending : 1;
         uint8_t                       m_Enabled : 1;
         uint8_t                       m_DoRender : 1;
+        /// Whether pose evaluation was skipped in the last update since the instance is not visible
+        uint8_t                       m_PoseSkipped : 1;
+        uint8_t                       m_Visible : 1;
     };
 
     struct InstanceCreateParams
@@ -298,6 +346,14 @@ namespace dmRig
         bool                          m_ForceAnimatePose;
     };
 
+    struct RigVertexDataEntry
+    {
+        Matrix4      m_ModelMatrix;
+        Matrix4      m_NormalMatrix;
+        Vector4      m_Color;
+        HRigInstance m_Instance;
+    };
+
     struct InstanceDestroyParams
     {
         HRigContext  m_Context;
@@ -316,8 +372,18 @@ namespace dmRig
     dmhash_t GetAnimation(HRigInstance instance);
 
     void* GenerateVertexData(HRigContext context, HRigInstance instance, const Matrix4& model_matrix, const Matrix4& normal_matrix, const Vector4 color, RigVertexFormat vertex_format, void* vertex_data_out);
+    // Generates vertex data for several instances into one buffer, in the same order and layout as calling
+    // GenerateVertexData for each entry in turn. Large batches are split over a set of worker threads.
+    void* GenerateVertexData(HRigContext context, const RigVertexDataEntry* entries, uint32_t entry_count, RigVertexFormat vertex_format, void* vertex_data_out);
     uint32_t GetVertexCount(HRigInstance instance);
 
+    // Instances are visible when created. Pose evaluation of instances that are not visible is throttled
+    // according to the context settings, while the animation cursor, events and mesh slots keep advancing
+    // every update. Bone game objects only follow the evaluated poses. Making an instance visible again
+    // evaluates its pose and notifies the pose callback right away.
+    void SetVisible(HRigContext context, HRigInstance instance, bool visible);
+    bool GetVisible(HRigInstance instance);
+
     Result SetMesh(HRigInstance instance, dmhash_t mesh_id);
     dmhash_t GetMesh(HRigInstance instance);
     Result SetMeshSlot(HRigInstance instance, dmhash_t mesh_id, dmhash_t slot_id);
@@ -13,6 +13,7 @@
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
 #include <dlib/log.h>
+#include <string.h>
 
 #include <../rig.h>
 
@@ -1452,11 +1453,11 @@ TEST_F(RigInstanceTest, MaxBoneCount)
 
     // m_ScratchInfluenceMatrixBuffer should be able to contain the instance max bone count, which is the max of the used skeleton and meshset
     // MaxBoneCount is set to BoneCount + 1 for testing.
-    ASSERT_EQ(m_Context->m_ScratchInfluenceMatrixBuffer.Size(), dmRig::GetMaxBoneCount(m_Instance));
-    ASSERT_EQ(m_Context->m_ScratchInfluenceMatrixBuffer.Size(), dmRig::GetBoneCount(m_Instance) + 1);
+    ASSERT_EQ(m_Context->m_VertexScratch[0].m_InfluenceMatrixBuffer.Size(), dmRig::GetMaxBoneCount(m_Instance));
+    ASSERT_EQ(m_Context->m_VertexScratch[0].m_InfluenceMatrixBuffer.Size(), dmRig::GetBoneCount(m_Instance) + 1);
 
     // Setting the m_ScratchInfluenceMatrixBuffer to zero ensures it have to be resized to max bone count
-    m_Context->m_ScratchInfluenceMatrixBuffer.SetCapacity(0);
+    m_Context->m_VertexScratch[0].m_InfluenceMatrixBuffer.SetCapacity(0);
     // If this isn't done correctly, it'll assert out of bounds
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0/60.0));
 }
@@ -1890,6 +1891,222 @@ TEST_F(RigInstanceTest, MultipleRigInfluences)
     DeleteRigData(mesh_set, skeleton, animation_set);
 }
 
+// Verifies the blended skinning against straightforward per-influence scalar skinning,
+// and that a batch split over several jobs produces the same data as one call per instance.
+TEST_F(RigInstanceTest, GenerateVertexDataBatch)
+{
+    // Let two bones influence each vertex
+    for (uint32_t i = 0; i < m_MeshSet->m_MeshAttachments.m_Count; ++i)
+    {
+        dmRigDDF::Mesh& mesh = m_MeshSet->m_MeshAttachments[i];
+        for (uint32_t w = 0; w < mesh.m_Weights.m_Count; w += 4)
+        {
+            mesh.m_Weights[w+0] = 0.75f;
+            mesh.m_Weights[w+1] = 0.25f;
+        }
+    }
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 0.5f));
+
+    const Matrix4 model_matrix = Matrix4::translation(Vector3(1.0f, 2.0f, 3.0f)) * Matrix4::rotationZ(0.5f) * Matrix4::scale(Vector3(2.0f, 1.0f, 1.0f));
+    const Matrix4 normal_matrix = transpose(inverse(model_matrix));
+
+    const uint32_t vertex_count = dmRig::GetVertexCount(m_Instance);
+    ASSERT_EQ(4u, vertex_count);
+    dmRig::RigModelVertex data[4];
+    ASSERT_EQ(data + vertex_count, dmRig::GenerateVertexData(m_Context, m_Instance, model_matrix, normal_matrix, Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)data));
+    // Small batches never start any worker threads
+    ASSERT_EQ((dmThreadPool::HThreadPool)0, m_Context->m_VertexDataPool);
+
+    const dmArray<Matrix4>& influences = m_Context->m_VertexScratch[0].m_InfluenceMatrixBuffer;
+    const dmRig::MeshSlotPose& slot_pose = m_Instance->m_MeshSlotPose[0];
+    const dmRigDDF::Mesh& mesh = m_MeshSet->m_MeshAttachments[slot_pose.m_MeshSlot->m_MeshAttachments[slot_pose.m_ActiveAttachment]];
+    ASSERT_EQ(vertex_count, mesh.m_PositionIndices.m_Count);
+    for (uint32_t i = 0; i < vertex_count; ++i)
+    {
+        uint32_t vi = mesh.m_PositionIndices[i];
+        uint32_t ni = mesh.m_NormalsIndices[i];
+        Vector4 position(mesh.m_Positions[vi*3+0], mesh.m_Positions[vi*3+1], mesh.m_Positions[vi*3+2], 1.0f);
+        Vector3 normal(mesh.m_Normals[ni*3+0], mesh.m_Normals[ni*3+1], mesh.m_Normals[ni*3+2]);
+
+        Vector4 skinned_position(0.0f);
+        Vector4 skinned_normal(0.0f);
+        for (uint32_t bi = 0; bi < 4; ++bi)
+        {
+            float weight = mesh.m_Weights[vi*4+bi];
+            if (weight) {
+                const Matrix4& influence = influences[mesh.m_BoneIndices[vi*4+bi]];
+                skinned_position += influence * position * weight;
+                skinned_normal += influence * normal * weight;
+            }
+        }
+        Vector4 expected_position = model_matrix * Point3(skinned_position.getXYZ());
+        Vector3 expected_normal = normalize((normal_matrix * skinned_normal.getXYZ()).getXYZ());
+
+        ASSERT_VEC3(expected_position, Vector3(data[i].x, data[i].y, data[i].z));
+        ASSERT_VEC3(expected_normal, Vector3(data[i].nx, data[i].ny, data[i].nz));
+    }
+
+    // Large enough for the batch to be split into several jobs
+    const uint32_t entry_count = 2048;
+    dmArray<dmRig::RigVertexDataEntry> entries;
+    entries.SetCapacity(entry_count);
+    entries.SetSize(entry_count);
+    dmArray<dmRig::RigModelVertex> batch_data;
+    batch_data.SetCapacity(entry_count * vertex_count);
+    batch_data.SetSize(entry_count * vertex_count);
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        dmRig::RigVertexDataEntry& entry = entries[i];
+        entry.m_Instance     = m_Instance;
+        entry.m_ModelMatrix  = Matrix4::translation(Vector3((float)i, 0.0f, 0.0f)) * model_matrix;
+        entry.m_NormalMatrix = transpose(inverse(entry.m_ModelMatrix));
+        entry.m_Color        = Vector4(1.0f);
+    }
+    ASSERT_EQ((void*)batch_data.End(), dmRig::GenerateVertexData(m_Context, entries.Begin(), entry_count, dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)batch_data.Begin()));
+    ASSERT_NE((dmThreadPool::HThreadPool)0, m_Context->m_VertexDataPool);
+
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        const dmRig::RigVertexDataEntry& entry = entries[i];
+        ASSERT_EQ(data + vertex_count, dmRig::GenerateVertexData(m_Context, m_Instance, entry.m_ModelMatrix, entry.m_NormalMatrix, entry.m_Color, dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)data));
+        ASSERT_EQ(0, memcmp(data, &batch_data[i * vertex_count], sizeof(data)));
+    }
+}
+
+// Instances in the same animation state share one pose evaluation, and
+// must end up with exactly the pose they would have evaluated themselves.
+TEST_F(RigInstanceTest, SharedPose)
+{
+    dmRig::HRigInstance second_instance = 0x0;
+    dmRig::InstanceCreateParams create_params = {0};
+    create_params.m_Context            = m_Context;
+    create_params.m_Instance           = &second_instance;
+    create_params.m_BindPose           = &m_BindPose;
+    create_params.m_Skeleton           = m_Skeleton;
+    create_params.m_MeshSet            = m_MeshSet;
+    create_params.m_AnimationSet       = m_AnimationSet;
+    create_params.m_TrackIdxToPose     = &m_TrackIdxToPose;
+    create_params.m_PoseIdxToInfluence = &m_PoseIdxToInfluence;
+    create_params.m_MeshId             = dmHashString64((const char*)"test");
+    create_params.m_DefaultAnimation   = dmHashString64((const char*)"");
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceCreate(create_params));
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(second_instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+
+    // Same state, the second instance copies the pose of the first
+    dmArray<dmTransform::Transform>& pose = *dmRig::GetPose(m_Instance);
+    dmArray<dmTransform::Transform>& second_pose = *dmRig::GetPose(second_instance);
+    ASSERT_NE(0u, m_Instance->m_PoseKey);
+    ASSERT_EQ(m_Instance->m_PoseKey, second_instance->m_PoseKey);
+    ASSERT_EQ(0, memcmp(pose.Begin(), second_pose.Begin(), pose.Size() * sizeof(dmTransform::Transform)));
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), second_pose[1].GetRotation());
+
+    dmRig::RigModelVertex data[4];
+    dmRig::RigModelVertex second_data[4];
+    ASSERT_EQ(data + 4, dmRig::GenerateVertexData(m_Context, m_Instance, Matrix4::identity(), Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)data));
+    ASSERT_EQ(second_data + 4, dmRig::GenerateVertexData(m_Context, second_instance, Matrix4::identity(), Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)second_data));
+    ASSERT_EQ(0, memcmp(data, second_data, sizeof(data)));
+
+    // Different cursors evaluate separately
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::SetCursor(second_instance, 0.0f, false));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_NE(m_Instance->m_PoseKey, second_instance->m_PoseKey);
+    ASSERT_VEC4(Quat::rotationZ((float)M_PI / 2.0f), second_pose[1].GetRotation());
+    ASSERT_VEC4(Quat::identity(), pose[1].GetRotation());
+
+    // Vertex data follows the pose even though the influence matrices were cached for the previous one
+    ASSERT_EQ(data + 4, dmRig::GenerateVertexData(m_Context, m_Instance, Matrix4::identity(), Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)data));
+    ASSERT_EQ(second_data + 4, dmRig::GenerateVertexData(m_Context, second_instance, Matrix4::identity(), Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)second_data));
+    ASSERT_NE(0, memcmp(data, second_data, sizeof(data)));
+
+    dmRig::InstanceDestroyParams destroy_params = {0};
+    destroy_params.m_Context = m_Context;
+    destroy_params.m_Instance = second_instance;
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceDestroy(destroy_params));
+}
+
+static void CountPoseCallback(void* user_data1, void* user_data2)
+{
+    ++*(uint32_t*)user_data1;
+}
+
+TEST_F(RigInstanceTest, OffscreenThrottling)
+{
+    m_Context->m_OffscreenUpdateInterval = 3;
+    m_Context->m_OffscreenPoseTimeout = 0;
+
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_TRUE(dmRig::GetVisible(m_Instance));
+
+    // Visible, evaluated every update
+    uint64_t pose_key = m_Instance->m_PoseKey;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+        ASSERT_NE(pose_key, m_Instance->m_PoseKey);
+        pose_key = m_Instance->m_PoseKey;
+    }
+
+    uint32_t pose_callbacks = 0;
+    m_Instance->m_PoseCallback = CountPoseCallback;
+    m_Instance->m_PoseCBUserData1 = &pose_callbacks;
+
+    // Not visible, the pose is evaluated every third update
+    dmRig::SetVisible(m_Context, m_Instance, false);
+    ASSERT_FALSE(dmRig::GetVisible(m_Instance));
+    uint32_t evaluated = 0;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        dmRig::Result result = dmRig::Update(m_Context, 1.0f);
+        if (pose_key != m_Instance->m_PoseKey) {
+            ASSERT_EQ(dmRig::RESULT_UPDATED_POSE, result);
+            pose_key = m_Instance->m_PoseKey;
+            ++evaluated;
+        } else {
+            ASSERT_EQ(dmRig::RESULT_OK, result);
+        }
+    }
+    ASSERT_EQ(2u, evaluated);
+    ASSERT_EQ(2u, pose_callbacks);
+
+    // Not visible for longer than the timeout, the pose is left as is while the cursor keeps moving
+    m_Context->m_OffscreenUpdateInterval = 1;
+    m_Context->m_OffscreenPoseTimeout = 7;
+    ASSERT_EQ(dmRig::RESULT_UPDATED_POSE, dmRig::Update(m_Context, 1.0f));
+    ASSERT_NE(pose_key, m_Instance->m_PoseKey);
+    pose_key = m_Instance->m_PoseKey;
+    float cursor = dmRig::GetCursor(m_Instance, false);
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_EQ(pose_key, m_Instance->m_PoseKey);
+    ASSERT_NE(cursor, dmRig::GetCursor(m_Instance, false));
+
+    // Drawing it anyway evaluates the pose before the vertex data is generated
+    dmRig::RigModelVertex data[4];
+    ASSERT_EQ(data + 4, dmRig::GenerateVertexData(m_Context, m_Instance, Matrix4::identity(), Matrix4::identity(), Vector4(1.0), dmRig::RIG_VERTEX_FORMAT_MODEL, (void*)data));
+    ASSERT_NE(pose_key, m_Instance->m_PoseKey);
+    pose_key = m_Instance->m_PoseKey;
+
+    // Making it visible brings the pose up to date with the cursor, and notifies the pose callback, right away
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_EQ(pose_key, m_Instance->m_PoseKey);
+    pose_callbacks = 0;
+    dmRig::SetVisible(m_Context, m_Instance, true);
+    ASSERT_NE(pose_key, m_Instance->m_PoseKey);
+    ASSERT_EQ(1u, pose_callbacks);
+
+    dmArray<dmTransform::Transform>& pose = *dmRig::GetPose(m_Instance);
+    uint32_t sample = (uint32_t)(dmRig::GetCursor(m_Instance, false) + 0.5f);
+    Quat expected_rotation_0 = sample == 2 ? Quat::rotationZ((float)M_PI / 2.0f) : Quat::identity();
+    Quat expected_rotation_1 = sample == 1 ? Quat::rotationZ((float)M_PI / 2.0f) : Quat::identity();
+    ASSERT_VEC4(expected_rotation_0, pose[0].GetRotation());
+    ASSERT_VEC4(expected_rotation_1, pose[1].GetRotation());
+}
+
 TEST_F(RigInstanceTest, AnimatedDrawOrder)
 {
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::SetMesh(m_Instance, dmHashString64("draw_order_skin")));
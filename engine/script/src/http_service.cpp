@@ -10,12 +10,16 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <dlib/array.h>
 #include <dlib/dstrings.h>
 #include <dlib/thread.h>
+#include <dlib/mutex.h>
+#include <dlib/condition_variable.h>
+#include <dlib/hash.h>
 #include <dlib/time.h>
 #include <dlib/message.h>
 #include <dlib/http_client.h>
@@ -24,9 +28,11 @@
 #include <dlib/sys.h>
 #include <dlib/uri.h>
 #include <dlib/math.h>
+#include <dlib/profile.h>
 #include <ddf/ddf.h>
 #include "http_ddf.h"
 #include "http_service.h"
+#include "http_service_private.h"
 
 namespace dmHttpService
 {
@@ -37,7 +43,8 @@ namespace dmHttpService
     // (Reason: Our HTTP service threads call getaddrinfo() which
     //  resulted in a writes outside the stack space inside libc.)
     const uint32_t THREAD_STACK_SIZE = 0x20000;
-    const uint32_t THREAD_COUNT = 4;
+    const uint32_t DEFAULT_THREAD_COUNT = 4;
+    const uint32_t MAX_THREAD_COUNT = 32;
     const uint32_t DEFAULT_RESPONSE_BUFFER_SIZE = 64 * 1024;
     const uint32_t DEFAULT_HEADER_BUFFER_SIZE = 16 * 1024;
 
@@ -48,16 +55,15 @@ namespace dmHttpService
     {
         dmThread::Thread      m_Thread;
         dmDNS::HChannel       m_DNSChannel;
-        dmMessage::HSocket    m_Socket;
         dmHttpClient::HClient m_Client;
         dmURI::Parts          m_CurrentURL;
+        uint64_t              m_CurrentHostHash;
         dmHttpDDF::HttpRequest*   m_Request;
         int                   m_Status;
         dmArray<char>         m_Response;
         dmArray<char>         m_Headers;
-        const HttpService*    m_Service;
+        HttpService*          m_Service;
         bool                  m_CacheFlusher;
-        volatile bool         m_Run;
     };
 
     struct HttpService
@@ -67,17 +73,34 @@ namespace dmHttpService
             m_Balancer = 0;
             m_Socket = 0;
             m_HttpCache = 0;
-            m_LoadBalanceCount = 0;
+            m_Mutex = 0;
+            m_Condition = 0;
+            memset(&m_Stats, 0, sizeof(m_Stats));
             m_Run = false;
+            m_Stop = false;
         }
         dmArray<Worker*>          m_Workers;
         dmThread::Thread          m_Balancer;
         dmMessage::HSocket        m_Socket;
         dmHttpCache::HCache       m_HttpCache;
-        int                       m_LoadBalanceCount;
+
+        // Requests waiting for a worker, oldest first. Idle workers take requests from
+        // the queue so that a slow request doesn't hold up requests queued after it.
+        // Protected by m_Mutex, as is m_Stats and m_Stop
+        dmArray<QueuedRequest>    m_Queue;
+        dmMutex::HMutex           m_Mutex;
+        dmConditionVariable::HConditionVariable m_Condition;
+        Stats                     m_Stats;
+        bool                      m_Stop;
+
         volatile bool             m_Run;
     };
 
+    Params::Params()
+    {
+        m_ThreadCount = DEFAULT_THREAD_COUNT;
+    }
+
     void HttpHeader(dmHttpClient::HResponse response, void* user_data, int status_code, const char* key, const char* value)
     {
         Worker* worker = (Worker*) user_data;
@@ -190,6 +213,16 @@ namespace dmHttpService
         }
     }
 
+    static uint64_t HashHost(const dmURI::Parts* url)
+    {
+        HashState64 hash_state;
+        dmHashInit64(&hash_state, false);
+        dmHashUpdateBuffer64(&hash_state, url->m_Scheme, strlen(url->m_Scheme));
+        dmHashUpdateBuffer64(&hash_state, url->m_Hostname, strlen(url->m_Hostname));
+        dmHashUpdateBuffer64(&hash_state, &url->m_Port, sizeof(url->m_Port));
+        return dmHashFinal64(&hash_state);
+    }
+
     void HandleRequest(Worker* worker, const dmMessage::URL* requester, dmHttpDDF::HttpRequest* request)
     {
         dmURI::Parts url;
@@ -227,8 +260,10 @@ namespace dmHttpService
             worker->m_Client = dmHttpClient::New(&params, url.m_Hostname, url.m_Port, strcmp(url.m_Scheme, "https") == 0);
             if (worker->m_Client) {
                 dmHttpClient::SetOptionInt(worker->m_Client, dmHttpClient::OPTION_MAX_GET_RETRIES, 1);
+                dmHttpClient::SetOptionInt(worker->m_Client, dmHttpClient::OPTION_ACCEPT_ENCODING, 1);
             }
             memcpy(&worker->m_CurrentURL, &url, sizeof(url));
+            worker->m_CurrentHostHash = HashHost(&url);
         }
 
         worker->m_Response.SetSize(0);
@@ -254,80 +289,150 @@ namespace dmHttpService
         }
     }
 
-    void Dispatch(dmMessage::Message *message, void* user_ptr)
+    static void FreeRequest(dmHttpDDF::HttpRequest* request)
     {
-        Worker* worker = (Worker*) user_ptr;
-        if (!worker->m_Run) {
-            return;
-        }
+        free((void*) request->m_Headers);
+        free((void*) request->m_Request);
+        free(request);
+    }
+
+    static void LogInvalidMessage(dmMessage::Message* message)
+    {
+        const dmMessage::URL* sender = &message->m_Sender;
+        const char* socket_name = dmMessage::GetSocketName(sender->m_Socket);
+        const char* path_name = dmHashReverseSafe64(sender->m_Path);
+        const char* fragment_name = dmHashReverseSafe64(sender->m_Fragment);
 
         if (message->m_Descriptor)
         {
             dmDDF::Descriptor* descriptor = (dmDDF::Descriptor*)message->m_Descriptor;
-
-            if (message->m_Descriptor == (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor)
-            {
-                dmHttpDDF::HttpRequest* request = (dmHttpDDF::HttpRequest*) &message->m_Data[0];
-                HandleRequest(worker, &message->m_Sender, request);
-                free((void*) request->m_Headers);
-                free((void*) request->m_Request);
-            }
-            else if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor)
-            {
-                worker->m_Run = false;
-            }
-            else
-            {
-                const dmMessage::URL* sender = &message->m_Sender;
-                const char* socket_name = dmMessage::GetSocketName(sender->m_Socket);
-                const char* path_name = dmHashReverseSafe64(sender->m_Path);
-                const char* fragment_name = dmHashReverseSafe64(sender->m_Fragment);
-                dmLogError("Unknown message '%s' sent to socket '%s' from %s:%s#%s.",
-                           descriptor->m_Name, HTTP_SOCKET_NAME, socket_name, path_name, fragment_name);
-            }
+            dmLogError("Unknown message '%s' sent to socket '%s' from %s:%s#%s.",
+                       descriptor->m_Name, HTTP_SOCKET_NAME, socket_name, path_name, fragment_name);
         }
         else
         {
-            const dmMessage::URL* sender = &message->m_Sender;
-            const char* socket_name = dmMessage::GetSocketName(sender->m_Socket);
-            const char* path_name = dmHashReverseSafe64(sender->m_Path);
-            const char* fragment_name = dmHashReverseSafe64(sender->m_Fragment);
-
             dmLogError("Only http messages can be sent to the '%s' socket. Message sent from: %s:%s#%s",
                        HTTP_SOCKET_NAME, socket_name, path_name, fragment_name);
         }
     }
 
+    // Moves the request from the message into the shared queue
     void LoadBalance(dmMessage::Message *message, void* user_ptr)
     {
         HttpService* service = (HttpService*) user_ptr;
         if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor) {
             service->m_Run = false;
-        } else {
-            dmMessage::URL r = message->m_Receiver;
-            r.m_Socket = service->m_Workers[service->m_LoadBalanceCount % THREAD_COUNT]->m_Socket;
-            dmMessage::Post(&message->m_Sender,
-                            &r,
-                            message->m_Id,
-                            message->m_UserData,
-                            message->m_Descriptor,
-                            message->m_Data,
-                            message->m_DataSize, 0);
-            service->m_LoadBalanceCount++;
+            return;
+        }
+        if (message->m_Descriptor != (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor) {
+            LogInvalidMessage(message);
+            return;
+        }
+
+        QueuedRequest queued;
+        queued.m_Requester = message->m_Sender;
+        queued.m_QueueTime = dmTime::GetTime();
+        queued.m_SkipCount = 0;
+        queued.m_Request = (dmHttpDDF::HttpRequest*) malloc(message->m_DataSize);
+        memcpy(queued.m_Request, &message->m_Data[0], message->m_DataSize);
+
+        // NOTE: The url is stored as an offset, see HandleRequest
+        dmURI::Parts url;
+        const char* url_string = (const char*) ((uintptr_t) queued.m_Request + (uintptr_t) queued.m_Request->m_Url);
+        queued.m_HostHash = dmURI::Parse(url_string, &url) == dmURI::RESULT_OK ? HashHost(&url) : 0;
+
+        DM_MUTEX_SCOPED_LOCK(service->m_Mutex);
+        if (service->m_Queue.Full()) {
+            service->m_Queue.OffsetCapacity(16);
+        }
+        service->m_Queue.Push(queued);
+        service->m_Stats.m_QueuedRequests++;
+        dmConditionVariable::Signal(service->m_Condition);
+    }
+
+    // The workers call this with m_Mutex held
+    void PopRequest(dmArray<QueuedRequest>& queue, uint64_t host_hash, QueuedRequest* out)
+    {
+        assert(!queue.Empty());
+
+        uint32_t index = 0;
+        if (host_hash != 0)
+        {
+            uint32_t lookahead = dmMath::Min(queue.Size(), HOST_AFFINITY_LOOKAHEAD);
+            for (uint32_t i = 0; i < lookahead; ++i)
+            {
+                if (queue[i].m_HostHash == host_hash)
+                {
+                    index = i;
+                    break;
+                }
+                if (queue[i].m_SkipCount >= HOST_AFFINITY_MAX_SKIPS)
+                {
+                    break;
+                }
+            }
+            for (uint32_t i = 0; i < index; ++i)
+            {
+                queue[i].m_SkipCount++;
+            }
         }
+
+        *out = queue[index];
+        // Keep the order of the remaining requests
+        memmove(&queue[index], &queue[index] + 1, (queue.Size() - index - 1) * sizeof(QueuedRequest));
+        queue.SetSize(queue.Size() - 1);
     }
 
     void Loop(void* arg)
     {
         Worker* worker = (Worker*) arg;
+        HttpService* service = worker->m_Service;
 
         uint64_t flush_period = 5 * 1000000U;
         uint64_t next_flush = dmTime::GetTime() + flush_period;
-        while (worker->m_Run)
+        while (true)
         {
-            dmMessage::DispatchBlocking(worker->m_Socket, &Dispatch, worker);
+            QueuedRequest queued;
+            uint64_t start;
+            {
+                DM_MUTEX_SCOPED_LOCK(service->m_Mutex);
+                while (!service->m_Stop && service->m_Queue.Empty())
+                {
+                    dmConditionVariable::Wait(service->m_Condition, service->m_Mutex);
+                }
+                if (service->m_Stop)
+                {
+                    break;
+                }
+                PopRequest(service->m_Queue, worker->m_Client ? worker->m_CurrentHostHash : 0, &queued);
+
+                start = dmTime::GetTime();
+                uint64_t queue_time = start - queued.m_QueueTime;
+                Stats& stats = service->m_Stats;
+                stats.m_QueuedRequests--;
+                stats.m_ActiveRequests++;
+                stats.m_TotalQueueTime += queue_time;
+                stats.m_MaxQueueTime = dmMath::Max(stats.m_MaxQueueTime, queue_time);
+                DM_COUNTER("Http.QueueTime (ms)", (uint32_t) (queue_time / 1000));
+            }
+
+            HandleRequest(worker, &queued.m_Requester, queued.m_Request);
+            FreeRequest(queued.m_Request);
+
+            {
+                DM_MUTEX_SCOPED_LOCK(service->m_Mutex);
+                uint64_t request_time = dmTime::GetTime() - start;
+                Stats& stats = service->m_Stats;
+                stats.m_ActiveRequests--;
+                stats.m_CompletedRequests++;
+                stats.m_TotalRequestTime += request_time;
+                stats.m_MaxRequestTime = dmMath::Max(stats.m_MaxRequestTime, request_time);
+                DM_COUNTER("Http.Requests", 1);
+                DM_COUNTER("Http.RequestTime (ms)", (uint32_t) (request_time / 1000));
+            }
+
             if (worker->m_CacheFlusher &&  dmTime::GetTime() > next_flush) {
-                dmHttpCache::Flush(worker->m_Service->m_HttpCache);
+                dmHttpCache::Flush(service->m_HttpCache);
                 next_flush = dmTime::GetTime() + flush_period;
             }
         }
@@ -341,7 +446,7 @@ namespace dmHttpService
         }
     }
 
-    HHttpService New()
+    HHttpService New(const Params* params)
     {
         HttpService* service = new HttpService;
 
@@ -364,22 +469,24 @@ namespace dmHttpService
             dmLogWarning("Unable to locate application support path for \"%s\": (%d)", "defold", sys_result);
         }
 
+        uint32_t thread_count = dmMath::Clamp(params->m_ThreadCount, 1U, MAX_THREAD_COUNT);
+
         service->m_Run = true;
+        service->m_Mutex = dmMutex::New();
+        service->m_Condition = dmConditionVariable::New();
+        service->m_Queue.SetCapacity(16);
         dmMessage::NewSocket(HTTP_SOCKET_NAME, &service->m_Socket);
-        service->m_Workers.SetCapacity(THREAD_COUNT);
-        for (uint32_t i = 0; i < THREAD_COUNT; ++i)
+        service->m_Workers.SetCapacity(thread_count);
+        for (uint32_t i = 0; i < thread_count; ++i)
         {
             Worker* worker = new Worker();
-            char tmp[128];
-            dmSnPrintf(tmp, sizeof(tmp), "@__http_worker_%d", i);
-            dmMessage::NewSocket(tmp, &worker->m_Socket);
             worker->m_Client = 0;
             memset(&worker->m_CurrentURL, 0, sizeof(worker->m_CurrentURL));
+            worker->m_CurrentHostHash = 0;
             worker->m_Request = 0;
             worker->m_Status = 0;
             worker->m_Service = service;
             worker->m_CacheFlusher = i == 0;
-            worker->m_Run = true;
             service->m_Workers.Push(worker);
 
             if (dmDNS::NewChannel(&worker->m_DNSChannel) != dmDNS::RESULT_OK)
@@ -402,19 +509,34 @@ namespace dmHttpService
         return http_service->m_Socket;
     }
 
+    void GetStats(HHttpService http_service, Stats* stats)
+    {
+        DM_MUTEX_SCOPED_LOCK(http_service->m_Mutex);
+        *stats = http_service->m_Stats;
+    }
+
     void Delete(HHttpService http_service)
     {
         dmMessage::URL url;
         url.m_Socket = http_service->m_Socket;
         dmMessage::Post(0, &url, 0, 0, (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor, 0, 0, 0);
-        for (uint32_t i = 0; i < THREAD_COUNT; ++i)
+        dmThread::Join(http_service->m_Balancer);
+
+        {
+            DM_MUTEX_SCOPED_LOCK(http_service->m_Mutex);
+            http_service->m_Stop = true;
+            dmConditionVariable::Broadcast(http_service->m_Condition);
+        }
+
+        uint32_t thread_count = http_service->m_Workers.Size();
+        for (uint32_t i = 0; i < thread_count; ++i)
         {
-            dmHttpService::Worker* worker = http_service->m_Workers[i];
-            url.m_Socket = worker->m_Socket;
             dmDNS::StopChannel(http_service->m_Workers[i]->m_DNSChannel);
-            dmMessage::Post(0, &url, 0, 0, (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor, 0, 0, 0);
+        }
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            dmHttpService::Worker* worker = http_service->m_Workers[i];
             dmThread::Join(worker->m_Thread);
-            dmMessage::DeleteSocket(worker->m_Socket);
             dmDNS::DeleteChannel(worker->m_DNSChannel);
             if (worker->m_Client)
             {
@@ -422,9 +544,17 @@ namespace dmHttpService
             }
             delete worker;
         }
-        dmThread::Join(http_service->m_Balancer);
+
+        // Requests that never got to a worker
+        for (uint32_t i = 0; i < http_service->m_Queue.Size(); ++i)
+        {
+            FreeRequest(http_service->m_Queue[i].m_Request);
+        }
+
         dmMessage::DeleteSocket(http_service->m_Socket);
         dmHttpCache::Close(http_service->m_HttpCache);
+        dmConditionVariable::Delete(http_service->m_Condition);
+        dmMutex::Delete(http_service->m_Mutex);
         delete http_service;
     }
 
@@ -13,12 +13,45 @@
 #ifndef DM_HTTP_SERVICE
 #define DM_HTTP_SERVICE
 
+#include <stdint.h>
+
 namespace dmHttpService
 {
     typedef struct HttpService* HHttpService;
 
-    HHttpService New();
+    /**
+     * Http service parameters
+     */
+    struct Params
+    {
+        Params();
+
+        /// Number of worker threads, ie the maximum number of concurrent requests. Default is 4
+        uint32_t m_ThreadCount;
+    };
+
+    /**
+     * Http service statistics. Times are in microseconds
+     */
+    struct Stats
+    {
+        /// Requests waiting for a worker
+        uint32_t m_QueuedRequests;
+        /// Requests currently being handled by a worker
+        uint32_t m_ActiveRequests;
+        /// Number of handled requests
+        uint32_t m_CompletedRequests;
+        /// Total and max time requests have waited for a worker
+        uint64_t m_TotalQueueTime;
+        uint64_t m_MaxQueueTime;
+        /// Total and max time from a worker taking a request until the response is sent
+        uint64_t m_TotalRequestTime;
+        uint64_t m_MaxRequestTime;
+    };
+
+    HHttpService New(const Params* params);
     dmMessage::HSocket GetSocket(HHttpService http_service);
+    void GetStats(HHttpService http_service, Stats* stats);
     void Delete(HHttpService http_service);
 
 }  // namespace dmHttpService
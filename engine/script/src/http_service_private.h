@@ -0,0 +1,55 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_HTTP_SERVICE_PRIVATE_H
+#define DM_HTTP_SERVICE_PRIVATE_H
+
+#include <stdint.h>
+#include <dlib/array.h>
+#include <dlib/message.h>
+
+namespace dmHttpDDF
+{
+    struct HttpRequest;
+}
+
+namespace dmHttpService
+{
+    // Number of queued requests a worker looks through for one to the host it is already connected to
+    const uint32_t HOST_AFFINITY_LOOKAHEAD = 8;
+    // Number of times a queued request can be passed over for requests to the host a worker is connected to
+    const uint32_t HOST_AFFINITY_MAX_SKIPS = 4;
+
+    struct QueuedRequest
+    {
+        dmMessage::URL           m_Requester;
+        // Hash of scheme, host and port of the request url
+        uint64_t                 m_HostHash;
+        uint64_t                 m_QueueTime;
+        // Number of times later requests were taken before this one, see PopRequest
+        uint32_t                 m_SkipCount;
+        // Copy of the message data, freed by the worker
+        dmHttpDDF::HttpRequest*  m_Request;
+    };
+
+    /**
+     * Removes the request a worker should handle next from the queue. This is the oldest request,
+     * or a request a bit further back in the queue if it goes to the host the worker is connected to.
+     * A request is passed over at most HOST_AFFINITY_MAX_SKIPS times so it can't be starved.
+     * @param queue Queued requests, oldest first. Must not be empty
+     * @param host_hash Host hash of the worker's connection, or 0 if it isn't connected
+     * @param out The removed request
+     */
+    void PopRequest(dmArray<QueuedRequest>& queue, uint64_t host_hash, QueuedRequest* out);
+}
+
+#endif // DM_HTTP_SERVICE_PRIVATE_H
@@ -279,6 +279,48 @@ namespace dmScript
      */
     void PushTable(lua_State*L, const char* data, uint32_t data_size);
 
+    /**
+     * Callback for writing serialized table data to a stream
+     * @param context User context
+     * @param data Data to write
+     * @param size Number of bytes to write
+     * @return true if all data was written
+     */
+    typedef bool (*TableWriteFunction)(void* context, const void* data, uint32_t size);
+
+    /**
+     * Callback for reading serialized table data from a stream
+     * @param context User context
+     * @param data Buffer to read into
+     * @param size Number of bytes requested
+     * @return Number of bytes read, which may be fewer than requested. 0 signals the end of the stream.
+     */
+    typedef uint32_t (*TableReadFunction)(void* context, void* data, uint32_t size);
+
+    /**
+     * Serialize a table to a stream. The output is identical to that of CheckTable, but the
+     * size is not limited by a buffer and the data is written in small chunks.
+     * Errors are caught, on failure the error message is pushed to the stack.
+     * @param L Lua state
+     * @param write_fn Function receiving the serialized data
+     * @param context User context passed to write_fn
+     * @param index Index of the table
+     * @param out_size Total number of bytes written. May be 0
+     * @return true on success, false if an error message was pushed
+     */
+    bool CheckTableStream(lua_State* L, TableWriteFunction write_fn, void* context, int index, uint32_t* out_size);
+
+    /**
+     * Push a table serialized by CheckTable or CheckTableStream, read from a stream.
+     * Errors are caught, on failure the error message is pushed instead of the table.
+     * In both cases the stack is increased by 1.
+     * @param L Lua state
+     * @param read_fn Function providing the serialized data
+     * @param context User context passed to read_fn
+     * @return true on success, false if an error message was pushed
+     */
+    bool PushTableStream(lua_State* L, TableReadFunction read_fn, void* context);
+
     /**
      * Check if the value at #index is a hash
      * @param L Lua state
@@ -21,6 +21,7 @@
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/profile.h>
 #include <dlib/uri.h>
 
 #include "script.h"
@@ -50,6 +51,8 @@ namespace dmScript
 
     dmHttpService::HHttpService g_Service = 0;
     int g_ServiceRefCount = 0;
+    // The context that publishes the service stats to the profiler, once per frame
+    HContext g_StatsContext = 0;
     uint64_t g_Timeout = 0;
 
     /*# perform a HTTP/HTTPS request
@@ -72,8 +75,8 @@ namespace dmScript
      * : [type:table] The response data. Contains the fields:
      *
      * - [type:number] `status`: the status of the response
-     * - [type:string] `response`: the response data
-     * - [type:table] `headers`: all the returned headers
+     * - [type:string] `response`: the response data. Data sent with gzip or deflate content encoding is decoded, unless an `Accept-Encoding` header is set in `headers`
+     * - [type:table] `headers`: all the returned headers. The `content-encoding` and `content-length` headers of decoded data are left out
      *
      * @param [headers] [type:table] optional table with custom headers
      * @param [post_data] [type:string] optional data to send
@@ -235,6 +238,15 @@ namespace dmScript
         g_Timeout = timeout;
     }
 
+    // Used for unit test
+    bool GetHttpServiceStats(dmHttpService::Stats* stats)
+    {
+        if (g_Service == 0)
+            return false;
+        dmHttpService::GetStats(g_Service, stats);
+        return true;
+    }
+
     static void HttpInitialize(HContext context)
     {
         lua_State* L = GetLuaState(context);
@@ -243,7 +255,11 @@ namespace dmScript
         int top = lua_gettop(L);
 
         if (g_Service == 0) {
-            g_Service = dmHttpService::New();
+            dmHttpService::Params params;
+            if (config_file) {
+                params.m_ThreadCount = dmConfigFile::GetInt(config_file, "network.http_thread_count", params.m_ThreadCount);
+            }
+            g_Service = dmHttpService::New(&params);
             dmScript::RegisterDDFDecoder(dmHttpDDF::HttpResponse::m_DDFDescriptor, &HttpResponseDecoder);
         }
         g_ServiceRefCount++;
@@ -259,8 +275,23 @@ namespace dmScript
         assert(top == lua_gettop(L));
     }
 
+    static void HttpUpdate(HContext context)
+    {
+        if (g_StatsContext == 0)
+            g_StatsContext = context;
+        if (g_StatsContext != context || g_Service == 0)
+            return;
+
+        dmHttpService::Stats stats;
+        dmHttpService::GetStats(g_Service, &stats);
+        DM_COUNTER("Http.Queued", stats.m_QueuedRequests);
+        DM_COUNTER("Http.Active", stats.m_ActiveRequests);
+    }
+
     static void HttpFinalize(HContext context)
     {
+        if (g_StatsContext == context)
+            g_StatsContext = 0;
         assert(g_ServiceRefCount > 0);
         g_ServiceRefCount--;
         if (g_ServiceRefCount == 0) {
@@ -273,7 +304,7 @@ namespace dmScript
     {
         static ScriptExtension sl;
         sl.Initialize = HttpInitialize;
-        sl.Update = 0x0;
+        sl.Update = HttpUpdate;
         sl.Finalize = HttpFinalize;
         sl.NewScriptWorld = 0x0;
         sl.DeleteScriptWorld = 0x0;
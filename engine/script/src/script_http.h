@@ -13,6 +13,11 @@
 #ifndef DM_SCRIPT_HTTP_H
 #define DM_SCRIPT_HTTP_H
 
+namespace dmHttpService
+{
+    struct Stats;
+}
+
 namespace dmScript
 {
     typedef struct Context* HContext;
@@ -20,6 +25,8 @@ namespace dmScript
     void InitializeHttp(HContext context);
 
     void SetHttpRequestTimeout(uint64_t timeout);
+
+    bool GetHttpServiceStats(dmHttpService::Stats* stats);
 }
 
 #endif // DM_SCRIPT_HTTP_H
@@ -27,9 +27,11 @@
 #include <direct.h>
 #endif
 
+#include <dlib/array.h>
 #include <dlib/dstrings.h>
 #include <dlib/sys.h>
 #include <dlib/log.h>
+#include <dlib/math.h>
 #include <dlib/socket.h>
 #include <dlib/path.h>
 #include <resource/resource.h>
@@ -48,14 +50,6 @@ extern "C"
 namespace dmScript
 {
 
-const uint32_t MAX_BUFFER_SIZE = 512 * 1024;
-
-union SaveLoadBuffer
-{
-    uint32_t m_alignment; // This alignment is required for js-web
-    char m_buffer[MAX_BUFFER_SIZE]; // Resides in .bss
-} g_saveload;
-
 #define LIB_NAME "sys"
 
     /*# System API documentation
@@ -71,9 +65,8 @@ union SaveLoadBuffer
     /*# saves a lua table to a file stored on disk
      * The table can later be loaded by <code>sys.load</code>.
      * Use <code>sys.get_save_file</code> to obtain a valid location for the file.
-     * Internally, this function uses a workspace buffer sized output file sized 512kb.
-     * This size reflects the output file size which must not exceed this limit.
-     * Additionally, the total number of rows that any one table may contain is limited to 65536
+     * The table is streamed to the file while it is serialized, so there is no limit on the file size.
+     * The total number of rows that any one table may contain is limited to 65536
      * (i.e. a 16 bit range). When tables are used to represent arrays, the values of
      * keys are permitted to fall within a 32 bit range, supporting sparse arrays, however
      * the limit on the total number of rows remains in effect.
@@ -96,12 +89,20 @@ union SaveLoadBuffer
      * ```
      */
 
+    static bool SaveTableWrite(void* context, const void* data, uint32_t size)
+    {
+        return fwrite(data, 1, size, (FILE*) context) == size;
+    }
+
+    static uint32_t LoadTableRead(void* context, void* data, uint32_t size)
+    {
+        return (uint32_t) fread(data, 1, size, (FILE*) context);
+    }
+
 #if !defined(__EMSCRIPTEN__)
     int Sys_Save(lua_State* L)
     {
         luaL_checktype(L, 2, LUA_TTABLE);
-        uint32_t n_used = CheckTable(L, g_saveload.m_buffer, sizeof(g_saveload.m_buffer), 2);
-
         const char* filename = luaL_checkstring(L, 1);
         char tmp_filename[DMPATH_MAX_PATH];
         // The counter and hash are there to make the files unique enough to avoid that the user
@@ -117,8 +118,14 @@ union SaveLoadBuffer
         FILE* file = fopen(tmp_filename, "wb");
         if (file != 0x0)
         {
-            bool result = fwrite(g_saveload.m_buffer, 1, n_used, file) == n_used;
-            result = (fclose(file) == 0) && result;
+            if (!CheckTableStream(L, SaveTableWrite, file, 2, 0))
+            {
+                // Table error, or the file could not be written. The error message is on the stack.
+                fclose(file);
+                dmSys::Unlink(tmp_filename);
+                return lua_error(L);
+            }
+            bool result = fclose(file) == 0;
             if (result)
             {
 #if defined(_WIN32)
@@ -140,25 +147,53 @@ union SaveLoadBuffer
 
 #else // __EMSCRIPTEN__
 
+    static bool SaveTableWriteMemory(void* context, const void* data, uint32_t size)
+    {
+        dmArray<char>* buffer = (dmArray<char>*) context;
+        if (buffer->Remaining() < size)
+        {
+            buffer->OffsetCapacity(dmMath::Max(size, buffer->Capacity()));
+        }
+        buffer->PushArray((const char*) data, size);
+        return true;
+    }
+
     int Sys_Save(lua_State* L)
     {
         const char* filename = luaL_checkstring(L, 1);
         luaL_checktype(L, 2, LUA_TTABLE);
-        uint32_t n_used = CheckTable(L, g_saveload.m_buffer, sizeof(g_saveload.m_buffer), 2);
+
+        // There is no atomic rename here, so the table is serialized to memory before the file is
+        // opened, to keep an invalid table from destroying the existing save file.
+        // The buffer is freed explicitly since raising a Lua error skips its destructor.
+        dmArray<char> buffer;
+        buffer.SetCapacity(4096);
+        if (!CheckTableStream(L, SaveTableWriteMemory, &buffer, 2, 0))
+        {
+            buffer.SetCapacity(0);
+            // The error message is on the stack
+            return lua_error(L);
+        }
+
+        bool result = false;
         FILE* file = fopen(filename, "wb");
         if (file != 0x0)
         {
-            bool result = fwrite(g_saveload.m_buffer, 1, n_used, file) == n_used;
+            result = fwrite(buffer.Begin(), 1, buffer.Size(), file) == buffer.Size();
             result = (fclose(file) == 0) && result;
-            if (result)
+            if (!result)
             {
-                lua_pushboolean(L, result);
-                return 1;
+                dmSys::Unlink(filename);
             }
+        }
+        buffer.SetCapacity(0);
 
-            dmSys::Unlink(filename);
+        if (!result)
+        {
+            return luaL_error(L, "Could not write to the file %s.", filename);
         }
-        return luaL_error(L, "Could not write to the file %s.", filename);
+        lua_pushboolean(L, result);
+        return 1;
     }
 
 #endif
@@ -190,22 +225,19 @@ union SaveLoadBuffer
             lua_newtable(L);
             return 1;
         }
-        size_t nread = fread(g_saveload.m_buffer, 1, sizeof(g_saveload.m_buffer), file);
-        bool file_size_ok = feof(file) != 0;
-        bool result = ferror(file) == 0 && file_size_ok;
+        bool result = PushTableStream(L, LoadTableRead, file);
+        bool read_error = ferror(file) != 0;
         fclose(file);
-        if (result)
+        if (read_error)
         {
-            PushTable(L, g_saveload.m_buffer, nread);
-            return 1;
+            return luaL_error(L, "Could not read from the file %s.", filename);
         }
-        else
+        if (!result)
         {
-            if(file_size_ok)
-                return luaL_error(L, "Could not read from the file %s.", filename);
-            else
-                return luaL_error(L, "File size exceeding size limit of %dkb: %s.", MAX_BUFFER_SIZE/1024, filename);
+            // The error message was pushed instead of the table
+            return lua_error(L);
         }
+        return 1;
     }
 
     /*# gets the save-file path
@@ -14,6 +14,7 @@
 #include <string.h>
 #include <dlib/log.h>
 #include <dlib/dstrings.h>
+#include <dlib/math.h>
 #include <dlib/static_assert.h>
 #include "script.h"
 #include "script_private.h"
@@ -230,76 +231,131 @@ namespace dmScript
         return buffer;
     }
 
-    // When storing/packing lua data to a byte array, we now use the binary lua string interface
-    static uint32_t SaveTSTRING(lua_State* L, int index, char* buffer, uint32_t buffer_size, const char* buffer_end, uint32_t count)
+    /*
+     * Destination of a table being serialized. Either a fixed size buffer (m_Write == 0), or a chunk
+     * buffer that is flushed to m_Write when full. In the latter case the chunk start is offset so
+     * that the address alignment of the cursor always matches its offset in the stream, which lets
+     * aligned values be written in place.
+     */
+    struct TableWriter
     {
-        size_t value_len = 0;
-        const char* value = lua_tolstring(L, index, &value_len);
-        uint32_t total_size = value_len + sizeof(uint32_t);
-        if (buffer_end - buffer < (intptr_t)total_size)
+        char*               m_Base;
+        char*               m_Start;
+        char*               m_Cursor;
+        char*               m_End;
+        uint32_t            m_Offset;       // Stream offset of m_Start
+        uint32_t            m_BufferSize;   // Used in error messages
+        TableWriteFunction  m_Write;
+        void*               m_Context;
+        int                 m_Index;
+        uint32_t            m_Size;         // Total number of bytes written
+    };
+
+    // Largest element, besides strings, written in one go (sub type, alignment and a Matrix4)
+    static const uint32_t TABLE_MAX_ELEMENT_SIZE = 1 + sizeof(float) + sizeof(float) * 16;
+    static const uint32_t TABLE_STREAM_CHUNK_SIZE = 4096;
+
+    static uint32_t GetOffset(const TableWriter& writer)
+    {
+        return writer.m_Offset + (uint32_t)(writer.m_Cursor - writer.m_Start);
+    }
+
+    static void Flush(lua_State* L, TableWriter& writer)
+    {
+        uint32_t size = (uint32_t)(writer.m_Cursor - writer.m_Start);
+        if (size > 0 && !writer.m_Write(writer.m_Context, writer.m_Start, size))
         {
-            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at '%s' for element #%d", buffer_size, value, count);
+            luaL_error(L, "failed to write table data");
         }
-
-        uint32_t len = (uint32_t)value_len;
-        memcpy(buffer, &len, sizeof(uint32_t));
-        buffer += sizeof(uint32_t);
-        memcpy(buffer, value, value_len);
-        return total_size;
+        writer.m_Offset += size;
+        writer.m_Start = writer.m_Base + (writer.m_Offset & (sizeof(float)-1));
+        writer.m_Cursor = writer.m_Start;
     }
 
-    // When loading older save games, we will use the old unpack method (with truncated c strings)
-    static uint32_t LoadOldTSTRING(lua_State* L, const char* buffer, const char* buffer_end, uint32_t count, PushTableLogger& logger)
+    // Make room for at least size bytes when streaming. Writes to a fixed size buffer are checked against m_End.
+    static void Reserve(lua_State* L, TableWriter& writer, uint32_t size)
     {
-        uint32_t total_size = strlen(buffer) + 1;
-        if (buffer_end - buffer < (intptr_t)total_size)
+        if (writer.m_Write != 0x0 && writer.m_End - writer.m_Cursor < (intptr_t)size)
         {
-            char log_str[PUSH_TABLE_LOGGER_STR_SIZE];
-            PushTableLogPrint(logger, log_str);
-            luaL_error(L, "Reading outside of buffer at element #%d (string): wanted to read: %d bytes left: %d [BufStart: %p, BufSize: %lu]\n'%s'", count, total_size, (int)(buffer_end - buffer), logger.m_BufferStart, logger.m_BufferSize, log_str);
+            Flush(L, writer);
         }
+    }
 
-        lua_pushstring(L, buffer);
-        return total_size;
+    static void WriteBytes(lua_State* L, TableWriter& writer, const char* data, uint32_t size)
+    {
+        while (size > 0)
+        {
+            if (writer.m_Cursor == writer.m_End)
+            {
+                Flush(L, writer);
+            }
+            uint32_t n = dmMath::Min(size, (uint32_t)(writer.m_End - writer.m_Cursor));
+            memcpy(writer.m_Cursor, data, n);
+            writer.m_Cursor += n;
+            data += n;
+            size -= n;
+        }
     }
 
-    // When loading/unpacking messages/save games, we use pascal strings, and the Lua binary string api
-    static uint32_t LoadTSTRING(lua_State* L, const char* buffer, const char* buffer_end, uint32_t count, PushTableLogger& logger)
+    // When storing/packing lua data to a byte array, we now use the binary lua string interface
+    static void SaveTSTRING(lua_State* L, int index, TableWriter& writer, uint32_t count)
     {
-        uint32_t len;
-        memcpy(&len, buffer, sizeof(uint32_t));
-        size_t value_len = (size_t)len;
+        size_t value_len = 0;
+        const char* value = lua_tolstring(L, index, &value_len);
         uint32_t total_size = value_len + sizeof(uint32_t);
-        if (buffer_end - buffer < (intptr_t)total_size)
+        if (writer.m_Write == 0x0 && writer.m_End - writer.m_Cursor < (intptr_t)total_size)
         {
-            char log_str[PUSH_TABLE_LOGGER_STR_SIZE];
-            PushTableLogPrint(logger, log_str);
-            char str[512];
-            dmSnPrintf(str, sizeof(str), "Reading outside of buffer at element #%d (string) [value_len=%lu]: wanted to read: %d bytes left: %d [BufStart: %p, BufSize: %lu]\n'%s'", count, value_len, total_size, (uint32_t)(buffer_end - buffer), logger.m_BufferStart, logger.m_BufferSize, log_str);
-            luaL_error(L, "%s", str);
+            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at '%s' for element #%d", writer.m_BufferSize, value, count);
         }
 
-        lua_pushlstring(L, buffer + sizeof(uint32_t), value_len);
-        return total_size;
+        uint32_t len = (uint32_t)value_len;
+        WriteBytes(L, writer, (const char*)&len, sizeof(uint32_t));
+        WriteBytes(L, writer, value, len);
     }
 
-    uint32_t DoCheckTable(lua_State* L, const TableHeader& header, const char* original_buffer, char* buffer, uint32_t buffer_size, int index)
+    static uint32_t DoCheckTable(lua_State* L, const TableHeader& header, TableWriter& writer, int index)
     {
         int top = lua_gettop(L);
         (void)top;
 
-        char* buffer_start = buffer;
-        char* buffer_end = buffer + buffer_size;
+        // The cursor and end live in the writer since they move when a streaming writer is flushed
+        char*& buffer = writer.m_Cursor;
+        char* const& buffer_end = writer.m_End;
+        const uint32_t buffer_size = writer.m_BufferSize;
+        const uint32_t start_offset = GetOffset(writer);
+
         luaL_checktype(L, index, LUA_TTABLE);
         lua_pushvalue(L, index);
-        lua_pushnil(L);
 
-        if (buffer_size < 2)
+        // The count precedes the elements. When streaming, the elements are counted up front
+        // since the count can't be patched in afterwards.
+        char* count_ptr = 0x0;
+        if (writer.m_Write != 0x0)
         {
-            luaL_error(L, "table too large");
+            uint32_t n = 0;
+            lua_pushnil(L);
+            while (lua_next(L, -2) != 0)
+            {
+                lua_pop(L, 1);
+                if (++n > 0xffff)
+                {
+                    luaL_error(L, "too many values in table, %d is max", 0xffff);
+                }
+            }
+            uint16_t n16 = (uint16_t)n;
+            WriteBytes(L, writer, (const char*)&n16, sizeof(uint16_t));
         }
-        // Make room for count (2 bytes)
-        buffer += 2;
+        else
+        {
+            if (buffer_end - buffer < 2)
+            {
+                luaL_error(L, "table too large");
+            }
+            // Make room for count (2 bytes)
+            count_ptr = buffer;
+            buffer += 2;
+        }
+        lua_pushnil(L);
 
         uint16_t count = 0;
         while (lua_next(L, -2) != 0)
@@ -312,6 +368,9 @@ namespace dmScript
 
             count++;
 
+            // Room for the key tags, an encoded index (at most 5 bytes) and any fixed size value
+            Reserve(L, writer, 2 + 5 + 1 + TABLE_MAX_ELEMENT_SIZE);
+
             int key_type = lua_type(L, -2);
             int value_type = lua_type(L, -1);
             if (key_type != LUA_TSTRING && key_type != LUA_TNUMBER)
@@ -328,7 +387,8 @@ namespace dmScript
             {
                 (*buffer++) = (char) LUA_TSTRING;
                 (*buffer++) = (char) value_type;
-                buffer += SaveTSTRING(L, -2, buffer, buffer_size, buffer_end, count);
+                SaveTSTRING(L, -2, writer, count);
+                Reserve(L, writer, 1 + TABLE_MAX_ELEMENT_SIZE);
             }
             else if (key_type == LUA_TNUMBER)
             {
@@ -353,7 +413,7 @@ namespace dmScript
                 case LUA_TNUMBER:
                 {
                     // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
+                    intptr_t offset = GetOffset(writer);
                     intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
                     intptr_t align_size = aligned_buffer - (intptr_t) offset;
 
@@ -386,7 +446,7 @@ namespace dmScript
 
                 case LUA_TSTRING:
                 {
-                    buffer += SaveTSTRING(L, -1, buffer, buffer_size, buffer_end, count);
+                    SaveTSTRING(L, -1, writer, count);
                 }
                 break;
 
@@ -400,7 +460,7 @@ namespace dmScript
                     char* sub_type = buffer++;
 
                     // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
+                    intptr_t offset = GetOffset(writer);
                     intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
                     intptr_t align_size = aligned_buffer - (intptr_t) offset;
 
@@ -516,8 +576,7 @@ namespace dmScript
 
                 case LUA_TTABLE:
                 {
-                    uint32_t n_used = DoCheckTable(L, header, original_buffer, buffer, buffer_end - buffer, -1);
-                    buffer += n_used;
+                    DoCheckTable(L, header, writer, -1);
                 }
                 break;
 
@@ -530,36 +589,89 @@ namespace dmScript
         }
         lua_pop(L, 1);
 
-        memcpy(buffer_start, &count, sizeof(uint16_t));
+        if (count_ptr != 0x0)
+        {
+            memcpy(count_ptr, &count, sizeof(uint16_t));
+        }
 
         assert(top == lua_gettop(L));
-        return buffer - buffer_start;
+        return GetOffset(writer) - start_offset;
     }
 
     uint32_t CheckTable(lua_State* L, char* buffer, uint32_t buffer_size, int index)
     {
         if (buffer_size > sizeof(TableHeader)) {
-            char* original_buffer = buffer;
-
             TableHeader* header = (TableHeader*)buffer;
             header->m_Magic = TABLE_MAGIC;
             header->m_Version = TABLE_VERSION_CURRENT;
-            buffer += sizeof(TableHeader);
-            buffer_size -= (buffer - original_buffer);
 
-            return sizeof(TableHeader) + DoCheckTable(L, *header, original_buffer, buffer, buffer_size, index);
+            TableWriter writer;
+            memset(&writer, 0, sizeof(writer));
+            writer.m_Base = buffer;
+            writer.m_Start = buffer;
+            writer.m_Cursor = buffer + sizeof(TableHeader);
+            writer.m_End = buffer + buffer_size;
+            writer.m_BufferSize = buffer_size - sizeof(TableHeader);
+
+            return sizeof(TableHeader) + DoCheckTable(L, *header, writer, index);
         } else {
             luaL_error(L, "buffer (%d bytes) too small for header (%zu bytes)", buffer_size, sizeof(TableHeader));
             return 0;
         }
     }
 
+    static int ProtectedCheckTableStream(lua_State* L)
+    {
+        TableWriter* writer = (TableWriter*)lua_touserdata(L, 1);
+        TableHeader header;
+        header.m_Magic = TABLE_MAGIC;
+        header.m_Version = TABLE_VERSION_CURRENT;
+        WriteBytes(L, *writer, (const char*)&header, sizeof(TableHeader));
+        DoCheckTable(L, header, *writer, 2);
+        Flush(L, *writer);
+        writer->m_Size = writer->m_Offset;
+        return 0;
+    }
+
+    bool CheckTableStream(lua_State* L, TableWriteFunction write_fn, void* context, int index, uint32_t* out_size)
+    {
+        char chunk[TABLE_STREAM_CHUNK_SIZE];
+
+        TableWriter writer;
+        memset(&writer, 0, sizeof(writer));
+        writer.m_Base = chunk;
+        writer.m_Start = chunk;
+        writer.m_Cursor = chunk;
+        writer.m_End = chunk + sizeof(chunk);
+        writer.m_BufferSize = sizeof(chunk);
+        writer.m_Write = write_fn;
+        writer.m_Context = context;
+
+        if (index < 0 && index > LUA_REGISTRYINDEX)
+        {
+            index = lua_gettop(L) + index + 1;
+        }
+        lua_pushcfunction(L, ProtectedCheckTableStream);
+        lua_pushlightuserdata(L, &writer);
+        lua_pushvalue(L, index);
+        if (lua_pcall(L, 2, 0, 0) != 0)
+        {
+            return false;
+        }
+        if (out_size)
+        {
+            *out_size = writer.m_Size;
+        }
+        return true;
+    }
+
     static const char* ReadHeader(const char* buffer, TableHeader& header)
     {
-        TableHeader* buffered_header = (TableHeader*)buffer;
-        if (TABLE_MAGIC == buffered_header->m_Magic) {
+        TableHeader buffered_header;
+        memcpy(&buffered_header, buffer, sizeof(TableHeader));
+        if (TABLE_MAGIC == buffered_header.m_Magic) {
             buffer += sizeof(TableHeader);
-            header = *buffered_header;
+            header = buffered_header;
         }
         return buffer;
     }
@@ -666,6 +778,126 @@ namespace dmScript
         }
     }
 
+    /*
+     * Source of a serialized table. Either a memory buffer (m_Read == 0), or a window into a stream
+     * that is refilled from m_Read on demand. Like the writer, the window start is offset so that
+     * the address alignment of the cursor matches its offset in the stream.
+     */
+    struct TableReader
+    {
+        const char*         m_Start;
+        const char*         m_Cursor;
+        const char*         m_End;
+        uint32_t            m_Offset;       // Stream offset of m_Start
+        TableReadFunction   m_Read;
+        void*               m_Context;
+        char*               m_Window;
+        uint32_t            m_WindowSize;
+        bool                m_EndOfStream;
+    };
+
+    // Extra zeroed bytes after the stream window. Values are bounds checked after they are read,
+    // this keeps such reads inside the allocation.
+    static const uint32_t TABLE_STREAM_WINDOW_PADDING = 128;
+    static const uint32_t TABLE_STREAM_MAX_STRING_SIZE = 0x40000000;
+
+    static uint32_t GetOffset(const TableReader& reader)
+    {
+        return reader.m_Offset + (uint32_t)(reader.m_Cursor - reader.m_Start);
+    }
+
+    // Try to make at least size bytes available at the cursor when streaming. May return with
+    // fewer bytes available at the end of the stream, which the regular bounds checks report.
+    static void Fill(TableReader& reader, uint32_t size)
+    {
+        uint32_t available = (uint32_t)(reader.m_End - reader.m_Cursor);
+        if (reader.m_Read == 0x0 || available >= size || reader.m_EndOfStream)
+        {
+            return;
+        }
+
+        uint32_t offset = GetOffset(reader);
+        uint32_t align = offset & (sizeof(float)-1);
+        uint32_t required = dmMath::Max(align + size, TABLE_STREAM_CHUNK_SIZE);
+        if (required > reader.m_WindowSize)
+        {
+            char* window = new char[required + TABLE_STREAM_WINDOW_PADDING];
+            if (available > 0)
+                memcpy(window + align, reader.m_Cursor, available);
+            delete[] reader.m_Window;
+            reader.m_Window = window;
+            reader.m_WindowSize = required;
+        }
+        else
+        {
+            memmove(reader.m_Window + align, reader.m_Cursor, available);
+        }
+        reader.m_Start = reader.m_Window + align;
+        reader.m_Cursor = reader.m_Start;
+        reader.m_End = reader.m_Start + available;
+        reader.m_Offset = offset;
+
+        while (!reader.m_EndOfStream && (uint32_t)(reader.m_End - reader.m_Cursor) < size)
+        {
+            uint32_t space = reader.m_WindowSize - (uint32_t)(reader.m_End - reader.m_Window);
+            uint32_t n = reader.m_Read(reader.m_Context, (char*)reader.m_End, space);
+            reader.m_EndOfStream = n == 0;
+            reader.m_End += n;
+        }
+        memset((char*)reader.m_End, 0, TABLE_STREAM_WINDOW_PADDING);
+    }
+
+    // When loading older save games, we will use the old unpack method (with truncated c strings)
+    static void LoadOldTSTRING(lua_State* L, TableReader& reader, uint32_t count, PushTableLogger& logger)
+    {
+        if (reader.m_Read != 0x0)
+        {
+            // Refill until the terminator is in the window
+            while (memchr(reader.m_Cursor, 0, reader.m_End - reader.m_Cursor) == 0x0 && !reader.m_EndOfStream)
+            {
+                Fill(reader, (uint32_t)(reader.m_End - reader.m_Cursor) + TABLE_STREAM_CHUNK_SIZE);
+            }
+        }
+        const char* buffer = reader.m_Cursor;
+        const char* buffer_end = reader.m_End;
+        uint32_t total_size = strlen(buffer) + 1;
+        if (buffer_end - buffer < (intptr_t)total_size)
+        {
+            char log_str[PUSH_TABLE_LOGGER_STR_SIZE];
+            PushTableLogPrint(logger, log_str);
+            luaL_error(L, "Reading outside of buffer at element #%d (string): wanted to read: %d bytes left: %d [BufStart: %p, BufSize: %lu]\n'%s'", count, total_size, (int)(buffer_end - buffer), logger.m_BufferStart, logger.m_BufferSize, log_str);
+        }
+
+        lua_pushstring(L, buffer);
+        reader.m_Cursor += total_size;
+    }
+
+    // When loading/unpacking messages/save games, we use pascal strings, and the Lua binary string api
+    static void LoadTSTRING(lua_State* L, TableReader& reader, uint32_t count, PushTableLogger& logger)
+    {
+        uint32_t len;
+        Fill(reader, sizeof(uint32_t));
+        memcpy(&len, reader.m_Cursor, sizeof(uint32_t));
+        // Don't let a corrupt length grow the stream window, the bounds check below reports it
+        if (len < TABLE_STREAM_MAX_STRING_SIZE)
+            Fill(reader, sizeof(uint32_t) + len);
+        const char* buffer = reader.m_Cursor;
+        const char* buffer_end = reader.m_End;
+        size_t value_len = (size_t)len;
+        uint32_t total_size = value_len + sizeof(uint32_t);
+        if (buffer_end - buffer < (intptr_t)total_size)
+        {
+            char log_str[PUSH_TABLE_LOGGER_STR_SIZE];
+            PushTableLogPrint(logger, log_str);
+            char str[512];
+            dmSnPrintf(str, sizeof(str), "Reading outside of buffer at element #%d (string) [value_len=%lu]: wanted to read: %d bytes left: %d [BufStart: %p, BufSize: %lu]\n'%s'", count, value_len, total_size, (uint32_t)(buffer_end - buffer), logger.m_BufferStart, logger.m_BufferSize, log_str);
+            luaL_error(L, "%s", str);
+        }
+
+        lua_pushlstring(L, buffer + sizeof(uint32_t), value_len);
+        reader.m_Cursor += total_size;
+    }
+
 #define CHECK_PUSHTABLE_OOB(ELEMTYPE, LOGGER, BUFFER, BUFFER_END, COUNT, DEPTH) \
     if (BUFFER > BUFFER_END) { \
         char log_str[PUSH_TABLE_LOGGER_STR_SIZE]; \
@@ -675,13 +907,16 @@ namespace dmScript
         return luaL_error(L, "%s", str); \
     }
 
-    int DoPushTable(lua_State*L, PushTableLogger& logger, const TableHeader& header, const char* original_buffer, const char* buffer, uint32_t buffer_size, uint32_t depth)
+    static int DoPushTable(lua_State*L, PushTableLogger& logger, const TableHeader& header, TableReader& reader, uint32_t depth)
     {
         int top = lua_gettop(L);
         (void)top;
 
-        const char* buffer_start = buffer;
-        const char* buffer_end = buffer + buffer_size;
+        // The cursor and end live in the reader since they move when a stream window is refilled
+        const char*& buffer = reader.m_Cursor;
+        const char* const& buffer_end = reader.m_End;
+        const uint32_t start_offset = GetOffset(reader);
+        Fill(reader, 2);
         CHECK_PUSHTABLE_OOB("table header", logger, buffer+2, buffer_end, 0, depth);
 
         uint16_t count;
@@ -702,6 +937,8 @@ namespace dmScript
 
         for (uint32_t i = 0; i < count; ++i)
         {
+            // Room for the key tags and an encoded index (at most 5 bytes)
+            Fill(reader, 2 + 5);
             CHECK_PUSHTABLE_OOB("key-value tags", logger, buffer+2, buffer_end, count, depth);
 
             char key_type = (*buffer++);
@@ -712,9 +949,9 @@ namespace dmScript
                 PushTableLogString(logger, "KS");
 
                 if (header.m_Version <= 1)
-                    buffer += LoadOldTSTRING(L, buffer, buffer_end, count, logger);
+                    LoadOldTSTRING(L, reader, count, logger);
                 else
-                    buffer += LoadTSTRING(L, buffer, buffer_end, count, logger);
+                    LoadTSTRING(L, reader, count, logger);
 
                 CHECK_PUSHTABLE_OOB("key string", logger, buffer, buffer_end, count, depth);
             }
@@ -726,6 +963,9 @@ namespace dmScript
                 CHECK_PUSHTABLE_OOB("key number", logger, buffer, buffer_end, count, depth);
             }
 
+            // Room for any fixed size value (sub type, alignment and a Matrix4)
+            Fill(reader, TABLE_MAX_ELEMENT_SIZE);
+
             switch (value_type)
             {
                 case LUA_TBOOLEAN:
@@ -742,7 +982,7 @@ namespace dmScript
                     PushTableLogString(logger, "VN");
 
                     // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
+                    intptr_t offset = GetOffset(reader);
                     intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
                     intptr_t align_size = aligned_buffer - (intptr_t) offset;
                     buffer += align_size;
@@ -761,9 +1001,9 @@ namespace dmScript
                     PushTableLogString(logger, "VS");
 
                     if (header.m_Version <= 1)
-                        buffer += LoadOldTSTRING(L, buffer, buffer_end, count, logger);
+                        LoadOldTSTRING(L, reader, count, logger);
                     else
-                        buffer += LoadTSTRING(L, buffer, buffer_end, count, logger);
+                        LoadTSTRING(L, reader, count, logger);
 
                     CHECK_PUSHTABLE_OOB("value string", logger, buffer, buffer_end, count, depth);
                 }
@@ -776,7 +1016,7 @@ namespace dmScript
                     char sub_type = *buffer++;
 
                     // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
+                    intptr_t offset = GetOffset(reader);
                     intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
                     intptr_t align_size = aligned_buffer - (intptr_t) offset;
                     buffer += align_size;
@@ -855,8 +1095,7 @@ namespace dmScript
                 break;
                 case LUA_TTABLE:
                 {
-                    int n_consumed = DoPushTable(L, logger, header, original_buffer, buffer, buffer_size, depth+1);
-                    buffer += n_consumed;
+                    DoPushTable(L, logger, header, reader, depth+1);
                     CHECK_PUSHTABLE_OOB("table", logger, buffer, buffer_end, count, depth);
                 }
                 break;
@@ -873,7 +1112,7 @@ namespace dmScript
         assert(top + 1 == lua_gettop(L));
 
         PushTableLogString(logger, "}");
-        return buffer - buffer_start;
+        return GetOffset(reader) - start_offset;
     }
 
 #undef CHECK_PUSHTABLE_OOB
@@ -897,7 +1136,13 @@ namespace dmScript
             PushTableLogger logger;
             logger.m_BufferStart = buffer;
             logger.m_BufferSize = buffer_size;
-            DoPushTable(L, logger, header, original_buffer, buffer, buffer_size, 0);
+
+            TableReader reader;
+            memset(&reader, 0, sizeof(reader));
+            reader.m_Start = original_buffer;
+            reader.m_Cursor = buffer;
+            reader.m_End = buffer + buffer_size;
+            DoPushTable(L, logger, header, reader, 0);
         }
         else
         {
@@ -907,4 +1152,39 @@ namespace dmScript
         }
     }
 
+    static int ProtectedPushTableStream(lua_State* L)
+    {
+        TableReader* reader = (TableReader*)lua_touserdata(L, 1);
+        lua_pop(L, 1);
+
+        TableHeader header;
+        Fill(*reader, sizeof(TableHeader));
+        if (reader->m_End - reader->m_Cursor < (intptr_t)sizeof(TableHeader))
+        {
+            return luaL_error(L, "Not enough data to read table header (header size: %d)", (int)sizeof(TableHeader));
+        }
+        reader->m_Cursor = ReadHeader(reader->m_Cursor, header);
+        if (!IsSupportedVersion(header))
+        {
+            return luaL_error(L, "Unsupported serialized table data: version = 0x%x (current = 0x%x)", header.m_Version, TABLE_VERSION_CURRENT);
+        }
+
+        PushTableLogger logger;
+        DoPushTable(L, logger, header, *reader, 0);
+        return 1;
+    }
+
+    bool PushTableStream(lua_State* L, TableReadFunction read_fn, void* context)
+    {
+        TableReader reader;
+        memset(&reader, 0, sizeof(reader));
+        reader.m_Read = read_fn;
+        reader.m_Context = context;
+
+        lua_pushcfunction(L, ProtectedPushTableStream);
+        lua_pushlightuserdata(L, &reader);
+        int ret = lua_pcall(L, 1, 1, 0);
+        delete[] reader.m_Window;
+        return ret == 0;
+    }
 }
@@ -13,9 +13,12 @@
 #include "script_timer.h"
 #include "script_timer_private.h"
 
+#include <math.h>
 #include <string.h>
-#include <dlib/index_pool.h>
+#include <algorithm>
+#include <dlib/array.h>
 #include <dlib/hashtable.h>
+#include <dlib/math.h>
 #include <dlib/profile.h>
 
 #include "script.h"
@@ -37,22 +40,34 @@ namespace dmScript
      */
 
     /*
-        The timers are stored in a flat array with no holes which we scan sequenctially on each update.
-
-        When a timer is removed the last timer in the list may change location (EraseSwap).
-
-        This is to keep the array sweep fast and handle cases where multiple short lived timers are
-        created followed by one long-lived timer. If we did not re-shuffle and keep holes we would keep
-        scanning the array to the end where the only live timer exists skipping all the holes.
-        How much of an issue this is guesswork at this point.
-
-        The timer identity is an index into an indirection layer combined with a generation counter,
-        this makes it possible to reuse the index for the indirection layer without risk of using
-        stale indexes - the caller to CancelTimer is allowed to call with an handle of a timer that already
-        has expired.
-
-        Each script instance needs to call KillTimers for its owner to clean up potential timers
+        The timers are scheduled on an absolute time line. Each timer world keeps the accumulated time
+        of all updates and every live timer has an absolute trigger time stored in a binary min-heap.
+
+        UpdateTimers only pops the timers at the top of the heap whose trigger time has passed, so the
+        cost of an update depends on the number of timers that fire, not on the number of timers that
+        exist. A world with 100k cooldown timers far in the future costs a single heap peek per frame.
+        Timers that are due in the same update trigger in the order they were added, as they did when
+        the update scanned the timer array.
+
+        The timers themselves live in slots that never move, each slot knows where its entry is in the
+        heap so a cancelled timer can be removed from the heap directly.
+
+        The timer identity is a slot index combined with a per slot generation counter, this makes it
+        possible to reuse the slots without risk of using stale handles - the caller to CancelTimer is
+        allowed to call with an handle of a timer that already has expired.
+
+        The handle is 32 bits and the slot index needs 20 of them to address more than 65535 timers,
+        which leaves 12 bits for the generation. Freed slots are reused in FIFO order, and only once
+        TIMER_FREE_SLOT_RESERVE other slots are free, so a slot is reused at most once per 16 freed
+        timers. A stale handle can match a new timer only after 4096 * 16 = 65536 timers have been
+        freed, as many as the 16 bit generation counter allowed before.
+
+        The timers of each owner are kept in an intrusive linked list so KillTimers does not have to scan
+        all timers. Each script instance needs to call KillTimers for its owner to clean up potential timers
         that has not yet been cancelled or completed (one-shot).
+
+        Timers that die during UpdateTimers are kept in their slots until the update is done so that
+        the timers already popped from the heap can be safely visited after each callback.
     */
 
     static const char TIMER_WORLD_VALUE_KEY[] = "__dm_timer_world__";
@@ -64,119 +79,332 @@ namespace dmScript
         uintptr_t       m_Owner;
         uintptr_t       m_UserData;
 
-        // Store complete timer handle with generation here to identify stale timer handles
-        HTimer          m_Handle;
-
-        // How much time remaining until the timer fires
-        float           m_Remaining;
-
         // The timer delay, we need to keep this for repeating timers
         float           m_Delay;
 
+        // Position of the timer in the heap, INVALID_TIMER_INDEX if it is not scheduled
+        uint32_t        m_HeapIndex;
+
+        // Siblings in the timer list of the owner. m_NextOwnerTimer is also the link in the free list
+        uint32_t        m_PrevOwnerTimer;
+        uint32_t        m_NextOwnerTimer;
+
+        // Order in which the timer was added, timers due in the same update trigger in this order
+        uint32_t        m_Sequence;
+
+        // Incremented each time the slot is freed to identify stale timer handles
+        uint16_t        m_Generation;
+
         // Flag if the timer should repeat
-        uint32_t        m_Repeat : 1;
+        uint16_t        m_Repeat : 1;
         // Flag if the timer is alive
-        uint32_t        m_IsAlive : 1;
+        uint16_t        m_IsAlive : 1;
     };
 
-    #define INVALID_TIMER_LOOKUP_INDEX  0xffffu
+    struct TimerHeapEntry
+    {
+        double          m_TriggerTime;
+        uint32_t        m_Sequence;
+        uint32_t        m_TimerIndex;
+    };
+
+    #define TIMER_INDEX_BITS            20u
+    #define TIMER_INDEX_MASK            ((1u << TIMER_INDEX_BITS) - 1u)
+    #define TIMER_GENERATION_MASK       (0xffffffffu >> TIMER_INDEX_BITS)
+    #define INVALID_TIMER_INDEX         0xffffffffu
     #define INITIAL_TIMER_CAPACITY      8u
-    #define MAX_TIMER_CAPACITY          65000u  // Needs to be less that 65535 since 65535 is reserved for invalid index
-    #define TIMER_CAPACITY_GROWTH       16u
+    #define MAX_TIMER_CAPACITY          TIMER_INDEX_MASK    // Needs to be less than TIMER_INDEX_MASK + 1 since that index is part of INVALID_TIMER_HANDLE
+    #define OWNER_TABLE_CAPACITY_GROWTH 64u
+    #define TIMER_FREE_SLOT_RESERVE     16u
 
     struct TimerWorld
     {
         dmArray<Timer>                      m_Timers;
-        dmArray<uint16_t>                   m_IndexLookup;
-        dmIndexPool<uint16_t>               m_IndexPool;
-        uint16_t                            m_Version;   // Incremented to avoid collisions each time we push timer indexes back to the m_IndexPool
+        dmArray<TimerHeapEntry>             m_Heap;
+        dmArray<TimerHeapEntry>             m_Triggered;    // The timers popped from the heap in the current update
+        dmArray<uint32_t>                   m_Released;     // The timers that died in the current update
+        dmHashTable64<uint32_t>             m_OwnerToFirstTimer;
+        double                              m_Time;
+        uint32_t                            m_FreeHead;
+        uint32_t                            m_FreeTail;
+        uint32_t                            m_FreeCount;
+        uint32_t                            m_AliveCount;
+        uint32_t                            m_Sequence;
         uint16_t                            m_InUpdate : 1;
     };
 
-    static uint16_t GetLookupIndex(HTimer handle)
+    static uint32_t GetLookupIndex(HTimer handle)
     {
-        return (uint16_t)(handle & 0xffffu);
+        return handle & TIMER_INDEX_MASK;
     }
 
-    static HTimer MakeHandle(uint16_t generation, uint16_t lookup_index)
+    static HTimer MakeHandle(uint32_t generation, uint32_t lookup_index)
     {
-        return (((uint32_t)generation) << 16) | (lookup_index);
+        return ((generation & TIMER_GENERATION_MASK) << TIMER_INDEX_BITS) | lookup_index;
     }
 
-    static Timer* AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
+    static HTimer GetHandle(const Timer& timer, uint32_t timer_index)
     {
-        assert(timer_world != 0x0);
-        uint32_t timer_count = timer_world->m_Timers.Size();
-        if (timer_count == MAX_TIMER_CAPACITY)
+        return MakeHandle(timer.m_Generation, timer_index);
+    }
+
+    template <typename T>
+    static void EnsureCapacity(dmArray<T>& array)
+    {
+        if (array.Full())
         {
-            dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
-            return 0x0;
+            array.SetCapacity(dmMath::Max(INITIAL_TIMER_CAPACITY, array.Capacity() * 2));
         }
+    }
 
-        if (timer_world->m_IndexPool.Remaining() == 0)
+    static bool SequenceLess(const TimerHeapEntry& a, const TimerHeapEntry& b)
+    {
+        // The sequence number may wrap, compare the distance to keep the order the timers were added in
+        return (int32_t)(a.m_Sequence - b.m_Sequence) < 0;
+    }
+
+    static bool HeapLess(const TimerHeapEntry& a, const TimerHeapEntry& b)
+    {
+        if (a.m_TriggerTime != b.m_TriggerTime)
         {
-            uint32_t old_capacity = timer_world->m_IndexPool.Capacity();
-            uint32_t capacity = dmMath::Min(old_capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_IndexPool.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetCapacity(capacity);
-            timer_world->m_IndexLookup.SetSize(capacity);
-            memset(&timer_world->m_IndexLookup[old_capacity], 0u, (capacity - old_capacity) * sizeof(uint16_t));
+            return a.m_TriggerTime < b.m_TriggerTime;
         }
+        return SequenceLess(a, b);
+    }
 
-        HTimer handle = MakeHandle(timer_world->m_Version, timer_world->m_IndexPool.Pop());
+    static void HeapSet(HTimerWorld timer_world, uint32_t heap_index, const TimerHeapEntry& entry)
+    {
+        timer_world->m_Heap[heap_index] = entry;
+        timer_world->m_Timers[entry.m_TimerIndex].m_HeapIndex = heap_index;
+    }
 
-        if (timer_world->m_Timers.Full())
+    static void HeapSiftUp(HTimerWorld timer_world, uint32_t heap_index)
+    {
+        TimerHeapEntry entry = timer_world->m_Heap[heap_index];
+        while (heap_index > 0)
         {
-            uint32_t capacity = timer_world->m_Timers.Capacity();
-            capacity = dmMath::Min(capacity + TIMER_CAPACITY_GROWTH, MAX_TIMER_CAPACITY);
-            timer_world->m_Timers.SetCapacity(capacity);
+            uint32_t parent = (heap_index - 1) / 2;
+            if (!HeapLess(entry, timer_world->m_Heap[parent]))
+            {
+                break;
+            }
+            HeapSet(timer_world, heap_index, timer_world->m_Heap[parent]);
+            heap_index = parent;
         }
+        HeapSet(timer_world, heap_index, entry);
+    }
 
-        timer_world->m_Timers.SetSize(timer_count + 1);
-        Timer& timer = timer_world->m_Timers[timer_count];
-        timer.m_Handle = handle;
-        timer.m_Owner = owner;
+    static void HeapSiftDown(HTimerWorld timer_world, uint32_t heap_index)
+    {
+        uint32_t size = timer_world->m_Heap.Size();
+        TimerHeapEntry entry = timer_world->m_Heap[heap_index];
+        while (true)
+        {
+            uint32_t child = heap_index * 2 + 1;
+            if (child >= size)
+            {
+                break;
+            }
+            if (child + 1 < size && HeapLess(timer_world->m_Heap[child + 1], timer_world->m_Heap[child]))
+            {
+                ++child;
+            }
+            if (!HeapLess(timer_world->m_Heap[child], entry))
+            {
+                break;
+            }
+            HeapSet(timer_world, heap_index, timer_world->m_Heap[child]);
+            heap_index = child;
+        }
+        HeapSet(timer_world, heap_index, entry);
+    }
 
-        uint16_t lookup_index = GetLookupIndex(handle);
+    static void ScheduleTimer(HTimerWorld timer_world, uint32_t timer_index, double trigger_time)
+    {
+        TimerHeapEntry entry;
+        entry.m_TriggerTime = trigger_time;
+        entry.m_Sequence = timer_world->m_Timers[timer_index].m_Sequence;
+        entry.m_TimerIndex = timer_index;
+
+        EnsureCapacity(timer_world->m_Heap);
+        timer_world->m_Heap.Push(entry);
+        HeapSiftUp(timer_world, timer_world->m_Heap.Size() - 1);
+    }
 
-        timer_world->m_IndexLookup[lookup_index] = timer_count;
-        return &timer;
+    static void UnscheduleTimer(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        uint32_t heap_index = timer_world->m_Timers[timer_index].m_HeapIndex;
+        if (heap_index == INVALID_TIMER_INDEX)
+        {
+            return;
+        }
+        timer_world->m_Timers[timer_index].m_HeapIndex = INVALID_TIMER_INDEX;
+
+        TimerHeapEntry last = timer_world->m_Heap.Back();
+        timer_world->m_Heap.Pop();
+        if (heap_index == timer_world->m_Heap.Size())
+        {
+            return;
+        }
+
+        timer_world->m_Heap[heap_index] = last;
+        if (heap_index > 0 && HeapLess(last, timer_world->m_Heap[(heap_index - 1) / 2]))
+        {
+            HeapSiftUp(timer_world, heap_index);
+        }
+        else
+        {
+            HeapSiftDown(timer_world, heap_index);
+        }
     }
 
-    static void EraseTimer(HTimerWorld timer_world, uint32_t timer_index)
+    static uint32_t AllocateTimer(HTimerWorld timer_world, uintptr_t owner)
     {
         assert(timer_world != 0x0);
 
-        Timer& movedTimer = timer_world->m_Timers.EraseSwap(timer_index);
+        // Keep a reserve of free slots to reuse each slot, and its generation counter, less often
+        uint32_t timer_index = timer_world->m_FreeHead;
+        bool reuse_slot = timer_world->m_FreeCount > TIMER_FREE_SLOT_RESERVE || (timer_index != INVALID_TIMER_INDEX && timer_world->m_Timers.Size() == MAX_TIMER_CAPACITY);
+        if (reuse_slot)
+        {
+            timer_world->m_FreeHead = timer_world->m_Timers[timer_index].m_NextOwnerTimer;
+            if (timer_world->m_FreeHead == INVALID_TIMER_INDEX)
+            {
+                timer_world->m_FreeTail = INVALID_TIMER_INDEX;
+            }
+            --timer_world->m_FreeCount;
+        }
+        else
+        {
+            timer_index = timer_world->m_Timers.Size();
+            if (timer_index == MAX_TIMER_CAPACITY)
+            {
+                dmLogError("Timer could not be stored since the timer buffer is full (%d).", MAX_TIMER_CAPACITY);
+                return INVALID_TIMER_INDEX;
+            }
+            if (timer_world->m_Timers.Full())
+            {
+                uint32_t capacity = dmMath::Min(timer_world->m_Timers.Capacity() * 2, MAX_TIMER_CAPACITY);
+                timer_world->m_Timers.SetCapacity(capacity);
+            }
+            timer_world->m_Timers.SetSize(timer_index + 1);
+            timer_world->m_Timers[timer_index].m_Generation = 0;
+        }
+
+        Timer& timer = timer_world->m_Timers[timer_index];
+        timer.m_Owner = owner;
+        timer.m_HeapIndex = INVALID_TIMER_INDEX;
+        timer.m_PrevOwnerTimer = INVALID_TIMER_INDEX;
+        timer.m_NextOwnerTimer = INVALID_TIMER_INDEX;
+
+        dmHashTable64<uint32_t>& owner_table = timer_world->m_OwnerToFirstTimer;
+        uint32_t* first_timer = owner_table.Get(owner);
+        if (first_timer != 0x0)
+        {
+            timer.m_NextOwnerTimer = *first_timer;
+            timer_world->m_Timers[*first_timer].m_PrevOwnerTimer = timer_index;
+            *first_timer = timer_index;
+            return timer_index;
+        }
 
-        if (timer_index < timer_world->m_Timers.Size())
+        if (owner_table.Full())
         {
-            uint16_t moved_lookup_index = GetLookupIndex(movedTimer.m_Handle);
-            timer_world->m_IndexLookup[moved_lookup_index] = timer_index;
+            uint32_t capacity = owner_table.Capacity() + OWNER_TABLE_CAPACITY_GROWTH;
+            owner_table.SetCapacity(dmMath::Max(1U, 2 * capacity / 3), capacity);
         }
+        owner_table.Put(owner, timer_index);
+        return timer_index;
     }
 
-    static void FreeTimer(HTimerWorld timer_world, Timer& timer)
+    static void FreeTimer(HTimerWorld timer_world, uint32_t timer_index)
     {
         assert(timer_world != 0x0);
+        Timer& timer = timer_world->m_Timers[timer_index];
         assert(timer.m_IsAlive == 0);
+        assert(timer.m_HeapIndex == INVALID_TIMER_INDEX);
 
-        uint16_t lookup_index = GetLookupIndex(timer.m_Handle);
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        timer_world->m_IndexPool.Push(lookup_index);
+        uint32_t prev = timer.m_PrevOwnerTimer;
+        uint32_t next = timer.m_NextOwnerTimer;
+        if (prev != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[prev].m_NextOwnerTimer = next;
+        }
+        else if (next != INVALID_TIMER_INDEX)
+        {
+            *timer_world->m_OwnerToFirstTimer.Get(timer.m_Owner) = next;
+        }
+        else
+        {
+            timer_world->m_OwnerToFirstTimer.Erase(timer.m_Owner);
+        }
+        if (next != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[next].m_PrevOwnerTimer = prev;
+        }
 
-        EraseTimer(timer_world, timer_index);
+        timer.m_Generation = (timer.m_Generation + 1) & TIMER_GENERATION_MASK;
+        timer.m_PrevOwnerTimer = INVALID_TIMER_INDEX;
+        timer.m_NextOwnerTimer = INVALID_TIMER_INDEX;
+        if (timer_world->m_FreeTail != INVALID_TIMER_INDEX)
+        {
+            timer_world->m_Timers[timer_world->m_FreeTail].m_NextOwnerTimer = timer_index;
+        }
+        else
+        {
+            timer_world->m_FreeHead = timer_index;
+        }
+        timer_world->m_FreeTail = timer_index;
+        ++timer_world->m_FreeCount;
+    }
+
+    // Marks a live timer as dead, the slot is released directly or at the end of UpdateTimers
+    static void KillTimer(HTimerWorld timer_world, uint32_t timer_index)
+    {
+        Timer& timer = timer_world->m_Timers[timer_index];
+        assert(timer.m_IsAlive == 1);
+        timer.m_IsAlive = 0;
+        --timer_world->m_AliveCount;
+        UnscheduleTimer(timer_world, timer_index);
+
+        if (timer_world->m_InUpdate == 0)
+        {
+            FreeTimer(timer_world, timer_index);
+        }
+        else
+        {
+            EnsureCapacity(timer_world->m_Released);
+            timer_world->m_Released.Push(timer_index);
+        }
+    }
+
+    // Returns the index of the timer if the handle refers to a live timer
+    static uint32_t GetAliveTimerIndex(HTimerWorld timer_world, HTimer handle)
+    {
+        uint32_t lookup_index = GetLookupIndex(handle);
+        if (lookup_index >= timer_world->m_Timers.Size())
+        {
+            return INVALID_TIMER_INDEX;
+        }
+
+        Timer& timer = timer_world->m_Timers[lookup_index];
+        if (timer.m_IsAlive == 0 || GetHandle(timer, lookup_index) != handle)
+        {
+            return INVALID_TIMER_INDEX;
+        }
+        return lookup_index;
     }
 
     HTimerWorld NewTimerWorld()
     {
         TimerWorld* timer_world = new TimerWorld();
         timer_world->m_Timers.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_IndexLookup.SetSize(INITIAL_TIMER_CAPACITY);
-        memset(&timer_world->m_IndexLookup[0], 0u, INITIAL_TIMER_CAPACITY * sizeof(uint16_t));
-        timer_world->m_IndexPool.SetCapacity(INITIAL_TIMER_CAPACITY);
-        timer_world->m_Version = 0;
+        timer_world->m_Heap.SetCapacity(INITIAL_TIMER_CAPACITY);
+        timer_world->m_Time = 0.0;
+        timer_world->m_FreeHead = INVALID_TIMER_INDEX;
+        timer_world->m_FreeTail = INVALID_TIMER_INDEX;
+        timer_world->m_FreeCount = 0;
+        timer_world->m_AliveCount = 0;
+        timer_world->m_Sequence = 0;
         timer_world->m_InUpdate = 0;
         return timer_world;
     }
@@ -191,36 +419,46 @@ namespace dmScript
     {
         assert(timer_world != 0x0);
         DM_PROFILE(TimerWorld, "Update");
+        DM_COUNTER("timerc", timer_world->m_AliveCount);
 
         timer_world->m_InUpdate = 1;
+        timer_world->m_Time += dt;
+        const double time = timer_world->m_Time;
+
+        // We only trigger timers that are due *at entry to UpdateTimers*. Timers added or rescheduled
+        // in a trigger callback are pushed to the heap after this and are not triggered in this scope.
+        dmArray<TimerHeapEntry>& triggered = timer_world->m_Triggered;
+        triggered.SetSize(0);
+        while (!timer_world->m_Heap.Empty() && timer_world->m_Heap[0].m_TriggerTime <= time)
+        {
+            TimerHeapEntry entry = timer_world->m_Heap[0];
+            UnscheduleTimer(timer_world, entry.m_TimerIndex);
+            EnsureCapacity(triggered);
+            triggered.Push(entry);
+        }
+        // The heap pops the due timers in trigger time order, trigger them in the order they were added
+        std::sort(triggered.Begin(), triggered.End(), SequenceLess);
 
-        // We only scan timers for trigger if the timer *existed at entry to UpdateTimers*, any timers added
-        // in a trigger callback will always be added at the end of m_Timers and not triggered in this scope.
-        uint32_t size = timer_world->m_Timers.Size();
-        DM_COUNTER("timerc", size);
-
+        uint32_t size = triggered.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
-            Timer* timer = &timer_world->m_Timers[i];
+            TimerHeapEntry entry = triggered[i];
+            uint32_t timer_index = entry.m_TimerIndex;
+            Timer* timer = &timer_world->m_Timers[timer_index];
             if (timer->m_IsAlive == 0)
             {
                 continue;
             }
 
-            timer->m_Remaining -= dt;
-            if (timer->m_Remaining > 0.0f)
-            {
-                continue;
-            }
-
-            float elapsed_time = timer->m_Delay - timer->m_Remaining;
+            double overdue = time - entry.m_TriggerTime;
+            float elapsed_time = (float)(timer->m_Delay + overdue);
 
             TimerEventType eventType = timer->m_Repeat == 0 ? TIMER_EVENT_TRIGGER_WILL_DIE : TIMER_EVENT_TRIGGER_WILL_REPEAT;
 
-            timer->m_Callback(timer_world, eventType, timer->m_Handle, elapsed_time, timer->m_Owner, timer->m_UserData);
+            timer->m_Callback(timer_world, eventType, GetHandle(*timer, timer_index), elapsed_time, timer->m_Owner, timer->m_UserData);
 
             // The array might have been reallocated here! So grab the pointer again...
-            timer = &timer_world->m_Timers[i];
+            timer = &timer_world->m_Timers[timer_index];
 
             if (timer->m_IsAlive == 0)
             {
@@ -229,45 +467,30 @@ namespace dmScript
 
             if (timer->m_Repeat == 0)
             {
-                timer->m_IsAlive = 0;
+                KillTimer(timer_world, timer_index);
                 continue;
             }
 
             if (timer->m_Delay == 0.0f)
             {
-                timer->m_Remaining = 0.0f;
+                ScheduleTimer(timer_world, timer_index, time);
                 continue;
             }
 
-            float wrapped_count = ((-timer->m_Remaining) / timer->m_Delay) + 1.f;
-            float offset_to_next_trigger  = floor(wrapped_count) * timer->m_Delay;
-            timer->m_Remaining += offset_to_next_trigger;
-            assert(timer->m_Remaining >= 0.f);
+            double wrapped_count = (overdue / timer->m_Delay) + 1.0;
+            double trigger_time = entry.m_TriggerTime + floor(wrapped_count) * timer->m_Delay;
+            assert(trigger_time >= time);
+            ScheduleTimer(timer_world, timer_index, trigger_time);
         }
 
         timer_world->m_InUpdate = 0;
 
-        size = timer_world->m_Timers.Size();
-        uint32_t original_size = size;
-        uint32_t i = 0;
-        while (i < size)
-        {
-            Timer& timer = timer_world->m_Timers[i];
-            if (timer.m_IsAlive == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++i;
-            }
-        }
-
-        if (size != original_size)
+        dmArray<uint32_t>& released = timer_world->m_Released;
+        for (uint32_t i = 0; i < released.Size(); ++i)
         {
-            ++timer_world->m_Version;
+            FreeTimer(timer_world, released[i]);
         }
+        released.SetSize(0);
     }
 
     HTimer AddTimer(HTimerWorld timer_world,
@@ -280,56 +503,39 @@ namespace dmScript
         assert(timer_world != 0x0);
         assert(delay >= 0.f);
         assert(timer_callback != 0x0);
-        Timer* timer = AllocateTimer(timer_world, owner);
-        if (timer == 0x0)
+        uint32_t timer_index = AllocateTimer(timer_world, owner);
+        if (timer_index == INVALID_TIMER_INDEX)
         {
             return INVALID_TIMER_HANDLE;
         }
 
-        timer->m_Delay = delay;
-        timer->m_Remaining = delay;
-        timer->m_UserData = userdata;
-        timer->m_Callback = timer_callback;
-        timer->m_Repeat = repeat;
-        timer->m_IsAlive = 1;
+        Timer& timer = timer_world->m_Timers[timer_index];
+        timer.m_Delay = delay;
+        timer.m_UserData = userdata;
+        timer.m_Callback = timer_callback;
+        timer.m_Repeat = repeat;
+        timer.m_IsAlive = 1;
+        timer.m_Sequence = timer_world->m_Sequence++;
+        ++timer_world->m_AliveCount;
+
+        ScheduleTimer(timer_world, timer_index, timer_world->m_Time + delay);
 
-        return timer->m_Handle;
+        return GetHandle(timer, timer_index);
     }
 
     bool CancelTimer(HTimerWorld timer_world, HTimer handle)
     {
         assert(timer_world != 0x0);
-        uint16_t lookup_index = GetLookupIndex(handle);
-        if (lookup_index >= timer_world->m_IndexLookup.Size())
+        uint32_t timer_index = GetAliveTimerIndex(timer_world, handle);
+        if (timer_index == INVALID_TIMER_INDEX)
         {
             return false;
         }
 
-        uint16_t timer_index = timer_world->m_IndexLookup[lookup_index];
-        if (timer_index >= timer_world->m_Timers.Size())
-        {
-            return false;
-        }
-
-        Timer& timer = timer_world->m_Timers[timer_index];
-        if (timer.m_Handle != handle)
-        {
-            return false;
-        }
-
-        if (timer.m_IsAlive == 0)
-        {
-            return false;
-        }
-
-        timer.m_IsAlive = 0;
-        timer.m_Callback(timer_world, TIMER_EVENT_CANCELLED, timer.m_Handle, 0.f, timer.m_Owner, timer.m_UserData);
-
-        if (timer_world->m_InUpdate == 0)
-        {
-            FreeTimer(timer_world, timer);
-            ++timer_world->m_Version;
-        }
+        // The callback may add or kill timers, so the slot is released before it is called
+        Timer timer = timer_world->m_Timers[timer_index];
+        KillTimer(timer_world, timer_index);
+        timer.m_Callback(timer_world, TIMER_EVENT_CANCELLED, handle, 0.f, timer.m_Owner, timer.m_UserData);
         return true;
     }
 
@@ -337,60 +543,38 @@ namespace dmScript
     {
         assert(timer_world != 0x0);
 
-        uint32_t size = timer_world->m_Timers.Size();
-        uint32_t cancelled_count = 0;
-        uint32_t timer_index = 0;
-        while (timer_index < size)
+        uint32_t* first_timer = timer_world->m_OwnerToFirstTimer.Get(owner);
+        if (first_timer == 0x0)
         {
-            Timer& timer = timer_world->m_Timers[timer_index];
-            if (timer.m_Owner != owner)
-            {
-                ++timer_index;
-                continue;
-            }
+            return 0;
+        }
 
-            if (timer.m_IsAlive == 1)
+        uint32_t cancelled_count = 0;
+        uint32_t timer_index = *first_timer;
+        while (timer_index != INVALID_TIMER_INDEX)
+        {
+            uint32_t next = timer_world->m_Timers[timer_index].m_NextOwnerTimer;
+            if (timer_world->m_Timers[timer_index].m_IsAlive == 1)
             {
-                timer.m_IsAlive = 0;
+                KillTimer(timer_world, timer_index);
                 ++cancelled_count;
             }
-
-            if (timer_world->m_InUpdate == 0)
-            {
-                FreeTimer(timer_world, timer);
-                --size;
-            }
-            else
-            {
-                ++timer_index;
-            }
-        }
-
-        if (cancelled_count > 0)
-        {
-            ++timer_world->m_Version;
+            timer_index = next;
         }
 
         return cancelled_count;
     }
 
-    uint32_t GetAliveTimers(HTimerWorld timer_world)
+    bool IsTimerAlive(HTimerWorld timer_world, HTimer handle)
     {
         assert(timer_world != 0x0);
+        return GetAliveTimerIndex(timer_world, handle) != INVALID_TIMER_INDEX;
+    }
 
-        uint32_t alive_timers = 0u;
-        uint32_t size = timer_world->m_Timers.Size();
-        uint32_t i = 0;
-        while (i < size)
-        {
-            Timer& timer = timer_world->m_Timers[i];
-            if(timer.m_IsAlive == 1)
-            {
-                ++alive_timers;
-            }
-            ++i;
-        }
-        return alive_timers;
+    uint32_t GetAliveTimers(HTimerWorld timer_world)
+    {
+        assert(timer_world != 0x0);
+        return timer_world->m_AliveCount;
     }
 
     static void SetTimerWorld(HScriptWorld script_world, HTimerWorld timer_world)
@@ -89,4 +89,28 @@ function test_http()
 
 end
 
-functions = { test_http = test_http }
+function test_http_slow()
+    -- The slow request is queued first. The requests after it are handled by the other
+    -- workers, so they all complete before it does.
+    local fast_left = 6
+    requests_left = fast_left + 1
+
+    http.request("http://127.0.0.1:" .. PORT .. "/sleep/1.0", "GET",
+        function(response)
+            assert(response.status == 200)
+            assert(fast_left == 0)
+            requests_left = requests_left - 1
+        end)
+
+    for i=1,6 do
+        http.request("http://127.0.0.1:" .. PORT, "GET",
+            function(response)
+                assert(response.status == 200)
+                assert(response.response == "Hello")
+                fast_left = fast_left - 1
+                requests_left = requests_left - 1
+            end)
+    end
+end
+
+functions = { test_http = test_http, test_http_slow = test_http_slow }
@@ -12,6 +12,8 @@
 
 #include "script.h"
 #include "script_http.h" // to set the timeout
+#include "http_service.h"
+#include "http_service_private.h"
 
 #include <dlib/configfile.h>
 #include <dlib/dstrings.h>
@@ -260,6 +262,14 @@ TEST_F(ScriptHttpTest, TestPost)
         }
     }
 
+    // The response is sent before the request is counted as completed
+    dmHttpService::Stats stats;
+    ASSERT_TRUE(dmScript::GetHttpServiceStats(&stats));
+    ASSERT_EQ(0U, stats.m_QueuedRequests);
+    ASSERT_EQ(7U, stats.m_CompletedRequests + stats.m_ActiveRequests);
+    ASSERT_GE(stats.m_TotalRequestTime, stats.m_MaxRequestTime);
+    ASSERT_GE(stats.m_TotalQueueTime, stats.m_MaxQueueTime);
+
     ASSERT_EQ(top, lua_gettop(L));
 }
 
@@ -370,6 +380,150 @@ TEST_F(ScriptHttpTest, TestDeletedSocket)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+TEST_F(ScriptHttpTest, TestSlowRequest)
+{
+    int top = lua_gettop(L);
+
+    ASSERT_TRUE(RunFile(L, "test_http.luac"));
+
+    char buf[1024];
+    dmSnPrintf(buf, sizeof(buf), "PORT = %d\n", m_WebServerPort);
+    RunString(L, buf);
+
+    lua_getglobal(L, "functions");
+    ASSERT_EQ(LUA_TTABLE, lua_type(L, -1));
+    lua_getfield(L, -1, "test_http_slow");
+    ASSERT_EQ(LUA_TFUNCTION, lua_type(L, -1));
+    int result = dmScript::PCall(L, 0, LUA_MULTRET);
+    if (result == LUA_ERRRUN)
+    {
+        ASSERT_TRUE(false);
+    }
+    else
+    {
+        ASSERT_EQ(0, result);
+    }
+    lua_pop(L, 1);
+
+    uint64_t start = dmTime::GetTime();
+    while (1) {
+        dmSys::PumpMessageQueue();
+        dmMessage::Dispatch(m_DefaultURL.m_Socket, DispatchCallbackDDF, this);
+
+        lua_getglobal(L, "requests_left");
+        int requests_left = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        if (requests_left == 0) {
+            break;
+        }
+
+        if( m_NumberOfFails )
+        {
+            break;
+        }
+
+        dmTime::Sleep(10 * 1000);
+
+        uint64_t now = dmTime::GetTime();
+        uint64_t elapsed = now - start;
+        if (elapsed / 1000000 > 8) {
+            dmLogError("The test timed out\n");
+            ASSERT_TRUE(0);
+        }
+    }
+
+    // No request waited in the queue for the slow one to complete
+    dmHttpService::Stats stats;
+    ASSERT_TRUE(dmScript::GetHttpServiceStats(&stats));
+    ASSERT_GE(stats.m_MaxRequestTime, 1000000U);
+    ASSERT_LT(stats.m_MaxQueueTime, 1000000U);
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
+static void PushQueuedRequest(dmArray<dmHttpService::QueuedRequest>& queue, uint64_t host_hash, uint64_t queue_time)
+{
+    dmHttpService::QueuedRequest queued;
+    memset(&queued, 0, sizeof(queued));
+    queued.m_HostHash = host_hash;
+    queued.m_QueueTime = queue_time;
+    if (queue.Full())
+        queue.OffsetCapacity(16);
+    queue.Push(queued);
+}
+
+// The queue time is used to tell the requests apart
+TEST(HttpService, PopRequestHostAffinity)
+{
+    const uint64_t host_a = 1;
+    const uint64_t host_b = 2;
+    dmArray<dmHttpService::QueuedRequest> queue;
+    PushQueuedRequest(queue, host_b, 0);
+    PushQueuedRequest(queue, host_b, 1);
+    PushQueuedRequest(queue, host_a, 2);
+    PushQueuedRequest(queue, host_b, 3);
+
+    // A worker that isn't connected takes the oldest request
+    dmHttpService::QueuedRequest queued;
+    dmHttpService::PopRequest(queue, 0, &queued);
+    ASSERT_EQ(0U, queued.m_QueueTime);
+
+    // A worker connected to a host takes the first request to it, the others keep their order
+    dmHttpService::PopRequest(queue, host_a, &queued);
+    ASSERT_EQ(2U, queued.m_QueueTime);
+    ASSERT_EQ(2U, queue.Size());
+    ASSERT_EQ(1U, queue[0].m_QueueTime);
+    ASSERT_EQ(1U, queue[0].m_SkipCount);
+    ASSERT_EQ(3U, queue[1].m_QueueTime);
+    ASSERT_EQ(0U, queue[1].m_SkipCount);
+
+    // Requests further back than the lookahead aren't considered
+    queue.SetSize(0);
+    for (uint32_t i = 0; i < dmHttpService::HOST_AFFINITY_LOOKAHEAD; ++i)
+    {
+        PushQueuedRequest(queue, host_b, i);
+    }
+    PushQueuedRequest(queue, host_a, dmHttpService::HOST_AFFINITY_LOOKAHEAD);
+    dmHttpService::PopRequest(queue, host_a, &queued);
+    ASSERT_EQ(0U, queued.m_QueueTime);
+}
+
+TEST(HttpService, PopRequestStarvation)
+{
+    const uint64_t host_a = 1;
+    const uint64_t host_b = 2;
+    const uint32_t count = 2 * dmHttpService::HOST_AFFINITY_MAX_SKIPS;
+
+    // The oldest request goes to host b, followed by a stream of requests to host a
+    dmArray<dmHttpService::QueuedRequest> queue;
+    PushQueuedRequest(queue, host_b, 0);
+    for (uint32_t i = 1; i <= count; ++i)
+    {
+        PushQueuedRequest(queue, host_a, i);
+    }
+
+    // A worker connected to host a passes the request to host b over a bounded number of times
+    dmHttpService::QueuedRequest queued;
+    for (uint32_t i = 1; i <= dmHttpService::HOST_AFFINITY_MAX_SKIPS; ++i)
+    {
+        dmHttpService::PopRequest(queue, host_a, &queued);
+        ASSERT_EQ(host_a, queued.m_HostHash);
+        ASSERT_EQ(i, queued.m_QueueTime);
+    }
+    dmHttpService::PopRequest(queue, host_a, &queued);
+    ASSERT_EQ(host_b, queued.m_HostHash);
+    ASSERT_EQ(dmHttpService::HOST_AFFINITY_MAX_SKIPS, queued.m_SkipCount);
+
+    // The rest are taken in order
+    for (uint32_t i = dmHttpService::HOST_AFFINITY_MAX_SKIPS + 1; i <= count; ++i)
+    {
+        dmHttpService::PopRequest(queue, host_a, &queued);
+        ASSERT_EQ(i, queued.m_QueueTime);
+    }
+    ASSERT_TRUE(queue.Empty());
+}
+
 int main(int argc, char **argv)
 {
     dmSocket::Initialize();
@@ -11,6 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdlib.h>
+#include <dlib/array.h>
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/align.h>
@@ -967,6 +968,115 @@ TEST_F(LuaTableTest, Stress)
     }
 }
 
+struct TableStream
+{
+    dmArray<char>   m_Data;
+    uint32_t        m_ReadOffset;
+    uint32_t        m_MaxReadSize; // Limits the size of each read to exercise refills
+};
+
+static bool TableStreamWrite(void* context, const void* data, uint32_t size)
+{
+    TableStream* stream = (TableStream*)context;
+    if (stream->m_Data.Remaining() < size)
+        stream->m_Data.OffsetCapacity(dmMath::Max(size, 4096u));
+    stream->m_Data.PushArray((const char*)data, size);
+    return true;
+}
+
+static uint32_t TableStreamRead(void* context, void* data, uint32_t size)
+{
+    TableStream* stream = (TableStream*)context;
+    uint32_t n = dmMath::Min(size, stream->m_Data.Size() - stream->m_ReadOffset);
+    if (stream->m_MaxReadSize != 0)
+        n = dmMath::Min(n, stream->m_MaxReadSize);
+    memcpy(data, stream->m_Data.Begin() + stream->m_ReadOffset, n);
+    stream->m_ReadOffset += n;
+    return n;
+}
+
+TEST_F(LuaTableTest, Stream)
+{
+    ASSERT_TRUE(RunString(L, " \
+        t = { number = 0.5, boolean = true, string = 'payload\\0\\1', long_string = string.rep('x', 10000), \
+              vector3 = vmath.vector3(1,2,3), vector4 = vmath.vector4(4,5,6,7), quat = vmath.quat(1,2,3,4), \
+              matrix4 = vmath.matrix4(), hash = hash('hashed value'), url = msg.url('a', 'b', 'c'), sub = {} } \
+        for i=1,2000 do t[i] = i * 0.25 end \
+        for i=1,100 do t.sub['key' .. i] = { i, tostring(i), { [-i] = i } } end \
+    "));
+    lua_getglobal(L, "t");
+
+    // The streamed data is identical to the data serialized into a buffer
+    const uint32_t buffer_size = 128 * 1024;
+    char* buffer = new char[buffer_size];
+    uint32_t buffer_used = dmScript::CheckTable(L, buffer, buffer_size, -1);
+
+    TableStream stream;
+    stream.m_ReadOffset = 0;
+    stream.m_MaxReadSize = 0;
+    uint32_t stream_size = 0;
+    ASSERT_TRUE(dmScript::CheckTableStream(L, TableStreamWrite, &stream, -1, &stream_size));
+    ASSERT_EQ(buffer_used, stream_size);
+    ASSERT_EQ(buffer_used, stream.m_Data.Size());
+    ASSERT_EQ(0, memcmp(buffer, stream.m_Data.Begin(), buffer_used));
+    delete[] buffer;
+    lua_pop(L, 1);
+
+    const uint32_t read_sizes[] = {0, 1, 7, 4096};
+    for (uint32_t i = 0; i < sizeof(read_sizes) / sizeof(read_sizes[0]); ++i)
+    {
+        stream.m_ReadOffset = 0;
+        stream.m_MaxReadSize = read_sizes[i];
+        ASSERT_TRUE(dmScript::PushTableStream(L, TableStreamRead, &stream));
+        lua_setglobal(L, "t2");
+        ASSERT_TRUE(RunString(L, " \
+            for k,v in pairs(t) do \
+                if type(v) ~= 'table' then assert(t2[k] == v, tostring(k)) end \
+            end \
+            assert(#t2 == 2000) \
+            assert(t2.sub.key42[2] == '42') \
+            assert(t2.sub.key42[3][-42] == 42) \
+        "));
+    }
+
+    // Truncated data
+    stream.m_ReadOffset = 0;
+    stream.m_MaxReadSize = 0;
+    stream.m_Data.SetSize(stream.m_Data.Size() / 2);
+    ASSERT_FALSE(dmScript::PushTableStream(L, TableStreamRead, &stream));
+    ASSERT_EQ(LUA_TSTRING, lua_type(L, -1));
+    lua_pop(L, 1);
+
+    // Unsupported value
+    ASSERT_TRUE(RunString(L, "t = { f = print }"));
+    lua_getglobal(L, "t");
+    stream.m_Data.SetSize(0);
+    ASSERT_FALSE(dmScript::CheckTableStream(L, TableStreamWrite, &stream, -1, 0));
+    ASSERT_STREQ("unsupported value type in table: function", lua_tostring(L, -1));
+    lua_pop(L, 2);
+
+    ASSERT_TRUE(RunString(L, "t = nil t2 = nil"));
+}
+
+TEST_F(LuaTableTest, Stream_TSTRING_V1) // old format, strings are null terminated
+{
+    TableStream stream;
+    stream.m_Data.SetCapacity(TABLE_TSTRING_V1_DAT_SIZE);
+    stream.m_Data.PushArray((const char*)TABLE_TSTRING_V1_DAT, TABLE_TSTRING_V1_DAT_SIZE);
+    stream.m_ReadOffset = 0;
+    stream.m_MaxReadSize = 3;
+    ASSERT_TRUE(dmScript::PushTableStream(L, TableStreamRead, &stream));
+    lua_setglobal(L, "t");
+
+    ASSERT_TRUE(RunString(L, " \
+        assert( t['binary'] == 'payload\\1' ) \
+        assert( t['vector3'] == vmath.vector3(1,2,3) ) \
+        assert( t['number'] == 0.5 ) \
+        assert( t['url'] == msg.url('a', 'b', 'c') ) \
+        t = nil \
+    "));
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
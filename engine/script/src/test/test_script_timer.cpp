@@ -719,6 +719,115 @@ TEST_F(ScriptTimerTest, TestKillTimers)
     dmScript::DeleteTimerWorld(timer_world);
 }
 
+TEST_F(ScriptTimerTest, TestTriggerOrder)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    static dmScript::HTimer handles[4];
+    static uint32_t order[4];
+
+    struct Callback {
+        static void cb(dmScript::HTimerWorld timer_world, dmScript::TimerEventType event_type, dmScript::HTimer timer_handle, float time_elapsed, uintptr_t owner, uintptr_t userdata)
+        {
+            order[TimerTestCallback::callback_count++] = (uint32_t)userdata;
+        }
+    };
+
+    handles[0] = dmScript::AddTimer(timer_world, 3.f, false, Callback::cb, 0x10, 0);
+    handles[1] = dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 1);
+    handles[2] = dmScript::AddTimer(timer_world, 2.f, false, Callback::cb, 0x10, 2);
+    handles[3] = dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 3);
+
+    // Timers due in the same update trigger in the order they were added
+    dmScript::UpdateTimers(timer_world, 5.f);
+    ASSERT_EQ(4u, TimerTestCallback::callback_count);
+    ASSERT_EQ(0u, order[0]);
+    ASSERT_EQ(1u, order[1]);
+    ASSERT_EQ(2u, order[2]);
+    ASSERT_EQ(3u, order[3]);
+
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    // Timers due in different updates trigger in due time order
+    TimerTestCallback::callback_count = 0;
+    handles[0] = dmScript::AddTimer(timer_world, 3.f, false, Callback::cb, 0x10, 0);
+    handles[1] = dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 1);
+    handles[2] = dmScript::AddTimer(timer_world, 2.f, false, Callback::cb, 0x10, 2);
+    handles[3] = dmScript::AddTimer(timer_world, 1.f, false, Callback::cb, 0x10, 3);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        dmScript::UpdateTimers(timer_world, 1.f);
+    }
+    ASSERT_EQ(4u, TimerTestCallback::callback_count);
+    ASSERT_EQ(1u, order[0]);
+    ASSERT_EQ(3u, order[1]);
+    ASSERT_EQ(2u, order[2]);
+    ASSERT_EQ(0u, order[3]);
+
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
+TEST_F(ScriptTimerTest, TestStaleHandles)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    // A single timer added and cancelled over and over must not get a handle that was used recently
+    dmScript::HTimer first = dmScript::AddTimer(timer_world, 1.f, false, TestCallback, 0x10, 0x0);
+    ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, first);
+    ASSERT_TRUE(dmScript::CancelTimer(timer_world, first));
+    for (uint32_t i = 0; i < 65535; ++i)
+    {
+        dmScript::HTimer handle = dmScript::AddTimer(timer_world, 1.f, false, TestCallback, 0x10, 0x0);
+        ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+        ASSERT_NE(first, handle);
+        ASSERT_FALSE(dmScript::CancelTimer(timer_world, first));
+        ASSERT_TRUE(dmScript::CancelTimer(timer_world, handle));
+    }
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
+TEST_F(ScriptTimerTest, TestIdleTimers)
+{
+    dmScript::HTimerWorld timer_world = dmScript::NewTimerWorld();
+
+    const uint32_t idle_count = 100000;
+    const uint32_t active_count = 16;
+    const uint32_t update_count = 1000;
+    const uint32_t owner_count = 64;
+
+    for (uint32_t i = 0; i < idle_count; ++i)
+    {
+        dmScript::HTimer handle = dmScript::AddTimer(timer_world, 1000.f + i * 0.01f, false, TestCallback, i % owner_count, 0x0);
+        ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+    }
+    for (uint32_t i = 0; i < active_count; ++i)
+    {
+        dmScript::HTimer handle = dmScript::AddTimer(timer_world, 0.f, true, TestCallback, i % owner_count, 0x0);
+        ASSERT_NE(dmScript::INVALID_TIMER_HANDLE, handle);
+    }
+    ASSERT_EQ(idle_count + active_count, GetAliveTimers(timer_world));
+
+    for (uint32_t i = 0; i < update_count; ++i)
+    {
+        dmScript::UpdateTimers(timer_world, 1.f / 60.f);
+    }
+    ASSERT_EQ(active_count * update_count, TimerTestCallback::callback_count);
+
+    uint32_t kill_count = 0;
+    for (uint32_t i = 0; i < owner_count; ++i)
+    {
+        kill_count += dmScript::KillTimers(timer_world, i);
+    }
+    ASSERT_EQ(idle_count + active_count, kill_count);
+    ASSERT_EQ(0u, GetAliveTimers(timer_world));
+
+    dmScript::DeleteTimerWorld(timer_world);
+}
+
 static bool RunString(lua_State* L, const char* script)
 {
     luaL_loadstring(L, script);
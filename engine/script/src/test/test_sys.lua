@@ -12,7 +12,6 @@
 
 function test_sys()
     local filename = "save001.save"
-    local max_table_size = 512 * 1024
     local file = sys.get_save_file("my_game", filename)
     -- Get file again, test mkdir
     file = sys.get_save_file("my_game", filename)
@@ -22,10 +21,22 @@ function test_sys()
     local data = sys.load(file)
     assert(#data == 0)
 
-    -- save file exceeding max buffer size, expected to fail
-    for i=1,max_table_size+1 do data[i] = i end
+    -- save table with too many rows, expected to fail
+    for i=1,65536 do data[i] = i end
     local ret, msg = pcall(function() sys.save(file, data) end)
-    if ret then assert(false, "expected lua error for sys.save with data table exceeding max size " .. max_table_size .. " bytes") end
+    if ret then assert(false, "expected lua error for sys.save with data table exceeding 65535 rows") end
+
+    -- save and load file larger than the old 512 kb save limit
+    local large_data = {}
+    local row = string.rep("x", 1000)
+    for i=1,1024 do large_data[i] = { name = row .. i, position = vmath.vector3(i, i, i) } end
+    assert(sys.save(file, large_data))
+    local large_data_prim = sys.load(file)
+    assert(#large_data_prim == 1024)
+    for i=1,1024 do
+        assert(large_data_prim[i].name == large_data[i].name)
+        assert(large_data_prim[i].position == large_data[i].position)
+    end
 
     -- save file with too long path (>1024 chars long), expected to fail
     local valid_data = { high_score = 1234, location = vmath.vector3(1,2,3), xp = 99, name = "Mr Player" }
@@ -53,12 +64,15 @@ function test_sys()
     assert(data['xp'] == data_prim['xp'])
     assert(data['name'] == data_prim['name'])
 
-    -- load file exceeding max buffer size, expected to fail
-    fh = io.open(file, "a+")
-    for i=1,(max_table_size/8) do fh:write("deadbeef") end
+    -- load truncated file, expected to fail
+    fh = io.open(file, "rb")
+    local contents = fh:read("*a")
+    fh:close()
+    fh = io.open(file, "wb")
+    fh:write(string.sub(contents, 1, #contents - 4))
     fh:close()
-    local ret, msg = pcall(function() sys.load(file, data) end)
-    if ret then assert(false, "expected lua error for sys.load with data table exceeding max size " .. max_table_size .. " bytes") end
+    local ret, msg = pcall(function() sys.load(file) end)
+    if ret then assert(false, "expected lua error for sys.load with truncated file") end
 
     -- get_config
     assert(sys.get_config("main.does_not_exists") == nil)